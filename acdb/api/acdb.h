@@ -2327,6 +2327,79 @@ int32_t acdb_ioctl(uint32_t cmd_id,
 	const void *cmd_struct, uint32_t cmd_struct_size,
 	void *rsp_struct, uint32_t rsp_struct_size);
 
+/** @ingroup ACDB_IOCTL
+
+	Allocates a response buffer for acdb_ioctl_alloc.
+
+	@param[in] ctx
+	The context given with the allocator.
+	@param[in] buf_index
+	Index of the response buffer. It is 0 for commands with one buffer.
+	For ACDB_CMD_GET_SUBGRAPH_DATA, index 0 is driver_prop and index 1
+	is spf_blob.
+	@param[in] size
+	Size of the buffer in bytes.
+
+	@return
+	The buffer, or NULL on failure. If the data does not fit, the
+	allocator is called again for the same index with a larger size and
+	the previous buffer is no longer used by the ACDB.
+*/
+typedef void* (*AcdbAllocFn)(void *ctx, uint32_t buf_index, uint32_t size);
+
+typedef struct _acdb_allocator_t AcdbAllocator;
+#include "acdb_begin_pack.h"
+struct _acdb_allocator_t {
+	/**< Allocates the response buffers */
+	AcdbAllocFn alloc;
+	/**< Context passed to alloc */
+	void *ctx;
+}
+#include "acdb_end_pack.h"
+;
+
+/** @ingroup ACDB_IOCTL
+
+	Runs an ACDB IOCTL that returns data in caller buffers, with the
+	buffers obtained from an allocator instead of calling acdb_ioctl once
+	for the size and again for the data.
+
+	The buffer pointers in the response must be NULL. The buffer sizes may
+	hold the size expected from an earlier call, which lets
+	ACDB_CMD_GET_GRAPH, ACDB_CMD_GET_SUBGRAPH_DATA and
+	ACDB_CMD_GET_SUBGRAPH_CALIBRATION_DATA_NONPERSIST be served in a
+	single pass when the data fits. Otherwise they must be 0.
+
+	On return the response points to the buffers from the allocator and
+	holds the size of the data in them. The caller owns the buffers and
+	frees them, also when the command fails.
+
+	@param[in] cmd_id
+	Command ID of a command that returns data in caller buffers.
+	@param[in] cmd_struct
+	Pointer to the command structure.
+	@param[in] cmd_struct_size
+	Size of the command structure.
+	@param[in,out] rsp_struct
+	Pointer to the response structure.
+	@param[in] rsp_struct_size
+	Size of the response structure.
+	@param[in] allocator
+	Allocator for the response buffers.
+
+	@return
+	The result of the call as defined by the command. AR_EUNSUPPORTED if
+	the command does not return data in caller buffers.
+
+	@dependencies
+	None
+
+*/
+int32_t acdb_ioctl_alloc(uint32_t cmd_id,
+	const void *cmd_struct, uint32_t cmd_struct_size,
+	void *rsp_struct, uint32_t rsp_struct_size,
+	const AcdbAllocator *allocator);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
@@ -1507,15 +1507,21 @@ int32_t ats_online_ioctl(
 
     if (status == AR_EOK)
     {
-        ACDB_MUTEX_LOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+        ACDB_CTX_MAN_CLIENT_CMD_LOCK(TRUE);
 
-        status = func_cb(cmd_buf,
-            cmd_buf_size,
-            rsp_buf,
-            rsp_buf_size,
-            rsp_buf_bytes_filled);
+        status = AcdbScratchAcquire(0);
+        if (AR_SUCCEEDED(status))
+        {
+            status = func_cb(cmd_buf,
+                cmd_buf_size,
+                rsp_buf,
+                rsp_buf_size,
+                rsp_buf_bytes_filled);
+
+            AcdbScratchRelease();
+        }
 
-        ACDB_MUTEX_UNLOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+        ACDB_CTX_MAN_CLIENT_CMD_UNLOCK();
     }
 
     return status;
@@ -21,6 +21,13 @@
 #include <stdio.h>
 
 #define LOG_TAG  "ACDB"
+
+/**< Storage class for per thread variables */
+#if defined(_WIN32) || defined(_WIN64)
+#define ACDB_THREAD_LOCAL __declspec(thread)
+#else
+#define ACDB_THREAD_LOCAL __thread
+#endif
 #define ACDB_ERR(...)  AR_LOG_ERR(LOG_TAG, __VA_ARGS__)
 #define ACDB_DBG(...)  AR_LOG_DEBUG(LOG_TAG, __VA_ARGS__)
 #define ACDB_INFO(...) AR_LOG_INFO(LOG_TAG, __VA_ARGS__)
@@ -7,8 +7,8 @@
 *
 * \brief
 *		Manages the active database context for an acdb_ioctl command. The
-*		context can only be changed per command since acdb_ioctl commands
-*		are guarded by a lock.
+*		active context is selected per thread, so commands holding the
+*		client lock for shared access can each select their own database.
 *
 * \copyright
 *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
@@ -33,9 +33,14 @@
 /**< The total number of databases being managed  */
 #define ACDB_CTX_MAN_DATABASE_COUNT acdb_ctx_man_get_database_count()
 
-/**< The lock for incoming ACDB client commands.(e.g ATS online
-commands from QACT and acdb_ioctl commands from GSL */
-#define ACDB_CTX_MAN_CLIENT_CMD_LOCK acdb_ctx_man_get_client_lock()
+/**< Acquires the lock for incoming ACDB client commands.(e.g ATS online
+commands from QACT and acdb_ioctl commands from GSL). Commands that modify
+the databases or delta data take it exclusively, all other commands share it */
+#define ACDB_CTX_MAN_CLIENT_CMD_LOCK(exclusive) \
+acdb_ctx_man_client_lock(exclusive)
+
+/**< Releases the lock acquired with ACDB_CTX_MAN_CLIENT_CMD_LOCK */
+#define ACDB_CTX_MAN_CLIENT_CMD_UNLOCK() acdb_ctx_man_client_unlock()
 
 #define ACDB_MAGIC_WORD 0x00ACDB00
 #define ACDB_HANDLE_MASK 0xF
@@ -60,6 +65,12 @@ typedef void *acdb_file_man_handle_t;
 /**< A handle to a delta file manager object */
 typedef void *acdb_delta_file_man_handle_t;
 
+/**< A handle to the graph key vector index of a database */
+typedef void *acdb_gkv_index_handle_t;
+
+/**< A handle to the PID persistence index of a database */
+typedef void *acdb_pid_persist_index_handle_t;
+
 /**< A context handle that holds references to the file manager,
 delta file manager, and heap objects for a database */
 typedef struct acdb_context_handle_t acdb_context_handle_t;
@@ -72,6 +83,12 @@ struct acdb_context_handle_t {
 	acdb_delta_file_man_handle_t delta_manager_handle;
 	/**< A handle to heap object*/
 	acdb_heap_handle_t heap_handle;
+	/**< A handle to the graph key vector index, NULL if it could not be
+	built in which case graph key vectors are found by searching the file */
+	acdb_gkv_index_handle_t gkv_index_handle;
+	/**< A handle to the PID persistence index, NULL if it could not be
+	built in which case the persist maps are searched in the file */
+	acdb_pid_persist_index_handle_t pid_persist_index_handle;
 };
 
 typedef enum acdb_ctx_manager_command_t
@@ -112,7 +129,9 @@ typedef enum acdb_ctx_manager_command_t
 
 /**
 * \brief
-*		Retrieves the active context handle
+*		Retrieves the active context handle of the calling thread. A thread
+*		that has not selected a database since databases were last added
+*		or removed gets the default database.
 *
 * \return a pointer to the active context handle, or
 *		  NULL if the context manager is not initialized
@@ -121,12 +140,24 @@ acdb_context_handle_t *acdb_ctx_man_get_active_handle(void);
 
 /**
 * \brief
-*		Retrieves the active context handle
+*		Acquires the client command lock. A thread that already holds
+*		the lock does not lock it again, nested commands run under the
+*		outermost lock.
 *
-* \return a pointer to the active context handle, or
-*		  NULL if the context manager is not initialized
+* \param[in] exclusive: TRUE for commands that modify the databases,
+*		delta data, or the set of loaded databases
+*
+* \return 0 on success, non-zero on failure
+*/
+int32_t acdb_ctx_man_client_lock(bool_t exclusive);
+
+/**
+* \brief
+*		Releases the client command lock held by the calling thread
+*
+* \return 0 on success, non-zero on failure
 */
-ar_osal_mutex_t acdb_ctx_man_get_client_lock(void);
+int32_t acdb_ctx_man_client_unlock(void);
 
 /**
 * \brief
@@ -17,6 +17,8 @@
 #include "acdb.h"
 #include "acdb_types.h"
 #include "acdb_parser.h"
+#include "acdb_utility.h"
+#include "acdb_context_mgr.h"
 
 /* ---------------------------------------------------------------------------
  * Preprocessor Definitions and Constants
@@ -26,9 +28,16 @@
  * Global Definitions
  *--------------------------------------------------------------------------- */
 
-extern uint32_t glb_buf_1[GLB_BUF_1_LENGTH];
-extern uint32_t glb_buf_2[GLB_BUF_2_LENGTH];
-extern uint32_t glb_buf_3[GLB_BUF_3_LENGTH];
+/**< Scratch buffers of the client call running on the calling thread.
+* See AcdbScratchAcquire */
+#define glb_buf_1 (AcdbScratchGet()->buf_1)
+#define glb_buf_2 (AcdbScratchGet()->buf_2)
+#define glb_buf_3 (AcdbScratchGet()->buf_3)
+
+/**< Sizes of the scratch buffers in bytes */
+#define GLB_BUF_1_SIZE (AcdbScratchGet()->buf_1_length * sizeof(uint32_t))
+#define GLB_BUF_2_SIZE (AcdbScratchGet()->buf_2_length * sizeof(uint32_t))
+#define GLB_BUF_3_SIZE (AcdbScratchGet()->buf_3_length * sizeof(uint32_t))
 
 /* ---------------------------------------------------------------------------
 * Type Declarations
@@ -295,18 +304,34 @@ int32_t DataProcSetMapToHeap(acdb_delta_data_map_t *map);
 * \brief
 *		Verifys whether a pid is globaly persistent.
 * \param[in] pid: Parameter ID to verify for global persistance
-* \return 0 on success, non-zero on failure
+* \return 0 on success, AR_ENOTEXIST if the pid is not globaly persistent
 */
 int32_t IsPidGlobalyPersistent(uint32_t pid);
 
 /**
 * \brief
 *		Verifys whether a pid is persistent.
-* \param[in] pid: Parameter ID to verify for global persistance
-* \return 0 on success, non-zero on failure
+* \param[in] pid: Parameter ID to verify for persistance
+* \return 0 on success, AR_ENOTEXIST if the pid is not persistent
 */
 int32_t IsPidPersistent(uint32_t pid);
 
+/**
+* \brief
+*		Builds an index of the PIDs in the PID Persist Map and the Global
+*       PID Persist Map of a database, used by IsPidPersistent and
+*       IsPidGlobalyPersistent. Free it with DataProcFreePidPersistIndex
+*
+* \param[in] fm_handle: The file manager handle of the database
+* \param[out] index: The new index
+*
+* \return 0 on success, and non-zero on failure
+*/
+int32_t DataProcCreatePidPersistIndex(acdb_file_man_handle_t fm_handle,
+    acdb_pid_persist_index_handle_t *index);
+
+void DataProcFreePidPersistIndex(acdb_pid_persist_index_handle_t index);
+
 /**
 * \brief
 * Retrieve tag data from the ACDB heap
@@ -639,6 +664,55 @@ int32_t DataProcSearchGkvLut(
     uint32_t gkv_lut_offset,
     acdb_graph_info_t *graph_info);
 
+/**
+* \brief
+*		Walks the GKV Key Table and GKV Lookup Tables of a database once and
+*       builds a hash index from each graph key vector to its lookup table
+*       entry. Free it with DataProcFreeGkvIndex
+*
+* \param[in] fm_handle: The file manager handle of the database
+* \param[out] index: The new index
+*
+* \return 0 on success, and non-zero on failure
+*/
+int32_t DataProcCreateGkvIndex(acdb_file_man_handle_t fm_handle,
+    acdb_gkv_index_handle_t *index);
+
+/**
+* \brief
+*		Computes the hash used to probe a GKV index. The hash does not
+*       depend on the index so it can be computed once and used to probe
+*       the index of every database
+*
+* \depends The input gkv must be sorted
+*
+* \param[in] gkv: The GKV to hash
+*
+* \return The hash of the GKV
+*/
+uint32_t DataProcGetGkvHash(AcdbGraphKeyVector* gkv);
+
+/**
+* \brief
+*		Looks up a GKV in an index built by DataProcCreateGkvIndex and gets
+*       back the offset to the Subgrah List and Subgraph Property Data List
+*
+* \depends The input gkv must be sorted
+*
+* \param[in] index: The GKV index of the database to search in
+* \param[in] gkv: The GKV to search for
+* \param[in] gkv_hash: The hash of gkv from DataProcGetGkvHash
+* \param[out] graph_info: Offset to the subgraph sequence list
+*               and subgraph property data list
+*
+* \return 0 on success, AR_ENOTEXIST if the GKV is not in the database
+*/
+int32_t DataProcSearchGkvIndex(acdb_gkv_index_handle_t index,
+    AcdbGraphKeyVector* gkv, uint32_t gkv_hash,
+    acdb_graph_info_t *graph_info);
+
+void DataProcFreeGkvIndex(acdb_gkv_index_handle_t index);
+
 /**
 * \brief
 *       Search for the first occurance of a <Module ID, Key Table Offset,
@@ -142,6 +142,9 @@ struct _acdb_file_man_rsp_t
 
 int32_t acdb_fm_get_db_chunks(uint32_t count, ...);
 
+int32_t acdb_get_db_chunk(acdb_file_man_handle_t handle,
+    uint32_t chunk_id, uint32_t* chunk_offset, uint32_t* chunk_size);
+
 int32_t acdb_fm_read_db_mem(acdb_file_man_handle_t handle,
     void* buffer, size_t read_size, uint32_t* offset);
 
@@ -151,6 +154,17 @@ int32_t acdb_fm_get_db_mem_ptr(acdb_file_man_handle_t handle,
 int32_t acdb_fm_get_db_mem_ptr_2(acdb_file_man_handle_t handle,
     void** file_ptr, uint32_t offset);
 
+/* \brief
+*      Get a database cache memory pointer at the specified offset to
+*      data_size bytes the caller reads through it. Unlike
+*      acdb_fm_get_db_mem_ptr_2 the whole range is bounds checked and
+*      counted as accessed when the database is loaded lazily.
+*
+* \return AR_EOK on success, non-zero otherwise
+*/
+int32_t acdb_fm_get_db_mem_ptr_3(acdb_file_man_handle_t handle,
+    void** file_ptr, size_t data_size, uint32_t offset);
+
 int32_t acdb_file_man_ioctl(uint32_t cmd_id,
     void *req, uint32_t sz_req,
     void *rsp, uint32_t sz_rsp);
@@ -164,6 +178,9 @@ int32_t FileManGetFilePointer1(void** file_ptr, size_t data_size,
 
 int32_t FileManGetFilePointer2(void** file_ptr, uint32_t offset);
 
+int32_t FileManGetFilePointer3(void** file_ptr, size_t data_size,
+    uint32_t offset);
+
 /* \brief
 *      Reads x bytes of data at the specified offset from the database
 *      cache and writes it to the provided destination buffer.
@@ -51,10 +51,9 @@ struct _acdb_tree_node_t
 typedef struct _kv_length_bin_t KVSubgraphMapBin;
 struct _kv_length_bin_t
 {
-	/**< The length of the key vector string */
-	uint32_t str_key_vector_size;
-	/**< The key vector string */
-	char_t *str_key_vector;
+	/**< The key vector of the map, the key value pairs are owned by
+	the map */
+	AcdbGraphKeyVector key_vector;
     /**< Maps a keyvector to a subgraph containing calibration data */
     acdb_delta_data_map_t *map;
 };
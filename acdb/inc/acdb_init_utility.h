@@ -129,7 +129,11 @@ int32_t AcdbInitUtilOpenDeltaFile(
 
 /**
 *	\brief
-*		Loads the acdb file from the file handle as a read only buffer
+*		Loads the acdb file from the file handle as a read only buffer.
+*       With ACDB_LOAD_FILE_MAPPED the buffer is a read only mapping of
+*       the file, otherwise (or when the file cannot be mapped) the file
+*       is read into a heap buffer. With ACDB_LOAD_FILE_LAZY the file manager
+*       also limits how much of the mapping stays resident
 *
 *   \param[in] fname: The acdb file name
 *	\param[in] fhandle: The acdb file handle
@@ -245,6 +245,34 @@ typedef struct acdb_header_v1_t
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
+
+/**< Smallest number of entries in a chunk index, must be a power of 2 */
+#define ACDB_CHUNK_INDEX_MIN_ENTRIES 64
+
+typedef struct acdb_chunk_index_entry_t
+{
+    /**< The chunk identifier, only valid when size is non zero */
+    uint32_t id;
+    /**< Offset of the chunk data from the start of the file */
+    uint32_t offset;
+    /**< The size of the chunk in bytes, 0 for an empty entry */
+    uint32_t size;
+}acdb_chunk_index_entry_t;
+
+/**< Open addressing table of the chunks in a database file */
+typedef struct acdb_chunk_index_t
+{
+    /**< Number of entries - 1, the number of entries is a power of 2 */
+    uint32_t mask;
+    /**< 32 - log2(number of entries), used by the hash */
+    uint32_t shift;
+    /**< Returned for chunks not in the file, AR_EFAILED if the chunk
+    headers are malformed past the last indexed chunk */
+    int32_t miss_status;
+    /**< The entries, allocated with the index */
+    acdb_chunk_index_entry_t *entries;
+}acdb_chunk_index_t;
+
 /* ---------------------------------------------------------------------------
 * Function Declarations and Documentation
 *--------------------------------------------------------------------------- */
@@ -253,6 +281,30 @@ int32_t acdb_parser_get_chunk(
     void* file_buffer, uint32_t buffer_length,
     uint32_t chunk_id, uint32_t *chunk_offset, uint32_t *chunk_size);
 
+/**
+*	\brief
+*		Walks the chunk headers of a database once and builds a chunk ID
+*       to chunk offset index, so chunks can be found without walking the
+*       file again. Free it with acdb_parser_free_chunk_index
+*
+*	\param[in] file_buffer: The database file in memory
+*	\param[in] buffer_length: The size of the database file
+*	\param[out] index: The new index
+*	\return AR_EOK on success and an error otherwise
+*/
+int32_t acdb_parser_create_chunk_index(
+    void* file_buffer, uint32_t buffer_length, acdb_chunk_index_t **index);
+
+/**
+*	\brief
+*		Looks up a chunk in an index built by acdb_parser_create_chunk_index.
+*       Returns the same result as acdb_parser_get_chunk on the indexed file
+*/
+int32_t acdb_parser_get_indexed_chunk(acdb_chunk_index_t *index,
+    uint32_t chunk_id, uint32_t *chunk_offset, uint32_t *chunk_size);
+
+void acdb_parser_free_chunk_index(acdb_chunk_index_t *index);
+
 int32_t acdb_parser_validate_file(acdb_buffer_t* in_mem_file);
 
 int32_t acdb_parser_get_acdb_header_v1(
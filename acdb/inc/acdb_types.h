@@ -26,18 +26,18 @@
 /**< The max character length of a string */
 #define ACDB_MAX_PATH_LENGTH 256
 
- /**< The number of elements in Global Buffer 1 */
+ /**< The minimum number of elements in scratch buffer 1 */
 #define GLB_BUF_1_LENGTH 2500
 
-/**< The number of elements in Global Buffer 2 */
+/**< The minimum number of elements in scratch buffer 2 */
 #define GLB_BUF_2_LENGTH 1000
 
-/**< The number of elements in Global Buffer 3 */
+/**< The minimum number of elements in scratch buffer 3 */
 #define GLB_BUF_3_LENGTH 500
 
-/**< Max number of keys that can be used. This is capped at half the capacity
-of the smallest global buffer length GLB_BUF_3_LENGTH*/
-#define ACDB_MAX_KEY_COUNT (GLB_BUF_3_LENGTH/2)
+/**< The number of scratch buffer elements needed to hold a key vector of
+key_count keys and the two offsets that follow it in a lookup table entry */
+#define ACDB_SCRATCH_KEY_VECTOR_LENGTH(key_count) (2 * (key_count) + 2)
 
 /*-----------------------------------------------------------------------------
 * Enums Types
@@ -50,6 +50,14 @@
 
 #define ACDB_FREE(data) AcdbFree((void*)data)
 
+/**< Lists of at most this many elements are insertion sorted by AcdbSort2,
+longer lists are insertion sorted in runs of this length that are merged */
+#define ACDB_SORT_RUN_LENGTH 16
+
+/**< Elements of at most this many words are moved through the stack
+while insertion sorting, larger elements need an allocation */
+#define ACDB_SORT_MAX_STACK_ELEM_WORDS 8
+
 //TODO: Remove this function once its avalible in the OSAL
 #ifndef ar_sscanf
 #if defined(_WIN64) || defined(_WIN32)
@@ -87,6 +95,24 @@ typedef void(*ACDB_LIST_CLEAR_CALLBACK)(
 * Struct Definitions
 *--------------------------------------------------------------------------- */
 
+/**< Scratch space used while processing one client command. Each thread
+* processing a command has its own scratch space, see AcdbScratchAcquire */
+typedef struct _acdb_scratch_t AcdbScratch;
+struct _acdb_scratch_t {
+    uint32_t *buf_1;
+    uint32_t *buf_2;
+    uint32_t *buf_3;
+    /**< Number of uint32_t elements in each buffer */
+    uint32_t buf_1_length;
+    uint32_t buf_2_length;
+    uint32_t buf_3_length;
+    /**< Number of nested client commands using the scratch space */
+    uint32_t ref_count;
+    /**< TRUE while acdb_ioctl_alloc fills buffers sized from a hint.
+    Running out of space is expected then and is not logged */
+    bool_t hinted_fill;
+};
+
 /* ---------------------------------------------------------------------------
 * Function Declarations and Documentation
 *--------------------------------------------------------------------------- */
@@ -116,7 +142,7 @@ int32_t AcdbDataBinarySearch2(void *p_array, size_t sz_arr, void *p_cmd,
 
 /**
 * \brief AcdbSort
-*		Performs insertion sort on an array of basic types
+*		Sorts an array of uint32_t in ascending order, see AcdbSort2
 * \param [in/out] p_array: array to be sorted
 * \param [in] sz_arr: size of p_array
 */
@@ -124,7 +150,9 @@ void AcdbSort(void* p_array, uint32_t sz_arr);
 
 /**
 * \brief AcdbSort2
-*		Performs insertion sort on an array of basic/user defined types
+*		Performs a stable sort on an array of basic/user defined types made
+*		of uint32_t members. Short lists are insertion sorted in place, longer
+*		lists are merge sorted in O(n log n) using a buffer the size of p_array
 * \param [in] sz_arr: byte size of p_array
 * \param [in/out] p_array: array to be sorted
 * \param [in] sz_elem: size of an element in the array
@@ -264,4 +292,46 @@ uint32_t AcdbCeil(uint32_t x, uint32_t y);
 * \param [in] list_data: A pointer to the memory used for storing data
 */
 int32_t AcdbGenericListInit(AcdbGenericList* list, uint32_t element_size, uint32_t max_element_count, void** list_data);
+
+/**
+* \brief AcdbScratchAcquire
+*		Allocates the scratch buffers used by a client command on the
+*		calling thread. The buffers are at least GLB_BUF_N_LENGTH elements
+*		long and grow to hold key vectors of key_count keys. A command
+*		issued while the thread already holds scratch space (e.g an ATS
+*		command calling acdb_ioctl) shares the outer command's buffers.
+*		Buffers released by earlier commands are reused when large enough.
+* \param [in] key_count: The largest key vector in the command request
+* \return AR_EOK on success, AR_ENOMEMORY if the buffers could not be
+*		allocated, AR_ENEEDMORE if the shared buffers of an outer command
+*		are too small
+*/
+int32_t AcdbScratchAcquire(uint32_t key_count);
+
+/**
+* \brief AcdbScratchRelease
+*		Releases the scratch buffers acquired with AcdbScratchAcquire
+*/
+void AcdbScratchRelease(void);
+
+/**
+* \brief AcdbScratchFreeCache
+*		Frees the scratch buffers kept for reuse by AcdbScratchRelease
+*/
+void AcdbScratchFreeCache(void);
+
+/**
+* \brief AcdbScratchGet
+*		Retrieves the scratch space of the calling thread. Code running
+*		outside of a client command shares a set of default buffers.
+* \return The scratch space
+*/
+AcdbScratch *AcdbScratchGet(void);
+
+/**
+* \brief AcdbScratchClear
+*		Zeroes one of the scratch buffers of the calling thread
+* \param [in] buf: glb_buf_1, glb_buf_2, or glb_buf_3
+*/
+void AcdbScratchClear(uint32_t *buf);
 #endif /* __ACDB_UTILITY_H__ */
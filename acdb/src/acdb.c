@@ -25,6 +25,45 @@
 #include "acdb_utility.h"
 #include "acdb_context_mgr.h"
 #include "acdb_heap.h"
+#include <stddef.h>
+
+/* ---------------------------------------------------------------------------
+* Preprocessor Definitions and Constants
+*--------------------------------------------------------------------------- */
+
+/**< Most response buffers filled by one acdb_ioctl_alloc command */
+#define ACDB_IOCTL_ALLOC_MAX_BUFS 2
+
+/**< Describes a response buffer field pair of a size/fill command */
+#define ACDB_RSP_BUF(type, size_field, ptr_field, elem_size) \
+	{ offsetof(type, size_field), offsetof(type, ptr_field), elem_size }
+
+/* ---------------------------------------------------------------------------
+* Type Declarations
+*--------------------------------------------------------------------------- */
+
+typedef struct _acdb_rsp_buf_t AcdbRspBuf;
+struct _acdb_rsp_buf_t {
+	/**< Offset of the buffer size in the response */
+	uint32_t size_offset;
+	/**< Offset of the buffer pointer in the response */
+	uint32_t ptr_offset;
+	/**< Size of an element when the size is an element count, 0 when
+	the size is in bytes */
+	uint32_t elem_size;
+};
+
+typedef struct _acdb_size_fill_cmd_t AcdbSizeFillCmd;
+struct _acdb_size_fill_cmd_t {
+	uint32_t cmd_id;
+	/**< Size of the response structure */
+	uint32_t rsp_size;
+	/**< TRUE if filling sets the size of the data written and fails
+	with AR_ENEEDMORE when a buffer is too small */
+	bool_t fill_reports_size;
+	uint32_t num_bufs;
+	AcdbRspBuf bufs[ACDB_IOCTL_ALLOC_MAX_BUFS];
+};
 
 /* ---------------------------------------------------------------------------
 * Global Data Definitions
@@ -32,6 +71,219 @@
 
 int32_t acdb_cmd_set_temp_path(AcdbSetTempPathReq *req);
 
+/**< The commands that fill caller buffers sized by a prior call, in the
+order of the buffer indices passed to AcdbAllocFn */
+static const AcdbSizeFillCmd acdb_size_fill_cmds[] = {
+	{ ACDB_CMD_GET_GRAPH, sizeof(AcdbGetGraphRsp), TRUE, 1,
+		{ ACDB_RSP_BUF(AcdbGetGraphRsp, size, subgraphs, 0) } },
+	{ ACDB_CMD_GET_SUBGRAPH_DATA, sizeof(AcdbGetSubgraphDataRsp), TRUE, 2,
+		{ ACDB_RSP_BUF(AcdbGetSubgraphDataRsp, driver_prop.size,
+			driver_prop.sub_graph_prop_data, 0),
+		  ACDB_RSP_BUF(AcdbGetSubgraphDataRsp, spf_blob.buf_size,
+			spf_blob.buf, 0) } },
+	{ ACDB_CMD_GET_SUBGRAPH_CONNECTIONS, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_SUBGRAPH_CALIBRATION_DATA_NONPERSIST, sizeof(AcdbBlob),
+		TRUE, 1, { ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_SUBGRAPH_CALIBRATION_DATA_PERSIST,
+		sizeof(AcdbSgIdPersistCalData), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbSgIdPersistCalData, cal_data_size, cal_data, 0) } },
+	{ ACDB_CMD_GET_DRIVER_DATA, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_MODULE_TAG_DATA, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_TAGGED_MODULES, sizeof(AcdbGetTaggedModulesRsp), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbGetTaggedModulesRsp, num_tagged_mids,
+			tagged_mid_list, sizeof(AcdbModuleInstance)) } },
+	{ ACDB_CMD_GET_AMDB_REGISTRATION_DATA, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_AMDB_DEREGISTRATION_DATA, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_SUBGRAPH_PROCIDS, sizeof(AcdbCmdGetSubgraphProcIdsRsp),
+		FALSE, 1, { ACDB_RSP_BUF(AcdbCmdGetSubgraphProcIdsRsp, size,
+			sg_proc_ids, 0) } },
+	{ ACDB_CMD_GET_AMDB_BOOTUP_LOAD_MODULES, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_TAGS_FROM_GKV, sizeof(AcdbCmdGetTagsFromGkvRsp), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbCmdGetTagsFromGkvRsp, list_size,
+			tag_module_list, 0) } },
+	{ ACDB_CMD_GET_GRAPH_CAL_KVS, sizeof(AcdbKeyVectorList), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbKeyVectorList, list_size, key_vector_list, 0) } },
+	{ ACDB_CMD_GET_SUPPORTED_GKVS, sizeof(AcdbKeyVectorList), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbKeyVectorList, list_size, key_vector_list, 0) } },
+	{ ACDB_CMD_GET_DRIVER_MODULE_KVS, sizeof(AcdbKeyVectorList), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbKeyVectorList, list_size, key_vector_list, 0) } },
+	{ ACDB_CMD_GET_GRAPH_TAG_KVS, sizeof(AcdbTagKeyVectorList), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbTagKeyVectorList, list_size,
+			key_vector_list, 0) } },
+	{ ACDB_CMD_GET_CAL_DATA, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_TAG_DATA, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_HW_ACCEL_SUBGRAPH_INFO, sizeof(AcdbHwAccelSubgraphInfoRsp),
+		FALSE, 1, { ACDB_RSP_BUF(AcdbHwAccelSubgraphInfoRsp, list_size,
+			subgraph_list, 0) } },
+	{ ACDB_CMD_GET_PROC_SUBGRAPH_CAL_DATA_PERSIST,
+		sizeof(AcdbSgIdPersistCalData), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbSgIdPersistCalData, cal_data_size, cal_data, 0) } },
+	{ ACDB_CMD_GET_AMDB_REGISTRATION_DATA_V2, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_AMDB_DEREGISTRATION_DATA_V2, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_AMDB_BOOTUP_LOAD_MODULES_V2, sizeof(AcdbBlob), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbBlob, buf_size, buf, 0) } },
+	{ ACDB_CMD_GET_GRAPH_ALIAS, sizeof(AcdbString), FALSE, 1,
+		{ ACDB_RSP_BUF(AcdbString, length, string, 0) } },
+	{ ACDB_CMD_GET_PROC_TAGGED_MODULES, sizeof(AcdbGetProcTaggedModulesRsp),
+		FALSE, 1, { ACDB_RSP_BUF(AcdbGetProcTaggedModulesRsp, list_size,
+			proc_tagged_module_list, 0) } },
+};
+
+/* ----------------------------------------------------------------------------
+* Private Function Definitions
+*--------------------------------------------------------------------------- */
+
+/**
+* \brief
+*		Determines whether a command modifies calibration, delta data, or
+*		the ACDB SW state. These commands hold the client lock exclusively
+*		while all other commands share it.
+*
+* \param[in] cmd_id: The acdb_ioctl command
+*
+* \return TRUE if the command modifies ACDB SW state, FALSE otherwise
+*/
+static bool_t acdb_is_write_cmd(uint32_t cmd_id)
+{
+	switch (cmd_id)
+	{
+	case ACDB_CMD_SET_CAL_DATA:
+	case ACDB_CMD_SET_TAG_DATA:
+	case ACDB_CMD_SET_TEMP_PATH:
+	case ACDB_CMD_ENABLE_PERSISTANCE:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+/**
+* \brief
+*		Retrieves the number of keys in the largest key vector of a command
+*		request so the command scratch buffers can be sized to hold it.
+*
+* \param[in] cmd_id: The acdb_ioctl command
+* \param[in] cmd_struct: The command request
+* \param[in] cmd_struct_size: The size of the command request
+*
+* \return The number of keys, or 0 if the request has no key vector
+*/
+static uint32_t acdb_get_cmd_key_count(uint32_t cmd_id,
+	const void *cmd_struct, uint32_t cmd_struct_size)
+{
+	const AcdbGraphKeyVector *kv[2] = { NULL, NULL };
+	uint32_t num_keys = 0;
+
+	if (IsNull(cmd_struct))
+		return 0;
+
+	switch (cmd_id)
+	{
+	case ACDB_CMD_GET_GRAPH:
+	case ACDB_CMD_GET_GRAPH_CAL_KVS:
+	case ACDB_CMD_GET_GRAPH_TAG_KVS:
+	case ACDB_CMD_GET_GRAPH_ALIAS:
+		if (cmd_struct_size == sizeof(AcdbGraphKeyVector))
+			kv[0] = (const AcdbGraphKeyVector*)cmd_struct;
+		break;
+	case ACDB_CMD_GET_SUBGRAPH_DATA:
+		if (cmd_struct_size == sizeof(AcdbSgIdGraphKeyVector))
+			kv[0] = &((const AcdbSgIdGraphKeyVector*)cmd_struct)
+				->graph_key_vector;
+		break;
+	case ACDB_CMD_GET_TAGS_FROM_GKV:
+		if (cmd_struct_size == sizeof(AcdbCmdGetTagsFromGkvReq))
+			kv[0] = ((const AcdbCmdGetTagsFromGkvReq*)cmd_struct)
+				->graph_key_vector;
+		break;
+	case ACDB_CMD_GET_SUBGRAPH_CALIBRATION_DATA_NONPERSIST:
+	case ACDB_CMD_GET_SUBGRAPH_CALIBRATION_DATA_PERSIST:
+	case ACDB_CMD_GET_SUBGRAPH_GLB_PSIST_IDENTIFIERS:
+		if (cmd_struct_size == sizeof(AcdbSgIdCalKeyVector))
+		{
+			kv[0] = &((const AcdbSgIdCalKeyVector*)cmd_struct)
+				->cal_key_vector_prior;
+			kv[1] = &((const AcdbSgIdCalKeyVector*)cmd_struct)
+				->cal_key_vector_new;
+		}
+		break;
+	case ACDB_CMD_GET_PROC_SUBGRAPH_CAL_DATA_PERSIST:
+		if (cmd_struct_size == sizeof(AcdbProcSubgraphPersistCalReq))
+		{
+			kv[0] = &((const AcdbProcSubgraphPersistCalReq*)cmd_struct)
+				->cal_key_vector_prior;
+			kv[1] = &((const AcdbProcSubgraphPersistCalReq*)cmd_struct)
+				->cal_key_vector_new;
+		}
+		break;
+	case ACDB_CMD_GET_DRIVER_DATA:
+		if (cmd_struct_size == sizeof(AcdbDriverData))
+			kv[0] = &((const AcdbDriverData*)cmd_struct)->key_vector;
+		break;
+	case ACDB_CMD_GET_MODULE_TAG_DATA:
+		if (cmd_struct_size == sizeof(AcdbSgIdModuleTag))
+			kv[0] = &((const AcdbSgIdModuleTag*)cmd_struct)
+				->module_tag.tag_key_vector;
+		break;
+	case ACDB_CMD_SET_CAL_DATA:
+		if (cmd_struct_size == sizeof(AcdbSetCalDataReq))
+		{
+			kv[0] = &((const AcdbSetCalDataReq*)cmd_struct)
+				->graph_key_vector;
+			kv[1] = &((const AcdbSetCalDataReq*)cmd_struct)
+				->cal_key_vector;
+		}
+		break;
+	case ACDB_CMD_GET_CAL_DATA:
+		if (cmd_struct_size == sizeof(AcdbGetCalDataReq))
+		{
+			kv[0] = &((const AcdbGetCalDataReq*)cmd_struct)
+				->graph_key_vector;
+			kv[1] = &((const AcdbGetCalDataReq*)cmd_struct)
+				->cal_key_vector;
+		}
+		break;
+	case ACDB_CMD_GET_TAG_DATA:
+		if (cmd_struct_size == sizeof(AcdbGetTagDataReq))
+		{
+			kv[0] = &((const AcdbGetTagDataReq*)cmd_struct)
+				->graph_key_vector;
+			kv[1] = &((const AcdbGetTagDataReq*)cmd_struct)
+				->module_tag.tag_key_vector;
+		}
+		break;
+	case ACDB_CMD_SET_TAG_DATA:
+		if (cmd_struct_size == sizeof(AcdbSetTagDataReq))
+		{
+			kv[0] = &((const AcdbSetTagDataReq*)cmd_struct)
+				->graph_key_vector;
+			kv[1] = &((const AcdbSetTagDataReq*)cmd_struct)
+				->module_tag.tag_key_vector;
+		}
+		break;
+	default:
+		break;
+	}
+
+	for (uint32_t i = 0; i < 2; i++)
+	{
+		if (!IsNull(kv[i]) && kv[i]->num_keys > num_keys)
+			num_keys = kv[i]->num_keys;
+	}
+
+	return num_keys;
+}
+
 /* ----------------------------------------------------------------------------
 * Public Function Definitions
 *--------------------------------------------------------------------------- */
@@ -70,8 +322,10 @@ int32_t acdb_init(AcdbDataFiles *acdb_data_files, AcdbFile* delta_file_path)
 		return status;
 	}
 
+	ACDB_CTX_MAN_CLIENT_CMD_LOCK(TRUE);
 	status = acdb_init_ioctl(ACDB_INIT_CMD_ADD_DATABASE,
 		&db_paths, sizeof(acdb_init_database_paths_t), NULL, 0);
+	ACDB_CTX_MAN_CLIENT_CMD_UNLOCK();
 	if (AR_FAILED(status))
 	{
 		ACDB_ERR("Error[%d]: Unable to add files to database.", status);
@@ -129,9 +383,11 @@ int32_t acdb_add_database(AcdbDatabaseFiles *acdb_data_files,
 		db_paths.writable_path.path = &writable_path->fileName[0];
 	}
 
+	ACDB_CTX_MAN_CLIENT_CMD_LOCK(TRUE);
 	status = acdb_init_ioctl(ACDB_INIT_CMD_ADD_DATABASE,
 		&db_paths, sizeof(acdb_init_database_paths_t),
 		acdb_handle, sizeof(acdb_handle_t));
+	ACDB_CTX_MAN_CLIENT_CMD_UNLOCK();
 	if (AR_FAILED(status))
 	{
 		ACDB_ERR("Error[%d]: Unable to add files to database.", status);
@@ -151,8 +407,10 @@ int32_t acdb_remove_database(const acdb_handle_t *acdb_handle)
 		return AR_EBADPARAM;;
 	}
 
+	ACDB_CTX_MAN_CLIENT_CMD_LOCK(TRUE);
 	status = acdb_init_ioctl(ACDB_INIT_CMD_REMOVE_DATABASE,
 		(acdb_handle_t)acdb_handle, sizeof(acdb_handle_t), NULL, 0);
+	ACDB_CTX_MAN_CLIENT_CMD_UNLOCK();
 	if (AR_FAILED(status))
 	{
 		ACDB_ERR("Error[%d]: Unable to add files to database.", status);
@@ -172,12 +430,14 @@ int32_t acdb_get_handle(AcdbFile *acdb_file, acdb_handle_t *acdb_handle)
 		return AR_EBADPARAM;
 	}
 
+	ACDB_CTX_MAN_CLIENT_CMD_LOCK(FALSE);
 	status = acdb_file_man_ioctl(ACDB_FILE_MAN_GET_VM_ID_FROM_FILE_NAME,
 		acdb_file, sizeof(AcdbFile),
 		&vm_id, sizeof(uint32_t));
 
 	status = acdb_ctx_man_ioctl(ACDB_CTX_MAN_CMD_GET_ACDB_CLIENT_HANDLE,
 		&vm_id, sizeof(uint32_t), acdb_handle, sizeof(acdb_handle_t));
+	ACDB_CTX_MAN_CLIENT_CMD_UNLOCK();
 
 	if (AR_FAILED(status))
 	{
@@ -196,7 +456,14 @@ int32_t acdbCmdIsPersistenceSupported(__UNUSED uint32_t *resp)
 	return AR_ENOTIMPL;
 }
 
-int32_t acdb_ioctl(uint32_t cmd_id,
+/**
+* \brief
+*		Runs an acdb_ioctl command. The caller holds the client lock and
+*		the command scratch buffers.
+*
+* \return The result of the command
+*/
+static int32_t acdb_ioctl_cmd(uint32_t cmd_id,
 	const void *cmd_struct,
 	uint32_t cmd_struct_size,
 	void *rsp_struct,
@@ -204,10 +471,6 @@ int32_t acdb_ioctl(uint32_t cmd_id,
 {
 	int32_t status = AR_EOK;
 
-	ACDB_PKT_LOG_DATA("ACDB_IOCTL_CMD_ID", &cmd_id, sizeof(cmd_id));
-
-	ACDB_MUTEX_LOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
-
 	switch (cmd_id) {
 	case ACDB_CMD_GET_GRAPH:
 		if (IsNull(cmd_struct) || cmd_struct_size != sizeof(AcdbGraphKeyVector) ||
@@ -220,7 +483,7 @@ int32_t acdb_ioctl(uint32_t cmd_id,
 			AcdbGraphKeyVector *req = (AcdbGraphKeyVector *)cmd_struct;
 			AcdbGetGraphRsp *rsp = (AcdbGetGraphRsp *)rsp_struct;
 
-			if (req->num_keys == 0 || req->num_keys >= ACDB_MAX_KEY_COUNT)
+			if (req->num_keys == 0)
 			{
 				status = AR_EBADPARAM;
 			}
@@ -239,8 +502,7 @@ int32_t acdb_ioctl(uint32_t cmd_id,
 			AcdbSgIdGraphKeyVector *req = (AcdbSgIdGraphKeyVector*)cmd_struct;
 			AcdbGetSubgraphDataRsp *rsp = (AcdbGetSubgraphDataRsp*)rsp_struct;
 			if (req->sg_ids == NULL ||
-				req->graph_key_vector.graph_key_vector == NULL ||
-				req->graph_key_vector.num_keys >= ACDB_MAX_KEY_COUNT)
+				req->graph_key_vector.graph_key_vector == NULL)
 			{
 				status = AR_EBADPARAM;
 			}
@@ -505,8 +767,7 @@ int32_t acdb_ioctl(uint32_t cmd_id,
 		{
 			AcdbCmdGetTagsFromGkvReq *req = (AcdbCmdGetTagsFromGkvReq*)cmd_struct;
 			AcdbCmdGetTagsFromGkvRsp *rsp = (AcdbCmdGetTagsFromGkvRsp*)rsp_struct;
-			if (req->graph_key_vector->num_keys == 0 ||
-				req->graph_key_vector->num_keys >= ACDB_MAX_KEY_COUNT)
+			if (req->graph_key_vector->num_keys == 0)
 			{
 				status = AR_EBADPARAM;
 			}
@@ -526,7 +787,7 @@ int32_t acdb_ioctl(uint32_t cmd_id,
         {
             AcdbGraphKeyVector *req = (AcdbGraphKeyVector*)cmd_struct;
             AcdbKeyVectorList *rsp = (AcdbKeyVectorList*)rsp_struct;
-            if (req->num_keys == 0 || req->num_keys >= ACDB_MAX_KEY_COUNT)
+            if (req->num_keys == 0)
             {
                 status = AR_EBADPARAM;
             }
@@ -577,7 +838,7 @@ int32_t acdb_ioctl(uint32_t cmd_id,
         {
             AcdbGraphKeyVector *req = (AcdbGraphKeyVector*)cmd_struct;
             AcdbTagKeyVectorList *rsp = (AcdbTagKeyVectorList*)rsp_struct;
-            if (req->num_keys == 0 || req->num_keys >= ACDB_MAX_KEY_COUNT)
+            if (req->num_keys == 0)
             {
                 status = AR_EBADPARAM;
             }
@@ -719,7 +980,7 @@ int32_t acdb_ioctl(uint32_t cmd_id,
 			AcdbGraphKeyVector* req = (AcdbGraphKeyVector*)cmd_struct;
 			AcdbString* rsp = (AcdbString*)rsp_struct;
 
-			if (req->num_keys == 0 || req->num_keys >= ACDB_MAX_KEY_COUNT)
+			if (req->num_keys == 0)
 			{
 				status = AR_EBADPARAM;
 			}
@@ -734,7 +995,214 @@ int32_t acdb_ioctl(uint32_t cmd_id,
 		break;
 	}
 
-	ACDB_MUTEX_UNLOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+	return status;
+}
+
+/**
+* \brief
+*		Looks up the response buffers of a size/fill command
+*
+* \param[in] cmd_id: The acdb_ioctl command
+*
+* \return The command or NULL if it does not fill caller buffers
+*/
+static const AcdbSizeFillCmd *acdb_get_size_fill_cmd(uint32_t cmd_id)
+{
+	for (uint32_t i = 0; i < sizeof(acdb_size_fill_cmds)
+		/ sizeof(acdb_size_fill_cmds[0]); i++)
+	{
+		if (acdb_size_fill_cmds[i].cmd_id == cmd_id)
+			return &acdb_size_fill_cmds[i];
+	}
+
+	return NULL;
+}
+
+/* Gets the size of a response buffer in bytes */
+static uint32_t acdb_rsp_buf_get_size(const void *rsp_struct,
+	const AcdbRspBuf *rsp_buf)
+{
+	uint32_t size = 0;
+
+	ACDB_MEM_CPY_SAFE(&size, sizeof(size),
+		(const uint8_t*)rsp_struct + rsp_buf->size_offset, sizeof(size));
+
+	return rsp_buf->elem_size ? size * rsp_buf->elem_size : size;
+}
+
+/* Sets the pointer and size in bytes of a response buffer */
+static void acdb_rsp_buf_set(void *rsp_struct, const AcdbRspBuf *rsp_buf,
+	void *buf, uint32_t size)
+{
+	if (rsp_buf->elem_size)
+		size /= rsp_buf->elem_size;
+
+	ACDB_MEM_CPY_SAFE((uint8_t*)rsp_struct + rsp_buf->size_offset,
+		sizeof(size), &size, sizeof(size));
+	ACDB_MEM_CPY_SAFE((uint8_t*)rsp_struct + rsp_buf->ptr_offset,
+		sizeof(buf), &buf, sizeof(buf));
+}
+
+/**
+* \brief
+*		Runs a size/fill command with response buffers from an allocator.
+*		When every buffer has a size hint and the command reports the size
+*		of the data it fills, the hinted buffers are filled in one pass.
+*		Otherwise, or if the data does not fit, the command is run once for
+*		the sizes and once more to fill buffers of exactly that size.
+*
+*		The response always points to the last buffers obtained from the
+*		allocator, including on failure.
+*
+* \return The result of the command
+*/
+static int32_t acdb_ioctl_size_fill(const AcdbSizeFillCmd *size_fill_cmd,
+	const void *cmd_struct, uint32_t cmd_struct_size,
+	void *rsp_struct, uint32_t rsp_struct_size,
+	const AcdbAllocator *allocator)
+{
+	int32_t status = AR_EOK;
+	bool_t hinted = size_fill_cmd->fill_reports_size;
+	uint32_t size = 0;
+	void *bufs[ACDB_IOCTL_ALLOC_MAX_BUFS] = { 0 };
+	uint32_t capacity[ACDB_IOCTL_ALLOC_MAX_BUFS] = { 0 };
+	const AcdbRspBuf *rsp_buf = NULL;
+
+	for (uint32_t i = 0; i < size_fill_cmd->num_bufs; i++)
+	{
+		capacity[i] = acdb_rsp_buf_get_size(rsp_struct,
+			&size_fill_cmd->bufs[i]);
+		if (capacity[i] == 0)
+			hinted = FALSE;
+	}
+
+	if (hinted)
+	{
+		for (uint32_t i = 0; i < size_fill_cmd->num_bufs; i++)
+		{
+			bufs[i] = allocator->alloc(allocator->ctx, i, capacity[i]);
+			acdb_rsp_buf_set(rsp_struct, &size_fill_cmd->bufs[i],
+				bufs[i], capacity[i]);
+			if (IsNull(bufs[i]))
+				return AR_ENOMEMORY;
+		}
+
+		AcdbScratchGet()->hinted_fill = TRUE;
+		status = acdb_ioctl_cmd(size_fill_cmd->cmd_id, cmd_struct,
+			cmd_struct_size, rsp_struct, rsp_struct_size);
+		AcdbScratchGet()->hinted_fill = FALSE;
+		if (status != AR_ENEEDMORE)
+			return status;
+	}
+
+	//Get the size of each buffer
+	for (uint32_t i = 0; i < size_fill_cmd->num_bufs; i++)
+	{
+		if (!hinted)
+			capacity[i] = 0;
+		acdb_rsp_buf_set(rsp_struct, &size_fill_cmd->bufs[i], NULL, 0);
+	}
+
+	status = acdb_ioctl_cmd(size_fill_cmd->cmd_id, cmd_struct,
+		cmd_struct_size, rsp_struct, rsp_struct_size);
+
+	for (uint32_t i = 0; i < size_fill_cmd->num_bufs && AR_SUCCEEDED(status); i++)
+	{
+		rsp_buf = &size_fill_cmd->bufs[i];
+		size = acdb_rsp_buf_get_size(rsp_struct, rsp_buf);
+		if (size > capacity[i])
+		{
+			bufs[i] = allocator->alloc(allocator->ctx, i, size);
+			capacity[i] = size;
+			if (IsNull(bufs[i]))
+				status = AR_ENOMEMORY;
+		}
+
+		acdb_rsp_buf_set(rsp_struct, rsp_buf, bufs[i], size);
+	}
+
+	if (AR_FAILED(status))
+	{
+		for (uint32_t i = 0; i < size_fill_cmd->num_bufs; i++)
+			acdb_rsp_buf_set(rsp_struct, &size_fill_cmd->bufs[i], bufs[i], 0);
+		return status;
+	}
+
+	return acdb_ioctl_cmd(size_fill_cmd->cmd_id, cmd_struct,
+		cmd_struct_size, rsp_struct, rsp_struct_size);
+}
+
+int32_t acdb_ioctl(uint32_t cmd_id,
+	const void *cmd_struct,
+	uint32_t cmd_struct_size,
+	void *rsp_struct,
+	uint32_t rsp_struct_size)
+{
+	int32_t status = AR_EOK;
+
+	ACDB_PKT_LOG_DATA("ACDB_IOCTL_CMD_ID", &cmd_id, sizeof(cmd_id));
+
+	ACDB_CTX_MAN_CLIENT_CMD_LOCK(acdb_is_write_cmd(cmd_id));
+
+	status = AcdbScratchAcquire(
+		acdb_get_cmd_key_count(cmd_id, cmd_struct, cmd_struct_size));
+	if (AR_FAILED(status))
+	{
+		ACDB_CTX_MAN_CLIENT_CMD_UNLOCK();
+		return status;
+	}
+
+	status = acdb_ioctl_cmd(cmd_id, cmd_struct, cmd_struct_size,
+		rsp_struct, rsp_struct_size);
+
+	AcdbScratchRelease();
+	ACDB_CTX_MAN_CLIENT_CMD_UNLOCK();
+
+	return status;
+}
+
+int32_t acdb_ioctl_alloc(uint32_t cmd_id,
+	const void *cmd_struct,
+	uint32_t cmd_struct_size,
+	void *rsp_struct,
+	uint32_t rsp_struct_size,
+	const AcdbAllocator *allocator)
+{
+	int32_t status = AR_EOK;
+	const AcdbSizeFillCmd *size_fill_cmd = acdb_get_size_fill_cmd(cmd_id);
+
+	if (IsNull(size_fill_cmd))
+	{
+		ACDB_ERR("Error[%d]: Command ID[%08X] does not return data in "
+			"caller allocated buffers", AR_EUNSUPPORTED, cmd_id);
+		return AR_EUNSUPPORTED;
+	}
+
+	if (IsNull(allocator) || IsNull(allocator->alloc) ||
+		IsNull(rsp_struct) || rsp_struct_size < size_fill_cmd->rsp_size)
+	{
+		ACDB_ERR("Error[%d]: The allocator or response is invalid",
+			AR_EBADPARAM);
+		return AR_EBADPARAM;
+	}
+
+	ACDB_PKT_LOG_DATA("ACDB_IOCTL_CMD_ID", &cmd_id, sizeof(cmd_id));
+
+	ACDB_CTX_MAN_CLIENT_CMD_LOCK(FALSE);
+
+	status = AcdbScratchAcquire(
+		acdb_get_cmd_key_count(cmd_id, cmd_struct, cmd_struct_size));
+	if (AR_FAILED(status))
+	{
+		ACDB_CTX_MAN_CLIENT_CMD_UNLOCK();
+		return status;
+	}
+
+	status = acdb_ioctl_size_fill(size_fill_cmd, cmd_struct, cmd_struct_size,
+		rsp_struct, rsp_struct_size, allocator);
+
+	AcdbScratchRelease();
+	ACDB_CTX_MAN_CLIENT_CMD_UNLOCK();
 
 	return status;
 }
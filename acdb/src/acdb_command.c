@@ -39,13 +39,6 @@
 
 #define ACDB_CLEAR_BUFFER(x) memset(&x, 0, sizeof(x))
 
-/* ---------------------------------------------------------------------------
-* Global Data Definitions
-*--------------------------------------------------------------------------- */
-uint32_t glb_buf_1[GLB_BUF_1_LENGTH];
-uint32_t glb_buf_2[GLB_BUF_2_LENGTH];
-uint32_t glb_buf_3[GLB_BUF_3_LENGTH];
-
 /* ---------------------------------------------------------------------------
 * Static Variable Definitions
 *--------------------------------------------------------------------------- */
@@ -559,8 +552,8 @@ int32_t TagDataSearchLut(AcdbGraphKeyVector *tkv,
 	uint32_t offset = 0;
 	bool_t result = FALSE;
 
-    ACDB_CLEAR_BUFFER(glb_buf_1);
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_1);
+    AcdbScratchClear(glb_buf_3);
 
     ci_tag_data_lut.chunk_id = ACDB_CHUNKID_MODULE_TAGDATA_LUT;
     status = ACDB_GET_CHUNK_INFO(&ci_tag_data_lut);
@@ -570,7 +563,7 @@ int32_t TagDataSearchLut(AcdbGraphKeyVector *tkv,
     }
 
     offset = ci_tag_data_lut.chunk_offset + tag_data_tbl_offset;
-    status = FileManReadBuffer(&glb_buf_1, 2 * sizeof(uint32_t), &offset);
+    status = FileManReadBuffer(glb_buf_1, 2 * sizeof(uint32_t), &offset);
     if (status != 0)
     {
         ACDB_ERR("Error[%d]: Unable to read TKV length and "
@@ -599,10 +592,10 @@ int32_t TagDataSearchLut(AcdbGraphKeyVector *tkv,
 	result = FALSE;
 	for (i = 0; i < key_table_header.num_entries; i++)
 	{
-		ACDB_CLEAR_BUFFER(glb_buf_1);
+		AcdbScratchClear(glb_buf_1);
 
         status = FileManReadBuffer(
-            &glb_buf_1, sz_tag_key_vector_entry, &offset);
+            glb_buf_1, sz_tag_key_vector_entry, &offset);
         if (status != 0)
         {
             ACDB_DBG("Error[%d]: Unable to read TKV values entry", AR_EFAILED);
@@ -619,8 +612,8 @@ int32_t TagDataSearchLut(AcdbGraphKeyVector *tkv,
 		}
 	}
 
-	ACDB_CLEAR_BUFFER(glb_buf_1);
-	ACDB_CLEAR_BUFFER(glb_buf_3);
+	AcdbScratchClear(glb_buf_1);
+	AcdbScratchClear(glb_buf_3);
 
 	if (FALSE == result)
 	{
@@ -762,7 +755,7 @@ int32_t TagDataGetParameterData(AcdbTagDataContextInfo *info, uint32_t *blob_off
         iid_pid_pair.parameter_id = info->parameter_list->list[i];
         module_header.parameter_id = info->parameter_list->list[i];
 
-        if (SEARCH_ERROR == AcdbDataBinarySearch2((void*)&glb_buf_3,
+        if (SEARCH_ERROR == AcdbDataBinarySearch2((void*)glb_buf_3,
             num_id_entries * sizeof(AcdbModIIDParamIDPair),
             &iid_pid_pair, 2,
             (int32_t)(sizeof(AcdbModIIDParamIDPair) / sizeof(uint32_t)),
@@ -827,7 +820,8 @@ int32_t TagDataGetParameterData(AcdbTagDataContextInfo *info, uint32_t *blob_off
         }
 
         caldata.size = module_header.param_size;
-        status = FileManGetFilePointer2((void**)&caldata.payload, offset);
+        status = FileManGetFilePointer3((void**)&caldata.payload,
+            caldata.size, offset);
 
         if (is_offloaded_param)
         {
@@ -1030,7 +1024,8 @@ int32_t TagDataGetSubgraphData(AcdbTagDataContextInfo *info,
         }
 
         caldata.size = module_header.param_size;
-        status = FileManGetFilePointer2((void**)&caldata.payload, cur_dpool_offset);
+        status = FileManGetFilePointer3((void**)&caldata.payload,
+            caldata.size, cur_dpool_offset);
 
         if (is_offloaded_param)
         {
@@ -1492,7 +1487,7 @@ int32_t AcdbCmdSetTagData(AcdbSetTagDataReq *req)
     }
 
     /* GLB_BUFFER_3 is used here as the filtered subgraph list. */
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_3);
     subgraph_param_data.subgraph_id_list.count = 0;
     subgraph_param_data.subgraph_id_list.list = &glb_buf_3[0];
     subgraph_param_data.data_size = req->blob_size;
@@ -1508,7 +1503,7 @@ int32_t AcdbCmdSetTagData(AcdbSetTagDataReq *req)
 
     status = AcdbSort2(
         req->module_tag.tag_key_vector.num_keys * sizeof(AcdbKeyValuePair),
-        &req->module_tag.tag_key_vector,
+        req->module_tag.tag_key_vector.graph_key_vector,
         sizeof(AcdbKeyValuePair), 0);
     if (AR_FAILED(status))
     {
@@ -1622,7 +1617,7 @@ int32_t AcdbCmdSetTagData(AcdbSetTagDataReq *req)
     }
 
 end:
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_3);
 
     return status;
 }
@@ -1706,7 +1701,7 @@ int32_t CalDataGetParameterData(AcdbAudioCalContextInfo *info, uint32_t *blob_of
             return AR_ENEEDMORE;
         }
 
-        ACDB_CLEAR_BUFFER(glb_buf_1);
+        AcdbScratchClear(glb_buf_1);
 
         iid_ref = (AcdbIidRefCount*)glb_buf_1;
     }
@@ -1716,7 +1711,7 @@ int32_t CalDataGetParameterData(AcdbAudioCalContextInfo *info, uint32_t *blob_of
         iid_pid_pair.parameter_id = info->parameter_list->list[i];
         module_header.parameter_id = info->parameter_list->list[i];
 
-        if (SEARCH_ERROR == AcdbDataBinarySearch2((void*)&glb_buf_3,
+        if (SEARCH_ERROR == AcdbDataBinarySearch2((void*)glb_buf_3,
             num_id_entries * sizeof(AcdbModIIDParamIDPair),
             &iid_pid_pair, 2,
             (int32_t)(sizeof(AcdbModIIDParamIDPair) / sizeof(uint32_t)),
@@ -1837,7 +1832,8 @@ int32_t CalDataGetParameterData(AcdbAudioCalContextInfo *info, uint32_t *blob_of
         }
 
         caldata.size = module_header.param_size;
-        status = FileManGetFilePointer2((void**)&caldata.payload, offset);
+        status = FileManGetFilePointer3((void**)&caldata.payload,
+            caldata.size, offset);
 
         if (is_offloaded_param)
         {
@@ -2201,7 +2197,7 @@ int32_t AcdbFindVoiceModuleCKV(
      */
     if (module_ckv.num_keys > 0)
     {
-        status = FileManReadBuffer(&glb_buf_1,
+        status = FileManReadBuffer(glb_buf_1,
             module_ckv.num_keys * sizeof(uint32_t), &offset);
         if (AR_FAILED(status))
         {
@@ -2481,7 +2477,8 @@ int32_t AcdbGetVoiceParameterCalData(
         }
 
         caldata.size = module_header.param_size;
-        status = FileManGetFilePointer2((void**)&caldata.payload, file_offset);
+        status = FileManGetFilePointer3((void**)&caldata.payload,
+            caldata.size, file_offset);
 
         status = IsOffloadedParam(module_header.parameter_id,
             &info->offloaded_parameter_list);
@@ -2876,7 +2873,7 @@ int32_t SearchTaggedModuleMapLut(ChunkInfo *ci_lut, SubgraphTagLutEntry *lut_ent
         return status;
     }
 
-    ACDB_CLEAR_BUFFER(glb_buf_1);
+    AcdbScratchClear(glb_buf_1);
 
     return status;
 }
@@ -3125,10 +3122,10 @@ int32_t BuildProcTaggedModulePayload(ChunkInfo* ci_def, AcdbUintList* subgraph_l
 
     /* Use glb_buf_3 to store list of unique processors found while iterating 
      * through subgraphs and procs.
-     * GLB_BUFFER_3 can hold up to GLB_BUF_3_LENGTH entries. We will never
+     * GLB_BUFFER_3 can hold at least GLB_BUF_3_LENGTH entries. We will never
      * have 500 procs, but we need to add the length check. */
     status = AcdbGenericListInit(&proc_domain_id_list, sizeof(AcdbProcDomainOffsetPair), 
-        GLB_BUF_3_LENGTH * sizeof(uint32_t), (void**)&glb_buf_3);
+        GLB_BUF_3_SIZE, (void**)glb_buf_3);
     if (AR_FAILED(status))
     {
         ACDB_ERR("Error[%d]: Unable to initialize list", status);
@@ -3513,7 +3510,7 @@ int32_t DriverDataSearchForModuleID(acdb_driver_cal_lut_entry_t *cal_lut_entry)
         return status;
     }
 
-	ACDB_CLEAR_BUFFER(glb_buf_1);
+	AcdbScratchClear(glb_buf_1);
 
 	return status;
 }
@@ -3555,7 +3552,7 @@ int32_t DriverDataSearchForKeys(
         if (num_keys > 0)
         {
             status = FileManReadBuffer(
-                &glb_buf_1, num_keys * sizeof(uint32_t), &offset);
+                glb_buf_1, num_keys * sizeof(uint32_t), &offset);
             if (AR_FAILED(status))
             {
                 ACDB_ERR("Error[%d]: Unable to read key vector", status);
@@ -3582,8 +3579,8 @@ int32_t DriverDataSearchForKeys(
     ACDB_ERR("Error[%d]: Unable to find matching key vector. "
         "One or more key IDs do not exist.", status);
 
-	ACDB_CLEAR_BUFFER(glb_buf_1);
-	ACDB_CLEAR_BUFFER(glb_buf_3);
+	AcdbScratchClear(glb_buf_1);
+	AcdbScratchClear(glb_buf_3);
 
 	return status;
 }
@@ -3646,7 +3643,7 @@ int32_t DriverDataSearchCalDataLUT(AcdbDriverData *req, AcdbBlob* rsp,
     //Setup Search Information
     search_info.num_search_keys = caldata_lut_header.num_keys;
     search_info.num_structure_elements = num_struct_elements;
-    search_info.table_entry_struct = &glb_buf_3;
+    search_info.table_entry_struct = glb_buf_3;
 
     status = AcdbTableBinarySearch(&table_info, &search_info);
     if (AR_FAILED(status))
@@ -3660,8 +3657,8 @@ int32_t DriverDataSearchCalDataLUT(AcdbDriverData *req, AcdbBlob* rsp,
         &glb_buf_3[0] + (caldata_lut_header.num_keys) * sizeof(uint32_t),
 		sizeof(AcdbDefDotPair));
 
-	ACDB_CLEAR_BUFFER(glb_buf_1);
-	ACDB_CLEAR_BUFFER(glb_buf_3);
+	AcdbScratchClear(glb_buf_1);
+	AcdbScratchClear(glb_buf_3);
 	return status;
 }
 
@@ -3707,7 +3704,7 @@ int32_t DriverDataGetCalibration(AcdbDriverData *req, AcdbBlob* rsp, AcdbDefDotP
         return status;
     }
 
-    status = FileManReadBuffer(&glb_buf_2, sizeof(uint32_t)* num_pids, &offset);
+    status = FileManReadBuffer(glb_buf_2, sizeof(uint32_t)* num_pids, &offset);
     if (AR_FAILED(status))
     {
         ACDB_ERR("Error[%d]: Failed to read Parameter List", status);
@@ -3723,7 +3720,7 @@ int32_t DriverDataGetCalibration(AcdbDriverData *req, AcdbBlob* rsp, AcdbDefDotP
         return status;
     }
 
-    status = FileManReadBuffer(&glb_buf_3, sizeof(uint32_t)* num_caldata_offsets, &offset);
+    status = FileManReadBuffer(glb_buf_3, sizeof(uint32_t)* num_caldata_offsets, &offset);
     if (AR_FAILED(status))
     {
         ACDB_ERR("Error[%d]: Failed to read parameter calibration offset list", status);
@@ -3818,9 +3815,9 @@ int32_t DriverDataGetCalibration(AcdbDriverData *req, AcdbBlob* rsp, AcdbDefDotP
 
     pid_list = NULL;
     caldata_offset_list = NULL;
-    ACDB_CLEAR_BUFFER(glb_buf_1);
-    ACDB_CLEAR_BUFFER(glb_buf_2);
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_1);
+    AcdbScratchClear(glb_buf_2);
+    AcdbScratchClear(glb_buf_3);
 
     return status;
 }
@@ -4152,6 +4149,10 @@ int32_t AcdbCmdGetGraph(AcdbGraphKeyVector *gkv, AcdbGetGraphRsp *rsp,
     {
         ACDB_DBG("Error[%d]: Detected empty usecase. "
             "No data will be returned. Skipping..", AR_EOK);
+        //The size may hold the capacity of a hinted buffer, report that
+        //nothing was filled
+        rsp->num_subgraphs = 0;
+        rsp->size = 0;
         return AR_EOK;
     }
     //GLB BUF 1 is used for the GKV search
@@ -4232,9 +4233,6 @@ int32_t AcdbCmdGetGraphAlias(AcdbGraphKeyVector* gkv, AcdbString* rsp)
         op = ACDB_OP_GET_DATA;
     }
 
-    if (gkv->num_keys > ACDB_MAX_KEY_COUNT - 1)
-        return AR_ENOMEMORY;
-
     //GLB BUF 3 is used to store the sorted GKV and the found GKV entry
     graph_kv.num_keys = gkv->num_keys;
     graph_kv.graph_key_vector = (AcdbKeyValuePair*)&glb_buf_3[0];
@@ -4321,7 +4319,7 @@ int32_t AcdbCmdGetGraphAlias(AcdbGraphKeyVector* gkv, AcdbString* rsp)
     search_info.num_search_keys = key_table_header.num_keys * 2;
     search_info.num_structure_elements =
         key_table_header.num_keys * 2 + 1;//key_ids + gkv alias Offset
-    search_info.table_entry_struct = &glb_buf_3;
+    search_info.table_entry_struct = glb_buf_3;
 
     status = AcdbTableBinarySearch(&table_info, &search_info);
     if (AR_FAILED(status))
@@ -4423,7 +4421,7 @@ int32_t BuildSpfPropertyBlob(uint32_t prop_index, size_t spf_blob_offset,
 
 		ACDB_MEM_CPY_SAFE(pOutput->spf_blob.buf + spf_blob_offset + *prop_data_offset
             + (prop_index * sizeof(errcode)), sz_sg_spf_prop_header,
-            &glb_buf_1 + *prop_data_offset, sz_sg_spf_prop_header);
+            (uint8_t*)glb_buf_1 + *prop_data_offset, sz_sg_spf_prop_header);
 
 		*prop_data_offset += sz_sg_spf_prop_header - sizeof(sz_spf_param);
 
@@ -4680,8 +4678,8 @@ int32_t BuildSubgraphDataRsp(AcdbSgIdGraphKeyVector *pInput, uint32_t sg_data_of
 	size_t sz_spf_blob = 0;
 	bool_t found = FALSE;
 
-	ACDB_CLEAR_BUFFER(glb_buf_1);
-	ACDB_CLEAR_BUFFER(glb_buf_3);
+	AcdbScratchClear(glb_buf_1);
+	AcdbScratchClear(glb_buf_3);
 
     ci_data_pool.chunk_id = ACDB_CHUNKID_DATAPOOL;
     status = ACDB_GET_CHUNK_INFO(&ci_data_pool);
@@ -4710,7 +4708,7 @@ int32_t BuildSubgraphDataRsp(AcdbSgIdGraphKeyVector *pInput, uint32_t sg_data_of
         offset = ci_data_pool.chunk_offset + sg_data_offset + (uint32_t)sz_sg_prop_data_header;
 		do
 		{
-            status = FileManReadBuffer(&glb_buf_1, sz_sg_obj_header, &offset);
+            status = FileManReadBuffer(glb_buf_1, sz_sg_obj_header, &offset);
             if (AR_FAILED(status))
             {
                 ACDB_ERR("Error[%d]: Unable to read subgraph ID from subgraph property data", status);
@@ -4741,7 +4739,7 @@ int32_t BuildSubgraphDataRsp(AcdbSgIdGraphKeyVector *pInput, uint32_t sg_data_of
 			//copy driver prop and spf prop data
 			//offset += (uint32_t)sz_sg_obj_header;
 
-			ACDB_CLEAR_BUFFER(glb_buf_1);
+			AcdbScratchClear(glb_buf_1);
 
             status = FileManReadBuffer(&sz_sg_driver_prop_data, sizeof(uint32_t), &offset);
             if (AR_FAILED(status))
@@ -4753,7 +4751,7 @@ int32_t BuildSubgraphDataRsp(AcdbSgIdGraphKeyVector *pInput, uint32_t sg_data_of
 
 			sz_all_driver_prop_data += sz_sg_driver_prop_data;
 
-            status = FileManReadBuffer(&glb_buf_1, sz_sg_driver_prop_data, &offset);
+            status = FileManReadBuffer(glb_buf_1, sz_sg_driver_prop_data, &offset);
             if (AR_FAILED(status))
             {
                 ACDB_ERR("Error[%d]: Unable to read subgraph driver properties", status);
@@ -4769,7 +4767,7 @@ int32_t BuildSubgraphDataRsp(AcdbSgIdGraphKeyVector *pInput, uint32_t sg_data_of
 				return status;
 			}
 
-			ACDB_CLEAR_BUFFER(glb_buf_1);
+			AcdbScratchClear(glb_buf_1);
 
             status = FileManReadBuffer(&sz_sg_spf_prop_data, sizeof(uint32_t), &offset);
             if (AR_FAILED(status))
@@ -4779,7 +4777,7 @@ int32_t BuildSubgraphDataRsp(AcdbSgIdGraphKeyVector *pInput, uint32_t sg_data_of
                 return status;
             }
 
-            status = FileManReadBuffer(&glb_buf_1, sz_sg_spf_prop_data, &offset);
+            status = FileManReadBuffer(glb_buf_1, sz_sg_spf_prop_data, &offset);
             if (AR_FAILED(status))
             {
                 ACDB_ERR("Error[%d]: Unable to read subgraph SPF properties", status);
@@ -5053,7 +5051,7 @@ int32_t AcdbCmdGetSubgraphConnections(AcdbSubGraphList* req, AcdbBlob* rsp)
         return status;
     }
 
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_3);
 
     ci_lut.chunk_id = ACDB_CHUNKID_SGCONNLUT;
     ci_def.chunk_id = ACDB_CHUNKID_SGCONNDEF;
@@ -5208,7 +5206,7 @@ int32_t AcdbGetSubgraphCalibration(AcdbAudioCalContextInfo *info,
             return AR_ENEEDMORE;
         }
 
-        ACDB_CLEAR_BUFFER(glb_buf_1);
+        AcdbScratchClear(glb_buf_1);
 
         iid_ref = (AcdbIidRefCount*)glb_buf_1;
     }
@@ -5425,7 +5423,8 @@ int32_t AcdbGetSubgraphCalibration(AcdbAudioCalContextInfo *info,
         src.buf = (void*)&module_header;
         tmp_blob_offset = 0;
         caldata.size = module_header.param_size;
-        status = FileManGetFilePointer2((void**)&caldata.payload, cur_dpool_offset);
+        status = FileManGetFilePointer3((void**)&caldata.payload,
+            caldata.size, cur_dpool_offset);
 
         if (is_offloaded_param)
         {
@@ -5455,8 +5454,12 @@ int32_t AcdbGetSubgraphCalibration(AcdbAudioCalContextInfo *info,
             status = AcdbWriteBuffer(rsp, blob_offset, &src);
             if (AR_FAILED(status))
             {
-                ACDB_ERR("Error[%d]: Need more memory to write module header",
-                    status);
+                //Expected when the buffer was sized from a hint
+                if (!AcdbScratchGet()->hinted_fill)
+                {
+                    ACDB_ERR("Error[%d]: Need more memory to write module header",
+                        status);
+                }
                 return status;
             }
 
@@ -5468,8 +5471,11 @@ int32_t AcdbGetSubgraphCalibration(AcdbAudioCalContextInfo *info,
 
             if (rsp->buf_size < (*blob_offset + padded_param_size))
             {
-                ACDB_ERR("Error[%d]: Need more memory to write param data",
-                    status);
+                if (!AcdbScratchGet()->hinted_fill)
+                {
+                    ACDB_ERR("Error[%d]: Need more memory to write param data",
+                        status);
+                }
                 return AR_ENEEDMORE;
             }
 
@@ -5590,7 +5596,7 @@ int32_t AcdbFindModuleCKV(AcdbCalKeyTblEntry *ckv_entry,
 
     if (module_ckv.num_keys > 0)
     {
-        status = FileManReadBuffer(&glb_buf_1,
+        status = FileManReadBuffer(glb_buf_1,
             module_ckv.num_keys * sizeof(uint32_t), &offset);
         if (AR_FAILED(status))
         {
@@ -6324,6 +6330,11 @@ int32_t AcdbCmdGetSubgraphCalDataNonPersist(AcdbSgIdCalKeyVector *req,
         status = AR_ENOTEXIST;
         ACDB_DBG("Error[%d]: No calibration found", status);
     }
+    else if (info.op == ACDB_OP_GET_DATA)
+    {
+        //Report the size of the data written, the buffer may be larger
+        rsp->buf_size = blob_offset;
+    }
 
     //Clean Up Context Info
     AcdbClearAudioCalContextInfo(&info);
@@ -7103,7 +7114,8 @@ int32_t GetVcpmParamPayload(
         tmp_dpo = offloaded_param_size_offset + 2 * sizeof(uint32_t);
 
         caldata.size = param_size;
-        status = FileManGetFilePointer2((void**)&caldata.payload, offset);
+        status = FileManGetFilePointer3((void**)&caldata.payload,
+            caldata.size, offset);
 
         status = GetOffloadedParameterData(
             &caldata, &param_size, rsp, &tmp_dpo);
@@ -7972,12 +7984,12 @@ int32_t BuildVcpmBlob(AcdbVcpmBlobInfo *vcpm_info,
         return status;
     }
 
-    ACDB_CLEAR_BUFFER(glb_buf_1);
+    AcdbScratchClear(glb_buf_1);
     vcpm_info->referenced_iid_list.count = 0;
     vcpm_info->referenced_iid_list.list = &glb_buf_1[0];
 
     /* This lists are small so glb_buff 3 split in half should be good enough */
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_3);
     vcpm_info->cal_key_id_table_offset_list.count = 0;
     vcpm_info->cal_key_id_table_offset_list.list = &glb_buf_3[0];
 
@@ -8065,7 +8077,7 @@ int32_t BuildVcpmBlob(AcdbVcpmBlobInfo *vcpm_info,
     }
 
 end:
-    ACDB_CLEAR_BUFFER(glb_buf_1);
+    AcdbScratchClear(glb_buf_1);
     AcdbListClear2(&vcpm_info->offloaded_param_info_list, AcdbFree);
 
     return status;
@@ -8633,7 +8645,7 @@ int32_t AcdbCmdGetProcSubgraphCalDataPersist(
         return status;
     }
 
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_3);
 
     (void)ar_mem_set(&info, 0, sizeof(AcdbAudioCalContextInfo));
 
@@ -8918,14 +8930,14 @@ end:
 //		found = FALSE;
 //		do
 //		{
-//			memset(&glb_buf_1, 0, sizeof(glb_buf_1));
+//			memset(glb_buf_1, 0, GLB_BUF_1_SIZE);
 //			int ret = file_seek(sgLutChkBuf + offset, AR_FSEEK_BEGIN);
 //			if (ret != 0)
 //			{
 //				ACDB_ERR("AcdbCmdGetSubgraphGlbPersistIds() failed, file seek to %d was unsuccessful", sgLutChkBuf + offset);
 //				return AR_EFAILED;
 //			}
-//			ret = file_read(&glb_buf_1, 2 * sizeof(uint32_t));
+//			ret = file_read(glb_buf_1, 2 * sizeof(uint32_t));
 //			if (ret != 0)
 //			{
 //				ACDB_ERR("AcdbCmdGetSubgraphGlbPersistIds() failed, sgID read was unsuccessful");
@@ -8939,14 +8951,14 @@ end:
 //				offset = offset + (2 * sizeof(uint32_t));
 //				for (uint32_t j = 0; j < num_cktbl_entries;j++)
 //				{
-//					memset(&glb_buf_1, 0, sizeof(glb_buf_1));
+//					memset(glb_buf_1, 0, GLB_BUF_1_SIZE);
 //					ret = file_seek(sgLutChkBuf + offset, AR_FSEEK_BEGIN);
 //					if (ret != 0)
 //					{
 //						ACDB_ERR("AcdbCmdGetSubgraphGlbPersistIds() failed, file seek to %d was unsuccessful", sgLutChkBuf + offset);
 //						return AR_EFAILED;
 //					}
-//					ret = file_read(&glb_buf_1, 2 * sizeof(uint32_t));
+//					ret = file_read(glb_buf_1, 2 * sizeof(uint32_t));
 //					if (ret != 0)
 //					{
 //						ACDB_ERR("AcdbCmdGetSubgraphGlbPersistIds() failed, calKeyTblOffset read was unsuccessful");
@@ -8967,7 +8979,7 @@ end:
 //						if (calKeyTblOffset != 0xffffffff)
 //						{
 //							uint32_t num_keys = 0;
-//							memset(&glb_buf_1, 0, sizeof(glb_buf_1));
+//							memset(glb_buf_1, 0, GLB_BUF_1_SIZE);
 //							ret = file_seek(calKeyChkBuf + calKeyTblOffset, AR_FSEEK_BEGIN);
 //							if (ret != 0)
 //							{
@@ -8990,7 +9002,7 @@ end:
 //
 //							if (num_keys > 0)
 //							{
-//								ret = file_read(&glb_buf_1, num_keys * sizeof(num_keys));
+//								ret = file_read(glb_buf_1, num_keys * sizeof(num_keys));
 //								if (ret != 0)
 //								{
 //									ACDB_ERR("AcdbCmdGetSubgraphGlbPersistIds() failed, keys read was unsuccessful");
@@ -9021,7 +9033,7 @@ end:
 //
 //						uint32_t num_entries = 0;
 //						uint32_t num_values = 0;
-//						memset(&glb_buf_2, 0, sizeof(glb_buf_2));
+//						memset(glb_buf_2, 0, GLB_BUF_2_SIZE);
 //						ret = file_seek(calLutChkBuf + calDataTblOffset, AR_FSEEK_BEGIN);
 //						if (ret != 0)
 //						{
@@ -9054,7 +9066,7 @@ end:
 //							ACDB_ERR("AcdbCmdGetSubgraphGlbPersistIds() failed, file seek to %d was unsuccessful", calLutChkBuf + calDataTblOffset + sizeof(num_entries) + sizeof(num_values));
 //							return AR_EFAILED;
 //						}
-//						ret = file_read(&glb_buf_2, num_entries * ((num_values * sizeof(uint32_t)) + (3 * sizeof(uint32_t))));
+//						ret = file_read(glb_buf_2, num_entries * ((num_values * sizeof(uint32_t)) + (3 * sizeof(uint32_t))));
 //						if (ret != 0)
 //						{
 //							ACDB_ERR("AcdbCmdGetSubgraphGlbPersistIds() failed, values read was unsuccessful");
@@ -9063,7 +9075,7 @@ end:
 //
 //						ACDB_PKT_LOG_DATA("NumEntries", &num_entries, sizeof(num_entries));
 //						ACDB_PKT_LOG_DATA("NumValues", &num_values, sizeof(num_values));
-//						ACDB_PKT_LOG_DATA("Values", &glb_buf_2, num_entries * ((num_values * sizeof(uint32_t)) + (3 * sizeof(uint32_t))));
+//						ACDB_PKT_LOG_DATA("Values", glb_buf_2, num_entries * ((num_values * sizeof(uint32_t)) + (3 * sizeof(uint32_t))));
 //
 //						uint32_t temp_offset = 0;
 //						uint32_t marked_offset = 0;
@@ -9168,21 +9180,21 @@ end:
 //							uint32_t iid_offset = 0;
 //							for (uint32_t r = 0; r < num_of_iids; r++)
 //							{
-//								memset(&glb_buf_3, 0, sizeof(glb_buf_3));
+//								memset(glb_buf_3, 0, GLB_BUF_3_SIZE);
 //								ret = file_seek(calDef2ChkBuf + calDataDefOffset, AR_FSEEK_BEGIN);
 //								if (ret != 0)
 //								{
 //									ACDB_ERR("AcdbCmdGetSubgraphGlbPersistIds() failed, file seek to %d was unsuccessful", calDef2ChkBuf + calDataDefOffset);
 //									return AR_EFAILED;
 //								}
-//								ret = file_read(&glb_buf_3, sizeof(uint32_t)); // iid value;
+//								ret = file_read(glb_buf_3, sizeof(uint32_t)); // iid value;
 //								if (ret != 0)
 //								{
 //									ACDB_ERR("AcdbCmdGetSubgraphGlbPersistIds() failed, iid value read was unsuccessful");
 //									return AR_EFAILED;
 //								}
 //
-//								ACDB_MEM_CPY(&iid_list + iid_offset, &glb_buf_3, sizeof(uint32_t));
+//								ACDB_MEM_CPY(&iid_list + iid_offset, glb_buf_3, sizeof(uint32_t));
 //								iid_offset += sizeof(uint32_t);
 //								calDataDefOffset += sizeof(uint32_t);
 //							}
@@ -9293,14 +9305,14 @@ end:
 //	pid_offset += (2 * sizeof(uint32_t));//size and num of calId's
 //	do
 //	{
-//		memset(&glb_buf_1, 0, sizeof(glb_buf_1));
+//		memset(glb_buf_1, 0, GLB_BUF_1_SIZE);
 //		int ret = file_seek(pidMapChkBuf + pid_offset, AR_FSEEK_BEGIN);
 //		if (ret != 0)
 //		{
 //			ACDB_ERR("AcdbCmdGetSubgraphGlbPersistCalData() failed, file seek to %d was unsuccessful", pidMapChkBuf + pid_offset);
 //			return AR_EFAILED;
 //		}
-//		ret = file_read(&glb_buf_1, 3 * sizeof(uint32_t));
+//		ret = file_read(glb_buf_1, 3 * sizeof(uint32_t));
 //		if (ret != 0)
 //		{
 //			ACDB_ERR("AcdbCmdGetSubgraphGlbPersistCalData() failed, calID read was unsuccessful");
@@ -9346,7 +9358,7 @@ end:
 //	ACDB_PKT_LOG_DATA("ParamSize", &param_size, sizeof(param_size));
 //	data_offset += sizeof(param_size);
 //
-//	memset(&glb_buf_1, 0, sizeof(glb_buf_1));
+//	memset(glb_buf_1, 0, GLB_BUF_1_SIZE);
 //	ret = file_seek(chkBuf + data_offset, AR_FSEEK_BEGIN);
 //	if (ret != 0)
 //	{
@@ -9387,9 +9399,9 @@ end:
 //
 //		if (param_size != 0)
 //		{
-//			if (param_size < sizeof(glb_buf_1))
+//			if (param_size < GLB_BUF_1_SIZE)
 //			{
-//				ret = file_read(&glb_buf_1, param_size);
+//				ret = file_read(glb_buf_1, param_size);
 //				if (ret != 0)
 //				{
 //					ACDB_ERR_MSG_1("Failed to read parameter payload from database.", ret);
@@ -9398,7 +9410,7 @@ end:
 //				}
 //				if (pOutput->buf_size >= (calBlobSize + param_size))
 //				{
-//				ACDB_MEM_CPY(pOutput->buf + calBlobSize, &glb_buf_1, param_size);
+//				ACDB_MEM_CPY(pOutput->buf + calBlobSize, glb_buf_1, param_size);
 //			}
 //			else
 //			{
@@ -9407,7 +9419,7 @@ end:
 //			}
 //			else
 //			{
-//				//ret = CopyFromFileToBuf(chkBuf + data_offset, (uint8_t*)(pOutput->buf) + calBlobSize, param_size, sizeof(glb_buf_1));
+//				//ret = CopyFromFileToBuf(chkBuf + data_offset, (uint8_t*)(pOutput->buf) + calBlobSize, param_size, GLB_BUF_1_SIZE);
 //				if (pOutput->buf_size >= (calBlobSize + param_size))
 //				{
 //				ret = CopyFromFileToBuf(chkBuf + data_offset, (uint8_t*)(pOutput->buf) + calBlobSize, param_size, param_size);
@@ -9495,7 +9507,7 @@ int32_t AcdbSetSubgraphCalibration(AcdbAudioCalContextInfo *info,
             return AR_ENEEDMORE;
         }
 
-        ACDB_CLEAR_BUFFER(glb_buf_1);
+        AcdbScratchClear(glb_buf_1);
 
         iid_ref = (AcdbIidRefCount*)glb_buf_1;
     }
@@ -11049,7 +11061,7 @@ int32_t BuildGetTagsFromGkvRsp(AcdbUintList* subgraph_list,
 
     op = IsNull(rsp->tag_module_list) ? ACDB_OP_GET_SIZE : ACDB_OP_GET_DATA;
 
-    tag_defofst_list.max_count = (uint32_t)(sizeof(glb_buf_1) / sizeof(uint32_t));
+    tag_defofst_list.max_count = (uint32_t)(GLB_BUF_1_SIZE / sizeof(uint32_t));
     tag_defofst_list.element_size = sizeof(AcdbTagDefOffsetPair);
     tag_defofst_list.list = (AcdbTagDefOffsetPair*)&glb_buf_1[0];
 
@@ -11072,9 +11084,9 @@ int32_t BuildGetTagsFromGkvRsp(AcdbUintList* subgraph_list,
         }
     }
 
-    ACDB_CLEAR_BUFFER(glb_buf_1);
-    ACDB_CLEAR_BUFFER(glb_buf_2);
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_1);
+    AcdbScratchClear(glb_buf_2);
+    AcdbScratchClear(glb_buf_3);
 
     if (rsp->num_tags == 0)
     {
@@ -11537,7 +11549,7 @@ int32_t GetAllAudioCKVVariations(AcdbKeyVectorLut *lookup,
         //offset += sizeof(AcdbCkvLutEntryOffsets);
     }
 
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_3);
     return status;
 }
 
@@ -11807,9 +11819,9 @@ int32_t BuildCalKeyVectorList(
     }
 
     //The KV Lookup Table uses GLB BUF 1
-    ACDB_CLEAR_BUFFER(glb_buf_1);
-    lookup.size = sizeof(glb_buf_1);
-    lookup.lookup_table = (AcdbKeyVectorLutEntry*)&glb_buf_1;
+    AcdbScratchClear(glb_buf_1);
+    lookup.size = GLB_BUF_1_SIZE;
+    lookup.lookup_table = (AcdbKeyVectorLutEntry*)glb_buf_1;
 
     data_pool_offset = ci_data_pool.chunk_offset + sg_list_offset;
     status = FileManReadBuffer(&sg_list_header,
@@ -11976,7 +11988,7 @@ int32_t TagKeyTableFindFirstOfSubgraphID(SubgraphTagLutEntry *sg_tag_entry, uint
         + sizeof(uint32_t) //Number of <SubgraphID, Tag> entries
         + search_info.entry_offset;
 
-    ACDB_CLEAR_BUFFER(glb_buf_1);
+    AcdbScratchClear(glb_buf_1);
 
     return status;
 }
@@ -12032,7 +12044,7 @@ int32_t FindTagKeyList(uint32_t tag_id, uint32_t* dpo)
     //Key Table format: [Table Size, Num Keys, KeyID+]
     *dpo = ci_data_pool.chunk_offset + tag_key_list_entry.key_list_offset
         + sizeof(uint32_t);//Skip size
-    ACDB_CLEAR_BUFFER(glb_buf_1);
+    AcdbScratchClear(glb_buf_1);
 
     return status;
 }
@@ -12199,7 +12211,7 @@ int32_t GetAllTKVVariations(SubgraphTagLutEntry *sg_tag_entry,
         *blob_offset += num_keys * sizeof(AcdbKeyValuePair);
     }
 
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_3);
     return status;
 }
 
@@ -12379,9 +12391,6 @@ int32_t GetUsecaseKeyVectorList(KeyVectorType kv_type, AcdbGraphKeyVector *gkv,
         return AR_EBADPARAM;
     }
 
-    if (gkv->num_keys > ACDB_MAX_KEY_COUNT)
-        return AR_EBADPARAM;
-
     switch (kv_type)
     {
     case CAL_KEY_VECTOR:
@@ -12741,7 +12750,7 @@ int32_t AcdbCmdGetSupportedGraphKeyVectors(AcdbUintList *key_id_list,
                 num_keys_found = 0;
 
                 //Read Graph Keys
-                status = FileManReadBuffer(&glb_buf_2, key_table_entry_size, &offset);
+                status = FileManReadBuffer(glb_buf_2, key_table_entry_size, &offset);
                 if (AR_FAILED(status))
                 {
                     ACDB_ERR("Error[%d]: Unable to read number of GKV Key ID tables.",
@@ -13111,7 +13120,7 @@ int32_t SearchSubgraphCalLut(
 
             if (num_ckv_tbl_entries == 0)
             {
-                ACDB_CLEAR_BUFFER(glb_buf_3);
+                AcdbScratchClear(glb_buf_3);
                 ACDB_ERR("Error[%d]: Subgraph(%x) does not have CKV table entries.",
                     AR_ENOTEXIST, subgraph_id);
                 return AR_ENOTEXIST;
@@ -13147,7 +13156,7 @@ int32_t SearchSubgraphCalLut(
             status, req_subgraph_id);
     }
 
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_3);
 
     return status;
 }
@@ -13203,7 +13212,7 @@ int32_t SearchSubgraphCalLut2(AcdbSgCalLutHeader *sg_lut_entry_header,
 
             if (entry_header.num_ckv_entries == 0)
             {
-                ACDB_CLEAR_BUFFER(glb_buf_3);
+                AcdbScratchClear(glb_buf_3);
                 ACDB_DBG("Warning[%d]: Subgraph(0x%x) does not"
                     " does not have CKVs",
                     AR_ENOTEXIST, entry_header.subgraph_id);
@@ -13371,8 +13380,8 @@ int32_t SearchForMatchingCalKeyVector(AcdbParameterCalData *req,
         status = AR_ENOTEXIST;
     }
 
-    ACDB_CLEAR_BUFFER(glb_buf_2);
-    ACDB_CLEAR_BUFFER(glb_buf_3);
+    AcdbScratchClear(glb_buf_2);
+    AcdbScratchClear(glb_buf_3);
     return status;
 }
 
@@ -13433,7 +13442,7 @@ int32_t BuildParameterCalDataBlob(AcdbParameterCalData *req, AcdbBlob *rsp,
     iid_pid_pair.module_iid = req->module_iid;
     iid_pid_pair.parameter_id = req->parameter_id;
 
-    if (SEARCH_ERROR == AcdbDataBinarySearch2((void*)&glb_buf_3,
+    if (SEARCH_ERROR == AcdbDataBinarySearch2((void*)glb_buf_3,
         num_iid_pid_entries * sizeof(AcdbModIIDParamIDPair),
         &iid_pid_pair, 2,
         (int32_t)(sizeof(AcdbModIIDParamIDPair) / sizeof(uint32_t)),
@@ -13553,7 +13562,7 @@ int32_t SearchForMatchingVoiceCalKeyValues(AcdbParameterCalData *req,
     if (num_keys != 0)
     {
         offset += sizeof(uint32_t);//num_entries is always 1
-        status = FileManReadBuffer(&glb_buf_1, num_keys * sizeof(uint32_t), &offset);
+        status = FileManReadBuffer(glb_buf_1, num_keys * sizeof(uint32_t), &offset);
         if (AR_FAILED(status))
         {
             ACDB_ERR("Error[%d]: Failed to Voice Key IDs.", status);
@@ -13626,7 +13635,7 @@ int32_t SearchForMatchingVoiceCalKeyIDs(AcdbParameterCalData *req,
 
     if (num_keys != 0)
     {
-        status = FileManReadBuffer(&glb_buf_1, num_keys * sizeof(uint32_t), &offset);
+        status = FileManReadBuffer(glb_buf_1, num_keys * sizeof(uint32_t), &offset);
         if (AR_FAILED(status))
         {
             ACDB_ERR("Error[%d]: Failed to Voice Key IDs.", status);
@@ -13848,7 +13857,7 @@ int32_t AcdbGetParameterCalData(AcdbParameterCalData *req, AcdbBlob* rsp)
     //Find Subgraph and Possible CKV offsets
     cal_key_entry_list = (AcdbCalKeyTblEntry*)&glb_buf_1[0];
 
-    status = SearchSubgraphCalLut(req->subgraph_id, sizeof(glb_buf_1),
+    status = SearchSubgraphCalLut(req->subgraph_id, GLB_BUF_1_SIZE,
         cal_key_entry_list, &num_entries);
     if (AR_FAILED(status))
     {
@@ -13933,7 +13942,7 @@ int32_t BuildParameterTagDataBlob(AcdbParameterTagData *req, AcdbBlob *rsp, Acdb
     iid_pid_pair.module_iid = req->module_iid;
     iid_pid_pair.parameter_id = req->parameter_id;
 
-    if (SEARCH_ERROR == AcdbDataBinarySearch2((void*)&glb_buf_3,
+    if (SEARCH_ERROR == AcdbDataBinarySearch2((void*)glb_buf_3,
         num_iid_pid_entries * sizeof(AcdbModIIDParamIDPair),
         &iid_pid_pair, 2,
         (int32_t)(sizeof(AcdbModIIDParamIDPair) / sizeof(uint32_t)),
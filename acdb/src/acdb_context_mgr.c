@@ -35,14 +35,18 @@
 typedef struct _acdb_man_context_t AcdbCtxManContext;
 struct _acdb_man_context_t
 {
-    ar_osal_mutex_t acdb_client_lock;
+    /**< Shared by read-only client commands, held exclusively by
+    commands that modify the databases */
+    ar_osal_rwlock_t acdb_client_rwlock;
     ar_osal_mutex_t ctx_man_lock;
     /**< a bit field representing the available file slots.
     0 = taken, 1 = open */
     //uint32_t active_db_slots;
-    /**< The index of the database that the filemanager is
-    currently pointing to */
+    /**< The database used by threads that have not selected one */
     acdb_context_handle_t *active_db;
+    /**< Incremented whenever databases are added or removed, invalidates
+    the database selected by each thread */
+    uint32_t database_generation;
     /**< Current Number of databases being managed */
     uint32_t database_count;
     /**< Maintains handle info about each loaded database */
@@ -62,6 +66,16 @@ struct acdb_man_subgraph_location_t
 
 static AcdbCtxManContext acdb_ctx_man_context;
 
+/**< The database selected by the calling thread and the database
+* generation it was selected in */
+static ACDB_THREAD_LOCAL acdb_context_handle_t *acdb_ctx_man_thread_db;
+static ACDB_THREAD_LOCAL uint32_t acdb_ctx_man_thread_db_generation;
+
+/**< The client lock held by the calling thread and how many nested
+* commands are holding it */
+static ACDB_THREAD_LOCAL ar_osal_rwlock_t acdb_ctx_man_thread_rwlock;
+static ACDB_THREAD_LOCAL uint32_t acdb_ctx_man_thread_lock_depth;
+
 /**< NOTE: In the case where setting the active handle for a list of subgraphs
 * results in more that one subgraph belonging to a different file:
 *
@@ -72,16 +86,24 @@ static AcdbCtxManContext acdb_ctx_man_context;
 * Private functions
 *--------------------------------------------------------------------------- */
 
+static void acdb_ctx_man_set_active_db(acdb_context_handle_t *db_ctx)
+{
+    acdb_ctx_man_thread_db = db_ctx;
+    acdb_ctx_man_thread_db_generation =
+        acdb_ctx_man_context.database_generation;
+}
+
 int32_t acdb_ctx_man_init(void)
 {
     int32_t status = AR_EOK;
 
-    if (!acdb_ctx_man_context.acdb_client_lock)
+    if (!acdb_ctx_man_context.acdb_client_rwlock)
     {
-        status = ar_osal_mutex_create(&acdb_ctx_man_context.acdb_client_lock);
+        status = ar_osal_rwlock_create(
+            &acdb_ctx_man_context.acdb_client_rwlock);
         if (AR_FAILED(status))
         {
-            ACDB_ERR("Error[%d]: failed to create acdb client mutex",
+            ACDB_ERR("Error[%d]: failed to create acdb client rwlock",
                 status);
         }
     }
@@ -133,9 +155,27 @@ int32_t acdb_ctx_man_add_database(acdb_context_handle_t *handle)
     db_ctx->delta_manager_handle = handle->delta_manager_handle;
     db_ctx->heap_handle = handle->heap_handle;
 
+    if (AR_FAILED(DataProcCreateGkvIndex(db_ctx->file_manager_handle,
+        &db_ctx->gkv_index_handle)))
+    {
+        ACDB_INFO("Warning: No graph key vector index for database %d, "
+            "graph key vectors are found by searching the file",
+            db_ctx->vm_id);
+        db_ctx->gkv_index_handle = NULL;
+    }
+
+    if (AR_FAILED(DataProcCreatePidPersistIndex(db_ctx->file_manager_handle,
+        &db_ctx->pid_persist_index_handle)))
+    {
+        ACDB_INFO("Warning: No PID persistence index for database %d, "
+            "persist maps are searched in the file", db_ctx->vm_id);
+        db_ctx->pid_persist_index_handle = NULL;
+    }
+
     //ACDB_BIT_SET(acdb_ctx_man_context.active_db_slots, index);
     acdb_ctx_man_context.database_count++;
-    if (1 == acdb_ctx_man_context.database_count)
+    acdb_ctx_man_context.database_generation++;
+    if (IsNull(acdb_ctx_man_context.active_db))
         acdb_ctx_man_context.active_db =
         acdb_ctx_man_context.database_info[index];
     ACDB_MUTEX_UNLOCK(acdb_ctx_man_context.ctx_man_lock);
@@ -169,8 +209,6 @@ int32_t acdb_ctx_man_remove_database(acdb_handle_t *handle)
         }
     }
 
-    ACDB_FREE(ctx_handle);
-
     ACDB_MUTEX_LOCK(acdb_ctx_man_context.ctx_man_lock);
 
     // ACDB_BIT_UNSET(acdb_ctx_man_context.active_db_slots, db_index);
@@ -180,8 +218,31 @@ int32_t acdb_ctx_man_remove_database(acdb_handle_t *handle)
         acdb_ctx_man_context.database_count--;
     }
 
+    acdb_ctx_man_context.database_generation++;
+    if (acdb_ctx_man_context.active_db == ctx_handle)
+    {
+        acdb_ctx_man_context.active_db = NULL;
+        for (uint32_t i = 0; i < ACDB_MAX_ACDB_FILES; i++)
+        {
+            if (!IsNull(acdb_ctx_man_context.database_info[i]) &&
+                acdb_ctx_man_context.database_info[i] != ctx_handle)
+            {
+                acdb_ctx_man_context.active_db =
+                    acdb_ctx_man_context.database_info[i];
+                break;
+            }
+        }
+    }
+
     ACDB_MUTEX_UNLOCK(acdb_ctx_man_context.ctx_man_lock);
 
+    if (!IsNull(ctx_handle))
+    {
+        DataProcFreeGkvIndex(ctx_handle->gkv_index_handle);
+        DataProcFreePidPersistIndex(ctx_handle->pid_persist_index_handle);
+    }
+    ACDB_FREE(ctx_handle);
+
     return status;
 }
 
@@ -190,6 +251,7 @@ int32_t acdb_ctx_man_reset(void)
     int32_t status = AR_EOK;
     acdb_context_handle_t *db_info = NULL;
     acdb_handle_t acdb_handle = NULL;
+    uint32_t database_generation = 0;
 
     for (uint32_t i = 0; i < acdb_ctx_man_context.database_count; i++)
     {
@@ -209,8 +271,16 @@ int32_t acdb_ctx_man_reset(void)
     }
 
     ar_osal_mutex_destroy(acdb_ctx_man_context.ctx_man_lock);
-    ar_osal_mutex_destroy(acdb_ctx_man_context.acdb_client_lock);
+    /* A thread resetting ACDB SW while holding the client lock (e.g ATS
+    * re-initializing a database) destroys it when the lock is released */
+    if (acdb_ctx_man_thread_rwlock !=
+        acdb_ctx_man_context.acdb_client_rwlock)
+        ar_osal_rwlock_destroy(acdb_ctx_man_context.acdb_client_rwlock);
+
+    /* Keep counting so databases selected before the reset stay invalid */
+    database_generation = acdb_ctx_man_context.database_generation + 1;
     ar_mem_set(&acdb_ctx_man_context, 0, sizeof(AcdbCtxManContext));
+    acdb_ctx_man_context.database_generation = database_generation;
     return status;
 }
 
@@ -291,8 +361,7 @@ int32_t acdb_ctx_man_set_context_handle(acdb_handle_t *handle)
         if (vm_id != acdb_ctx_man_context.database_info[i]->vm_id)
             continue;
 
-        acdb_ctx_man_context.active_db =
-            acdb_ctx_man_context.database_info[i];
+        acdb_ctx_man_set_active_db(acdb_ctx_man_context.database_info[i]);
         break;
     }
 
@@ -306,10 +375,10 @@ int32_t acdb_ctx_man_set_context_handle_using_index(uint32_t db_index)
     if (db_index > acdb_ctx_man_context.database_count)
         return AR_EBADPARAM;
 
-    acdb_ctx_man_context.active_db =
-        acdb_ctx_man_context.database_info[db_index];
+    acdb_ctx_man_set_active_db(
+        acdb_ctx_man_context.database_info[db_index]);
 
-    if (IsNull(acdb_ctx_man_context.active_db))
+    if (IsNull(acdb_ctx_man_thread_db))
     {
         ACDB_ERR("Error[%d]: No database context was found at "
             "index %d", db_index);
@@ -324,16 +393,35 @@ int32_t acdb_ctx_man_set_handle_using_gkv(
 {
     int32_t status = AR_ENOTEXIST;
     uint32_t gkv_lut_offset = 0;
+    uint32_t gkv_hash = 0;
+    acdb_context_handle_t *db_ctx = NULL;
 
     if (IsNull(gkv) || IsNull(graph_info))
     {
         return AR_EBADPARAM;
     }
 
+    gkv_hash = DataProcGetGkvHash(gkv);
     for (uint32_t i = 0; i < acdb_ctx_man_context.database_count; i++)
     {
-        acdb_ctx_man_context.active_db =
-            acdb_ctx_man_context.database_info[i];
+        db_ctx = acdb_ctx_man_context.database_info[i];
+
+        if (!IsNull(db_ctx->gkv_index_handle))
+        {
+            status = DataProcSearchGkvIndex(db_ctx->gkv_index_handle,
+                gkv, gkv_hash, graph_info);
+            if (AR_ENOTEXIST == status)
+                continue;
+            else if (AR_FAILED(status))
+            {
+                return status;
+            }
+
+            acdb_ctx_man_set_active_db(db_ctx);
+            return status;
+        }
+
+        acdb_ctx_man_set_active_db(db_ctx);
 
         status = DataProcSearchGkvKeyTable(gkv, &gkv_lut_offset);
         if (AR_ENOTEXIST == status)
@@ -378,8 +466,7 @@ int32_t acdb_ctx_man_set_handle_using_subgraph(
 
     if (acdb_ctx_man_context.database_count == 1)
     {
-        acdb_ctx_man_context.active_db =
-            acdb_ctx_man_context.database_info[0];
+        acdb_ctx_man_set_active_db(acdb_ctx_man_context.database_info[0]);
         return AR_EOK;
     }
 
@@ -392,8 +479,7 @@ int32_t acdb_ctx_man_set_handle_using_subgraph(
     for (uint32_t i = 0; i < acdb_ctx_man_context.database_count; i++)
     {
         num_subgraphs_found = 0;
-        acdb_ctx_man_context.active_db =
-            acdb_ctx_man_context.database_info[i];
+        acdb_ctx_man_set_active_db(acdb_ctx_man_context.database_info[i]);
 
         if (1 == subgraph_id_list->count)
         {
@@ -468,8 +554,7 @@ int32_t acdb_ctx_man_set_handle_using_driver_module(
 
     for (uint32_t i = 0; i < acdb_ctx_man_context.database_count; i++)
     {
-        acdb_ctx_man_context.active_db =
-            acdb_ctx_man_context.database_info[i];
+        acdb_ctx_man_set_active_db(acdb_ctx_man_context.database_info[i]);
 
         status = DriverDataFindFirstOfModuleID(
             cal_lut_entry, cal_lut_entry_offset);
@@ -492,12 +577,64 @@ int32_t acdb_ctx_man_set_handle_using_driver_module(
 
 acdb_context_handle_t *acdb_ctx_man_get_active_handle(void)
 {
+    if (!IsNull(acdb_ctx_man_thread_db) &&
+        acdb_ctx_man_thread_db_generation ==
+        acdb_ctx_man_context.database_generation)
+        return acdb_ctx_man_thread_db;
+
     return acdb_ctx_man_context.active_db;
 }
 
-ar_osal_mutex_t acdb_ctx_man_get_client_lock(void)
+int32_t acdb_ctx_man_client_lock(bool_t exclusive)
 {
-    return acdb_ctx_man_context.acdb_client_lock;
+    int32_t status = AR_EOK;
+    ar_osal_rwlock_t rwlock = acdb_ctx_man_context.acdb_client_rwlock;
+
+    /* Commands issued while holding the lock (e.g ATS re-initializing a
+    * database) run under the outermost lock */
+    if (acdb_ctx_man_thread_lock_depth++ > 0)
+        return AR_EOK;
+
+    acdb_ctx_man_thread_rwlock = NULL;
+    if (IsNull(rwlock))
+        return AR_EOK;
+
+    status = exclusive ?
+        ar_osal_rwlock_write_lock(rwlock) : ar_osal_rwlock_read_lock(rwlock);
+    if (AR_FAILED(status))
+    {
+        ACDB_DBG("Error[%d]: Failed to obtain client lock", status);
+        acdb_ctx_man_thread_lock_depth--;
+        return status;
+    }
+
+    acdb_ctx_man_thread_rwlock = rwlock;
+    return status;
+}
+
+int32_t acdb_ctx_man_client_unlock(void)
+{
+    int32_t status = AR_EOK;
+
+    if (0 == acdb_ctx_man_thread_lock_depth)
+        return AR_EFAILED;
+
+    if (--acdb_ctx_man_thread_lock_depth > 0 ||
+        IsNull(acdb_ctx_man_thread_rwlock))
+        return AR_EOK;
+
+    status = ar_osal_rwlock_unlock(acdb_ctx_man_thread_rwlock);
+    if (AR_FAILED(status))
+    {
+        ACDB_DBG("Error[%d]: Failed to release client lock", status);
+    }
+
+    if (acdb_ctx_man_thread_rwlock !=
+        acdb_ctx_man_context.acdb_client_rwlock)
+        ar_osal_rwlock_destroy(acdb_ctx_man_thread_rwlock);
+
+    acdb_ctx_man_thread_rwlock = NULL;
+    return status;
 }
 
 uint32_t acdb_ctx_man_get_database_count(void)
@@ -266,100 +266,254 @@ int32_t DataProcGetProcDomainForModule(AcdbSubgraphPdmMap* subgraph_proc_domain_
     return AR_ENOTEXIST;
 }
 
-int32_t IsPidGlobalyPersistent(uint32_t pid)
+/**< Smallest number of entries in a PID persistence index, must be a
+* power of 2 */
+#define ACDB_PID_PERSIST_INDEX_MIN_ENTRIES 64
+
+#define ACDB_PID_PERSIST_INDEX_SLOT(index, pid) \
+    ((uint32_t)((pid) * 0x9E3779B1u) >> (index)->shift)
+
+/**< The PID is in the PID Persist Map */
+#define ACDB_PID_PERSIST_FLAG_PERSISTENT 0x1
+/**< The PID is in the Global PID Persist Map */
+#define ACDB_PID_PERSIST_FLAG_GLOBAL 0x2
+
+typedef struct acdb_pid_persist_index_entry_t
 {
-	//Acdb File Manager will handle selecting the correct ACDB file to read from
-	//ar_fhandle fhandle = NULL;
+    uint32_t pid;
+    /**< ACDB_PID_PERSIST_FLAG_*, 0 for an empty entry */
+    uint32_t flags;
+}acdb_pid_persist_index_entry_t;
+
+/**< Open addressing table of the PIDs in the PID Persist Map and the
+* Global PID Persist Map of a database */
+typedef struct acdb_pid_persist_index_t
+{
+    /**< Number of entries - 1, the number of entries is a power of 2 */
+    uint32_t mask;
+    /**< 32 - log2(number of entries), used by ACDB_PID_PERSIST_INDEX_SLOT */
+    uint32_t shift;
+    /**< Returned by IsPidPersistent for PIDs not in the index */
+    int32_t persist_miss_status;
+    /**< Returned by IsPidGlobalyPersistent for PIDs not in the index */
+    int32_t global_miss_status;
+    /**< The entries, allocated with the index */
+    acdb_pid_persist_index_entry_t *entries;
+}acdb_pid_persist_index_t;
 
-	uint32_t status = AR_EOK;
-	uint32_t offset = 0;
-	uint32_t cal_id_count = 0;
-	uint32_t search_index = 0;
-	uint32_t *glb_persist_pid_map = NULL;
-	ChunkInfo ci = { 0 };
-	//Header: <Cal ID, PID, Cal Data offset in datapool>
-	size_t sz_cal_id_obj_header = 3 * sizeof(uint32_t);
+/**
+* \brief
+*       Gets a pointer to a PID map chunk made of a uint32_t count followed
+*       by count entries of entry_words words each
+*
+* \return 0 on success, AR_ENOTEXIST if the map is empty and non-zero
+*       on failure
+*/
+static int32_t DataProcGetPidMap(acdb_file_man_handle_t fm_handle,
+    uint32_t chunk_id, uint32_t entry_words,
+    uint32_t *count, uint32_t **map)
+{
+    int32_t status = AR_EOK;
+    uint32_t chunk_offset = 0;
+    uint32_t chunk_size = 0;
 
-	CalibrationIdMap cal_id_obj;
+    *count = 0;
+    status = acdb_get_db_chunk(fm_handle, chunk_id,
+        &chunk_offset, &chunk_size);
+    if (AR_FAILED(status))
+        return status;
 
-	cal_id_obj.cal_id = 0;
-	cal_id_obj.param_id = pid;
-	cal_id_obj.cal_data_offset = 0;
+    status = acdb_fm_read_db_mem(fm_handle,
+        count, sizeof(uint32_t), &chunk_offset);
+    if (AR_FAILED(status))
+        return status;
 
-	//ACDB_CLEAR_BUFFER(glb_buf_1);
+    if (*count == 0)
+        return AR_ENOTEXIST;
 
-    ci.chunk_id = ACDB_CHUNKID_GLB_PID_PERSIST_MAP;
-	status = ACDB_GET_CHUNK_INFO(&ci);
-	if (AR_EOK != status) return status;
+    if (chunk_size < sizeof(uint32_t) || *count >
+        (chunk_size - sizeof(uint32_t)) / (entry_words * sizeof(uint32_t)))
+    {
+        *count = 0;
+        return AR_EFAILED;
+    }
 
-    offset = ci.chunk_offset;
-    status = FileManReadBuffer(&cal_id_count, sizeof(uint32_t), &offset);
-	if (AR_EOK != status) return status;
+    return acdb_fm_get_db_mem_ptr(fm_handle, (void**)map,
+        *count * entry_words * sizeof(uint32_t), &chunk_offset);
+}
+
+static void DataProcAddPidPersistFlag(acdb_pid_persist_index_t *index,
+    uint32_t pid, uint32_t flag)
+{
+    uint32_t slot = ACDB_PID_PERSIST_INDEX_SLOT(index, pid);
+
+    while (index->entries[slot].flags != 0 &&
+        index->entries[slot].pid != pid)
+        slot = (slot + 1) & index->mask;
 
-    if (cal_id_count == 0)
+    index->entries[slot].pid = pid;
+    index->entries[slot].flags |= flag;
+}
+
+int32_t DataProcCreatePidPersistIndex(acdb_file_man_handle_t fm_handle,
+    acdb_pid_persist_index_handle_t *index)
+{
+    int32_t persist_status = AR_EOK;
+    int32_t global_status = AR_EOK;
+    uint32_t num_pids = 0;
+    uint32_t num_cal_ids = 0;
+    uint32_t num_entries = ACDB_PID_PERSIST_INDEX_MIN_ENTRIES;
+    uint32_t shift = 32;
+    uint32_t *persist_pid_map = NULL;
+    CalibrationIdMap *glb_persist_pid_map = NULL;
+    acdb_pid_persist_index_t *new_index = NULL;
+
+    if (IsNull(fm_handle) || IsNull(index))
     {
-        ACDB_ERR("Cannot determine global persistence of Parameter(%x). "
-            "The number of Calibration Identifiers is zero.", pid);
-        return AR_ENOTEXIST;
+        ACDB_ERR("Error[%d]: One or more input parameter(s) are null.",
+            AR_EBADPARAM);
+        return AR_EBADPARAM;
     }
 
-    glb_persist_pid_map = ACDB_MALLOC(uint32_t, 3 * cal_id_count);
+    persist_status = DataProcGetPidMap(fm_handle, ACDB_CHUNKID_PIDPERSIST,
+        1, &num_pids, &persist_pid_map);
+    if (AR_FAILED(persist_status))
+        num_pids = 0;
+
+    //Entries are <Cal ID, PID, Cal Data offset in datapool>
+    global_status = DataProcGetPidMap(fm_handle,
+        ACDB_CHUNKID_GLB_PID_PERSIST_MAP,
+        sizeof(CalibrationIdMap) / sizeof(uint32_t),
+        &num_cal_ids, (uint32_t**)&glb_persist_pid_map);
+    if (AR_FAILED(global_status))
+        num_cal_ids = 0;
+
+    /* At most half full so probe sequences stay short */
+    while (num_entries < 2 * (num_pids + num_cal_ids))
+        num_entries <<= 1;
+    for (uint32_t n = num_entries; n > 1; n >>= 1)
+        shift--;
+
+    new_index = (acdb_pid_persist_index_t*)ACDB_MALLOC(uint8_t,
+        sizeof(acdb_pid_persist_index_t)
+        + num_entries * sizeof(acdb_pid_persist_index_entry_t));
+    if (IsNull(new_index))
+        return AR_ENOMEMORY;
 
-    status = FileManReadBuffer(glb_persist_pid_map, cal_id_count * sz_cal_id_obj_header, &offset);
-    if (AR_EOK != status) goto end;
+    new_index->mask = num_entries - 1;
+    new_index->shift = shift;
+    new_index->persist_miss_status =
+        AR_FAILED(persist_status) ? persist_status : AR_ENOTEXIST;
+    new_index->global_miss_status =
+        AR_FAILED(global_status) ? global_status : AR_ENOTEXIST;
+    new_index->entries = (acdb_pid_persist_index_entry_t*)(new_index + 1);
+    ar_mem_set(new_index->entries, 0,
+        num_entries * sizeof(acdb_pid_persist_index_entry_t));
 
-	if (AR_EOK != AcdbDataBinarySearch2(
-		glb_persist_pid_map/*glb_buf_1*/, cal_id_count * sz_cal_id_obj_header,
-		&cal_id_obj, 1, sizeof(CalibrationIdMap)/sizeof(uint32_t),
-		&search_index))
-	{
-		status =  AR_ENOTEXIST;
-	}
+    for (uint32_t i = 0; i < num_pids; i++)
+    {
+        DataProcAddPidPersistFlag(new_index, persist_pid_map[i],
+            ACDB_PID_PERSIST_FLAG_PERSISTENT);
+    }
 
-end:
+    for (uint32_t i = 0; i < num_cal_ids; i++)
+    {
+        DataProcAddPidPersistFlag(new_index,
+            glb_persist_pid_map[i].param_id, ACDB_PID_PERSIST_FLAG_GLOBAL);
+    }
 
-	ACDB_FREE(glb_persist_pid_map);
+    *index = new_index;
+    return AR_EOK;
+}
 
-	return status;
+void DataProcFreePidPersistIndex(acdb_pid_persist_index_handle_t index)
+{
+    if (!IsNull(index))
+        ACDB_FREE(index);
 }
 
-int32_t IsPidPersistent(uint32_t pid)
+/**
+* \brief
+*       Checks whether a PID is in the PID Persist Map (flag
+*       ACDB_PID_PERSIST_FLAG_PERSISTENT) or the Global PID Persist Map
+*       (flag ACDB_PID_PERSIST_FLAG_GLOBAL) of the active database
+*
+* \return 0 if the PID is in the map, AR_ENOTEXIST if it is not and
+*       non-zero if the map cannot be read
+*/
+static int32_t DataProcSearchPidPersistMap(uint32_t pid, uint32_t flag)
 {
-	int32_t status = AR_EOK;
-	uint32_t num_pids = 0;
-	uint32_t offset = 0;
-	uint32_t search_index = 0;
-	uint32_t *persist_pid_map = NULL;
-	ChunkInfo ci = { 0 };
+    int32_t status = AR_EOK;
+    uint32_t slot = 0;
+    uint32_t count = 0;
+    uint32_t *map = NULL;
+    acdb_context_handle_t *ctx_handle = NULL;
+    acdb_pid_persist_index_t *index = NULL;
 
-    ci.chunk_id = ACDB_CHUNKID_PIDPERSIST;
-    status = ACDB_GET_CHUNK_INFO(&ci);
-	if (AR_EOK != status) return status;
+    ctx_handle = acdb_ctx_man_get_active_handle();
+    if (IsNull(ctx_handle))
+        return AR_EHANDLE;
 
-    offset = ci.chunk_offset;
-    status = FileManGetFilePointer1(
-        (void**)&persist_pid_map, sizeof(uint32_t), &offset);
-    if (AR_EOK != status) return status;
+    index = (acdb_pid_persist_index_t*)ctx_handle->pid_persist_index_handle;
+    if (!IsNull(index))
+    {
+        slot = ACDB_PID_PERSIST_INDEX_SLOT(index, pid);
+        while (index->entries[slot].flags != 0)
+        {
+            if (index->entries[slot].pid == pid)
+            {
+                if (index->entries[slot].flags & flag)
+                    return AR_EOK;
+                break;
+            }
+            slot = (slot + 1) & index->mask;
+        }
 
-    num_pids = *persist_pid_map;
-    if (num_pids == 0)
+        return ACDB_PID_PERSIST_FLAG_GLOBAL == flag ?
+            index->global_miss_status : index->persist_miss_status;
+    }
+
+    /* No index for this database, search the map in the file */
+    if (ACDB_PID_PERSIST_FLAG_GLOBAL == flag)
     {
+        status = DataProcGetPidMap(ctx_handle->file_manager_handle,
+            ACDB_CHUNKID_GLB_PID_PERSIST_MAP,
+            sizeof(CalibrationIdMap) / sizeof(uint32_t), &count, &map);
+        if (AR_FAILED(status))
+            return status;
+
+        //The map is sorted by Cal ID, so the PID column is scanned
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (((CalibrationIdMap*)map)[i].param_id == pid)
+                return AR_EOK;
+        }
+
         return AR_ENOTEXIST;
     }
 
-    status = FileManGetFilePointer1(
-        (void**)&persist_pid_map, num_pids * sizeof(uint32_t), &offset);
-    if (AR_EOK != status) return status;
+    status = DataProcGetPidMap(ctx_handle->file_manager_handle,
+        ACDB_CHUNKID_PIDPERSIST, 1, &count, &map);
+    if (AR_FAILED(status))
+        return status;
 
-	if (AR_EOK != AcdbDataBinarySearch2(
-		persist_pid_map, num_pids * sizeof(uint32_t),
-		&pid, 1, 1,
-		&search_index))
-	{
-		status =  AR_ENOTEXIST;
-	}
+    if (AR_EOK != AcdbDataBinarySearch2(
+        map, count * sizeof(uint32_t), &pid, 1, 1, &slot))
+    {
+        return AR_ENOTEXIST;
+    }
 
-	return status;
+    return AR_EOK;
+}
+
+int32_t IsPidGlobalyPersistent(uint32_t pid)
+{
+    return DataProcSearchPidPersistMap(pid, ACDB_PID_PERSIST_FLAG_GLOBAL);
+}
+
+int32_t IsPidPersistent(uint32_t pid)
+{
+    return DataProcSearchPidPersistMap(pid, ACDB_PID_PERSIST_FLAG_PERSISTENT);
 }
 
 int32_t DataProcGetPersistenceType(uint32_t pid, AcdbDataPersistanceType *persistence_type)
@@ -2323,7 +2477,7 @@ int32_t DataProcSearchGkvKeyTable(
             search_info.num_search_keys = key_table_header.num_keys;
             search_info.num_structure_elements =
                 key_table_header.num_keys + 1;//key_ids + GKVLUT Offset
-            search_info.table_entry_struct = &glb_buf_2;
+            search_info.table_entry_struct = glb_buf_2;
 
             status = AcdbTableBinarySearch(&table_info, &search_info);
 
@@ -2430,7 +2584,7 @@ int32_t DataProcSearchGkvLut(AcdbGraphKeyVector* gkv,
         search_info.num_search_keys = key_table_header.num_keys;
         search_info.num_structure_elements =
             key_table_header.num_keys + 2;//Values + List Offset + Data Offset
-        search_info.table_entry_struct = &glb_buf_2;
+        search_info.table_entry_struct = glb_buf_2;
 
         status = AcdbTableBinarySearch(&table_info, &search_info);
         if (AR_FAILED(status))
@@ -2447,6 +2601,355 @@ int32_t DataProcSearchGkvLut(AcdbGraphKeyVector* gkv,
     return status;
 }
 
+/**< Smallest number of entries in a GKV index, must be a power of 2 */
+#define ACDB_GKV_INDEX_MIN_ENTRIES 64
+
+/**< Largest number of graphs in a GKV index, keeps the entry count and
+* the index size from overflowing */
+#define ACDB_GKV_INDEX_MAX_GRAPHS 0x08000000
+
+#define ACDB_GKV_INDEX_SLOT(index, hash) \
+    ((uint32_t)((hash) * 0x9E3779B1u) >> (index)->shift)
+
+typedef struct acdb_gkv_index_entry_t
+{
+    /**< Hash of the graph key vector, see DataProcGetGkvHash */
+    uint32_t hash;
+    /**< Number of keys in the graph key vector */
+    uint32_t num_keys;
+    /**< File offset of the key IDs in the GKV Key Table,
+    0 for an empty entry */
+    uint32_t key_offset;
+    /**< File offset of the values in the GKV Lookup Table. The values are
+    followed by the subgraph list and subgraph property data offsets */
+    uint32_t value_offset;
+}acdb_gkv_index_entry_t;
+
+/**< Open addressing table of the graph key vectors in a database. Only
+* the file offsets of a graph key vector are kept, its keys and values are
+* compared in the file when the hash matches */
+typedef struct acdb_gkv_index_t
+{
+    /**< The database the offsets refer to */
+    acdb_file_man_handle_t fm_handle;
+    /**< Number of entries - 1, the number of entries is a power of 2 */
+    uint32_t mask;
+    /**< 32 - log2(number of entries), used by ACDB_GKV_INDEX_SLOT */
+    uint32_t shift;
+    /**< The entries, allocated with the index */
+    acdb_gkv_index_entry_t *entries;
+}acdb_gkv_index_t;
+
+static uint32_t DataProcMixGkvHash(uint32_t hash, uint32_t word)
+{
+    hash = (hash ^ word) * 0x9E3779B1u;
+    return hash ^ (hash >> 15);
+}
+
+/**
+* \brief
+*       Reads the header of a GKV Key Table or GKV Lookup Table and gets a
+*       pointer to its rows. The rows must end before chunk_end
+*
+* \param[in] fm_handle: The database to read from
+* \param[in] chunk_end: File offset of the end of the chunk holding the table
+* \param[in] row_extra_words: Words in each row after the keys or values
+* \param[in/out] offset: File offset of the table header, moved past the table
+* \param[out] header: The table header
+* \param[out] rows: The rows of the table
+* \param[out] rows_offset: File offset of the rows
+*
+* \return 0 on success, and non-zero on failure
+*/
+static int32_t DataProcGetGkvTableRows(acdb_file_man_handle_t fm_handle,
+    uint32_t chunk_end, uint32_t row_extra_words, uint32_t *offset,
+    KeyTableHeader *header, uint32_t **rows, uint32_t *rows_offset)
+{
+    int32_t status = AR_EOK;
+    uint32_t row_words = 0;
+    uint32_t words_left = 0;
+
+    if (*offset > chunk_end ||
+        chunk_end - *offset < sizeof(KeyTableHeader))
+        return AR_EFAILED;
+
+    status = acdb_fm_read_db_mem(fm_handle,
+        header, sizeof(KeyTableHeader), offset);
+    if (AR_FAILED(status))
+        return status;
+
+    words_left = (chunk_end - *offset) / sizeof(uint32_t);
+    if (header->num_keys > words_left)
+        return AR_EFAILED;
+
+    row_words = header->num_keys + row_extra_words;
+    if (header->num_entries > words_left / row_words)
+        return AR_EFAILED;
+
+    *rows_offset = *offset;
+    if (0 == header->num_entries)
+    {
+        *rows = NULL;
+        return AR_EOK;
+    }
+
+    return acdb_fm_get_db_mem_ptr(fm_handle, (void**)rows,
+        header->num_entries * row_words * sizeof(uint32_t), offset);
+}
+
+int32_t DataProcCreateGkvIndex(acdb_file_man_handle_t fm_handle,
+    acdb_gkv_index_handle_t *index)
+{
+    int32_t status = AR_EOK;
+    uint32_t key_chunk_offset = 0;
+    uint32_t key_chunk_size = 0;
+    uint32_t lut_chunk_offset = 0;
+    uint32_t lut_chunk_size = 0;
+    uint32_t offset = 0;
+    uint32_t lut_offset = 0;
+    uint32_t key_rows_offset = 0;
+    uint32_t value_rows_offset = 0;
+    uint32_t num_key_tables = 0;
+    uint32_t num_graphs = 0;
+    uint32_t num_entries = ACDB_GKV_INDEX_MIN_ENTRIES;
+    uint32_t shift = 32;
+    uint32_t hash = 0;
+    uint32_t slot = 0;
+    uint32_t *key_rows = NULL;
+    uint32_t *key_row = NULL;
+    uint32_t *value_rows = NULL;
+    uint32_t *value_row = NULL;
+    KeyTableHeader key_table_header = { 0 };
+    KeyTableHeader lut_header = { 0 };
+    acdb_gkv_index_t *new_index = NULL;
+    acdb_gkv_index_entry_t *entry = NULL;
+
+    if (IsNull(fm_handle) || IsNull(index))
+    {
+        ACDB_ERR("Error[%d]: One or more input parameter(s) are null.",
+            AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
+
+    /* A database without graphs gets an empty index */
+    status = acdb_get_db_chunk(fm_handle, ACDB_CHUNKID_GKVKEYTBL,
+        &key_chunk_offset, &key_chunk_size);
+    if (AR_ENOTEXIST == status)
+        key_chunk_size = 0;
+    else if (AR_FAILED(status))
+        return status;
+
+    if (key_chunk_size != 0)
+    {
+        status = acdb_get_db_chunk(fm_handle, ACDB_CHUNKID_GKVLUTTBL,
+            &lut_chunk_offset, &lut_chunk_size);
+        if (AR_FAILED(status))
+            return status;
+
+        offset = key_chunk_offset;
+        status = acdb_fm_read_db_mem(fm_handle,
+            &num_key_tables, sizeof(uint32_t), &offset);
+        if (AR_FAILED(status))
+            return status;
+    }
+
+    /* The first pass counts the graphs so the index is allocated once,
+     * the second pass fills it */
+    for (uint32_t pass = 0; pass < 2; pass++)
+    {
+        offset = key_chunk_offset + sizeof(uint32_t);
+        for (uint32_t i = 0; i < num_key_tables; i++)
+        {
+            //Key IDs + GKVLUT Offset
+            status = DataProcGetGkvTableRows(fm_handle,
+                key_chunk_offset + key_chunk_size, 1, &offset,
+                &key_table_header, &key_rows, &key_rows_offset);
+            if (AR_FAILED(status))
+                goto end;
+
+            for (uint32_t j = 0; j < key_table_header.num_entries; j++)
+            {
+                key_row = key_rows + j * (key_table_header.num_keys + 1);
+                lut_offset = key_row[key_table_header.num_keys];
+                if (lut_offset >= lut_chunk_size)
+                {
+                    status = AR_EFAILED;
+                    goto end;
+                }
+
+                //Values + SG List Offset + SG Data Offset
+                lut_offset += lut_chunk_offset;
+                status = DataProcGetGkvTableRows(fm_handle,
+                    lut_chunk_offset + lut_chunk_size, 2, &lut_offset,
+                    &lut_header, &value_rows, &value_rows_offset);
+                if (AR_FAILED(status))
+                    goto end;
+
+                /* Never matched by DataProcSearchGkvLut either */
+                if (lut_header.num_keys != key_table_header.num_keys)
+                    continue;
+
+                if (0 == pass)
+                {
+                    if (lut_header.num_entries >
+                        ACDB_GKV_INDEX_MAX_GRAPHS - num_graphs)
+                    {
+                        status = AR_EFAILED;
+                        goto end;
+                    }
+
+                    num_graphs += lut_header.num_entries;
+                    continue;
+                }
+
+                for (uint32_t k = 0; k < lut_header.num_entries; k++)
+                {
+                    value_row = value_rows + k * (lut_header.num_keys + 2);
+
+                    hash = DataProcMixGkvHash(0, lut_header.num_keys);
+                    for (uint32_t n = 0; n < lut_header.num_keys; n++)
+                    {
+                        hash = DataProcMixGkvHash(hash, key_row[n]);
+                        hash = DataProcMixGkvHash(hash, value_row[n]);
+                    }
+
+                    /* A duplicate graph key vector lands after the first
+                     * one on the same probe sequence, so the first wins
+                     * like it does when searching the file */
+                    slot = ACDB_GKV_INDEX_SLOT(new_index, hash);
+                    entry = &new_index->entries[slot];
+                    while (entry->key_offset != 0)
+                    {
+                        slot = (slot + 1) & new_index->mask;
+                        entry = &new_index->entries[slot];
+                    }
+
+                    entry->hash = hash;
+                    entry->num_keys = lut_header.num_keys;
+                    entry->key_offset = key_rows_offset
+                        + j * (key_table_header.num_keys + 1)
+                        * (uint32_t)sizeof(uint32_t);
+                    entry->value_offset = value_rows_offset
+                        + k * (lut_header.num_keys + 2)
+                        * (uint32_t)sizeof(uint32_t);
+                }
+            }
+        }
+
+        if (0 != pass)
+            break;
+
+        /* At most half full so probe sequences stay short */
+        while (num_entries < 2 * num_graphs)
+            num_entries <<= 1;
+        for (uint32_t n = num_entries; n > 1; n >>= 1)
+            shift--;
+
+        new_index = (acdb_gkv_index_t*)ACDB_MALLOC(uint8_t,
+            sizeof(acdb_gkv_index_t)
+            + num_entries * sizeof(acdb_gkv_index_entry_t));
+        if (IsNull(new_index))
+            return AR_ENOMEMORY;
+
+        new_index->fm_handle = fm_handle;
+        new_index->mask = num_entries - 1;
+        new_index->shift = shift;
+        new_index->entries = (acdb_gkv_index_entry_t*)(new_index + 1);
+        ar_mem_set(new_index->entries, 0,
+            num_entries * sizeof(acdb_gkv_index_entry_t));
+    }
+
+    *index = new_index;
+    return AR_EOK;
+
+end:
+    ACDB_ERR("Error[%d]: The graph key vector tables are malformed.",
+        status);
+    if (!IsNull(new_index))
+        ACDB_FREE(new_index);
+    return status;
+}
+
+uint32_t DataProcGetGkvHash(AcdbGraphKeyVector* gkv)
+{
+    uint32_t hash = 0;
+
+    if (IsNull(gkv))
+        return 0;
+
+    hash = DataProcMixGkvHash(0, gkv->num_keys);
+    for (uint32_t i = 0; i < gkv->num_keys; i++)
+    {
+        hash = DataProcMixGkvHash(hash, gkv->graph_key_vector[i].key);
+        hash = DataProcMixGkvHash(hash, gkv->graph_key_vector[i].value);
+    }
+
+    return hash;
+}
+
+int32_t DataProcSearchGkvIndex(acdb_gkv_index_handle_t index,
+    AcdbGraphKeyVector* gkv, uint32_t gkv_hash,
+    acdb_graph_info_t *graph_info)
+{
+    int32_t status = AR_EOK;
+    uint32_t slot = 0;
+    uint32_t i = 0;
+    uint32_t *keys = NULL;
+    uint32_t *values = NULL;
+    acdb_gkv_index_t *gkv_index = (acdb_gkv_index_t*)index;
+    acdb_gkv_index_entry_t *entry = NULL;
+
+    if (IsNull(gkv_index) || IsNull(gkv) || IsNull(graph_info) ||
+        (gkv->num_keys != 0 && IsNull(gkv->graph_key_vector)))
+    {
+        ACDB_ERR("Error[%d]: One or more input parameter(s) are null.",
+            AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
+
+    slot = ACDB_GKV_INDEX_SLOT(gkv_index, gkv_hash);
+    for (entry = &gkv_index->entries[slot]; entry->key_offset != 0;
+        entry = &gkv_index->entries[slot])
+    {
+        slot = (slot + 1) & gkv_index->mask;
+
+        if (entry->hash != gkv_hash || entry->num_keys != gkv->num_keys)
+            continue;
+
+        status = acdb_fm_get_db_mem_ptr_2(gkv_index->fm_handle,
+            (void**)&keys, entry->key_offset);
+        if (AR_FAILED(status))
+            return status;
+
+        status = acdb_fm_get_db_mem_ptr_2(gkv_index->fm_handle,
+            (void**)&values, entry->value_offset);
+        if (AR_FAILED(status))
+            return status;
+
+        for (i = 0; i < gkv->num_keys; i++)
+        {
+            if (keys[i] != gkv->graph_key_vector[i].key ||
+                values[i] != gkv->graph_key_vector[i].value)
+                break;
+        }
+
+        if (i != gkv->num_keys)
+            continue;
+
+        graph_info->sg_list_offset = values[gkv->num_keys];
+        graph_info->sg_prop_data_offset = values[gkv->num_keys + 1];
+        return AR_EOK;
+    }
+
+    return AR_ENOTEXIST;
+}
+
+void DataProcFreeGkvIndex(acdb_gkv_index_handle_t index)
+{
+    if (!IsNull(index))
+        ACDB_FREE(index);
+}
+
 /**
 * \brief
 *       Search for the first occurance of a <Module ID, Key Table Offset,
@@ -2512,7 +3015,7 @@ int32_t DriverDataFindFirstOfModuleID(
         + sizeof(uint32_t) //Number of <Module, key table, value table> entries
         + search_info.entry_offset;
 
-    ACDB_CLEAR_BUFFER(glb_buf_1);
+    AcdbScratchClear(glb_buf_1);
 
     return status;
 }
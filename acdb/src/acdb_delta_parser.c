@@ -366,10 +366,11 @@ int32_t acdb_delta_parser_read_map(
 		return status;
 	}
 
-	if (kv_pair_count > ACDB_MAX_KEY_COUNT)
+	if (bytes_read > file_size || kv_pair_count >
+		(file_size - bytes_read) / sizeof(AcdbKeyValuePair))
 	{
-		ACDB_ERR("Error[%d]: The key vector length %d is larger than "
-			"the max %d", kv_pair_count, ACDB_MAX_KEY_COUNT);
+		ACDB_ERR("Error[%d]: The key vector length %d runs past the "
+			"end of the delta file", AR_EBADPARAM, kv_pair_count);
 		return AR_EBADPARAM;
 	}
 
@@ -378,7 +379,13 @@ int32_t acdb_delta_parser_read_map(
     if (kv_pair_count > 0)
     {
         key_vector->graph_key_vector = ACDB_MALLOC(
-			AcdbKeyValuePair, kv_pair_count * sizeof(AcdbKeyValuePair));
+			AcdbKeyValuePair, kv_pair_count);
+        if (IsNull(key_vector->graph_key_vector))
+        {
+            ACDB_ERR("Error[%d]: Unable to allocate memory for a key "
+                "vector of %d keys", AR_ENOMEMORY, kv_pair_count);
+            return AR_ENOMEMORY;
+        }
 
         status = file_seek_read(fhandle, key_vector->graph_key_vector,
 			kv_pair_count * sizeof(AcdbKeyValuePair), &bytes_read);
@@ -27,6 +27,10 @@
 #include "ar_osal_file_io.h"
 #include "acdb_common.h"
 #include "acdb_data_proc.h"
+#ifdef ACDB_LOAD_FILE_LAZY
+#include "ar_osal_atomic.h"
+#include "ar_osal_mutex.h"
+#endif
 
 /* ---------------------------------------------------------------------------
 * Preprocessor Definitions and Constants
@@ -69,6 +73,29 @@
 #define ACDB_FM_WS_INFO_AT_INDEX(index) acdb_file_man_context \
 .workspace_info[index]
 
+#ifdef ACDB_LOAD_FILE_LAZY
+/**< Kilobytes of data chunks each database keeps resident, the least
+recently used windows are released past it */
+#ifndef ACDB_LAZY_RESIDENT_KB
+#define ACDB_LAZY_RESIDENT_KB 4096
+#endif
+
+/**< Kilobytes per window of a data chunk. Residency is counted and released
+per window so a data chunk larger than the budget is only partly resident */
+#ifndef ACDB_LAZY_WINDOW_KB
+#define ACDB_LAZY_WINDOW_KB 64
+#endif
+
+#define ACDB_LAZY_WINDOW_SIZE (ACDB_LAZY_WINDOW_KB * 1024)
+
+/**< Records an access to size bytes at a database offset for the resident
+budget */
+#define ACDB_FM_LAZY_TOUCH(db, offset, size) \
+AcdbFileManTouchLazyChunk(db, offset, size)
+#else
+#define ACDB_FM_LAZY_TOUCH(db, offset, size)
+#endif
+
 /* ---------------------------------------------------------------------------
 * Type Declarations
 *--------------------------------------------------------------------------- */
@@ -107,6 +134,57 @@ struct _acdb_file_man_workspace_info_t {
     acdb_path_256_t workspace_file;
 };
 
+#ifdef ACDB_LOAD_FILE_LAZY
+/**< A window of ACDB_LAZY_WINDOW_SIZE bytes of a data chunk, the last
+window of a chunk may be shorter */
+typedef struct acdb_lazy_window_t
+{
+    /**< Offset of the window from the start of the file */
+    uint32_t offset;
+    /**< The size of the window in bytes */
+    uint32_t size;
+    /**< The access count of the chunk map at the last access */
+    volatile uint32_t last_access;
+    /**< TRUE while the window counts against the resident budget */
+    volatile uint32_t resident;
+}acdb_lazy_window_t;
+
+typedef struct acdb_lazy_chunk_t
+{
+    /**< Offset of the chunk data from the start of the file */
+    uint32_t offset;
+    /**< The size of the chunk in bytes */
+    uint32_t size;
+    /**< Index of the first window of the chunk in the map */
+    uint32_t first_window;
+}acdb_lazy_chunk_t;
+
+/**< The data chunks of a mapped database sorted by offset */
+typedef struct acdb_lazy_chunk_map_t
+{
+    /**< Serializes releasing windows */
+    ar_osal_mutex_t evict_lock;
+    /**< Incremented on every access to a data chunk */
+    volatile uint32_t access_count;
+    /**< Number of resident windows */
+    volatile uint32_t resident_windows;
+    /**< Number of resident windows past which windows are released */
+    uint32_t budget;
+    /**< Offset of the first chunk */
+    uint32_t start;
+    /**< Offset of the end of the last chunk */
+    uint32_t end;
+    /**< Number of chunks */
+    uint32_t count;
+    /**< The chunks, allocated with the map */
+    acdb_lazy_chunk_t *chunks;
+    /**< Number of windows of all chunks */
+    uint32_t window_count;
+    /**< The windows of all chunks in chunk order, allocated with the map */
+    acdb_lazy_window_t *windows;
+}acdb_lazy_chunk_map_t;
+#endif
+
 typedef struct _acdb_file_man_database_info_t AcdbFileManDatabaseInfo;
 struct _acdb_file_man_database_info_t {
     /**< The virtual machine id used by the database */
@@ -121,6 +199,14 @@ struct _acdb_file_man_database_info_t {
     uint32_t database_cache_size;
     /**< A pointer to the database file cached in memory */
     void* database_cache;
+    /**< Chunk ID to offset index of database_cache, NULL if it could not
+    be built in which case chunks are found by walking the file */
+    acdb_chunk_index_t* chunk_index;
+#ifdef ACDB_LOAD_FILE_LAZY
+    /**< The chunks paged in on first access, NULL if the database is
+    not mapped in which case it is fully resident */
+    acdb_lazy_chunk_map_t* lazy_chunks;
+#endif
     /**< The path to the database file */
     acdb_path_256_t database_file;
     /**< The path where the database files reside */
@@ -216,6 +302,291 @@ int32_t AcdbFileManValidateImExShSubgraphs(
 * Function Declarations and Definitions
 *--------------------------------------------------------------------------- */
 
+#ifdef ACDB_LOAD_FILE_LAZY
+/**< Chunks holding calibration data, which is read a little at a time and is
+paged in on first access. All other chunks hold the chunk directory and the
+lookup tables and are kept resident */
+static const uint32_t acdb_lazy_chunk_ids[] = {
+    ACDB_CHUNKID_DATAPOOL,
+    ACDB_CHUNKID_VCPM_CAL_DATA,
+};
+
+static bool_t AcdbFileManIsLazyChunk(uint32_t chunk_id)
+{
+    for (uint32_t i = 0; i < sizeof(acdb_lazy_chunk_ids)
+        / sizeof(acdb_lazy_chunk_ids[0]); i++)
+    {
+        if (acdb_lazy_chunk_ids[i] == chunk_id)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+static void AcdbFileManFreeLazyChunkMap(acdb_lazy_chunk_map_t* map)
+{
+    if (IsNull(map))
+        return;
+
+    if (!IsNull(map->evict_lock))
+        (void)ar_osal_mutex_destroy(map->evict_lock);
+
+    ACDB_FREE(map->windows);
+    ACDB_FREE(map->chunks);
+    ACDB_FREE(map);
+}
+
+/**
+* \brief
+*       Builds the map of the data chunks of a mapped database and starts
+*       loading the other chunks. The data chunks are left to be paged in
+*       a window at a time by the first access through the file manager.
+*
+* \param[in] db_info: The database with its chunk index built
+* \param[out] map: The new map, NULL if the database has no data chunks
+* \return AR_EOK on success, AR_EUNSUPPORTED if the database is not mapped,
+*       and an error otherwise
+*/
+static int32_t AcdbFileManCreateLazyChunkMap(AcdbFileManDatabaseInfo* db_info,
+    acdb_lazy_chunk_map_t** map)
+{
+    int32_t status = AR_EOK;
+    uint32_t count = 0;
+    uint32_t window_count = 0;
+    uint32_t window = 0;
+    uint32_t window_offset = 0;
+    acdb_chunk_index_entry_t* entry = NULL;
+    acdb_lazy_chunk_t* chunk = NULL;
+    acdb_lazy_chunk_map_t* new_map = NULL;
+
+    *map = NULL;
+    if (IsNull(db_info->chunk_index))
+        return AR_EUNSUPPORTED;
+
+    for (uint32_t i = 0; i <= db_info->chunk_index->mask; i++)
+    {
+        entry = &db_info->chunk_index->entries[i];
+        if (entry->size == 0)
+            continue;
+
+        if (AcdbFileManIsLazyChunk(entry->id))
+        {
+            count++;
+            window_count += (entry->size + ACDB_LAZY_WINDOW_SIZE - 1)
+                / ACDB_LAZY_WINDOW_SIZE;
+            continue;
+        }
+
+        status = ar_fmap_advise(db_info->database_cache,
+            entry->offset, entry->size, AR_FMAP_ADVICE_WILLNEED);
+        if (AR_FAILED(status))
+            return status;
+    }
+
+    if (count == 0)
+        return AR_EOK;
+
+    new_map = ACDB_MALLOC(acdb_lazy_chunk_map_t, 1);
+    if (IsNull(new_map))
+        return AR_ENOMEMORY;
+
+    ar_mem_set(new_map, 0, sizeof(acdb_lazy_chunk_map_t));
+    new_map->chunks = ACDB_MALLOC(acdb_lazy_chunk_t, count);
+    new_map->windows = ACDB_MALLOC(acdb_lazy_window_t, window_count);
+    if (IsNull(new_map->chunks) || IsNull(new_map->windows))
+    {
+        status = AR_ENOMEMORY;
+        goto end;
+    }
+
+    status = ar_osal_mutex_create(&new_map->evict_lock);
+    if (AR_FAILED(status))
+        goto end;
+
+    for (uint32_t i = 0; i <= db_info->chunk_index->mask; i++)
+    {
+        entry = &db_info->chunk_index->entries[i];
+        if (entry->size == 0 || !AcdbFileManIsLazyChunk(entry->id))
+            continue;
+
+        new_map->chunks[new_map->count].offset = entry->offset;
+        new_map->chunks[new_map->count].size = entry->size;
+        new_map->count++;
+    }
+
+    status = AcdbSort2(count * sizeof(acdb_lazy_chunk_t), new_map->chunks,
+        sizeof(acdb_lazy_chunk_t), 0);
+    if (AR_FAILED(status))
+        goto end;
+
+    /* Windows are laid out in chunk order so a chunk's windows follow its
+     * first one */
+    for (uint32_t i = 0; i < count; i++)
+    {
+        chunk = &new_map->chunks[i];
+        chunk->first_window = window;
+        for (window_offset = 0; window_offset < chunk->size;
+            window_offset += ACDB_LAZY_WINDOW_SIZE)
+        {
+            new_map->windows[window].offset = chunk->offset + window_offset;
+            new_map->windows[window].size =
+                chunk->size - window_offset < ACDB_LAZY_WINDOW_SIZE ?
+                chunk->size - window_offset : ACDB_LAZY_WINDOW_SIZE;
+            new_map->windows[window].last_access = 0;
+            new_map->windows[window].resident = FALSE;
+            window++;
+        }
+    }
+
+    new_map->window_count = window_count;
+    new_map->budget = ACDB_LAZY_RESIDENT_KB / ACDB_LAZY_WINDOW_KB;
+    if (new_map->budget == 0)
+        new_map->budget = 1;
+    new_map->start = new_map->chunks[0].offset;
+    new_map->end = new_map->chunks[count - 1].offset
+        + new_map->chunks[count - 1].size;
+
+    *map = new_map;
+    new_map = NULL;
+
+end:
+    AcdbFileManFreeLazyChunkMap(new_map);
+    return status;
+}
+
+/**
+* \brief
+*       Releases the least recently accessed windows until the number of
+*       resident windows is back within the budget. Threads still holding
+*       pointers into a released window read it from the file again.
+*
+* \param[in] db: The database
+* \param[in] keep: The window being accessed, never released
+*/
+static void AcdbFileManEvictLazyChunks(AcdbFileManDatabaseInfo* db,
+    acdb_lazy_window_t* keep)
+{
+    acdb_lazy_chunk_map_t* map = db->lazy_chunks;
+    acdb_lazy_window_t* victim = NULL;
+    uint32_t now = 0;
+    uint32_t age = 0;
+
+    ACDB_MUTEX_LOCK(map->evict_lock);
+
+    while (ar_osal_atomic_load_u32(&map->resident_windows) > map->budget)
+    {
+        victim = NULL;
+        age = 0;
+        now = ar_osal_atomic_load_u32(&map->access_count);
+        for (uint32_t i = 0; i < map->window_count; i++)
+        {
+            if (&map->windows[i] == keep ||
+                !ar_osal_atomic_load_u32(&map->windows[i].resident))
+                continue;
+
+            /* Unsigned difference so the count may wrap */
+            if (IsNull(victim) ||
+                now - ar_osal_atomic_load_u32(&map->windows[i].last_access) > age)
+            {
+                victim = &map->windows[i];
+                age = now - ar_osal_atomic_load_u32(&victim->last_access);
+            }
+        }
+
+        if (IsNull(victim))
+            break;
+
+        /* Only cleared here under the lock, a concurrent first access that
+         * still sees it set is not counted again */
+        ar_osal_atomic_store_u32(&victim->resident, FALSE);
+        (void)ar_fmap_advise(db->database_cache, victim->offset,
+            victim->size, AR_FMAP_ADVICE_DONTNEED);
+        (void)ar_osal_atomic_sub_u32(&map->resident_windows, 1);
+    }
+
+    ACDB_MUTEX_UNLOCK(map->evict_lock);
+}
+
+/**
+* \brief
+*       Records an access to a data chunk window. The window is counted
+*       against the resident budget on its first access, going past the
+*       budget releases other windows.
+*
+* \param[in] db: The database
+* \param[in] window: The window being accessed
+*/
+static void AcdbFileManTouchLazyWindow(AcdbFileManDatabaseInfo* db,
+    acdb_lazy_window_t* window)
+{
+    acdb_lazy_chunk_map_t* map = db->lazy_chunks;
+    uint32_t expected = FALSE;
+
+    ar_osal_atomic_store_u32(&window->last_access,
+        ar_osal_atomic_add_u32(&map->access_count, 1));
+
+    if (ar_osal_atomic_load_u32(&window->resident) ||
+        !ar_osal_atomic_cmpxchg_u32(&window->resident, &expected, TRUE))
+        return;
+
+    if (ar_osal_atomic_add_u32(&map->resident_windows, 1) > map->budget)
+        AcdbFileManEvictLazyChunks(db, window);
+}
+
+/**
+* \brief
+*       Records an access to every data chunk window overlapping the
+*       size bytes at offset. Bytes between data chunks belong to resident
+*       chunks and are not counted.
+*
+* \param[in] db: The database
+* \param[in] offset: The offset being read from the database
+* \param[in] size: The number of bytes being read
+*/
+static void AcdbFileManTouchLazyChunk(AcdbFileManDatabaseInfo* db,
+    uint32_t offset, size_t size)
+{
+    acdb_lazy_chunk_map_t* map = db->lazy_chunks;
+    acdb_lazy_chunk_t* chunk = NULL;
+    uint32_t end = 0;
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+    uint32_t mid = 0;
+
+    if (IsNull(map) || size == 0 || offset >= map->end)
+        return;
+
+    end = size > map->end - offset ? map->end : offset + (uint32_t)size;
+    if (end <= map->start)
+        return;
+
+    /* Find the first chunk ending past offset */
+    hi = map->count;
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (offset < map->chunks[mid].offset ||
+            offset - map->chunks[mid].offset < map->chunks[mid].size)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    for (; lo < map->count && map->chunks[lo].offset < end; lo++)
+    {
+        chunk = &map->chunks[lo];
+        for (uint32_t i = offset > chunk->offset ?
+            (offset - chunk->offset) / ACDB_LAZY_WINDOW_SIZE : 0;
+            i * ACDB_LAZY_WINDOW_SIZE < chunk->size &&
+            chunk->offset + i * ACDB_LAZY_WINDOW_SIZE < end; i++)
+        {
+            AcdbFileManTouchLazyWindow(db,
+                &map->windows[chunk->first_window + i]);
+        }
+    }
+}
+#endif
+
 int32_t AcdbFileManSetFileIndex(int32_t file_index)
 {
     if (file_index < -1 || file_index > acdb_file_man_context.database_count)
@@ -537,6 +908,23 @@ int32_t AcdbFileManAddAcdb(int32_t index, uint32_t *vm_id,
     db_info->database_cache = file_info->file.buffer;
     db_info->database_cache_size = file_info->file.size;
     db_info->file_handle = file_info->file_handle;
+
+    if (AR_FAILED(acdb_parser_create_chunk_index(db_info->database_cache,
+        db_info->database_cache_size, &db_info->chunk_index)))
+    {
+        ACDB_INFO("Warning: No chunk index for %s, chunks are found by "
+            "walking the file", file_info->path);
+        db_info->chunk_index = NULL;
+    }
+#ifdef ACDB_LOAD_FILE_LAZY
+    if (AR_FAILED(AcdbFileManCreateLazyChunkMap(db_info,
+        &db_info->lazy_chunks)))
+    {
+        ACDB_INFO("Warning: %s is not paged in lazily, it is fully "
+            "resident", file_info->path);
+        db_info->lazy_chunks = NULL;
+    }
+#endif
     db_info->file_type = file_info->file_type;
     db_info->database_file.path_len = file_info->path_length;
     ACDB_MEM_CPY_SAFE(
@@ -719,6 +1107,13 @@ int32_t AcdbFileManRemoveDatabase(acdb_file_man_handle_t *fm_handle)
     if (!IsNull(db_info->file_handle))
         (void)ar_fclose(db_info->file_handle);
 
+    acdb_parser_free_chunk_index(db_info->chunk_index);
+    db_info->chunk_index = NULL;
+#ifdef ACDB_LOAD_FILE_LAZY
+    AcdbFileManFreeLazyChunkMap(db_info->lazy_chunks);
+    db_info->lazy_chunks = NULL;
+#endif
+
     acdb_buffer_t in_mem_file;
     in_mem_file.buffer = db_info->database_cache;
     in_mem_file.size = db_info->database_cache_size;
@@ -1707,10 +2102,14 @@ int32_t acdb_get_db_chunk(acdb_file_man_handle_t handle,
 
     AcdbFileManDatabaseInfo* db = (AcdbFileManDatabaseInfo*)handle;
 
-    int32_t status = acdb_parser_get_chunk(
-        db->database_cache,
-        db->database_cache_size,
-        chunk_id, chunk_offset, chunk_size);
+    int32_t status = IsNull(db->chunk_index) ?
+        acdb_parser_get_chunk(
+            db->database_cache,
+            db->database_cache_size,
+            chunk_id, chunk_offset, chunk_size) :
+        acdb_parser_get_indexed_chunk(
+            db->chunk_index,
+            chunk_id, chunk_offset, chunk_size);
     if (AR_FAILED(status))
     {
         ACDB_DBG("Error[%d]: Failed to get information for Chunk[0x%x]",
@@ -1826,6 +2225,26 @@ int32_t acdb_fm_read_db_mem(acdb_file_man_handle_t handle,
         return AR_EBADPARAM;
     }
 
+#ifdef ACDB_LOAD_FILE_LAZY
+    /* Copy a window at a time so a read larger than the resident budget
+     * does not release its own windows before they are copied */
+    while (read_size > ACDB_LAZY_WINDOW_SIZE)
+    {
+        ACDB_FM_LAZY_TOUCH(db, *offset, ACDB_LAZY_WINDOW_SIZE);
+
+        status = ar_mem_cpy(buffer, ACDB_LAZY_WINDOW_SIZE,
+            buffer_ptr, ACDB_LAZY_WINDOW_SIZE);
+        if (AR_FAILED(status)) return status;
+
+        buffer = (uint8_t*)buffer + ACDB_LAZY_WINDOW_SIZE;
+        buffer_ptr += ACDB_LAZY_WINDOW_SIZE;
+        read_size -= ACDB_LAZY_WINDOW_SIZE;
+        *offset += ACDB_LAZY_WINDOW_SIZE;
+    }
+#endif
+
+    ACDB_FM_LAZY_TOUCH(db, *offset, read_size);
+
     status = ar_mem_cpy(buffer, read_size, buffer_ptr, read_size);
     if (AR_FAILED(status)) return status;
 
@@ -1854,6 +2273,8 @@ int32_t acdb_fm_get_db_mem_ptr(acdb_file_man_handle_t handle,
         return AR_EBADPARAM;
     }
 
+    ACDB_FM_LAZY_TOUCH(db, *offset, data_size);
+
     *file_ptr = (uint8_t*)db->database_cache + *offset;
     *offset += (uint32_t)data_size;
 
@@ -1879,11 +2300,22 @@ int32_t acdb_fm_get_db_mem_ptr_2(acdb_file_man_handle_t handle,
     if((uint8_t*)addr_start + offset > (uint8_t*)addr_end)
         return AR_EBADPARAM;
 
+    ACDB_FM_LAZY_TOUCH(db, offset, 1);
+
     *file_ptr = (uint8_t*)db->database_cache + offset;
 
     return status;
 }
 
+int32_t acdb_fm_get_db_mem_ptr_3(acdb_file_man_handle_t handle,
+    void** file_ptr, size_t data_size, uint32_t offset)
+{
+    if (data_size == 0)
+        return acdb_fm_get_db_mem_ptr_2(handle, file_ptr, offset);
+
+    return acdb_fm_get_db_mem_ptr(handle, file_ptr, data_size, &offset);
+}
+
 int32_t FileManReadBuffer(void* buffer, size_t read_size, uint32_t* offset)
 {
     acdb_context_handle_t* ctx_handle = NULL;
@@ -1923,6 +2355,20 @@ int32_t FileManGetFilePointer2(void** file_ptr, uint32_t offset)
         file_ptr, offset);
 }
 
+int32_t FileManGetFilePointer3(void** file_ptr, size_t data_size,
+    uint32_t offset)
+{
+    acdb_context_handle_t* handle = NULL;
+
+    handle = acdb_ctx_man_get_active_handle();
+
+    if (IsNull(handle))
+        return AR_EHANDLE;
+
+    return acdb_fm_get_db_mem_ptr_3(handle->file_manager_handle,
+        file_ptr, data_size, offset);
+}
+
 int32_t FileManDbReadAndSeek(acdb_fm_read_req_t *req)
 {
     acdb_context_handle_t* ctx_handle = NULL;
@@ -24,7 +24,6 @@
 
 #define ACDB_MAX(a,b) (((a) > (b)) ? (a) : (b))
 #define ACDB_MIN(a,b) (((a) < (b)) ? (a) : (b))
-#define HEX_DIGITS 8
 #define ACDB_MAX_ACDB_FILES 16
 
 /**< A File Manager macro that simplifies accessing the database info within the
@@ -95,64 +94,31 @@ int32_t acdb_heap_clear(acdb_heap_handle_t handle);
 
 /**
 * \breif
-*	Converts a key vector to a string.
-*	Caller is responsible for freeing the returned string pointer
+*	Compares two key vectors pair by pair, the key before the value. A key
+*	vector that is a prefix of the other is the smaller one.
 *
-* \return pointer to key vector string on succes, null on failure
+* \return negative if kv_a is smaller, positive if it is larger, 0 if equal
 */
-char *acdb_heap_key_vector_to_string(
-    const AcdbGraphKeyVector *key_vector, size_t *sz_str_key_vector)
+static int32_t acdb_heap_compare_key_vectors(
+    const AcdbGraphKeyVector *kv_a, const AcdbGraphKeyVector *kv_b)
 {
-	/* Example
-	Format	: <key, value>...<key, value>
-	Input	: <0xA, 0x1><0xB, 0x1><0xC, 0x1>
-	Output  : 'A1B1C1' in Big Endian
-	*/
-	if (IsNull(key_vector)) return NULL;
-
-	uint32_t offset = 0;
-	//Max Key Vector String length = 8 * 2 * key_vector->num_keys;
-	size_t str_size = 0;
-	//8 Hex Digits in 32-bit integer * 2 members in <key,value>
-    uint32_t sz_str_kv_pair = 16 + 1;
-	char tmp[16 + 1] = "";
-	char *key_vector_str = NULL;
-
-	for (uint32_t i = 0; i < key_vector->num_keys; i++)
-	{
-        if (0 > ar_sprintf(tmp, sz_str_kv_pair, "%08x%08x",
-            key_vector->graph_key_vector[i].key,
-            key_vector->graph_key_vector[i].value))
-        {
-            return NULL;
-        }
-        str_size += ar_strlen(tmp, (size_t)sz_str_kv_pair);
-	}
+    uint32_t num_keys = ACDB_MIN(kv_a->num_keys, kv_b->num_keys);
+    const AcdbKeyValuePair *kvp_a = kv_a->graph_key_vector;
+    const AcdbKeyValuePair *kvp_b = kv_b->graph_key_vector;
 
-	str_size += 1;// '\0'
+    for (uint32_t i = 0; i < num_keys; i++)
+    {
+        if (kvp_a[i].key != kvp_b[i].key)
+            return kvp_a[i].key < kvp_b[i].key ? -1 : 1;
 
-	key_vector_str = ACDB_MALLOC(char, str_size);
-	if (IsNull(key_vector_str)) return NULL;
-	memset(key_vector_str, 0, str_size);
+        if (kvp_a[i].value != kvp_b[i].value)
+            return kvp_a[i].value < kvp_b[i].value ? -1 : 1;
+    }
 
-	for (uint32_t i = 0; i < key_vector->num_keys; i++)
-	{
-        if (key_vector_str + offset < key_vector_str + str_size)
-        {
-            if (0 > ar_sprintf(key_vector_str + offset, sz_str_kv_pair,
-                "%08x%08x",
-                key_vector->graph_key_vector[i].key,
-                key_vector->graph_key_vector[i].value))
-            {
-                ACDB_FREE(key_vector_str);
-                return NULL;
-            }
-            offset = (uint32_t)ar_strlen(key_vector_str, str_size);
-        }
-	}
+    if (kv_a->num_keys != kv_b->num_keys)
+        return kv_a->num_keys < kv_b->num_keys ? -1 : 1;
 
-	*sz_str_key_vector = offset;
-	return key_vector_str;
+    return 0;
 }
 
 /**
@@ -264,7 +230,11 @@ void acdb_tree_update_depth(AcdbTreeNode *tnode)
             break;
         }
 
-        if (!acdb_tree_is_leaf(p_cur_node) && !IsNull(p_cur_node))
+        if (IsNull(p_cur_node->left) && IsNull(p_cur_node->right))
+        {
+            p_cur_node->depth = 1;
+        }
+        else if (!acdb_tree_is_leaf(p_cur_node) && !IsNull(p_cur_node))
         {
             if (IsNull(p_cur_node->right))
             {
@@ -301,9 +271,9 @@ int32_t acdb_tree_direction(AcdbTreeNode *p_x, AcdbTreeNode *p_y)
         return TREE_DIR_NONE;
     }
 
-    int32_t direction = strcmp(
-        ((KVSubgraphMapBin*)p_x->p_struct)->str_key_vector,
-        ((KVSubgraphMapBin*)p_y->p_struct)->str_key_vector);
+    int32_t direction = acdb_heap_compare_key_vectors(
+        &((KVSubgraphMapBin*)p_x->p_struct)->key_vector,
+        &((KVSubgraphMapBin*)p_y->p_struct)->key_vector);
 
     if (direction < 0)
     {
@@ -416,6 +386,10 @@ void acdb_tree_rotate(AcdbTreeNode *p_a, AcdbTreeNode *p_c, int32_t factor)
         p_a->left = p_c;
 
         p_b->right = p_c->left;
+        if (!IsNull(p_b->right))
+        {
+            p_b->right->parent = p_b;
+        }
         p_c->left = p_b;
 
         acdb_tree_rotate_right(p_a, p_b);
@@ -434,6 +408,10 @@ void acdb_tree_rotate(AcdbTreeNode *p_a, AcdbTreeNode *p_c, int32_t factor)
         p_a->right = p_c;
 
         p_b->left = p_c->right;
+        if (!IsNull(p_b->left))
+        {
+            p_b->left->parent = p_b;
+        }
         p_c->right = p_b;
 
         acdb_tree_rotate_left(p_a, p_b);
@@ -495,8 +473,8 @@ KVSubgraphMapBin *acdb_heap_create_map_bin(void)
     if (IsNull(bin))
         return NULL;
 
-    bin->str_key_vector_size = 0;
-    bin->str_key_vector = NULL;
+    bin->key_vector.num_keys = 0;
+    bin->key_vector.graph_key_vector = NULL;
     bin->map = NULL;
 
     return bin;
@@ -624,7 +602,6 @@ void acdb_heap_free_map(acdb_delta_data_map_t *map)
 void acdb_heap_free_bin(KVSubgraphMapBin **bin)
 {
     acdb_heap_free_map((*bin)->map);
-    ACDB_FREE((*bin)->str_key_vector);
     ACDB_FREE(*bin);
     *bin = NULL;
 }
@@ -720,17 +697,15 @@ int32_t acdb_heap_insert(acdb_heap_handle_t handle, AcdbTreeNode *tnode)
     return AR_EOK;
 }
 
-//int32_t acdb_heap_remove(TreeNode *tnode)
-//{
-//	int32_t status = AR_ENOTIMPL;
-//	//the reverse of insert
-//	//copy the same code but instead of inserting the node, ACDB_FREE the memory associated with the node
-//	return status;
-//}
-
-int32_t acdb_heap_get_bin(acdb_heap_handle_t handle,
-    size_t size_str_key_vector,
-    char* str_key_vector, KVSubgraphMapBin **bin)
+/**
+* \breif acdb_heap_get_node
+*	Find the tree node holding the map of a key vector. The lookup compares
+*	the key vector in place and does not allocate.
+*
+* \return 0 on succes, AR_ENOTEXIST if the key vector is not in the tree
+*/
+int32_t acdb_heap_get_node(acdb_heap_handle_t handle,
+    const AcdbGraphKeyVector *key_vector, AcdbTreeNode **node)
 {
     int32_t status = AR_EOK;
     int32_t tree_dir = TREE_DIR_NONE;
@@ -742,6 +717,9 @@ int32_t acdb_heap_get_bin(acdb_heap_handle_t handle,
     if (IsNull(handle))
         return AR_EHANDLE;
 
+    if (IsNull(key_vector))
+        return AR_EBADPARAM;
+
     db_heap = (AcdbHeapInfo*)handle;
     t = db_heap->root;
 
@@ -750,8 +728,8 @@ int32_t acdb_heap_get_bin(acdb_heap_handle_t handle,
         return AR_ENOTEXIST;
     }
 
-    tmp_bin.str_key_vector = str_key_vector;
-    tmp_bin.str_key_vector_size = (uint32_t)(size_str_key_vector);
+    tmp_bin.key_vector = *key_vector;
+    tmp_bin.map = NULL;
     tnode.depth = 1;
     tnode.left = NULL;
     tnode.right = NULL;
@@ -788,7 +766,7 @@ int32_t acdb_heap_get_bin(acdb_heap_handle_t handle,
         }
         case TREE_DIR_NONE:
         {
-            *bin = (KVSubgraphMapBin*)t->p_struct;
+            *node = t;
             break;
         }
         default:
@@ -799,13 +777,114 @@ int32_t acdb_heap_get_bin(acdb_heap_handle_t handle,
             AR_EOK != status) break;
     }
 
-    tmp_bin.str_key_vector = NULL;
-    tmp_bin.str_key_vector_size = 0;
     t = NULL;
 
     return status;
 }
 
+/**
+* \breif acdb_heap_remove
+*	Remove the node holding the map of a key vector from the tree and free
+*	the map. The tree is rebalanced from the parent of the unlinked node up
+*	to the root.
+*
+* \return 0 on succes, AR_ENOTEXIST if the key vector is not in the tree
+*/
+int32_t acdb_heap_remove(acdb_heap_handle_t handle,
+    const AcdbGraphKeyVector *key_vector)
+{
+    int32_t status = AR_EOK;
+    int32_t factor = 0;
+    AcdbTreeNode *tnode = NULL;
+    AcdbTreeNode *succ = NULL;
+    AcdbTreeNode *child = NULL;
+    AcdbTreeNode *t = NULL;
+    AcdbTreeNode *u = NULL;
+    KVSubgraphMapBin *bin = NULL;
+    AcdbHeapInfo* db_heap = NULL;
+
+    status = acdb_heap_get_node(handle, key_vector, &tnode);
+    if (AR_FAILED(status))
+        return status;
+
+    db_heap = (AcdbHeapInfo*)handle;
+
+    /* A node with two subtrees takes the bin of its in-order successor,
+     * which has no left subtree, and the successor is unlinked instead */
+    if (!IsNull(tnode->left) && !IsNull(tnode->right))
+    {
+        succ = tnode->right;
+        while (!IsNull(succ->left))
+            succ = succ->left;
+
+        bin = (KVSubgraphMapBin*)tnode->p_struct;
+        tnode->p_struct = succ->p_struct;
+        succ->p_struct = bin;
+        tnode = succ;
+    }
+
+    child = IsNull(tnode->left) ? tnode->right : tnode->left;
+    t = tnode->parent;
+
+    if (!IsNull(child))
+        child->parent = t;
+
+    if (IsNull(t))
+        db_heap->root = child;
+    else if (t->left == tnode)
+        t->left = child;
+    else
+        t->right = child;
+
+    bin = (KVSubgraphMapBin*)tnode->p_struct;
+    acdb_heap_free_bin(&bin);
+    ACDB_FREE(tnode);
+
+    if (IsNull(t))
+        return AR_EOK;
+
+    acdb_tree_update_depth(t);
+
+    //Check balance and rotate when nessesary. Set the new root
+    while (t != NULL)
+    {
+        if (!acdb_tree_is_balanced(t, &factor))
+        {
+            //t - grandparent
+            //  - parent, the deeper subtree of t
+            //u - child, the deeper subtree of the parent. Ties are broken
+            //    toward the side of the parent for a single rotation
+            u = factor < 0 ? t->left : t->right;
+            if (factor < 0)
+            {
+                u = (IsNull(u->right) ||
+                    (!IsNull(u->left) && u->left->depth >= u->right->depth)) ?
+                    u->left : u->right;
+            }
+            else
+            {
+                u = (IsNull(u->left) ||
+                    (!IsNull(u->right) && u->right->depth >= u->left->depth)) ?
+                    u->right : u->left;
+            }
+
+            acdb_tree_rotate(t, u, factor);
+
+            //t has moved down, continue from the root of the rotated subtree
+            t = t->parent;
+        }
+
+        if (t->parent == NULL)
+        {
+            db_heap->root = t;
+        }
+
+        t = t->parent;
+    }
+
+    return AR_EOK;
+}
+
 /* ---------------------------------------------------------------------------
 * IOCTL Command Functions
 *--------------------------------------------------------------------------- */
@@ -894,8 +973,6 @@ int32_t acdb_heap_add_delta_data_map(
     acdb_heap_map_handle_info_t* info)
 {
     int32_t status = AR_EOK;
-    size_t size_str_key_vector = 0;
-    char_t* str_key_vector = NULL;
     AcdbTreeNode* bin_node = NULL;
     KVSubgraphMapBin* bin = NULL;
     AcdbGraphKeyVector *map_key_vector = NULL;
@@ -921,13 +998,9 @@ int32_t acdb_heap_add_delta_data_map(
     if (IsNull(map_key_vector))
         return AR_EBADPARAM;
 
-    str_key_vector = acdb_heap_key_vector_to_string(
-        map_key_vector, &size_str_key_vector);
-
     /* Check to see if Tree has the appropriate bin
      * Locate bin and append to linked list */
-    status = acdb_heap_get_bin(heap_handle,
-        size_str_key_vector, str_key_vector, &bin);
+    status = acdb_heap_get_node(heap_handle, map_key_vector, &bin_node);
     if (AR_SUCCEEDED(status))
     {
         goto end;
@@ -949,8 +1022,7 @@ int32_t acdb_heap_add_delta_data_map(
             goto end;
         }
 
-        bin->str_key_vector = str_key_vector;
-        bin->str_key_vector_size = (uint32_t)(size_str_key_vector);
+        bin->key_vector = *map_key_vector;
         bin->map = info->map;
 
         acdb_heap_insert(heap_handle, bin_node);
@@ -962,7 +1034,6 @@ end:
     {
         ACDB_FREE(bin_node);
         ACDB_FREE(bin);
-        ACDB_FREE(str_key_vector);
     }
 
     return status;
@@ -973,84 +1044,57 @@ int32_t acdb_heap_get_ckv_subgraph_map(
     acdb_delta_data_map_t** map)
 {
     int32_t status = AR_EOK;
-    KVSubgraphMapBin *bin = NULL;
-    AcdbGraphKeyVector *map_key_vector = NULL;
+    AcdbTreeNode *bin_node = NULL;
     acdb_delta_data_map_t *tmp_map = NULL;
-    size_t size_str_key_vector = 0;
     acdb_context_handle_t* handle = NULL;
-    char* str_key_vector = NULL;
 
     handle = acdb_ctx_man_get_active_handle();
 
     if (IsNull(handle) || IsNull(handle->heap_handle))
         return AR_EHANDLE;
 
-    str_key_vector = acdb_heap_key_vector_to_string(
-        cal_key_vector, &size_str_key_vector);
-
-    status = acdb_heap_get_bin(handle->heap_handle,
-        size_str_key_vector, str_key_vector, &bin);
-
+    status = acdb_heap_get_node(handle->heap_handle,
+        cal_key_vector, &bin_node);
     if (AR_EOK != status)
     {
         //ACDB_ERR("Key Vector not found in heap");
         //LogKeyVector(cal_key_vector);
-        goto end;
+        return status;
     }
 
-    tmp_map = (acdb_delta_data_map_t*)bin->map;
+    tmp_map = ((KVSubgraphMapBin*)bin_node->p_struct)->map;
 
-    if (IsNull(tmp_map->key_vector_data))
+    if (IsNull(get_key_vector_from_map(tmp_map)))
     {
-        if (!IsNull(str_key_vector))
-            ACDB_DBG("Map key vector data is null for "
-                "Key Vector<%s>", str_key_vector);
-        status = AR_ENOTEXIST;
-        goto end;
+        ACDB_DBG("Error[%d]: Map key vector data is null or of an unknown "
+            "type", AR_ENOTEXIST);
+        return AR_ENOTEXIST;
     }
 
-    switch (tmp_map->key_vector_type)
-    {
-    case TAG_KEY_VECTOR:
-        map_key_vector = &((AcdbModuleTag*)tmp_map->key_vector_data)->tag_key_vector;
-        break;
-    case CAL_KEY_VECTOR:
-        map_key_vector = ((AcdbGraphKeyVector*)tmp_map->key_vector_data);
-        break;
-    default:
-        if (!IsNull(str_key_vector))
-            ACDB_DBG("Unable to determine Key Vector type "
-                "for Key Vector<%s>", str_key_vector);
-        status = AR_ENOTEXIST;
-        goto end;
-    }
+    *map = tmp_map;
+    return status;
+}
 
-    //Compare Sorted Key Vectors and values
-    if (0 == ACDB_MEM_CMP(
-        cal_key_vector->graph_key_vector,
-        map_key_vector->graph_key_vector,
-        map_key_vector->num_keys * sizeof(AcdbKeyValuePair)))
-    {
-        *map = tmp_map;
-        tmp_map = NULL;
-    }
+/**
+* \brief  acdb_heap_remove_map
+*           Removes the map of a key vector from the heap of the active
+*           database and frees it
+* \param[in] key_vector: The key vector of the map to remove
+*
+* \return
+* 0 -- Success
+* Nonzero -- Failure
+*/
+int32_t acdb_heap_remove_map(const AcdbGraphKeyVector *key_vector)
+{
+    acdb_context_handle_t* handle = NULL;
 
-    if (IsNull(*map))
-    {
-        if(!IsNull(str_key_vector))
-            ACDB_DBG("KV Map does not exist for "
-                "Key Vector<%s>", str_key_vector);
-        status = AR_ENOTEXIST;
-    }
+    handle = acdb_ctx_man_get_active_handle();
 
-    end:
-    if (!IsNull(str_key_vector))
-    {
-        ACDB_FREE(str_key_vector);
-        str_key_vector = NULL;
-    }
+    if (IsNull(handle) || IsNull(handle->heap_handle))
+        return AR_EHANDLE;
 
-    return status;
+    return acdb_heap_remove(handle->heap_handle, key_vector);
 }
 
 /**
@@ -1266,36 +1310,16 @@ int32_t acdb_heap_get_heap_info(AcdbBufferContext *rsp)
 
             num_nodes++;
 
-            char* next_int = bin->str_key_vector;
-            char tmp[HEX_DIGITS + 1];
-            uint32_t num_keys = 0;
-
-            offset += sizeof(num_keys);//Make room to write number of keys
-            /** Get Key Vector
-             * This loop will write key followed by value for each key value pair.
-             * The str_key_vector is in the form A0000000A0000001B0000000B0000001 where
-             * key1.ID = A0000000 key1.Value = A0000001
-             * key2.ID = B0000000 key2.Value = B0000001
-             */
-            while (*next_int != '\0')
-            {
-                ACDB_MEM_CPY_SAFE(&tmp[0], HEX_DIGITS, next_int, HEX_DIGITS);//8 bytes for 8 hex digits
-
-                uint32_t key = 0;//(uint32_t)strtoul(&tmp[0], NULL, 16);
+            uint32_t num_keys = bin->key_vector.num_keys;
+            uint32_t sz_key_vector = num_keys * sizeof(AcdbKeyValuePair);
 
-                ar_sscanf(&tmp[0], "%08x", &key);
-                next_int += HEX_DIGITS;
+            //Write the number of keys followed by the key value pairs
+            ACDB_MEM_CPY_SAFE(&rsp->buf[offset], sizeof(num_keys), &num_keys, sizeof(num_keys));
+            offset += sizeof(num_keys);
 
-                //write to rsp buf
-                ACDB_MEM_CPY_SAFE(&rsp->buf[offset], sizeof(key), &key, sizeof(key));
-                offset += sizeof(key);
-                num_keys++;
-            }
-
-            next_int = NULL;
-            num_keys = num_keys / 2;
-            ACDB_MEM_CPY_SAFE(&rsp->buf[offset - (num_keys * sizeof(AcdbKeyValuePair) + sizeof(num_keys))],
-                sizeof(num_keys), &num_keys, sizeof(num_keys));
+            ACDB_MEM_CPY_SAFE(&rsp->buf[offset], sz_key_vector,
+                bin->key_vector.graph_key_vector, sz_key_vector);
+            offset += sz_key_vector;
 
             //Get Size of map
             acdb_delta_data_map_t *map =
@@ -1386,7 +1410,10 @@ int32_t acdb_heap_ioctl(uint32_t cmd_id,
     }
     case ACDB_HEAP_CMD_REMOVE_MAP:
     {
-        //Similar to Get Map but frees the memory associated with the map
+        if (IsNull(req) || req_size < sizeof(AcdbGraphKeyVector))
+            return AR_EBADPARAM;
+
+        status = acdb_heap_remove_map((AcdbGraphKeyVector*)req);
         break;
     }
     case ACDB_HEAP_CMD_GET_MAP:
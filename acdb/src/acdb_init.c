@@ -577,6 +577,8 @@ int32_t acdb_init_reset(void)
 			"context manager.", status);
 	}
 
+	AcdbScratchFreeCache();
+
 	ACDB_PKT_LOG_DEINIT();
 
 	status = AcdbARHeapDeinit();
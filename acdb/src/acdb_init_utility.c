@@ -27,6 +27,9 @@
 
 int32_t AcbdInitLoadInMemFile(const char_t* fname, ar_fhandle fhandle, acdb_buffer_t* in_mem_file)
 {
+    int32_t status = AR_EUNSUPPORTED;
+    size_t bytes_read = 0;
+
     in_mem_file->size = (uint32_t)ar_fsize(fhandle);
 
     if (in_mem_file->size == 0)
@@ -35,8 +38,19 @@ int32_t AcbdInitLoadInMemFile(const char_t* fname, ar_fhandle fhandle, acdb_buff
         return AR_EBADPARAM;
     }
 
-    int32_t status = ar_fmap(fhandle, &in_mem_file->buffer);
-    if (AR_EUNSUPPORTED == status)
+#ifdef ACDB_LOAD_FILE_MAPPED
+    /* Serve the file straight from a read only mapping, pages are read on
+     * first access and shared with other processes using the same file */
+    status = ar_fmap(fhandle, (const void**)&in_mem_file->buffer);
+    if (AR_FAILED(status) && AR_EUNSUPPORTED != status)
+    {
+        ACDB_INFO("Unable to map file %s, error %d. Reading it into memory",
+            fname, status);
+    }
+#endif
+    /* The file is still usable from the heap whenever it cannot be mapped,
+     * AcbdInitUnloadInMemFile frees it as ar_funmap does not know it */
+    if (AR_FAILED(status))
     {
         in_mem_file->buffer = (void*)ACDB_MALLOC(uint8_t, in_mem_file->size);
 
@@ -45,11 +59,25 @@ int32_t AcbdInitLoadInMemFile(const char_t* fname, ar_fhandle fhandle, acdb_buff
             ACDB_ERR("Error[%d]: Not enough memory to allocate for file %s", AR_ENOMEMORY, fname);
             return AR_ENOMEMORY;
         }
-        status = AR_EOK;
-    }
-    else if (AR_FAILED(status))
-    {
-        ACDB_ERR("Error[%d]: Failed to map memory for file %s", status, fname);
+
+        status = ar_fread(fhandle, in_mem_file->buffer, in_mem_file->size, &bytes_read);
+        if (AR_FAILED(status))
+        {
+            ACDB_ERR("Error[%d]: Unable to read file: %s", status, fname);
+        }
+        else if (bytes_read != in_mem_file->size)
+        {
+            status = AR_EBADPARAM;
+            ACDB_ERR("Error[%d]: File size does not match "
+                "the number of bytes read: %s", status, fname);
+        }
+
+        if (AR_FAILED(status))
+        {
+            ACDB_FREE(in_mem_file->buffer);
+            in_mem_file->buffer = NULL;
+            in_mem_file->size = 0;
+        }
     }
 
     return status;
@@ -57,6 +85,8 @@ int32_t AcbdInitLoadInMemFile(const char_t* fname, ar_fhandle fhandle, acdb_buff
 
 int32_t AcbdInitUnloadInMemFile(acdb_buffer_t* in_mem_file)
 {
+    int32_t status = AR_EUNSUPPORTED;
+
     if (IsNull(in_mem_file))
     {
         ACDB_ERR("Error[%d]: in_mem_file pointer is null", AR_EBADPARAM);
@@ -65,10 +95,13 @@ int32_t AcbdInitUnloadInMemFile(acdb_buffer_t* in_mem_file)
 
     in_mem_file->size = 0;
 
-    int32_t status = ar_funmap(in_mem_file->buffer);
+#ifdef ACDB_LOAD_FILE_MAPPED
+    status = ar_funmap(in_mem_file->buffer);
+#endif
     if (AR_EUNSUPPORTED == status)
     {
         ACDB_FREE(in_mem_file->buffer);
+        status = AR_EOK;
     }
     else if (AR_FAILED(status))
     {
@@ -186,7 +219,6 @@ int32_t AcdbInitUtilGetFileData(const char_t* fname, ar_fhandle* fhandle,
     acdb_buffer_t *in_mem_file)
 {
     int32_t status = AR_EOK;
-    size_t bytes_read = 0;
 
     if (IsNull(fname) || IsNull(in_mem_file))
     {
@@ -213,27 +245,6 @@ int32_t AcdbInitUtilGetFileData(const char_t* fname, ar_fhandle* fhandle,
     if (AR_FAILED(status))
     {
         ACDB_ERR("ERROR[%d]: Failed to load in_mem_file %s", status, fname);
-        return status;
-    }
-
-    status = ar_fread(*fhandle, in_mem_file->buffer, in_mem_file->size, &bytes_read);
-    if (AR_FAILED(status))
-    {
-        ACDB_ERR("Error[%d]: Unable to read file: %s", status, fname);
-        goto end;
-    }
-
-    if (bytes_read != in_mem_file->size)
-    {
-        status = AR_EBADPARAM;
-        ACDB_ERR("Error[%d]: File size does not match "
-            "the number of bytes read: %s", status, fname);
-    }
-
-end:
-    if (AR_FAILED(status))
-    {
-        AcbdInitUnloadInMemFile(in_mem_file);
     }
 
     return status;
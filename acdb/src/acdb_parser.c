@@ -56,6 +56,11 @@ typedef struct acdb_chunk_header_t
 	uint32_t size;
 }acdb_chunk_header_t;
 
+/* Multiplicative hash, chunk IDs are four character codes that differ in a
+ * single byte so the low bits alone do not spread them */
+#define ACDB_CHUNK_INDEX_HASH(index, id) \
+    ((uint32_t)((id) * 0x9E3779B1u) >> (index)->shift)
+
 /* ---------------------------------------------------------------------------
 * Static Function Declarations and Definitions
 *--------------------------------------------------------------------------- */
@@ -112,6 +117,128 @@ int32_t acdb_parser_get_chunk(
     return status;
 }
 
+int32_t acdb_parser_create_chunk_index(
+    void* file_buffer, uint32_t buffer_length, acdb_chunk_index_t **index)
+{
+    uint8_t *start_ptr = NULL;
+    uint8_t *end_ptr = NULL;
+    acdb_chunk_header_t *header = NULL;
+    acdb_chunk_index_t *new_index = NULL;
+    acdb_chunk_index_entry_t *entry = NULL;
+    uint32_t num_chunks = 0;
+    uint32_t num_entries = ACDB_CHUNK_INDEX_MIN_ENTRIES;
+    uint32_t shift = 32;
+    uint32_t i = 0;
+    int32_t miss_status = AR_ENOTEXIST;
+
+    if (file_buffer == NULL || index == NULL ||
+        buffer_length < sizeof(acdb_file_properties_t))
+    {
+        return AR_EBADPARAM;
+    }
+
+    start_ptr = (uint8_t*)file_buffer + sizeof(acdb_file_properties_t);
+    end_ptr = (uint8_t*)file_buffer + buffer_length;
+
+    /* Count the chunks the linear walk can reach. A lookup that misses the
+     * index fails the same way the walk fails past the last of them */
+    while (start_ptr < end_ptr)
+    {
+        header = (acdb_chunk_header_t*)start_ptr;
+        if (start_ptr + sizeof(acdb_chunk_header_t) > end_ptr ||
+            header->size == 0 ||
+            header->size > (uint32_t)(end_ptr - start_ptr - sizeof(acdb_chunk_header_t)))
+        {
+            miss_status = AR_EFAILED;
+            break;
+        }
+
+        num_chunks++;
+        start_ptr += sizeof(acdb_chunk_header_t) + header->size;
+    }
+
+    /* At most half full so probe sequences stay short */
+    while (num_entries < 2 * num_chunks)
+        num_entries <<= 1;
+    for (i = num_entries; i > 1; i >>= 1)
+        shift--;
+
+    new_index = (acdb_chunk_index_t*)ACDB_MALLOC(uint8_t,
+        sizeof(acdb_chunk_index_t)
+        + num_entries * sizeof(acdb_chunk_index_entry_t));
+    if (IsNull(new_index))
+        return AR_ENOMEMORY;
+
+    new_index->mask = num_entries - 1;
+    new_index->shift = shift;
+    new_index->miss_status = miss_status;
+    new_index->entries = (acdb_chunk_index_entry_t*)(new_index + 1);
+    ar_mem_set(new_index->entries, 0,
+        num_entries * sizeof(acdb_chunk_index_entry_t));
+
+    start_ptr = (uint8_t*)file_buffer + sizeof(acdb_file_properties_t);
+    for (i = 0; i < num_chunks; i++)
+    {
+        header = (acdb_chunk_header_t*)start_ptr;
+        entry = &new_index->entries[
+            ACDB_CHUNK_INDEX_HASH(new_index, header->id)];
+
+        /* Empty entries have a size of 0, which no indexed chunk has */
+        while (entry->size != 0 && entry->id != header->id)
+        {
+            entry = &new_index->entries[
+                (entry - new_index->entries + 1) & new_index->mask];
+        }
+
+        /* The walk returns the first chunk with a given ID, keep that one */
+        if (entry->size == 0)
+        {
+            entry->id = header->id;
+            entry->offset = (uint32_t)(start_ptr
+                - (uint8_t*)file_buffer + sizeof(acdb_chunk_header_t));
+            entry->size = header->size;
+        }
+
+        start_ptr += sizeof(acdb_chunk_header_t) + header->size;
+    }
+
+    *index = new_index;
+    return AR_EOK;
+}
+
+int32_t acdb_parser_get_indexed_chunk(acdb_chunk_index_t *index,
+    uint32_t chunk_id, uint32_t *chunk_offset, uint32_t *chunk_size)
+{
+    acdb_chunk_index_entry_t *entry = NULL;
+    uint32_t slot = 0;
+
+    if (index == NULL || chunk_offset == NULL || chunk_size == NULL)
+    {
+        return AR_EBADPARAM;
+    }
+
+    slot = ACDB_CHUNK_INDEX_HASH(index, chunk_id);
+    for (entry = &index->entries[slot]; entry->size != 0;
+        entry = &index->entries[slot])
+    {
+        if (entry->id == chunk_id)
+        {
+            *chunk_offset = entry->offset;
+            *chunk_size = entry->size;
+            return AR_EOK;
+        }
+        slot = (slot + 1) & index->mask;
+    }
+
+    return index->miss_status;
+}
+
+void acdb_parser_free_chunk_index(acdb_chunk_index_t *index)
+{
+    if (!IsNull(index))
+        ACDB_FREE(index);
+}
+
 int32_t acdb_parser_validate_file(acdb_buffer_t *in_mem_file)
 {
 	int32_t status = AR_EOK;
@@ -18,8 +18,16 @@
 
 #include "acdb_utility.h"
 #include "acdb_common.h"
+#include "ar_osal_atomic.h"
 //#include <stdarg.h>
 
+/* ---------------------------------------------------------------------------
+* Preprocessor Definitions and Constants
+*--------------------------------------------------------------------------- */
+
+/**< Number of released scratch spaces kept for reuse by later commands */
+#define ACDB_SCRATCH_CACHE_SIZE 4
+
 /* ---------------------------------------------------------------------------
 * Globals
 *--------------------------------------------------------------------------- */
@@ -32,6 +40,29 @@ static ar_heap_info glb_ar_heap_info =
 	AR_HEAP_TAG_DEFAULT
  };
 
+/**< Scratch space of the client command running on this thread */
+static ACDB_THREAD_LOCAL AcdbScratch *acdb_thread_scratch;
+
+/**< Scratch spaces released by finished commands. The cache is shared
+* rather than thread local since a thread local cache would leak when its
+* thread exits */
+static void *volatile acdb_scratch_cache[ACDB_SCRATCH_CACHE_SIZE];
+
+/**< Scratch space used outside of client commands */
+static uint32_t acdb_default_buf_1[GLB_BUF_1_LENGTH];
+static uint32_t acdb_default_buf_2[GLB_BUF_2_LENGTH];
+static uint32_t acdb_default_buf_3[GLB_BUF_3_LENGTH];
+static AcdbScratch acdb_default_scratch =
+{
+    acdb_default_buf_1,
+    acdb_default_buf_2,
+    acdb_default_buf_3,
+    GLB_BUF_1_LENGTH,
+    GLB_BUF_2_LENGTH,
+    GLB_BUF_3_LENGTH,
+    0
+};
+
 /* ---------------------------------------------------------------------------
 * Functions
 *--------------------------------------------------------------------------- */
@@ -254,65 +285,164 @@ int32_t AcdbDataBinarySearch2(void *p_array, size_t sz_arr, void *p_cmd,
 	return result;
 }
 
-void AcdbSort(void* p_array, uint32_t sz_arr)
+static void AcdbSortCopyElem(uint32_t *dst, const uint32_t *src,
+	uint32_t elem_words)
 {
-	//insertion sort
+	for (uint32_t i = 0; i < elem_words; i++)
+		dst[i] = src[i];
+}
 
-	uint32_t* lst = (uint32_t*)p_array;
-	uint32_t tmp = 0;
-	int32_t j = 0;
-	uint32_t elem_count = sz_arr / sizeof(uint32_t);
+/* Stable insertion sort of elem_count elements of elem_words words each.
+ * tmp_elem holds one element */
+static void AcdbSortInsertion(uint32_t *lst, uint32_t elem_count,
+	uint32_t elem_words, uint32_t key_elem_pos, uint32_t *tmp_elem)
+{
+	uint32_t key = 0;
+	uint32_t j = 0;
 
-	for (uint32_t i = 0; i + 1UL < elem_count; i++)
+	for (uint32_t i = 1; i < elem_count; i++)
 	{
-		j = i;
-		while (j > -1)
+		key = lst[i * elem_words + key_elem_pos];
+		if (lst[(i - 1) * elem_words + key_elem_pos] <= key)
+			continue;
+
+		AcdbSortCopyElem(tmp_elem, &lst[i * elem_words], elem_words);
+		for (j = i; j > 0 &&
+			lst[(j - 1) * elem_words + key_elem_pos] > key; j--)
 		{
-			if (lst[j] > lst[j + 1])
-			{
-				tmp = lst[j];
-				lst[j] = lst[j + 1];
-				lst[j + 1] = tmp;
-			}
-			j--;
+			AcdbSortCopyElem(&lst[j * elem_words],
+				&lst[(j - 1) * elem_words], elem_words);
 		}
+		AcdbSortCopyElem(&lst[j * elem_words], tmp_elem, elem_words);
+	}
+}
+
+/* Stable merge of the sorted runs [lo, mid) and [mid, hi) of src into the
+ * same positions of dst */
+static void AcdbSortMerge(uint32_t *dst, const uint32_t *src,
+	uint32_t lo, uint32_t mid, uint32_t hi,
+	uint32_t elem_words, uint32_t key_elem_pos)
+{
+	uint32_t i = lo;
+	uint32_t j = mid;
+	uint32_t k = lo;
+
+	/* Runs that are already in order are copied as they are */
+	if (mid < hi && src[(mid - 1) * elem_words + key_elem_pos]
+		> src[mid * elem_words + key_elem_pos])
+	{
+		while (i < mid && j < hi)
+		{
+			if (src[j * elem_words + key_elem_pos]
+				< src[i * elem_words + key_elem_pos])
+				AcdbSortCopyElem(&dst[k++ * elem_words],
+					&src[j++ * elem_words], elem_words);
+			else
+				AcdbSortCopyElem(&dst[k++ * elem_words],
+					&src[i++ * elem_words], elem_words);
+		}
+	}
+
+	if (i < mid)
+	{
+		ACDB_MEM_CPY_SAFE(&dst[k * elem_words],
+			(mid - i) * elem_words * sizeof(uint32_t),
+			&src[i * elem_words], (mid - i) * elem_words * sizeof(uint32_t));
+		k += mid - i;
+	}
+
+	if (j < hi)
+	{
+		ACDB_MEM_CPY_SAFE(&dst[k * elem_words],
+			(hi - j) * elem_words * sizeof(uint32_t),
+			&src[j * elem_words], (hi - j) * elem_words * sizeof(uint32_t));
 	}
 }
 
+void AcdbSort(void* p_array, uint32_t sz_arr)
+{
+	(void)AcdbSort2(sz_arr, p_array, sizeof(uint32_t), 0);
+}
+
 int32_t AcdbSort2(size_t sz_arr, void* p_array, size_t sz_elem, uint32_t key_elem_pos)
 {
-	if (IsNull(p_array) || sz_arr == 0 || sz_elem == 0 || sz_arr < sz_elem)
+	uint32_t stack_elem[ACDB_SORT_MAX_STACK_ELEM_WORDS];
+	uint32_t *lst = (uint32_t*)p_array;
+	uint32_t *buf = NULL;
+	uint32_t *src = NULL;
+	uint32_t *dst = NULL;
+	uint32_t *tmp = NULL;
+	uint32_t elem_count = 0;
+	uint32_t elem_words = 0;
+	uint32_t run = 0;
+	uint32_t lo = 0;
+	uint32_t mid = 0;
+	uint32_t hi = 0;
+
+	if (IsNull(p_array) || sz_arr == 0 || sz_elem == 0 || sz_arr < sz_elem ||
+		sz_elem % sizeof(uint32_t) != 0 ||
+		key_elem_pos >= sz_elem / sizeof(uint32_t))
 		return AR_EBADPARAM;
 
-	if (1 == sz_arr / sz_elem) return AR_EOK;
+	elem_count = (uint32_t)(sz_arr / sz_elem);
+	elem_words = (uint32_t)(sz_elem / sizeof(uint32_t));
+
+	if (1 == elem_count) return AR_EOK;
+
+	if (elem_count <= ACDB_SORT_RUN_LENGTH)
+	{
+		if (elem_words <= ACDB_SORT_MAX_STACK_ELEM_WORDS)
+		{
+			AcdbSortInsertion(lst, elem_count, elem_words,
+				key_elem_pos, stack_elem);
+			return AR_EOK;
+		}
+
+		tmp = ACDB_MALLOC(uint32_t, elem_words);
+		if (IsNull(tmp)) return AR_ENOMEMORY;
+
+		AcdbSortInsertion(lst, elem_count, elem_words, key_elem_pos, tmp);
+		ACDB_FREE(tmp);
+		return AR_EOK;
+	}
 
-	uint32_t* lst = (uint32_t*)p_array;
-	uint32_t elem_count = (uint32_t)sz_arr / (uint32_t)sz_elem;
-	int32_t elem_member_count = (uint32_t)sz_elem / sizeof(uint32_t);
-	int32_t lst_len = elem_count * elem_member_count;
-    uint32_t *tmp_elem = ACDB_MALLOC(uint32_t, elem_member_count);
-	int32_t j = 0;
+	buf = ACDB_MALLOC(uint32_t, elem_count * elem_words);
+	if (IsNull(buf)) return AR_ENOMEMORY;
 
-	if (IsNull(tmp_elem)) return AR_ENOMEMORY;
+	/* The merge buffer is unused until the runs are sorted */
+	for (lo = 0; lo < elem_count; lo += ACDB_SORT_RUN_LENGTH)
+	{
+		hi = lo + ACDB_SORT_RUN_LENGTH;
+		if (hi > elem_count)
+			hi = elem_count;
 
-	for (int32_t i = 0; i < lst_len - elem_member_count; i += elem_member_count)
+		AcdbSortInsertion(&lst[lo * elem_words], hi - lo, elem_words,
+			key_elem_pos, buf);
+	}
+
+	src = lst;
+	dst = buf;
+	for (run = ACDB_SORT_RUN_LENGTH; run < elem_count; run *= 2)
 	{
-		j = i;
-		while (j > -1)
+		for (lo = 0; lo < elem_count; lo += 2 * run)
 		{
-			uint32_t a = lst[j + key_elem_pos];
-			uint32_t b = lst[j + key_elem_pos + elem_member_count];
-			if (a > b)
-			{
-				ACDB_MEM_CPY_SAFE((void*)tmp_elem, sz_elem, &lst[j], sz_elem);
-				ACDB_MEM_CPY_SAFE(&lst[j], sz_elem, &lst[j + elem_member_count], sz_elem);
-				ACDB_MEM_CPY_SAFE(&lst[j + elem_member_count], sz_elem, tmp_elem, sz_elem);
-			}
-			j -= elem_member_count;
+			mid = (run < elem_count - lo) ? lo + run : elem_count;
+			hi = (2 * run < elem_count - lo) ? lo + 2 * run : elem_count;
+			AcdbSortMerge(dst, src, lo, mid, hi, elem_words, key_elem_pos);
 		}
+
+		tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	if (src != lst)
+	{
+		ACDB_MEM_CPY_SAFE(lst, sz_arr, src,
+			(size_t)elem_count * elem_words * sizeof(uint32_t));
 	}
 
-	ACDB_FREE(tmp_elem);
+	ACDB_FREE(buf);
 	return AR_EOK;
 }
 
@@ -725,3 +855,162 @@ int32_t AcdbGenericListInit(AcdbGenericList* list, uint32_t element_size, uint32
 
 	return AR_EOK;
 }
+
+/**
+* \brief AcdbScratchCacheTake
+*		Takes a scratch space from the cache
+* \return A cached scratch space or NULL if the cache is empty
+*/
+static AcdbScratch *AcdbScratchCacheTake(void)
+{
+    void *scratch = NULL;
+
+    for (uint32_t i = 0; i < ACDB_SCRATCH_CACHE_SIZE; i++)
+    {
+        scratch = ar_osal_atomic_load_ptr(&acdb_scratch_cache[i]);
+        if (!IsNull(scratch) && ar_osal_atomic_cmpxchg_ptr(
+            &acdb_scratch_cache[i], &scratch, NULL))
+            return (AcdbScratch*)scratch;
+    }
+
+    return NULL;
+}
+
+/**
+* \brief AcdbScratchCachePut
+*		Returns a scratch space to the cache
+* \param [in] scratch: The scratch space to cache
+* \return TRUE if the scratch space was cached, FALSE if the cache is full
+*/
+static bool_t AcdbScratchCachePut(AcdbScratch *scratch)
+{
+    void *empty = NULL;
+
+    for (uint32_t i = 0; i < ACDB_SCRATCH_CACHE_SIZE; i++)
+    {
+        empty = NULL;
+        if (ar_osal_atomic_cmpxchg_ptr(
+            &acdb_scratch_cache[i], &empty, scratch))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+int32_t AcdbScratchAcquire(uint32_t key_count)
+{
+    AcdbScratch *scratch = acdb_thread_scratch;
+    uint32_t kv_length = ACDB_SCRATCH_KEY_VECTOR_LENGTH(key_count);
+    uint32_t buf_1_length = GLB_BUF_1_LENGTH;
+    uint32_t buf_2_length = GLB_BUF_2_LENGTH;
+    uint32_t buf_3_length = GLB_BUF_3_LENGTH;
+
+    if (!IsNull(scratch))
+    {
+        /* The outer command may hold pointers into the buffers, so they
+         * cannot be reallocated */
+        if (kv_length > scratch->buf_3_length)
+        {
+            ACDB_ERR("Error[%d]: The key vector length %d exceeds the "
+                "scratch space of the current command",
+                AR_ENEEDMORE, key_count);
+            return AR_ENEEDMORE;
+        }
+
+        scratch->ref_count++;
+        return AR_EOK;
+    }
+
+    if (kv_length > buf_1_length)
+        buf_1_length = kv_length;
+    if (kv_length > buf_2_length)
+        buf_2_length = kv_length;
+    if (kv_length > buf_3_length)
+        buf_3_length = kv_length;
+
+    scratch = AcdbScratchCacheTake();
+    if (!IsNull(scratch))
+    {
+        if (scratch->buf_1_length >= buf_1_length &&
+            scratch->buf_2_length >= buf_2_length &&
+            scratch->buf_3_length >= buf_3_length)
+        {
+            scratch->ref_count = 1;
+            scratch->hinted_fill = FALSE;
+            acdb_thread_scratch = scratch;
+            return AR_EOK;
+        }
+
+        /* Too small for this command, replace it with a larger one */
+        AcdbFree(scratch);
+    }
+
+    /* One allocation holding the header followed by the three buffers */
+    scratch = (AcdbScratch*)AcdbMalloc(sizeof(AcdbScratch) +
+        (size_t)(buf_1_length + buf_2_length + buf_3_length)
+        * sizeof(uint32_t));
+    if (IsNull(scratch))
+    {
+        ACDB_ERR("Error[%d]: Unable to allocate scratch buffers",
+            AR_ENOMEMORY);
+        return AR_ENOMEMORY;
+    }
+
+    scratch->buf_1 = (uint32_t*)(scratch + 1);
+    scratch->buf_2 = scratch->buf_1 + buf_1_length;
+    scratch->buf_3 = scratch->buf_2 + buf_2_length;
+    scratch->buf_1_length = buf_1_length;
+    scratch->buf_2_length = buf_2_length;
+    scratch->buf_3_length = buf_3_length;
+    scratch->ref_count = 1;
+    scratch->hinted_fill = FALSE;
+
+    acdb_thread_scratch = scratch;
+    return AR_EOK;
+}
+
+void AcdbScratchRelease(void)
+{
+    AcdbScratch *scratch = acdb_thread_scratch;
+
+    if (IsNull(scratch) || --scratch->ref_count > 0)
+        return;
+
+    acdb_thread_scratch = NULL;
+    if (!AcdbScratchCachePut(scratch))
+        AcdbFree(scratch);
+}
+
+void AcdbScratchFreeCache(void)
+{
+    AcdbScratch *scratch = AcdbScratchCacheTake();
+
+    while (!IsNull(scratch))
+    {
+        AcdbFree(scratch);
+        scratch = AcdbScratchCacheTake();
+    }
+}
+
+AcdbScratch *AcdbScratchGet(void)
+{
+    if (IsNull(acdb_thread_scratch))
+        return &acdb_default_scratch;
+
+    return acdb_thread_scratch;
+}
+
+void AcdbScratchClear(uint32_t *buf)
+{
+    AcdbScratch *scratch = AcdbScratchGet();
+    uint32_t length = 0;
+
+    if (buf == scratch->buf_1)
+        length = scratch->buf_1_length;
+    else if (buf == scratch->buf_2)
+        length = scratch->buf_2_length;
+    else if (buf == scratch->buf_3)
+        length = scratch->buf_3_length;
+
+    ar_mem_set(buf, 0, length * sizeof(uint32_t));
+}
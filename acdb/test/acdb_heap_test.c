@@ -0,0 +1,287 @@
+/**
+*=============================================================================
+* \file acdb_heap_test.c
+*
+* \brief
+*		Test of the delta data heap, the AVL tree of key vector maps. Maps
+*		of random calibration key vectors are added and removed in a random
+*		order. After every few operations the tree is walked to check that
+*		it is ordered, balanced, that the stored depths and parent links are
+*		right and that exactly the added key vectors can be found.
+*
+* \copyright
+*  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+*  SPDX-License-Identifier: BSD-3-Clause
+*
+*=============================================================================
+*/
+
+/* ---------------------------------------------------------------------------
+* Include Files
+*--------------------------------------------------------------------------- */
+
+#include <stdio.h>
+/* built into the test to reach the heap info behind the handle */
+#include "../src/acdb_heap.c"
+
+/* ---------------------------------------------------------------------------
+* Preprocessor Definitions and Constants
+*--------------------------------------------------------------------------- */
+
+/**< Number of distinct key vectors that may be in the tree */
+#define HEAP_TEST_NUM_KVS (1024)
+
+/**< Number of add or remove operations */
+#define HEAP_TEST_NUM_OPS (50000)
+
+/**< The tree is checked every HEAP_TEST_CHECK_INTERVAL operations */
+#define HEAP_TEST_CHECK_INTERVAL (64)
+
+#define HEAP_TEST_MAX_KEYS (4)
+
+/* ---------------------------------------------------------------------------
+* Globals
+*--------------------------------------------------------------------------- */
+
+static AcdbKeyValuePair heap_test_kvps[HEAP_TEST_NUM_KVS][HEAP_TEST_MAX_KEYS];
+static AcdbGraphKeyVector heap_test_kvs[HEAP_TEST_NUM_KVS];
+static bool_t heap_test_in_tree[HEAP_TEST_NUM_KVS];
+
+static uint32_t heap_test_rnd = 0x12345678;
+
+/* ---------------------------------------------------------------------------
+* Functions
+*--------------------------------------------------------------------------- */
+
+static uint32_t heap_test_next(void)
+{
+	heap_test_rnd ^= heap_test_rnd << 13;
+	heap_test_rnd ^= heap_test_rnd >> 17;
+	heap_test_rnd ^= heap_test_rnd << 5;
+	return heap_test_rnd;
+}
+
+/* Creates a map owning a copy of a key vector, like the delta parser does */
+static acdb_delta_data_map_t *heap_test_create_map(
+	const AcdbGraphKeyVector *key_vector)
+{
+	acdb_delta_data_map_t *map = ACDB_MALLOC(acdb_delta_data_map_t, 1);
+	AcdbGraphKeyVector *map_kv = ACDB_MALLOC(AcdbGraphKeyVector, 1);
+	uint32_t sz_kvps = key_vector->num_keys * sizeof(AcdbKeyValuePair);
+
+	if (IsNull(map) || IsNull(map_kv))
+	{
+		ACDB_FREE(map);
+		ACDB_FREE(map_kv);
+		return NULL;
+	}
+
+	ar_mem_set(map, 0, sizeof(acdb_delta_data_map_t));
+	map_kv->num_keys = key_vector->num_keys;
+	map_kv->graph_key_vector = ACDB_MALLOC(AcdbKeyValuePair,
+		key_vector->num_keys);
+	if (IsNull(map_kv->graph_key_vector))
+	{
+		ACDB_FREE(map);
+		ACDB_FREE(map_kv);
+		return NULL;
+	}
+
+	ACDB_MEM_CPY_SAFE(map_kv->graph_key_vector, sz_kvps,
+		key_vector->graph_key_vector, sz_kvps);
+	map->key_vector_type = CAL_KEY_VECTOR;
+	map->key_vector_data = map_kv;
+	return map;
+}
+
+/**
+* \brief
+*		Checks the subtree under tnode and counts its nodes
+*
+* \param[in] prev: The key vector of the node before the subtree in order
+*
+* \return The depth of the subtree, or -1 if it is not a valid AVL tree
+*/
+static int32_t heap_test_check_tree(AcdbTreeNode *tnode, AcdbTreeNode *parent,
+	const AcdbGraphKeyVector **prev, uint32_t *count)
+{
+	int32_t left = 0;
+	int32_t right = 0;
+	int32_t depth = 0;
+	const AcdbGraphKeyVector *kv = NULL;
+
+	if (IsNull(tnode))
+		return 0;
+
+	if (tnode->parent != parent)
+	{
+		printf("parent link is wrong\n");
+		return -1;
+	}
+
+	left = heap_test_check_tree(tnode->left, tnode, prev, count);
+	if (left < 0)
+		return -1;
+
+	kv = &((KVSubgraphMapBin*)tnode->p_struct)->key_vector;
+	if (!IsNull(*prev) && acdb_heap_compare_key_vectors(*prev, kv) >= 0)
+	{
+		printf("key vectors are out of order\n");
+		return -1;
+	}
+	*prev = kv;
+	(*count)++;
+
+	right = heap_test_check_tree(tnode->right, tnode, prev, count);
+	if (right < 0)
+		return -1;
+
+	depth = 1 + (left > right ? left : right);
+	if (tnode->depth != depth)
+	{
+		printf("stored depth %d, actual depth %d\n", tnode->depth, depth);
+		return -1;
+	}
+
+	if (left - right > 1 || right - left > 1)
+	{
+		printf("subtree depths %d and %d are unbalanced\n", left, right);
+		return -1;
+	}
+
+	return depth;
+}
+
+/* Checks the whole tree and that exactly the added key vectors are found */
+static int32_t heap_test_check(acdb_heap_handle_t handle, uint32_t num_in_tree)
+{
+	const AcdbGraphKeyVector *prev = NULL;
+	AcdbTreeNode *tnode = NULL;
+	uint32_t count = 0;
+	int32_t status = AR_EOK;
+
+	if (heap_test_check_tree(((AcdbHeapInfo*)handle)->root, NULL,
+		&prev, &count) < 0)
+		return AR_EFAILED;
+
+	if (count != num_in_tree)
+	{
+		printf("%u nodes in the tree, expected %u\n", count, num_in_tree);
+		return AR_EFAILED;
+	}
+
+	for (uint32_t i = 0; i < HEAP_TEST_NUM_KVS; i++)
+	{
+		status = acdb_heap_get_node(handle, &heap_test_kvs[i], &tnode);
+		if (heap_test_in_tree[i] != AR_SUCCEEDED(status))
+		{
+			printf("key vector %u is %s\n", i, heap_test_in_tree[i] ?
+				"missing" : "found after it was removed");
+			return AR_EFAILED;
+		}
+	}
+
+	return AR_EOK;
+}
+
+/* Creates distinct key vectors of 1 to HEAP_TEST_MAX_KEYS keys */
+static void heap_test_create_kvs(void)
+{
+	uint32_t num_kvs = 0;
+
+	while (num_kvs < HEAP_TEST_NUM_KVS)
+	{
+		AcdbGraphKeyVector *kv = &heap_test_kvs[num_kvs];
+		bool_t is_new = TRUE;
+
+		kv->num_keys = 1 + heap_test_next() % HEAP_TEST_MAX_KEYS;
+		kv->graph_key_vector = heap_test_kvps[num_kvs];
+		for (uint32_t i = 0; i < kv->num_keys; i++)
+		{
+			kv->graph_key_vector[i].key = 0xA0000000 + i * 0x100 +
+				heap_test_next() % 2;
+			kv->graph_key_vector[i].value = heap_test_next() % 8;
+		}
+
+		for (uint32_t i = 0; i < num_kvs && is_new; i++)
+			is_new = acdb_heap_compare_key_vectors(kv, &heap_test_kvs[i]) != 0;
+
+		if (is_new)
+			num_kvs++;
+	}
+}
+
+int main(void)
+{
+	acdb_heap_handle_t handle = NULL;
+	acdb_heap_map_handle_info_t info = { 0 };
+	uint32_t vm_id = 0;
+	uint32_t num_in_tree = 0;
+	uint32_t i = 0;
+	int32_t status = AR_EOK;
+
+	heap_test_create_kvs();
+
+	status = acdb_heap_ioctl(ACDB_HEAP_CMD_INIT, NULL, 0, NULL, 0);
+	if (AR_SUCCEEDED(status))
+		status = acdb_heap_ioctl(ACDB_HEAP_CMD_ADD_DATABASE,
+			&vm_id, sizeof(vm_id), &handle, sizeof(handle));
+	if (AR_FAILED(status))
+	{
+		printf("heap init failed %d\n", status);
+		return 1;
+	}
+
+	info.handle = handle;
+	for (uint32_t op = 0; op < HEAP_TEST_NUM_OPS && AR_SUCCEEDED(status); op++)
+	{
+		i = heap_test_next() % HEAP_TEST_NUM_KVS;
+
+		if (heap_test_in_tree[i])
+		{
+			status = acdb_heap_remove(handle, &heap_test_kvs[i]);
+			heap_test_in_tree[i] = FALSE;
+			num_in_tree--;
+		}
+		else
+		{
+			info.map = heap_test_create_map(&heap_test_kvs[i]);
+			status = IsNull(info.map) ? AR_ENOMEMORY :
+				acdb_heap_ioctl(ACDB_HEAP_CMD_ADD_MAP_USING_HANDLE,
+					&info, sizeof(info), NULL, 0);
+			heap_test_in_tree[i] = TRUE;
+			num_in_tree++;
+		}
+
+		if (AR_FAILED(status))
+			printf("operation %u on key vector %u failed %d\n", op, i, status);
+		else if (op % HEAP_TEST_CHECK_INTERVAL == 0)
+			status = heap_test_check(handle, num_in_tree);
+	}
+
+	/* Empty the tree, then the removed nodes must all be gone */
+	for (i = 0; i < HEAP_TEST_NUM_KVS && AR_SUCCEEDED(status); i++)
+	{
+		if (!heap_test_in_tree[i])
+			continue;
+
+		status = acdb_heap_remove(handle, &heap_test_kvs[i]);
+		heap_test_in_tree[i] = FALSE;
+		num_in_tree--;
+		if (AR_SUCCEEDED(status) && i % HEAP_TEST_CHECK_INTERVAL == 0)
+			status = heap_test_check(handle, num_in_tree);
+	}
+
+	if (AR_SUCCEEDED(status) && !IsNull(((AcdbHeapInfo*)handle)->root))
+	{
+		printf("the tree is not empty\n");
+		status = AR_EFAILED;
+	}
+
+	acdb_heap_ioctl(ACDB_HEAP_CMD_REMOVE_DATABASE,
+		handle, sizeof(handle), NULL, 0);
+
+	printf("%u add/remove operations: %s\n", HEAP_TEST_NUM_OPS,
+		AR_SUCCEEDED(status) ? "PASSED" : "FAILED");
+	return AR_SUCCEEDED(status) ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+/**
+*=============================================================================
+* \file acdb_sort_bench.c
+*
+* \brief
+*		Benchmark of AcdbSort2 against the insertion sort it replaced. Key
+*		vectors (key ID + value pairs sorted on the key ID) of growing length
+*		are sorted by both, the results are checked to be equal and the time
+*		per sort is reported.
+*
+* \copyright
+*  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+*  SPDX-License-Identifier: BSD-3-Clause
+*
+*=============================================================================
+*/
+
+/* ---------------------------------------------------------------------------
+* Include Files
+*--------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include "acdb_utility.h"
+#include "ar_osal_timer.h"
+
+/* ---------------------------------------------------------------------------
+* Preprocessor Definitions and Constants
+*--------------------------------------------------------------------------- */
+
+/**< Total number of elements sorted for each list length */
+#define SORT_BENCH_ELEMENTS (1 << 20)
+
+#define SORT_BENCH_MAX_KEYS (4096)
+
+/* ---------------------------------------------------------------------------
+* Globals
+*--------------------------------------------------------------------------- */
+
+static const uint32_t sort_bench_num_keys[] = { 4, 8, 16, 64, 256, 1024, SORT_BENCH_MAX_KEYS };
+
+static AcdbKeyValuePair sort_bench_input[SORT_BENCH_MAX_KEYS];
+static AcdbKeyValuePair sort_bench_list[SORT_BENCH_MAX_KEYS];
+static AcdbKeyValuePair sort_bench_expected[SORT_BENCH_MAX_KEYS];
+
+static uint32_t sort_bench_rnd = 0x12345678;
+
+/* ---------------------------------------------------------------------------
+* Functions
+*--------------------------------------------------------------------------- */
+
+/* The insertion sort AcdbSort2 used before, kept as the reference */
+static int32_t sort_bench_insertion_sort(size_t sz_arr, void* p_array,
+	size_t sz_elem, uint32_t key_elem_pos)
+{
+	if (IsNull(p_array) || sz_arr == 0 || sz_elem == 0 || sz_arr < sz_elem)
+		return AR_EBADPARAM;
+
+	if (1 == sz_arr / sz_elem) return AR_EOK;
+
+	uint32_t* lst = (uint32_t*)p_array;
+	uint32_t elem_count = (uint32_t)sz_arr / (uint32_t)sz_elem;
+	int32_t elem_member_count = (uint32_t)sz_elem / sizeof(uint32_t);
+	int32_t lst_len = elem_count * elem_member_count;
+	uint32_t *tmp_elem = ACDB_MALLOC(uint32_t, elem_member_count);
+	int32_t j = 0;
+
+	if (IsNull(tmp_elem)) return AR_ENOMEMORY;
+
+	for (int32_t i = 0; i < lst_len - elem_member_count; i += elem_member_count)
+	{
+		j = i;
+		while (j > -1)
+		{
+			uint32_t a = lst[j + key_elem_pos];
+			uint32_t b = lst[j + key_elem_pos + elem_member_count];
+			if (a > b)
+			{
+				ACDB_MEM_CPY_SAFE((void*)tmp_elem, sz_elem, &lst[j], sz_elem);
+				ACDB_MEM_CPY_SAFE(&lst[j], sz_elem, &lst[j + elem_member_count], sz_elem);
+				ACDB_MEM_CPY_SAFE(&lst[j + elem_member_count], sz_elem, tmp_elem, sz_elem);
+			}
+			j -= elem_member_count;
+		}
+	}
+
+	ACDB_FREE(tmp_elem);
+	return AR_EOK;
+}
+
+static uint32_t sort_bench_next(void)
+{
+	sort_bench_rnd ^= sort_bench_rnd << 13;
+	sort_bench_rnd ^= sort_bench_rnd >> 17;
+	sort_bench_rnd ^= sort_bench_rnd << 5;
+	return sort_bench_rnd;
+}
+
+/* Sorts num_keys pairs repeatedly and gets back the ns per sort */
+static int32_t sort_bench_run(uint32_t num_keys, bool_t reference,
+	uint64_t *ns)
+{
+	uint32_t iterations = SORT_BENCH_ELEMENTS / num_keys;
+	uint32_t sz_list = num_keys * sizeof(AcdbKeyValuePair);
+	uint64_t start_us = 0;
+	int32_t status = AR_EOK;
+
+	/* The quadratic sort is given fewer rounds on long lists */
+	if (reference && num_keys > 256)
+		iterations = (iterations + 15) / 16;
+
+	/* Each round sorts a fresh copy of the input, the copy is timed with
+	 * both sorts */
+	start_us = ar_timer_get_time_in_us();
+	for (uint32_t i = 0; i < iterations && AR_SUCCEEDED(status); i++)
+	{
+		ACDB_MEM_CPY_SAFE(sort_bench_list, sz_list, sort_bench_input, sz_list);
+		status = reference ?
+			sort_bench_insertion_sort(sz_list, sort_bench_list,
+				sizeof(AcdbKeyValuePair), 0) :
+			AcdbSort2(sz_list, sort_bench_list,
+				sizeof(AcdbKeyValuePair), 0);
+	}
+
+	*ns = ((ar_timer_get_time_in_us() - start_us) * 1000) / iterations;
+	return status;
+}
+
+int main(void)
+{
+	int rc = 0;
+
+	for (uint32_t i = 0; i < sizeof(sort_bench_num_keys) / sizeof(sort_bench_num_keys[0]); i++)
+	{
+		uint32_t num_keys = sort_bench_num_keys[i];
+		uint32_t sz_list = num_keys * sizeof(AcdbKeyValuePair);
+		uint64_t reference_ns = 0;
+		uint64_t sort_ns = 0;
+		int32_t status = AR_EOK;
+
+		/* Few distinct key IDs so equal keys show whether the order of
+		 * equal elements is kept */
+		for (uint32_t j = 0; j < num_keys; j++)
+		{
+			sort_bench_input[j].key = sort_bench_next() % (num_keys / 2 + 1);
+			sort_bench_input[j].value = j;
+		}
+
+		status = sort_bench_run(num_keys, TRUE, &reference_ns);
+		ACDB_MEM_CPY_SAFE(sort_bench_expected, sz_list, sort_bench_list, sz_list);
+		if (AR_SUCCEEDED(status))
+			status = sort_bench_run(num_keys, FALSE, &sort_ns);
+
+		if (AR_FAILED(status) ||
+			0 != ar_mem_cmp(sort_bench_expected, sort_bench_list, sz_list))
+		{
+			printf("%u keys: FAILED\n", num_keys);
+			rc = 1;
+			continue;
+		}
+
+		printf("%u keys: insertion sort %llu ns, AcdbSort2 %llu ns per sort\n",
+			num_keys,
+			(unsigned long long)reference_ns,
+			(unsigned long long)sort_ns);
+	}
+
+	return rc;
+}
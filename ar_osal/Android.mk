@@ -31,7 +31,8 @@ LOCAL_C_INCLUDES += $(TARGET_OUT_HEADERS)/diag/include
 
 LOCAL_ADDITIONAL_DEPENDENCIES  := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
 
-LOCAL_SRC_FILES := src/linux/ar_osal_mutex.c \
+LOCAL_SRC_FILES := src/linux/ar_osal_atomic.c \
+                   src/linux/ar_osal_mutex.c \
                    src/linux/ar_osal_thread.c \
                    src/linux/ar_osal_signal.c \
                    src/linux/ar_osal_log.c \
@@ -0,0 +1,187 @@
+#ifndef AR_OSAL_ATOMIC_H
+#define AR_OSAL_ATOMIC_H
+
+/**
+ * \file ar_osal_atomic.h
+ * \brief
+ *      This file contains atomic operation APIs. All operations are
+ *      sequentially consistent and can be used to build lock free data
+ *      structures shared between threads.
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* =======================================================================
+INCLUDE FILES FOR MODULE
+========================================================================== */
+#include "ar_osal_types.h"
+
+/****************************************************************************
+** Atomic operations
+*****************************************************************************/
+
+/**
+  Atomically reads a 32 bit value.
+
+  @param[in] p: Pointer to the value.
+
+  @return
+  Current value.
+
+  @dependencies
+  None. @newpage
+*/
+uint32_t ar_osal_atomic_load_u32(volatile uint32_t *p);
+
+/**
+  Atomically writes a 32 bit value.
+
+  @param[in] p: Pointer to the value.
+  @param[in] val: Value to write.
+
+  @dependencies
+  None. @newpage
+*/
+void ar_osal_atomic_store_u32(volatile uint32_t *p, uint32_t val);
+
+/**
+  Atomically adds to a 32 bit value.
+
+  @param[in] p: Pointer to the value.
+  @param[in] val: Value to add.
+
+  @return
+  Value after the addition.
+
+  @dependencies
+  None. @newpage
+*/
+uint32_t ar_osal_atomic_add_u32(volatile uint32_t *p, uint32_t val);
+
+/**
+  Atomically subtracts from a 32 bit value.
+
+  @param[in] p: Pointer to the value.
+  @param[in] val: Value to subtract.
+
+  @return
+  Value after the subtraction.
+
+  @dependencies
+  None. @newpage
+*/
+uint32_t ar_osal_atomic_sub_u32(volatile uint32_t *p, uint32_t val);
+
+/**
+  Atomically compares a 32 bit value with an expected value and, if equal,
+  replaces it with a new value.
+
+  @param[in] p: Pointer to the value.
+  @param[in,out] expected: Expected value. Updated with the current value
+                           when the comparison fails.
+  @param[in] desired: Value to write if the comparison succeeds.
+
+  @return
+  TRUE -- Value was replaced
+  FALSE -- Value did not match expected
+
+  @dependencies
+  None. @newpage
+*/
+bool_t ar_osal_atomic_cmpxchg_u32(volatile uint32_t *p, uint32_t *expected,
+	uint32_t desired);
+
+/**
+  Atomically reads a 64 bit value.
+
+  @param[in] p: Pointer to the value, must be 8 byte aligned.
+
+  @return
+  Current value.
+
+  @dependencies
+  None. @newpage
+*/
+uint64_t ar_osal_atomic_load_u64(volatile uint64_t *p);
+
+/**
+  Atomically compares a 64 bit value with an expected value and, if equal,
+  replaces it with a new value.
+
+  @param[in] p: Pointer to the value, must be 8 byte aligned.
+  @param[in,out] expected: Expected value. Updated with the current value
+                           when the comparison fails.
+  @param[in] desired: Value to write if the comparison succeeds.
+
+  @return
+  TRUE -- Value was replaced
+  FALSE -- Value did not match expected
+
+  @dependencies
+  None. @newpage
+*/
+bool_t ar_osal_atomic_cmpxchg_u64(volatile uint64_t *p, uint64_t *expected,
+	uint64_t desired);
+
+/**
+  Atomically reads a pointer.
+
+  @param[in] p: Pointer to the pointer.
+
+  @return
+  Current pointer value.
+
+  @dependencies
+  None. @newpage
+*/
+void *ar_osal_atomic_load_ptr(void *volatile *p);
+
+/**
+  Atomically writes a pointer.
+
+  @param[in] p: Pointer to the pointer.
+  @param[in] val: Pointer value to write.
+
+  @dependencies
+  None. @newpage
+*/
+void ar_osal_atomic_store_ptr(void *volatile *p, void *val);
+
+/**
+  Atomically compares a pointer with an expected value and, if equal,
+  replaces it with a new value.
+
+  @param[in] p: Pointer to the pointer.
+  @param[in,out] expected: Expected pointer value. Updated with the current
+                           value when the comparison fails.
+  @param[in] desired: Pointer value to write if the comparison succeeds.
+
+  @return
+  TRUE -- Pointer was replaced
+  FALSE -- Pointer did not match expected
+
+  @dependencies
+  None. @newpage
+*/
+bool_t ar_osal_atomic_cmpxchg_ptr(void *volatile *p, void **expected,
+	void *desired);
+
+/**
+  Keeps memory accesses before the fence from being reordered with any
+  load or store after it, including plain non atomic ones.
+
+  @dependencies
+  None. @newpage
+*/
+void ar_osal_atomic_fence(void);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* #ifndef AR_OSAL_ATOMIC_H */
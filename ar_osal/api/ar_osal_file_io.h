@@ -63,6 +63,17 @@ typedef enum ar_fseek_reference {
     AR_FSEEK_CURRENT = 2
 } ar_fseek_reference_t ;
 
+typedef enum ar_fmap_advice {
+    /**
+     *The range will be accessed soon.
+     */
+    AR_FMAP_ADVICE_WILLNEED = 0,
+    /**
+     *The range will not be accessed soon, its memory can be released.
+     */
+    AR_FMAP_ADVICE_DONTNEED = 1
+} ar_fmap_advice_t;
+
 /**
  * \brief ar_fopen
  *        open a file or create if does not exist. 
@@ -128,10 +139,35 @@ int32_t ar_fmap(ar_fhandle handle,
  * 
  * \return
  *  0 -- Success
+ *  AR_EUNSUPPORTED -- fbuffer is not a mapping made by ar_fmap
  *  Nonzero -- Failure
  */
 int32_t ar_funmap(const void *fbuffer);
 
+/**
+ * \brief ar_fmap_advise
+ *          Tell the platform how a range of a mapped file will be used
+ *
+ * AR_FMAP_ADVICE_WILLNEED starts loading the range ahead of its first access.
+ * AR_FMAP_ADVICE_DONTNEED releases the memory backing the range, the mapping
+ * stays valid and the range is read from the file again on its next access,
+ * so pointers into it held by other threads remain usable.
+ *
+ * \param[in] fbuffer: The pointer to the file buffer obtained by ar_fmap
+ * \param[in] offset: Start of the range in bytes from the start of the file
+ * \param[in] size: Size of the range in bytes
+ * \param[in] advice: One of ar_fmap_advice_t
+ *
+ * \return
+ *  0 -- Success
+ *  AR_EUNSUPPORTED -- The platform does not map files or fbuffer was not mapped
+ *  Nonzero -- Failure
+ */
+int32_t ar_fmap_advise(const void *fbuffer,
+                       size_t offset,
+                       size_t size,
+                       ar_fmap_advice_t advice);
+
 /**
  * \brief  ar_fseek
  *           Move the file pointer for read/write to the required offset.
@@ -22,6 +22,13 @@ Recursive mutex are always used for thread-safe programming.
  - ar_osal_mutex_lock()
  - ar_osal_mutex_try_lock()
  - ar_osal_mutex_unlock()
+
+It also describes the reader-writer lock functions.
+ - ar_osal_rwlock_create()
+ - ar_osal_rwlock_destroy()
+ - ar_osal_rwlock_read_lock()
+ - ar_osal_rwlock_write_lock()
+ - ar_osal_rwlock_unlock()
 */
 
 #ifdef __cplusplus
@@ -44,6 +51,10 @@ INCLUDE FILES FOR MODULE
 */
 typedef void *ar_osal_mutex_t;
 
+/** ar osal reader-writer lock type object.
+*/
+typedef void *ar_osal_rwlock_t;
+
 /****************************************************************************
 ** Mutex
 *****************************************************************************/
@@ -196,6 +207,104 @@ int32_t ar_osal_mutex_try_lock(ar_osal_mutex_t mutex);
  */
 int32_t ar_osal_mutex_unlock(ar_osal_mutex_t mutex);
 
+/****************************************************************************
+** Reader-writer lock
+*****************************************************************************/
+
+/**
+  Creates and initialize a reader-writer lock. Any number of readers may
+  hold the lock at the same time, a writer holds it alone. The lock is
+  not recursive.
+
+  @datatypes
+  ar_osal_rwlock_t
+
+  @param[Out] rwlock: Pointer to the reader-writer lock object handle.
+
+  @return
+  0 -- Success
+  Nonzero -- Failure
+
+  @dependencies
+  None. @newpage
+*/
+int32_t ar_osal_rwlock_create(ar_osal_rwlock_t *rwlock);
+
+/**
+  Delete/free a reader-writer lock object. This function must be called
+  for each corresponding ar_osal_rwlock_create function.
+
+  @datatypes
+  ar_osal_rwlock_t
+
+  @param[in] rwlock: Pointer to the reader-writer lock.
+
+  @return
+  0 -- Success
+  Nonzero -- Failure
+
+  @dependencies
+  Before calling this function, the object must have been created.
+  @newpage
+*/
+int32_t ar_osal_rwlock_destroy(ar_osal_rwlock_t rwlock);
+
+/**
+  Locks a reader-writer lock for shared access. Blocks while a writer
+  holds the lock.
+
+  @datatypes
+  ar_osal_rwlock_t
+
+  @param[in] rwlock: Pointer to the reader-writer lock.
+
+  @return
+  0 -- Success
+  Nonzero -- Failure
+
+  @dependencies
+  Before calling this function, the object must be created.
+  @newpage
+*/
+int32_t ar_osal_rwlock_read_lock(ar_osal_rwlock_t rwlock);
+
+/**
+  Locks a reader-writer lock for exclusive access. Blocks while any
+  reader or writer holds the lock.
+
+  @datatypes
+  ar_osal_rwlock_t
+
+  @param[in] rwlock: Pointer to the reader-writer lock.
+
+  @return
+  0 -- Success
+  Nonzero -- Failure
+
+  @dependencies
+  Before calling this function, the object must be created.
+  @newpage
+*/
+int32_t ar_osal_rwlock_write_lock(ar_osal_rwlock_t rwlock);
+
+/**
+  Releases a reader-writer lock held for shared or exclusive access.
+
+  @datatypes
+  ar_osal_rwlock_t
+
+  @param[in] rwlock: Pointer to the reader-writer lock.
+
+  @return
+  0 -- Success
+  Nonzero -- Failure
+
+  @dependencies
+  Before calling this function, the object must be created.
+  @newpage
+*/
+int32_t ar_osal_rwlock_unlock(ar_osal_rwlock_t rwlock);
+
 
 #ifdef __cplusplus
 }
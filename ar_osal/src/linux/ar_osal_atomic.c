@@ -0,0 +1,74 @@
+/**
+ * \file ar_osal_atomic.c
+ *
+ * \brief
+ *      This file implements atomic operation apis using the GCC/Clang
+ *      __atomic builtins.
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ar_osal_atomic.h"
+
+uint32_t ar_osal_atomic_load_u32(volatile uint32_t *p)
+{
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+
+void ar_osal_atomic_store_u32(volatile uint32_t *p, uint32_t val)
+{
+    __atomic_store_n(p, val, __ATOMIC_SEQ_CST);
+}
+
+uint32_t ar_osal_atomic_add_u32(volatile uint32_t *p, uint32_t val)
+{
+    return __atomic_add_fetch(p, val, __ATOMIC_SEQ_CST);
+}
+
+uint32_t ar_osal_atomic_sub_u32(volatile uint32_t *p, uint32_t val)
+{
+    return __atomic_sub_fetch(p, val, __ATOMIC_SEQ_CST);
+}
+
+bool_t ar_osal_atomic_cmpxchg_u32(volatile uint32_t *p, uint32_t *expected,
+    uint32_t desired)
+{
+    return __atomic_compare_exchange_n(p, expected, desired, 0,
+        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
+
+uint64_t ar_osal_atomic_load_u64(volatile uint64_t *p)
+{
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+
+bool_t ar_osal_atomic_cmpxchg_u64(volatile uint64_t *p, uint64_t *expected,
+    uint64_t desired)
+{
+    return __atomic_compare_exchange_n(p, expected, desired, 0,
+        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
+
+void *ar_osal_atomic_load_ptr(void *volatile *p)
+{
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+
+void ar_osal_atomic_store_ptr(void *volatile *p, void *val)
+{
+    __atomic_store_n(p, val, __ATOMIC_SEQ_CST);
+}
+
+bool_t ar_osal_atomic_cmpxchg_ptr(void *volatile *p, void **expected,
+    void *desired)
+{
+    return __atomic_compare_exchange_n(p, expected, desired, 0,
+        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? TRUE : FALSE;
+}
+
+void ar_osal_atomic_fence(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
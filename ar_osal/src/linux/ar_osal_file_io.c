@@ -14,9 +14,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <errno.h>
+#include <pthread.h>
 #include "ar_osal_file_io.h"
 #include "ar_osal_log.h"
 #include "ar_osal_error.h"
@@ -30,6 +32,19 @@ const char* gsl_log_paths[] = {"/data/vendor/audio/gsl_log.bin",
 
 #define AR_FILE_WRITE_MAX_SIZE ( (256)*(1024)*(1024) ) //256 MB
 
+/* Files mapped at once, munmap needs the length so each mapping is tracked */
+#ifndef AR_FMAP_MAX_MAPPINGS
+#define AR_FMAP_MAX_MAPPINGS 16
+#endif
+
+typedef struct ar_fmap_entry {
+    void *addr;
+    size_t length;
+} ar_fmap_entry_t;
+
+static ar_fmap_entry_t ar_fmap_entries[AR_FMAP_MAX_MAPPINGS];
+static pthread_mutex_t ar_fmap_lock = PTHREAD_MUTEX_INITIALIZER;
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_fopen(_Out_ ar_fhandle *handle,
                    _In_  const char_t *path,
@@ -169,13 +184,135 @@ _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_fmap(ar_fhandle handle,
                 const void **fbuffer)
 {
-    return AR_EUNSUPPORTED;
+    int32_t rc = 0;
+    FILE *file_ptr = (FILE *)handle;
+    size_t file_size;
+    void *addr;
+    int i;
+
+    if (NULL == handle || NULL == fbuffer) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s Invalid file handle or buffer\n",__func__);
+        return AR_EBADPARAM;
+    }
+
+    file_size = ar_fsize(handle);
+    if (0 == file_size) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s cannot map an empty file\n",__func__);
+        return AR_EBADPARAM;
+    }
+
+    pthread_mutex_lock(&ar_fmap_lock);
+    for (i = 0; i < AR_FMAP_MAX_MAPPINGS; i++) {
+        if (NULL == ar_fmap_entries[i].addr)
+            break;
+    }
+    if (AR_FMAP_MAX_MAPPINGS == i) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s all %d mappings in use\n",__func__, AR_FMAP_MAX_MAPPINGS);
+        rc = AR_ENORESOURCE;
+        goto done;
+    }
+
+    /*
+     * Read only private mapping, pages are loaded on first access and
+     * shared through the page cache with every process mapping the file.
+     */
+    addr = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fileno(file_ptr), 0);
+    if (MAP_FAILED == addr) {
+        rc = AR_EFAILED;
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s mmap failed %d %s\n", __func__, rc, strerror(errno));
+        goto done;
+    }
+
+    ar_fmap_entries[i].addr = addr;
+    ar_fmap_entries[i].length = file_size;
+    *fbuffer = addr;
+done:
+    pthread_mutex_unlock(&ar_fmap_lock);
+    return rc;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_funmap(const void *fbuffer)
 {
-    return AR_EUNSUPPORTED;
+    /* buffers not mapped by ar_fmap are left to the caller to free */
+    int32_t rc = AR_EUNSUPPORTED;
+    int i;
+
+    if (NULL == fbuffer) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s Invalid buffer\n",__func__);
+        return AR_EBADPARAM;
+    }
+
+    pthread_mutex_lock(&ar_fmap_lock);
+    for (i = 0; i < AR_FMAP_MAX_MAPPINGS; i++) {
+        if (fbuffer != ar_fmap_entries[i].addr)
+            continue;
+
+        rc = 0;
+        if (0 != munmap(ar_fmap_entries[i].addr, ar_fmap_entries[i].length)) {
+            rc = AR_EFAILED;
+            AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s munmap failed %d %s\n", __func__, rc, strerror(errno));
+        }
+        ar_fmap_entries[i].addr = NULL;
+        ar_fmap_entries[i].length = 0;
+        break;
+    }
+    pthread_mutex_unlock(&ar_fmap_lock);
+
+    if (AR_EUNSUPPORTED == rc)
+        AR_LOG_DEBUG(AR_OSAL_FILE_IO_LOG_TAG,"%s buffer was not mapped by ar_fmap\n",__func__);
+    return rc;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_fmap_advise(const void *fbuffer,
+                       size_t offset,
+                       size_t size,
+                       ar_fmap_advice_t advice)
+{
+    int32_t rc = AR_EUNSUPPORTED;
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t length = 0;
+    uintptr_t start;
+    int i;
+
+    if (NULL == fbuffer || 0 == size) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s Invalid buffer or size\n",__func__);
+        return AR_EBADPARAM;
+    }
+
+    pthread_mutex_lock(&ar_fmap_lock);
+    for (i = 0; i < AR_FMAP_MAX_MAPPINGS; i++) {
+        if (fbuffer == ar_fmap_entries[i].addr) {
+            length = ar_fmap_entries[i].length;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&ar_fmap_lock);
+
+    /* Buffers that were not mapped are left alone, the caller falls back to
+     * keeping them resident */
+    if (AR_FMAP_MAX_MAPPINGS == i)
+        return rc;
+
+    if (offset >= length || size > length - offset) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s range %zu + %zu is beyond the mapping\n",__func__, offset, size);
+        return AR_EBADPARAM;
+    }
+
+    /* madvise works on whole pages, pages shared with a neighbouring range
+     * are covered too. Dropping them is harmless as the mapping is read only
+     * and they are read from the file again. */
+    start = ((uintptr_t)fbuffer + offset) & ~(uintptr_t)(page_size - 1);
+    size += ((uintptr_t)fbuffer + offset) - start;
+
+    rc = 0;
+    if (0 != madvise((void *)start, size,
+                     AR_FMAP_ADVICE_DONTNEED == advice ? MADV_DONTNEED : MADV_WILLNEED)) {
+        rc = AR_EFAILED;
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s madvise failed %d %s\n", __func__, rc, strerror(errno));
+    }
+    return rc;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
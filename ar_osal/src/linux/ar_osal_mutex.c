@@ -2,8 +2,8 @@
  * \file ar_osal_mutex.c
  *
  * \brief
- *      This file implements mutex apis. Recursive mutexes are always used
- *      for thread-safe programming.
+ *      This file implements mutex and reader-writer lock apis. Recursive
+ *      mutexes are always used for thread-safe programming.
  *
  * \copyright
  *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
@@ -24,6 +24,10 @@ typedef struct osal_int_mutex {
     pthread_mutex_t mutex;
 } osal_int_mutex_t;
 
+typedef struct osal_int_rwlock {
+    pthread_rwlock_t rwlock;
+} osal_int_rwlock_t;
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_osal_mutex_init(_Inout_ ar_osal_mutex_t mutex __unused)
 {
@@ -156,3 +160,98 @@ int32_t ar_osal_mutex_unlock(_In_ ar_osal_mutex_t ar_osal_mutex)
     }
     return rc;
 }
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_rwlock_create(_Inout_ ar_osal_rwlock_t *ar_osal_rwlock)
+{
+    int32_t rc;
+    osal_int_rwlock_t *the_rwlock;
+
+    if (NULL == ar_osal_rwlock) {
+        return AR_EBADPARAM;
+    }
+
+    the_rwlock = ((osal_int_rwlock_t *) malloc(sizeof(osal_int_rwlock_t)));
+    if (NULL == the_rwlock) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: failed to allocate memory for rwlock\n", __func__);
+        return AR_ENOMEMORY;
+    }
+
+    rc = pthread_rwlock_init(&the_rwlock->rwlock, NULL);
+    if (rc) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: failed to initialize rwlock\n", __func__);
+        free(the_rwlock);
+        return AR_EFAILED;
+    }
+
+    *ar_osal_rwlock = the_rwlock;
+    return 0;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_rwlock_destroy(_In_ ar_osal_rwlock_t ar_osal_rwlock)
+{
+    osal_int_rwlock_t *the_rwlock = ar_osal_rwlock;
+
+    if (NULL == the_rwlock) {
+        return AR_EBADPARAM;
+    }
+
+    if (pthread_rwlock_destroy(&the_rwlock->rwlock)) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: Failed to destroy rwlock\n", __func__);
+        return AR_EFAILED;
+    }
+    free(the_rwlock);
+    return 0;
+}
+
+_IRQL_requires_min_(PASSIVE_LEVEL)
+int32_t ar_osal_rwlock_read_lock(_In_ ar_osal_rwlock_t ar_osal_rwlock)
+{
+    osal_int_rwlock_t *the_rwlock = ar_osal_rwlock;
+
+    if (NULL == the_rwlock) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: ar_osal_rwlock is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+
+    if (pthread_rwlock_rdlock(&the_rwlock->rwlock)) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: Failed to read lock ar_osal_rwlock\n", __func__);
+        return AR_EFAILED;
+    }
+    return 0;
+}
+
+_IRQL_requires_min_(PASSIVE_LEVEL)
+int32_t ar_osal_rwlock_write_lock(_In_ ar_osal_rwlock_t ar_osal_rwlock)
+{
+    osal_int_rwlock_t *the_rwlock = ar_osal_rwlock;
+
+    if (NULL == the_rwlock) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: ar_osal_rwlock is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+
+    if (pthread_rwlock_wrlock(&the_rwlock->rwlock)) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: Failed to write lock ar_osal_rwlock\n", __func__);
+        return AR_EFAILED;
+    }
+    return 0;
+}
+
+_IRQL_requires_min_(PASSIVE_LEVEL)
+int32_t ar_osal_rwlock_unlock(_In_ ar_osal_rwlock_t ar_osal_rwlock)
+{
+    osal_int_rwlock_t *the_rwlock = ar_osal_rwlock;
+
+    if (NULL == the_rwlock) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: ar_osal_rwlock is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+
+    if (pthread_rwlock_unlock(&the_rwlock->rwlock)) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: Failed to release ar_osal_rwlock\n", __func__);
+        return AR_EFAILED;
+    }
+    return 0;
+}
@@ -35,6 +35,7 @@ LOCAL_SRC_FILES := \
     test/src/ar_osal_signal_thread.c \
     test/src/ar_osal_test.c \
     test/src/ar_osal_test_service.c \
+    test/src/ar_test_atomic.c \
     test/src/ar_test_file_io.c \
     test/src/ar_test_heap.c \
     test/src/ar_test_list.c \
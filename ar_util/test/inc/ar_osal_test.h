@@ -28,3 +28,5 @@ void ar_test_string_main();
 
 void ar_test_data_log_main();
 
+void ar_test_atomic_main();
+
@@ -65,6 +65,11 @@ void main()
     /* data log test case*/
     ar_test_data_log_main();
     AR_LOG_DEBUG(LOG_TAG, " data logging test case ended ");
+
+    AR_LOG_DEBUG(LOG_TAG, " atomic test case starting ");
+    /* atomic test case*/
+    ar_test_atomic_main();
+    AR_LOG_DEBUG(LOG_TAG, " atomic test case ended ");
     AR_LOG_DEBUG(LOG_TAG, "*******************************************************************");
 
 
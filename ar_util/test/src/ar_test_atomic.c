@@ -0,0 +1,113 @@
+/*
+*  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+*  SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "ar_osal_test.h"
+#include "ar_osal_atomic.h"
+#include "ar_osal_thread.h"
+#include "ar_osal_log.h"
+#include "ar_osal_types.h"
+#include "ar_osal_error.h"
+
+#define ATOMIC_THREADCOUNT (4)
+#define ATOMIC_ITERATIONS (100000)
+
+static volatile uint32_t atomic_counter;
+
+static void atomic_increment_thread(void *param)
+{
+	uint32_t i;
+
+	__UNREFERENCED_PARAM(param);
+
+	for (i = 0; i < ATOMIC_ITERATIONS; i++)
+		ar_osal_atomic_add_u32(&atomic_counter, 1);
+}
+
+void ar_test_atomic_main()
+{
+	int32_t status = AR_EOK;
+	void *threads[ATOMIC_THREADCOUNT] = { NULL };
+	ar_osal_thread_attr_t osal_thread_attr = { NULL, 1024, 0 };
+	volatile uint32_t val = 5;
+	uint32_t expected = 0;
+	int32_t a = 0, b = 0;
+	void *volatile ptr = &a;
+	void *expected_ptr = &b;
+	volatile uint64_t val64 = 0x100000000ULL;
+	uint64_t expected64 = 0;
+	int32_t i = 0;
+
+	ar_osal_atomic_store_u32(&val, 10);
+	if (ar_osal_atomic_load_u32(&val) != 10)
+		AR_LOG_ERR(LOG_TAG, "atomic store/load failed");
+
+	if (ar_osal_atomic_add_u32(&val, 5) != 15 ||
+		ar_osal_atomic_sub_u32(&val, 3) != 12)
+		AR_LOG_ERR(LOG_TAG, "atomic add/sub failed");
+
+	/* cmpxchg must fail and report the current value */
+	if (ar_osal_atomic_cmpxchg_u32(&val, &expected, 20) || expected != 12)
+		AR_LOG_ERR(LOG_TAG, "atomic cmpxchg mismatch case failed");
+
+	if (!ar_osal_atomic_cmpxchg_u32(&val, &expected, 20) ||
+		ar_osal_atomic_load_u32(&val) != 20)
+		AR_LOG_ERR(LOG_TAG, "atomic cmpxchg match case failed");
+
+	if (ar_osal_atomic_cmpxchg_ptr(&ptr, &expected_ptr, NULL) ||
+		expected_ptr != &a)
+		AR_LOG_ERR(LOG_TAG, "atomic ptr cmpxchg mismatch case failed");
+
+	if (!ar_osal_atomic_cmpxchg_ptr(&ptr, &expected_ptr, &b) ||
+		ar_osal_atomic_load_ptr(&ptr) != &b)
+		AR_LOG_ERR(LOG_TAG, "atomic ptr cmpxchg match case failed");
+
+	if (ar_osal_atomic_cmpxchg_u64(&val64, &expected64, 1) ||
+		expected64 != 0x100000000ULL)
+		AR_LOG_ERR(LOG_TAG, "atomic u64 cmpxchg mismatch case failed");
+
+	if (!ar_osal_atomic_cmpxchg_u64(&val64, &expected64, 0x200000001ULL) ||
+		ar_osal_atomic_load_u64(&val64) != 0x200000001ULL)
+		AR_LOG_ERR(LOG_TAG, "atomic u64 cmpxchg match case failed");
+
+	/* concurrent increments must not be lost */
+	ar_osal_atomic_store_u32(&atomic_counter, 0);
+	for (i = 0; i < ATOMIC_THREADCOUNT; i++)
+	{
+		status = ar_osal_thread_attr_init(&osal_thread_attr);
+		if (status != AR_EOK)
+		{
+			AR_LOG_ERR(LOG_TAG, "ar_osal_thread_attr_init error: %d", status);
+			goto end;
+		}
+
+		status = ar_osal_thread_create(&threads[i], &osal_thread_attr,
+			(ar_osal_thread_start_routine)atomic_increment_thread, NULL);
+		if (status != AR_EOK)
+		{
+			AR_LOG_ERR(LOG_TAG, "ar_osal_thread_create error: %d", status);
+			goto end;
+		}
+	}
+
+	for (i = 0; i < ATOMIC_THREADCOUNT; i++)
+	{
+		status = ar_osal_thread_join_destroy(threads[i]);
+		if (AR_EOK != status)
+			AR_LOG_ERR(LOG_TAG, "ar_osal_thread_join_destroy failed (%d)",
+				status);
+	}
+
+	if (ar_osal_atomic_load_u32(&atomic_counter) !=
+		ATOMIC_THREADCOUNT * ATOMIC_ITERATIONS)
+	{
+		AR_LOG_ERR(LOG_TAG, "atomic counter mismatch %u",
+			ar_osal_atomic_load_u32(&atomic_counter));
+	}
+	else
+	{
+		AR_LOG_INFO(LOG_TAG, "atomic counter test passed");
+	}
+end:
+	return;
+}
@@ -19,6 +19,7 @@ LOCAL_SRC_FILES := \
     ext/dynamic_allocation/src/gpr_dynamic_allocation.c \
     ext/logging/src/gpr_log_generic.c \
     ext/logging/stub_src/gpr_log_diag_stub.c \
+    ext/logging/src/gpr_trace.c \
     datalinks/gpr_lx/src/gpr_lx.c \
     platform/linux/gpr_init_lx_wrapper.c
 
@@ -40,6 +41,7 @@ LOCAL_C_INCLUDES := \
     $(LOCAL_PATH)/datalinks/gpr_lx/inc
 
 LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)/api
+LOCAL_EXPORT_C_INCLUDE_DIRS += $(LOCAL_PATH)/ext/logging/inc
 LOCAL_CFLAGS := -D_ANDROID_ \
         -DSESSION_ARRAY_SIZE=200 \
         -DGPR_USE_CUTILS
@@ -12,6 +12,7 @@
  *  SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stddef.h>
 #include "ar_osal_mem_op.h"
 #include "ar_osal_mutex.h"
 #include "ar_osal_heap.h"
@@ -20,6 +21,9 @@
 #include "gpr_msg_if.h"
 #include "gpr_api_inline.h"
 #include "ar_msg.h"
+#include "ar_osal_atomic.h"
+#include "ar_osal_sleep.h"
+#include "gpr_heap_i.h"
 
 //#define SESSION_ARRAY_SIZE 200
 #define SESSION_HASH(RANGE, x) ((x) % (RANGE - 1)) // always a prime number
@@ -44,26 +48,112 @@ struct gpr_module_node_t
    uint32_t           my_module_port;
    gpr_module_entry_t session;
    gpr_module_node_t *next;
+   volatile uint32_t  ref_cnt;    // one reference held by the list plus one per in-flight lookup
+   gpr_heap_index_t   heap_index; // heap the node was allocated from
 };
 
+/* Slot table of the open addressing variant, private to that variant */
+typedef struct gpr_session_table_t gpr_session_table_t;
+
 /* Structures to store the registered module nodes, heap index provided will be used to
-   allocate the nodes. Client must allocate memory for the cb_list[] */
+   allocate the nodes. Client must allocate memory for the cb_list[]
+
+   Lookups do not take any lock. Registration and deregistration are serialized by the caller,
+   publish nodes with atomic pointer stores and, after unlinking a node, wait for lookups that
+   may still be walking the list to finish before dropping the list reference (RCU style).
+   Lookups count themselves in readers[epoch & 1]; the writer flips the epoch and waits for the
+   old counter to drain, so lookups that start afterwards do not hold up a deregistration. */
 struct gpr_module_node_list_t
 {
-   gpr_heap_index_t   heap_index;       // heap index from which module nodes need to be allocated
-   uint32_t           max_cb_list_size; // max size of the cb_list array
-   gpr_module_node_t *cb_list[1];       // array containing the module node pointers.
+   gpr_heap_index_t     heap_index;       // heap index from which module nodes need to be allocated
+   uint32_t             max_cb_list_size; // max size of the cb_list array
+   volatile uint32_t    epoch;            // selects the reader counter used by new lookups
+   volatile uint32_t    readers[2];       // lookups in progress per epoch
+   gpr_session_table_t *table;            // slot table of the open addressing variant, unused by the others
+   gpr_module_node_t   *cb_list[1];       // array containing the module node pointers.
 };
 typedef struct gpr_module_node_list_t gpr_module_node_list_t;
 
+/* Poll interval used while waiting for in progress lookups to leave the list */
+#define GPR_SESSION_GRACE_POLL_US (50)
+
+static inline uint32_t gpr_session_read_lock(gpr_module_node_list_t *list_handle)
+{
+   uint32_t epoch = ar_osal_atomic_load_u32(&list_handle->epoch) & 1;
+
+   (void)ar_osal_atomic_add_u32(&list_handle->readers[epoch], 1);
+   return epoch;
+}
+
+static inline void gpr_session_read_unlock(gpr_module_node_list_t *list_handle, uint32_t epoch)
+{
+   (void)ar_osal_atomic_sub_u32(&list_handle->readers[epoch], 1);
+}
+
+/* Waits until no lookup can still reference a node unlinked before this call, writers only.
+   Both counters are drained in turn: a lookup that read the epoch just before a flip may still
+   count itself in the counter new lookups use. */
+static inline void gpr_session_synchronize(gpr_module_node_list_t *list_handle)
+{
+   for (uint32_t flip = 0; flip < 2; flip++)
+   {
+      uint32_t old_epoch = ar_osal_atomic_add_u32(&list_handle->epoch, 1) - 1;
+
+      while (0 != ar_osal_atomic_load_u32(&list_handle->readers[old_epoch & 1]))
+      {
+         (void)ar_osal_micro_sleep(GPR_SESSION_GRACE_POLL_US);
+      }
+   }
+}
+
+/* Takes a reference on a node found during a lookup, fails once the node is being released */
+static inline bool_t gpr_session_try_get(gpr_module_node_t *node)
+{
+   uint32_t cnt = ar_osal_atomic_load_u32(&node->ref_cnt);
+
+   while (0 != cnt)
+   {
+      if (ar_osal_atomic_cmpxchg_u32(&node->ref_cnt, &cnt, cnt + 1))
+      {
+         return TRUE;
+      }
+   }
+   return FALSE;
+}
+
+/* Drops a reference on a node, the node is freed with its last reference */
+static inline void gpr_session_node_put(gpr_module_node_t *node)
+{
+   ar_heap_info heap_info;
+
+   if (0 == ar_osal_atomic_sub_u32(&node->ref_cnt, 1))
+   {
+      gpr_populate_ar_heap_info(node->heap_index, AR_HEAP_ALIGN_8_BYTES, &heap_info);
+      ar_heap_free(node, &heap_info);
+   }
+}
+
+/* Releases a session returned by gpr_get_session */
+static inline void gpr_put_session(gpr_module_entry_t *entry)
+{
+   gpr_session_node_put((gpr_module_node_t *)(((char_t *)entry) - offsetof(gpr_module_node_t, session)));
+}
+
+/* Registers a session with its callback, the session is visible to lookups once this returns.
+   Must be serialized with gpr_deinit_session by the caller. */
 GPR_INTERNAL uint32_t gpr_init_session(uint32_t                my_module_port,
-                                       gpr_module_entry_t    **ret_entry,
+                                       gpr_callback_fn_t       callback_fn,
+                                       void                   *callback_data,
                                        gpr_module_node_list_t *list_handle);
 
+/* Lock free lookup, the returned session holds a reference that must be released
+   with gpr_put_session */
 GPR_INTERNAL uint32_t gpr_get_session(uint32_t                my_module_port,
                                       gpr_module_entry_t    **ret_entry,
                                       gpr_module_node_list_t *list_handle);
 
+/* Unlinks the session, it is freed once the last in-flight lookup releases it.
+   Must be serialized with gpr_init_session by the caller. */
 GPR_INTERNAL uint32_t gpr_deinit_session(uint32_t my_module_port, gpr_module_node_list_t *list_handle);
 
 #endif /* _GPR_SESSION_H_ */
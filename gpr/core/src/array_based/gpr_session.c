@@ -33,7 +33,8 @@
   #AR_EOK when successful.
 */
 GPR_INTERNAL uint32_t gpr_init_session(uint32_t                src_port,
-                                       gpr_module_entry_t    **ret_entry,
+                                       gpr_callback_fn_t       callback_fn,
+                                       void                   *callback_data,
                                        gpr_module_node_list_t *list_handle)
 {
    if (NULL == list_handle)
@@ -82,15 +83,19 @@ GPR_INTERNAL uint32_t gpr_init_session(uint32_t                src_port,
       AR_MSG(DBG_ERROR_PRIO,
              "Error: Finding any free space, increase session_array_size cur_size: %lu",
              list_handle->max_cb_list_size);
+      ar_heap_free(new_node, &heap_info);
       return AR_EFAILED;
    }
 
-   // Fill up the new node
-   chain[free_index]        = new_node;
-   new_node->my_module_port = src_port;
-   *ret_entry               = &new_node->session;
+   // Fill up the new node before it becomes visible to lookups
+   new_node->my_module_port        = src_port;
+   new_node->session.callback_fn   = callback_fn;
+   new_node->session.callback_data = callback_data;
+   new_node->next                  = NULL; // as it is array based (next node is not required)
+   new_node->ref_cnt               = 1;
+   new_node->heap_index            = heap_index;
 
-   chain[free_index]->next = NULL; // as it is array based (next node is not required)
+   ar_osal_atomic_store_ptr((void *volatile *)&chain[free_index], new_node);
 
    return AR_EOK;
 }
@@ -115,18 +120,18 @@ GPR_INTERNAL uint32_t gpr_deinit_session(uint32_t src_port, gpr_module_node_list
       return AR_EFAILED;
    }
 
-   gpr_heap_index_t heap_index = list_handle->heap_index;
-   ar_heap_info     heap_info;
-   gpr_populate_ar_heap_info(heap_index, AR_HEAP_ALIGN_8_BYTES, &heap_info);
-
    gpr_module_node_t **cb_list = &list_handle->cb_list[0];
+   gpr_module_node_t  *dealloc;
 
    for (uint32_t i = 0; i < list_handle->max_cb_list_size; i++)
    {
       if ((cb_list[i] != NULL) && (cb_list[i]->my_module_port == src_port))
       {
-         ar_heap_free(cb_list[i], &heap_info);
-         cb_list[i] = NULL;
+         dealloc = cb_list[i];
+         ar_osal_atomic_store_ptr((void *volatile *)&cb_list[i], NULL);
+
+         gpr_session_synchronize(list_handle);
+         gpr_session_node_put(dealloc);
          return AR_EOK;
       }
    }
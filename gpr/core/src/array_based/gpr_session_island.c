@@ -36,14 +36,25 @@ GPR_INTERNAL uint32_t gpr_get_session(uint32_t                my_port,
       return AR_EFAILED;
    }
    gpr_module_node_t **cb_list = &list_handle->cb_list[0];
+   gpr_module_node_t  *node;
+   uint32_t            epoch = gpr_session_read_lock(list_handle);
+
    for (uint32_t i = 0; i < list_handle->max_cb_list_size; i++)
    {
-      if ((cb_list[i] != NULL) && (cb_list[i]->my_module_port == my_port))
+      node = (gpr_module_node_t *)ar_osal_atomic_load_ptr((void *volatile *)&cb_list[i]);
+      if ((node != NULL) && (node->my_module_port == my_port))
       {
-         *ret_entry = &cb_list[i]->session;
-         return AR_EOK;
+         // fails only if the node is being deregistered right now
+         if (gpr_session_try_get(node))
+         {
+            gpr_session_read_unlock(list_handle, epoch);
+            *ret_entry = &node->session;
+            return AR_EOK;
+         }
+         break;
       }
    }
+   gpr_session_read_unlock(list_handle, epoch);
 
 #ifdef GPR_DEBUG_MSG
    AR_MSG(DBG_ERROR_PRIO, "No such module port (%lu) found in linked list", my_port);
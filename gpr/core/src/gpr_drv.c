@@ -437,6 +437,13 @@ static uint32_t gpr_drv_util_create_packet_pool_info_arrs(uint32_t
       ar_mem_set((void *)gpr_ctxt_struct_t.static_pool_arr,
                  0,
                  num_static_packet_pools * sizeof(gpr_drv_pkt_static_pool_info_t));
+
+      gpr_ctxt_struct_t.static_pool_order =
+         (uint32_t *)ar_heap_malloc(num_static_packet_pools * sizeof(uint32_t), &heap_info);
+      if (NULL == gpr_ctxt_struct_t.static_pool_order)
+      {
+         return AR_EFAILED;
+      }
    }
 
    // malloc dynamic pool array if needed
@@ -499,6 +506,11 @@ static uint32_t gpr_drv_util_free_packet_pool_info_arrs(void)
       ar_heap_free((void *)gpr_ctxt_struct_t.static_pool_arr, &heap_info);
    }
 
+   if (gpr_ctxt_struct_t.static_pool_order)
+   {
+      ar_heap_free((void *)gpr_ctxt_struct_t.static_pool_order, &heap_info);
+   }
+
    if (gpr_ctxt_struct_t.dyn_pool_arr)
    {
       ar_heap_free((void *)gpr_ctxt_struct_t.dyn_pool_arr, &heap_info);
@@ -519,6 +531,83 @@ static uint32_t gpr_drv_util_free_packet_pool_info_arrs(void)
    return AR_EOK;
 }
 #endif
+
+// Utility to sort the static pools by packet heap address and fill the address slots, called once all the
+// static pools are allocated
+static void gpr_drv_util_build_static_pool_order(void)
+{
+   gpr_drv_pkt_static_pool_info_t *pools    = gpr_ctxt_struct_t.static_pool_arr;
+   uint32_t                       *order    = gpr_ctxt_struct_t.static_pool_order;
+   uint32_t                        num      = gpr_ctxt_struct_t.num_static_packet_pools;
+   uint8_t                        *slots    = gpr_ctxt_struct_t.static_pool_slot;
+   uint32_t                        shift    = 0;
+   uintptr_t                       min_size = 0;
+   uintptr_t                       span;
+
+   ar_mem_set((void *)slots, GPR_DRV_STATIC_POOL_NO_SLOT, sizeof(gpr_ctxt_struct_t.static_pool_slot));
+
+   if (0 == num)
+   {
+      return;
+   }
+
+   gpr_ctxt_struct_t.static_pool_min_addr = pools[0].packet_heap;
+   gpr_ctxt_struct_t.static_pool_max_addr = pools[0].packet_heap_end;
+
+   // insertion sort, number of pools is small
+   for (uint32_t idx = 0; idx < num; idx++)
+   {
+      uint32_t pos = idx;
+      while ((pos > 0) && (pools[order[pos - 1]].packet_heap > pools[idx].packet_heap))
+      {
+         order[pos] = order[pos - 1];
+         pos--;
+      }
+      order[pos] = idx;
+
+      if (pools[idx].packet_heap < gpr_ctxt_struct_t.static_pool_min_addr)
+      {
+         gpr_ctxt_struct_t.static_pool_min_addr = pools[idx].packet_heap;
+      }
+      if (pools[idx].packet_heap_end > gpr_ctxt_struct_t.static_pool_max_addr)
+      {
+         gpr_ctxt_struct_t.static_pool_max_addr = pools[idx].packet_heap_end;
+      }
+      if ((0 == min_size) || ((uintptr_t)(pools[idx].packet_heap_end - pools[idx].packet_heap) < min_size))
+      {
+         min_size = (uintptr_t)(pools[idx].packet_heap_end - pools[idx].packet_heap);
+      }
+   }
+
+   // largest slot not exceeding the smallest pool, grown if the span needs more slots than available
+   span = (uintptr_t)(gpr_ctxt_struct_t.static_pool_max_addr - gpr_ctxt_struct_t.static_pool_min_addr);
+   while (((uintptr_t)2 << shift) <= min_size)
+   {
+      shift++;
+   }
+   while ((span >> shift) >= GPR_DRV_STATIC_POOL_NUM_SLOTS)
+   {
+      shift++;
+   }
+   gpr_ctxt_struct_t.static_pool_slot_shift = shift;
+
+   // pools are visited in address order so each slot keeps the first pool overlapping it
+   for (uint32_t pos = 0; pos < num; pos++)
+   {
+      gpr_drv_pkt_static_pool_info_t *pool  = &pools[order[pos]];
+      uintptr_t first = (uintptr_t)(pool->packet_heap - gpr_ctxt_struct_t.static_pool_min_addr) >> shift;
+      uintptr_t last  = (uintptr_t)(pool->packet_heap_end - gpr_ctxt_struct_t.static_pool_min_addr) >> shift;
+
+      for (uintptr_t slot = first; slot <= last; slot++)
+      {
+         if (GPR_DRV_STATIC_POOL_NO_SLOT == slots[slot])
+         {
+            slots[slot] = (uint8_t)pos;
+         }
+      }
+   }
+}
+
 /*@brief Creating memory for GPR packets and initializing all datalink layers
 
   @return
@@ -645,6 +734,8 @@ GPR_EXTERNAL uint32_t gpr_drv_internal_init_v2(uint32_t                  default
       }
    }
 
+   gpr_drv_util_build_static_pool_order();
+
    /* Save default domain id and pass it through init*/
    gpr_ctxt_struct_t.default_domain_id = default_domain_id;
 
@@ -911,8 +1002,7 @@ uint32_t __gpr_cmd_register_v2(uint32_t          src_port,
                                void             *callback_data,
                                gpr_heap_index_t  heap_index)
 {
-   uint32_t            rc      = 0;
-   gpr_module_entry_t *session = NULL;
+   uint32_t rc = 0;
 
    if (NULL == callback_fn)
    {
@@ -931,20 +1021,11 @@ uint32_t __gpr_cmd_register_v2(uint32_t          src_port,
       list_handle = gpr_ctxt_struct_t.heap1_list;
    }
 
+   /* The task lock only serializes registration changes, lookups on the send path do not take it */
    ar_osal_mutex_lock(gpr_ctxt_struct_t.gpr_drv_task_lock);
 
-   // saves src port in cb_list and returns pointer to session
-   rc = gpr_init_session(src_port, &session, list_handle);
-
-   /* Save cb function and argument if any */
-   if (session)
-   {
-      session->callback_fn = callback_fn;
-      if (callback_data)
-      {
-         session->callback_data = callback_data;
-      }
-   }
+   // saves src port, cb function and argument in cb_list
+   rc = gpr_init_session(src_port, callback_fn, callback_data, list_handle);
 
    ar_osal_mutex_unlock(gpr_ctxt_struct_t.gpr_drv_task_lock);
    return rc;
@@ -993,7 +1074,7 @@ uint32_t __gpr_cmd_deregister_v2(uint32_t src_port, gpr_heap_index_t heap_index)
 
    ar_osal_mutex_lock(gpr_ctxt_struct_t.gpr_drv_task_lock);
 
-   // free memory for node corresponding to the port
+   // unlink the node corresponding to the port, it is freed once in-flight deliveries release it
    (void)gpr_deinit_session(src_port, list_handle);
 
    ar_osal_mutex_unlock(gpr_ctxt_struct_t.gpr_drv_task_lock);
@@ -1039,12 +1120,8 @@ uint32_t __gpr_cmd_is_registered(uint32_t port, bool_t *is_registered)
       return AR_EBADPARAM;
    }
 
-   ar_osal_mutex_lock(gpr_ctxt_struct_t.gpr_drv_task_lock);
-
    rc = gpr_get_session_util(port, &session);
 
-   ar_osal_mutex_unlock(gpr_ctxt_struct_t.gpr_drv_task_lock);
-
    if (NULL == session)
    {
       *is_registered = FALSE;
@@ -1052,6 +1129,7 @@ uint32_t __gpr_cmd_is_registered(uint32_t port, bool_t *is_registered)
    else
    {
       *is_registered = TRUE;
+      gpr_put_session(session);
    }
 
    return rc;
@@ -24,6 +24,7 @@
 #include "gpr_memq.h"
 #include "gpr_api_inline.h"
 #include "gpr_log.h"
+#include "gpr_trace.h"
 #include "gpr_session.h"
 #include "ar_osal_servreg.h"
 #include "ar_osal_string.h"
@@ -64,6 +65,12 @@ struct ipc_dl_local_t
 // GPR driver internal MAX number of pools limit.
 #define MAX_GPR_PKT_POOLS 128
 
+// Number of address range slots used to find the static pool owning a packet, see static_pool_slot.
+#define GPR_DRV_STATIC_POOL_NUM_SLOTS 256
+
+// Marks a static_pool_slot entry not covered by any static pool, MAX_GPR_PKT_POOLS must stay below it.
+#define GPR_DRV_STATIC_POOL_NO_SLOT 0xFF
+
 // Info related to each of the static packet pool
 typedef struct gpr_drv_pkt_static_pool_info_t
 {
@@ -110,6 +117,18 @@ typedef struct gpr_ctxt_struct_t
    uint32_t                        num_static_packet_pools;
    gpr_drv_pkt_static_pool_info_t *static_pool_arr;
 
+   /* Indices into static_pool_arr sorted by packet_heap address, along with the lowest and highest
+      address covered by any static pool. Used to find the pool owning a packet without scanning all pools. */
+   uint32_t *static_pool_order;
+   char     *static_pool_min_addr;
+   char     *static_pool_max_addr;
+
+   /* The static pool address span split in equal power of two slots. Each slot holds the position in
+      static_pool_order of the first pool overlapping it. Slots are no larger than the smallest pool
+      unless the span is too sparse, so a lookup checks at most two pools. */
+   uint8_t  static_pool_slot[GPR_DRV_STATIC_POOL_NUM_SLOTS];
+   uint32_t static_pool_slot_shift;
+
    /* Packets in the dynamic pool are malloced when packet_alloc() is called. the info struct contains
        max packets that can be dynamically allocated, current num of malloced packets and each packets size. */
    uint32_t                         num_dyn_packet_pools;
@@ -128,6 +147,8 @@ void gpr_drv_isr_lock_fn(void);
 
 void gpr_drv_isr_unlock_fn(void);
 
+GPR_INTERNAL gpr_drv_pkt_static_pool_info_t *gpr_drv_get_static_pool(void *packet);
+
 GPR_INTERNAL uint32_t gpr_get_session_util(uint32_t my_module_port, gpr_module_entry_t **ret_entry);
 
 #endif /* __GPR_DRV_I_H__ */
@@ -48,6 +48,43 @@ void gpr_drv_isr_unlock_fn(void)
    (void)ar_osal_mutex_unlock(gpr_ctxt_struct_t.gpr_drv_isr_lock);
 }
 
+/* Returns the static pool owning the packet, NULL if the packet is not from a static pool. */
+GPR_INTERNAL gpr_drv_pkt_static_pool_info_t *gpr_drv_get_static_pool(void *packet)
+{
+   char                           *addr = (char *)packet;
+   gpr_drv_pkt_static_pool_info_t *pool;
+   uint32_t                        pos;
+
+   // Datalink and dynamic packets normally lie outside all static pools
+   if ((addr <= gpr_ctxt_struct_t.static_pool_min_addr) || (addr >= gpr_ctxt_struct_t.static_pool_max_addr))
+   {
+      return NULL;
+   }
+
+   // Start at the first pool overlapping the address slot, slots are normally no larger than a pool
+   pos = gpr_ctxt_struct_t.static_pool_slot[(uintptr_t)(addr - gpr_ctxt_struct_t.static_pool_min_addr) >>
+                                            gpr_ctxt_struct_t.static_pool_slot_shift];
+   if (GPR_DRV_STATIC_POOL_NO_SLOT == pos)
+   {
+      return NULL;
+   }
+
+   for (; pos < gpr_ctxt_struct_t.num_static_packet_pools; pos++)
+   {
+      pool = &gpr_ctxt_struct_t.static_pool_arr[gpr_ctxt_struct_t.static_pool_order[pos]];
+      if (addr <= pool->packet_heap)
+      {
+         break;
+      }
+      if (addr < pool->packet_heap_end)
+      {
+         return pool;
+      }
+   }
+
+   return NULL;
+}
+
 /**
   @brief Sends an asynchronous message to other modules.
 
@@ -74,9 +111,10 @@ uint32_t __gpr_cmd_async_send(gpr_packet_t *packet)
       return AR_EBADPARAM;
    }
 
-   uint32_t          domain_id  = packet->dst_domain_id;
-   uint32_t          packet_len = GPR_PKT_GET_PACKET_BYTE_SIZE(packet->header);
-   gpr_memq_block_t *block;
+   uint32_t                        domain_id  = packet->dst_domain_id;
+   uint32_t                        packet_len = GPR_PKT_GET_PACKET_BYTE_SIZE(packet->header);
+   gpr_drv_pkt_static_pool_info_t *pool;
+   gpr_memq_block_t               *block;
 
 #ifdef GPR_DEBUG_MSG
    AR_MSG(DBG_HIGH_PRIO,
@@ -91,6 +129,7 @@ uint32_t __gpr_cmd_async_send(gpr_packet_t *packet)
    {
       // Log incoming and outgoing packets
       gpr_log_packet(packet);
+      gpr_trace_packet(packet);
    }
 
    if (GPR_PL_MAX_DOMAIN_ID_V < domain_id)
@@ -113,57 +152,46 @@ uint32_t __gpr_cmd_async_send(gpr_packet_t *packet)
    // check if the packet is from a static packet pool.
    // if so, set memq metadata and then send the packet
    // else, just call send
-   bool_t pkt_is_from_the_static_pool = false;
-   for (uint32_t idx = 0; idx < gpr_ctxt_struct_t.num_static_packet_pools; idx++)
+   pool = gpr_drv_get_static_pool(packet);
+   if (NULL != pool)
    {
-      /* Freeing linked list nodes*/
-      if ((char *)packet > gpr_ctxt_struct_t.static_pool_arr[idx].packet_heap &&
-          (char *)packet < gpr_ctxt_struct_t.static_pool_arr[idx].packet_heap_end)
-      {
-         pkt_is_from_the_static_pool = true;
-
 #ifdef GPR_DEBUG_MSG
-         AR_MSG(DBG_HIGH_PRIO,
-                "gpr packet send: Destination Domain ID %hhu, Destination Port %ld",
-                packet->dst_domain_id,
-                packet->dst_port);
+      AR_MSG(DBG_HIGH_PRIO,
+             "gpr packet send: Destination Domain ID %hhu, Destination Port %ld",
+             packet->dst_domain_id,
+             packet->dst_port);
 #endif
-         if (packet_len <= gpr_ctxt_struct_t.static_pool_arr[idx].buf_size)
-         {
-            block = gpr_ctxt_struct_t.static_pool_arr[idx].free_packets_memq;
-         }
-         else
-         {
-            AR_MSG(DBG_ERROR_PRIO, "Send error %lu", packet->dst_port);
-            return AR_EFAILED;
-         }
-
-         /* Sets the packet ownership to destination before sending */
-         gpr_memq_node_set_metadata(block, packet, 0, packet->dst_port);
+      if (packet_len <= pool->buf_size)
+      {
+         block = pool->free_packets_memq;
+      }
+      else
+      {
+         AR_MSG(DBG_ERROR_PRIO, "Send error %lu", packet->dst_port);
+         return AR_EFAILED;
+      }
 
-         rc = local_gpr_ipc_dl_table[domain_id].fn_ptr->send(domain_id, packet, packet_len);
-         if (rc)
-         {
-            /* Sets the packet owner to source if send fails for any reason */
-            gpr_memq_node_set_metadata(block, packet, 0, packet->src_port);
-            AR_MSG(DBG_ERROR_PRIO,
-                   "gpr packet send failed rc %d: Destination Domain ID %hhu, Destination Port %ld Opcode %lx token "
-                   "%lx",
-                   rc,
-                   packet->dst_domain_id,
-                   packet->dst_port,
-                   packet->opcode,
-                   packet->token);
-         }
+      /* Sets the packet ownership to destination before sending */
+      gpr_memq_node_set_metadata(block, packet, 0, packet->dst_port);
 
-         // stop iterating the loop
-         break;
+      rc = local_gpr_ipc_dl_table[domain_id].fn_ptr->send(domain_id, packet, packet_len);
+      if (rc)
+      {
+         /* Sets the packet owner to source if send fails for any reason */
+         gpr_memq_node_set_metadata(block, packet, 0, packet->src_port);
+         AR_MSG(DBG_ERROR_PRIO,
+                "gpr packet send failed rc %d: Destination Domain ID %hhu, Destination Port %ld Opcode %lx token "
+                "%lx",
+                rc,
+                packet->dst_domain_id,
+                packet->dst_port,
+                packet->opcode,
+                packet->token);
       }
    }
-
-   // If the packet is not from static pool, it could be from datalink packet or dynamic packet pool.
-   if (!pkt_is_from_the_static_pool)
+   else
    {
+      // If the packet is not from static pool, it could be from datalink packet or dynamic packet pool.
 #ifdef GPR_DEBUG_MSG
       AR_MSG(DBG_HIGH_PRIO,
              "GPR datalink packet send: Destination Domain ID %hhu, Destination Port %ld",
@@ -259,13 +287,14 @@ uint32_t __gpr_cmd_alloc_v2(uint32_t alloc_size, gpr_heap_index_t heap_index, gp
          {
             found_packet_pool = TRUE;
 
-            gpr_allocate_dynamic_packet(&new_packet, packet_size);
+            gpr_allocate_dynamic_packet(&new_packet, packet_size, idx);
             if (new_packet == NULL)
             {
                AR_MSG(DBG_ERROR_PRIO, "alloc_error unsupported size %lu, heap_index: %lu", alloc_size, heap_index);
                return AR_ENORESOURCE;
             }
             gpr_ctxt_struct_t.dyn_pool_arr[idx].curr_num_packets++;
+            break;
          }
       }
    }
@@ -309,49 +338,40 @@ uint32_t __gpr_cmd_free(gpr_packet_t *packet)
       return AR_EBADPARAM;
    }
 
-   gpr_memq_block_t *block       = NULL;
-   uint32_t          packet_size = GPR_PKT_GET_PACKET_BYTE_SIZE(packet->header);
-   uint32_t          domain_id   = packet->src_domain_id;
+   gpr_memq_block_t               *block       = NULL;
+   gpr_drv_pkt_static_pool_info_t *pool        = NULL;
+   uint32_t                        packet_size = GPR_PKT_GET_PACKET_BYTE_SIZE(packet->header);
+   uint32_t                        domain_id   = packet->src_domain_id;
+   uint32_t                        dyn_pool_idx;
 
-   bool_t pkt_is_from_static_pool = FALSE;
    /* If the packet is from Static pool, mark it Free*/
-   for (uint32_t idx = 0; idx < gpr_ctxt_struct_t.num_static_packet_pools; idx++)
+   pool = gpr_drv_get_static_pool(packet);
+   if (NULL != pool)
    {
-      if ((char *)packet > gpr_ctxt_struct_t.static_pool_arr[idx].packet_heap &&
-          (char *)packet < gpr_ctxt_struct_t.static_pool_arr[idx].packet_heap_end)
+      /* If buffer is allocated by GPR*/
+      if (packet_size <= pool->buf_size)
       {
-         /* If buffer is allocated by GPR*/
-         if (packet_size <= gpr_ctxt_struct_t.static_pool_arr[idx].buf_size)
-         {
-            block = gpr_ctxt_struct_t.static_pool_arr[idx].free_packets_memq;
+         block = pool->free_packets_memq;
 
-            /* Sets the packet owner to 0 before free the packet. */
-            gpr_memq_node_set_metadata(block, packet, 0, 0);
-            gpr_memq_free(block, packet);
-            pkt_is_from_static_pool = TRUE;
-            return AR_EOK;
-         }
-         else
-         {
-            return AR_EBADPARAM;
-         }
+         /* Sets the packet owner to 0 before free the packet. */
+         gpr_memq_node_set_metadata(block, packet, 0, 0);
+         gpr_memq_free(block, packet);
+         return AR_EOK;
+      }
+      else
+      {
+         return AR_EBADPARAM;
       }
    }
 
    // If packet is not from static pool, it could be from Dynamic pool.
-   if (FALSE == pkt_is_from_static_pool)
+   if (gpr_ctxt_struct_t.num_dyn_packet_pools > 0)
    {
-      for (uint32_t idx = 0; idx < gpr_ctxt_struct_t.num_dyn_packet_pools; idx++)
+      if ((gpr_check_and_free_dynamic_packet(packet, &dyn_pool_idx) == AR_EOK) &&
+          (dyn_pool_idx < gpr_ctxt_struct_t.num_dyn_packet_pools))
       {
-         if ((packet_size <= gpr_ctxt_struct_t.dyn_pool_arr[idx].buf_size) &&
-             (gpr_ctxt_struct_t.dyn_pool_arr[idx].curr_num_packets > 0))
-         {
-            if (gpr_check_and_free_dynamic_packet(packet) == AR_EOK)
-            {
-               gpr_ctxt_struct_t.dyn_pool_arr[idx].curr_num_packets--;
-               return AR_EOK;
-            }
-         }
+         gpr_ctxt_struct_t.dyn_pool_arr[dyn_pool_idx].curr_num_packets--;
+         return AR_EOK;
       }
    }
 
@@ -430,9 +450,9 @@ uint32_t __gpr_cmd_alloc_ext(gpr_cmd_alloc_ext_t *args)
 
 uint32_t __gpr_cmd_alloc_ext_v2(gpr_cmd_alloc_ext_v2_t *args)
 {
-   uint32_t          rc;
-   gpr_packet_t     *new_packet;
-   gpr_memq_block_t *block;
+   uint32_t                        rc;
+   gpr_packet_t                   *new_packet;
+   gpr_drv_pkt_static_pool_info_t *pool;
 
    if ((NULL == args) || (NULL == args->ret_packet))
    {
@@ -454,15 +474,10 @@ uint32_t __gpr_cmd_alloc_ext_v2(gpr_cmd_alloc_ext_v2_t *args)
    new_packet->client_data   = args->client_data;
 
    // set metadata in the corresponding packets memq.
-   for (uint32_t idx = 0; idx < gpr_ctxt_struct_t.num_static_packet_pools; idx++)
+   pool = gpr_drv_get_static_pool(new_packet);
+   if (NULL != pool)
    {
-      if ((char *)new_packet > gpr_ctxt_struct_t.static_pool_arr[idx].packet_heap &&
-          (char *)new_packet < gpr_ctxt_struct_t.static_pool_arr[idx].packet_heap_end)
-      {
-         block = gpr_ctxt_struct_t.static_pool_arr[idx].free_packets_memq;
-         gpr_memq_node_set_metadata(block, new_packet, 0, new_packet->src_port);
-         break;
-      }
+      gpr_memq_node_set_metadata(pool->free_packets_memq, new_packet, 0, new_packet->src_port);
    }
 
    *args->ret_packet = new_packet;
@@ -612,15 +627,11 @@ uint32_t __gpr_cmd_end_command(gpr_packet_t *packet, uint32_t status)
          ((opcode_type & AR_GUID_TYPE_DATA_EVENT) == AR_GUID_TYPE_DATA_EVENT)))
    {
       // get GPR packet heap index
-      gpr_heap_index_t gpr_heap_index = GPR_HEAP_INDEX_DEFAULT;
-      for (uint32_t idx = 0; idx < gpr_ctxt_struct_t.num_static_packet_pools; idx++)
+      gpr_heap_index_t                gpr_heap_index = GPR_HEAP_INDEX_DEFAULT;
+      gpr_drv_pkt_static_pool_info_t *pool           = gpr_drv_get_static_pool(packet);
+      if (NULL != pool)
       {
-         /* Freeing linked list nodes*/
-         if ((char *)packet > gpr_ctxt_struct_t.static_pool_arr[idx].packet_heap &&
-             (char *)packet < gpr_ctxt_struct_t.static_pool_arr[idx].packet_heap_end)
-         {
-            gpr_heap_index = gpr_ctxt_struct_t.static_pool_arr[idx].heap_index;
-         }
+         gpr_heap_index = pool->heap_index;
       }
 
       // Reverse the source and destination addresses to send a command response.
@@ -694,12 +705,10 @@ GPR_INTERNAL uint32_t gpr_local_send(uint32_t domain_id __UNUSED, void *buf, uin
           packet->token);
 #endif
 
-   ar_osal_mutex_lock(gpr_ctxt_struct_t.gpr_drv_task_lock);
-
+   /* Lock free lookup, the session stays valid until it is put even if the port deregisters
+      meanwhile, so callbacks to different ports can run concurrently */
    result = gpr_get_session_util(packet->dst_port, &session);
 
-   ar_osal_mutex_unlock(gpr_ctxt_struct_t.gpr_drv_task_lock);
-
    if (AR_ENOTEXIST == result)
    {
       AR_MSG(DBG_ERROR_PRIO, "Session not found, returning");
@@ -715,6 +724,11 @@ GPR_INTERNAL uint32_t gpr_local_send(uint32_t domain_id __UNUSED, void *buf, uin
       AR_MSG(DBG_ERROR_PRIO, "Sending packet failed, retrieved session is null");
       rc = AR_EFAILED;
    }
+
+   if (NULL != session)
+   {
+      gpr_put_session(session);
+   }
    return rc;
 }
 
@@ -736,7 +750,7 @@ GPR_INTERNAL uint32_t gpr_local_receive_done(uint32_t domain_id __UNUSED, void *
 /*@brief Internal utility to get the session handle for the given port. It searches
          all the available cb lists in the gpr driver.
   @param[in] port          Module port number
-  @param[out] ret_entry    Return node ptr
+  @param[out] ret_entry    Return node ptr, holds a reference released with gpr_put_session
 
   @return
   #AR_EOK when successful.
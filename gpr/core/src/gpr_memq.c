@@ -16,6 +16,7 @@
 #include "gpr_memq.h"
 #include "ar_osal_mem_op.h"
 #include "ar_osal_heap.h"
+#include "ar_osal_atomic.h"
 #include "gpr_heap_i.h"
 /******************************************************************************
  * Functions                                                                   *
@@ -36,7 +37,6 @@ GPR_EXTERNAL int gpr_memq_init(gpr_memq_block_t        *block,
                                gpr_memq_lock_leave_fn_t unlock_fn,
                                gpr_heap_index_t         heap_index)
 {
-   uint32_t rc = AR_EOK;
    if ((NULL == block) || (NULL == heap_base) || (NULL == lock_fn) || (NULL == unlock_fn))
    {
       return AR_EBADPARAM;
@@ -47,28 +47,27 @@ GPR_EXTERNAL int gpr_memq_init(gpr_memq_block_t        *block,
       return AR_EBADPARAM;
    }
 
-   /* Partition the heap into fixed units in the free queue */
-   (void)gpr_list_init(&block->free_q, lock_fn, unlock_fn);
+   /* Partition the heap into fixed units, each unit links to the one after it */
    block->base_addr     = heap_base;
    block->unit_size     = unit_size;
    block->metadata_size = metadata_size;
+   block->total_units   = heap_size / unit_size;
 
-   while (heap_size >= unit_size)
+   if (block->total_units >= GPR_MEMQ_UNIT_IN_USE_V)
    {
-      (void)gpr_list_init_node((gpr_list_node_t *)heap_base);
+      return AR_EBADPARAM;
+   }
 
-      rc = gpr_list_add_tail(&block->free_q, ((gpr_list_node_t *)heap_base));
-      if (AR_EOK != rc)
-      {
-         AR_MSG(DBG_ERROR_PRIO, "GPR memq: Adding node to free queue failed, init failed rc %d", rc);
-         return rc;
-      }
+   for (uint32_t unit = 0; unit < block->total_units; unit++)
+   {
+      gpr_memq_entry_t *entry = (gpr_memq_entry_t *)(heap_base + (unit * unit_size));
 
-      heap_base += unit_size;
-      heap_size -= unit_size;
+      entry->next     = (unit + 1 < block->total_units) ? (unit + 2) : 0;
+      entry->reserved = 0;
    }
 
-   block->total_units = block->free_q.size;
+   block->free_head  = (block->total_units > 0) ? 1 : 0;
+   block->free_count = block->total_units;
 
    /*populate heap info*/
    ar_heap_info heap_info;
@@ -115,12 +114,12 @@ GPR_EXTERNAL void gpr_memq_deinit(gpr_memq_block_t *block, gpr_heap_index_t heap
       return;
    }
 
-   if (block->free_q.size != block->total_units)
+   if (ar_osal_atomic_load_u32(&block->free_count) != block->total_units)
    {
       AR_MSG(DBG_ERROR_PRIO, "memory leak detected");
    }
 
-   gpr_list_clear(&block->free_q);
+   block->free_head = 0;
 
    if (NULL != block->unique_metadata_ids)
    {
@@ -19,26 +19,37 @@ typedef void (*gpr_memq_lock_leave_fn_t)(void);
 
 /* Memory Queue Definitions */
 
+/* The free units form a lock free stack (Treiber stack). Units are referred to by their index in
+** the heap plus one so that 0 can terminate the stack, and the head carries a tag that is bumped
+** on every update so a head which was popped and pushed back in between is not mistaken for
+** unchanged (ABA). Unit memory is never released while the queue is in use, so reading the next
+** index of a unit another thread has just popped is harmless; the head update then fails. */
 typedef struct gpr_memq_block_t
 {
-   gpr_list_t free_q;
-   char_t    *base_addr;
-   uint32_t   total_units;
-   uint32_t   unit_size;
-   uint32_t   metadata_size;
-   uint32_t  *unique_metadata_ids;
-   uint32_t  *unique_metadata_counts;
+   volatile uint64_t free_head; /* [63:32] update tag, [31:0] index + 1 of the first free unit */
+   volatile uint32_t free_count;
+   char_t           *base_addr;
+   uint32_t          total_units;
+   uint32_t          unit_size;
+   uint32_t          metadata_size;
+   uint32_t         *unique_metadata_ids;
+   uint32_t         *unique_metadata_counts;
 } gpr_memq_block_t;
 
 typedef struct gpr_memq_entry_t
 {
-   gpr_list_node_t link; /* Must be first */
+   volatile uint32_t next; /* index + 1 of the next free unit, GPR_MEMQ_UNIT_IN_USE_V once allocated */
+   uint32_t          reserved;
 } gpr_memq_entry_t;
 
 #define GPR_MEMQ_BYTES_PER_METADATA_ITEM_V (sizeof(int32_t))
 #define GPR_MEMQ_UNIT_OVERHEAD_V (sizeof(gpr_memq_entry_t))
+#define GPR_MEMQ_UNIT_IN_USE_V (0xFFFFFFFF)
 
 /* Memory Queue Prototypes */
+
+/* lock_fn and unlock_fn are no longer used by the queue itself, alloc and free are lock free.
+** They are still validated so existing callers keep the same contract. */
 GPR_EXTERNAL int gpr_memq_init(gpr_memq_block_t        *block,
                                char_t                  *heap_base,
                                uint32_t                 heap_size,
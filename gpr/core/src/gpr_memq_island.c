@@ -16,6 +16,7 @@
 #include "gpr_memq.h"
 #include "ar_osal_mem_op.h"
 #include "ar_osal_heap.h"
+#include "ar_osal_atomic.h"
 
 /******************************************************************************
  * Functions                                                                   *
@@ -42,6 +43,17 @@ uint32_t gpr_memq_size_of_metadata_and_overhead(gpr_memq_block_t *block)
    return ((GPR_MEMQ_BYTES_PER_METADATA_ITEM_V * block->metadata_size) + GPR_MEMQ_UNIT_OVERHEAD_V);
 }
 
+static inline gpr_memq_entry_t *gpr_memq_entry_from_index(gpr_memq_block_t *block, uint32_t index)
+{
+   return (gpr_memq_entry_t *)(block->base_addr + ((index - 1) * block->unit_size));
+}
+
+/* Builds a new free list head pointing at index, with the tag of the old head bumped */
+static inline uint64_t gpr_memq_make_head(uint64_t old_head, uint32_t index)
+{
+   return ((((old_head >> 32) + 1) & 0xFFFFFFFF) << 32) | index;
+}
+
 GPR_EXTERNAL uint32_t gpr_memq_node_set_metadata(gpr_memq_block_t *block, void *mem_ptr, uint32_t index, int32_t value)
 {
    int32_t *metadata;
@@ -73,16 +85,26 @@ GPR_EXTERNAL uint32_t gpr_memq_node_get_metadata(gpr_memq_block_t *block,
 
 GPR_EXTERNAL void *gpr_memq_alloc(gpr_memq_block_t *block)
 {
-   gpr_list_node_t *node;
-   char_t          *mem_ptr;
-   uint32_t         md_interator;
-   uint32_t         md_index;
-   int32_t          metadata         = 0;
-   uint32_t         total_unique_mds = 0;
-
-   if (gpr_list_remove_head(&block->free_q, &node) == AR_EOK)
+   gpr_memq_entry_t *entry;
+   uint64_t          head;
+   uint32_t          next;
+   char_t           *mem_ptr;
+   uint32_t          md_interator;
+   uint32_t          md_index;
+   int32_t           metadata         = 0;
+   uint32_t          total_unique_mds = 0;
+
+   head = ar_osal_atomic_load_u64(&block->free_head);
+   while (0 != (uint32_t)head)
    {
-      return (((char_t *)node) + gpr_memq_size_of_metadata_and_overhead(block));
+      entry = gpr_memq_entry_from_index(block, (uint32_t)head);
+      next  = ar_osal_atomic_load_u32(&entry->next);
+      if (ar_osal_atomic_cmpxchg_u64(&block->free_head, &head, gpr_memq_make_head(head, next)))
+      {
+         ar_osal_atomic_store_u32(&entry->next, GPR_MEMQ_UNIT_IN_USE_V);
+         (void)ar_osal_atomic_sub_u32(&block->free_count, 1);
+         return (((char_t *)entry) + gpr_memq_size_of_metadata_and_overhead(block));
+      }
    }
 
    AR_MSG(DBG_ERROR_PRIO, "Out of memory failure");
@@ -115,18 +137,40 @@ GPR_EXTERNAL void *gpr_memq_alloc(gpr_memq_block_t *block)
 
 GPR_EXTERNAL void gpr_memq_free(gpr_memq_block_t *block, void *data_ptr)
 {
-   uint32_t         rc = AR_EOK;
-   gpr_list_node_t *node;
+   gpr_memq_entry_t *entry;
+   uint32_t          offset;
+   uint32_t          in_use = GPR_MEMQ_UNIT_IN_USE_V;
+   uint64_t          head;
 
    if ((block == NULL) || (data_ptr == NULL))
    {
       AR_MSG(DBG_ERROR_PRIO, "GPR memq: block is NULL or data ptr is NULL");
       return;
    }
-   node = ((gpr_list_node_t *)(((char_t *)data_ptr) - gpr_memq_size_of_metadata_and_overhead(block)));
-   rc   = gpr_list_add_tail(&block->free_q, node);
-   if (AR_EOK != rc)
+
+   entry  = ((gpr_memq_entry_t *)(((char_t *)data_ptr) - gpr_memq_size_of_metadata_and_overhead(block)));
+   offset = (uint32_t)((char_t *)entry - block->base_addr);
+   if (((char_t *)entry < block->base_addr) || (offset % block->unit_size) ||
+       (offset / block->unit_size >= block->total_units))
    {
-      AR_MSG(DBG_ERROR_PRIO, "GPR memq: Cannot free packet, packet is corrupted or already freed rc %d", rc);
+      AR_MSG(DBG_ERROR_PRIO, "GPR memq: Cannot free packet, packet does not belong to this queue");
+      return;
+   }
+
+   /* Claim the unit back from the in use state so a double free is caught */
+   if (!ar_osal_atomic_cmpxchg_u32(&entry->next, &in_use, 0))
+   {
+      AR_MSG(DBG_ERROR_PRIO, "GPR memq: Cannot free packet, packet is corrupted or already freed");
+      return;
    }
+
+   head = ar_osal_atomic_load_u64(&block->free_head);
+   do
+   {
+      ar_osal_atomic_store_u32(&entry->next, (uint32_t)head);
+   } while (!ar_osal_atomic_cmpxchg_u64(&block->free_head,
+                                        &head,
+                                        gpr_memq_make_head(head, (offset / block->unit_size) + 1)));
+
+   (void)ar_osal_atomic_add_u32(&block->free_count, 1);
 }
@@ -34,7 +34,8 @@
   #AR_EOK when successful.
 */
 GPR_INTERNAL uint32_t gpr_init_session(uint32_t                src_port,
-                                       gpr_module_entry_t    **ret_entry,
+                                       gpr_callback_fn_t       callback_fn,
+                                       void                   *callback_data,
                                        gpr_module_node_list_t *list_handle)
 {
    if (NULL == list_handle)
@@ -59,6 +60,14 @@ GPR_INTERNAL uint32_t gpr_init_session(uint32_t                src_port,
       return AR_ENOMEMORY;
    }
 
+   // Fill up the new node before it becomes visible to lookups
+   new_node->my_module_port        = src_port;
+   new_node->session.callback_fn   = callback_fn;
+   new_node->session.callback_data = callback_data;
+   new_node->next                  = NULL;
+   new_node->ref_cnt               = 1;
+   new_node->heap_index            = heap_index;
+
    gpr_module_node_t **chain = &list_handle->cb_list[0];
 
    // Calculate the hash index..
@@ -68,7 +77,7 @@ GPR_INTERNAL uint32_t gpr_init_session(uint32_t                src_port,
    // Check if the hashed index is empty.
    if (chain[hash_key] == NULL)
    {
-      chain[hash_key] = new_node;
+      ar_osal_atomic_store_ptr((void *volatile *)&chain[hash_key], new_node);
    }
    // collision
    else
@@ -94,14 +103,9 @@ GPR_INTERNAL uint32_t gpr_init_session(uint32_t                src_port,
          }
          temp = temp->next;
       }
-      temp->next = new_node;
+      ar_osal_atomic_store_ptr((void *volatile *)&temp->next, new_node);
    }
 
-   // Fill up the new node
-   new_node->my_module_port = src_port;
-   new_node->next           = NULL;
-
-   *ret_entry = &new_node->session;
    return AR_EOK;
 }
 
@@ -125,49 +129,27 @@ GPR_INTERNAL uint32_t gpr_deinit_session(uint32_t src_port, gpr_module_node_list
       return AR_EFAILED;
    }
 
-   gpr_heap_index_t    heap_index = list_handle->heap_index;
-   gpr_module_node_t **chain      = &list_handle->cb_list[0];
+   gpr_module_node_t **chain = &list_handle->cb_list[0];
 
-   uint32_t           MAX_CB_LIST_SIZE = list_handle->max_cb_list_size;
-   uint32_t           hash_key         = SESSION_HASH(MAX_CB_LIST_SIZE, src_port);
-   gpr_module_node_t *temp             = chain[hash_key], *dealloc;
+   uint32_t            MAX_CB_LIST_SIZE = list_handle->max_cb_list_size;
+   uint32_t            hash_key         = SESSION_HASH(MAX_CB_LIST_SIZE, src_port);
+   gpr_module_node_t **link             = &chain[hash_key];
+   gpr_module_node_t  *dealloc;
 
-   ar_heap_info heap_info;
-   gpr_populate_ar_heap_info(heap_index, AR_HEAP_ALIGN_8_BYTES, &heap_info);
-
-   if (temp != NULL)
+   while (*link != NULL)
    {
-      if ((temp->my_module_port == src_port) & (temp->next == NULL)) // when there are no other nodes linked
+      if ((*link)->my_module_port == src_port)
       {
-         dealloc         = temp;
-         chain[hash_key] = NULL;
-         ar_heap_free(dealloc, &heap_info);
+         dealloc = *link;
+
+         /* Unlink, the node keeps its next pointer so lookups currently on it can move on */
+         ar_osal_atomic_store_ptr((void *volatile *)link, dealloc->next);
+
+         gpr_session_synchronize(list_handle);
+         gpr_session_node_put(dealloc);
          return AR_EOK;
       }
-      else
-      {
-         if (temp->my_module_port == src_port) // If this is a first node and other nodes are linked to it
-         {
-            dealloc = temp->next;
-            ar_heap_free(temp, &heap_info);
-            chain[hash_key] = dealloc;
-            return AR_EOK;
-         }
-         else // not the first node and other nodes are linked to it..
-         {
-            while (temp->next != NULL)
-            {
-               if (temp->next->my_module_port == src_port) // If this is a first node and other nodes are linked to it
-               {
-                  dealloc = temp->next->next;
-                  ar_heap_free(temp->next, &heap_info);
-                  temp->next = dealloc;
-                  return AR_EOK;
-               }
-               temp = temp->next;
-            }
-         }
-      }
+      link = &(*link)->next;
    }
 
    AR_MSG(DBG_HIGH_PRIO, "No such module port (%lu) found to deinit", src_port);
@@ -38,18 +38,26 @@ GPR_INTERNAL uint32_t gpr_get_session(uint32_t                my_port,
    }
    gpr_module_node_t **chain = &list_handle->cb_list[0]; // Initialize current
    uint32_t            key   = SESSION_HASH(list_handle->max_cb_list_size, my_port);
+   uint32_t            epoch = gpr_session_read_lock(list_handle);
 
-   gpr_module_node_t *temp = chain[key];
+   gpr_module_node_t *temp = (gpr_module_node_t *)ar_osal_atomic_load_ptr((void *volatile *)&chain[key]);
 
    while (temp != NULL)
    {
       if (temp->my_module_port == my_port) // directly hashed slot finding
       {
-         *ret_entry = &temp->session;
-         return AR_EOK;
+         // fails only if the node is being deregistered right now
+         if (gpr_session_try_get(temp))
+         {
+            gpr_session_read_unlock(list_handle, epoch);
+            *ret_entry = &temp->session;
+            return AR_EOK;
+         }
+         break;
       }
-      temp = temp->next; // if it is open hashed slots
+      temp = (gpr_module_node_t *)ar_osal_atomic_load_ptr((void *volatile *)&temp->next); // if it is open hashed slots
    }
+   gpr_session_read_unlock(list_handle, epoch);
 
 #ifdef GPR_DEBUG_MSG
    AR_MSG(DBG_ERROR_PRIO, "No such module port (%lu) found in linked list", my_port);
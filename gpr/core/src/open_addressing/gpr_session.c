@@ -0,0 +1,311 @@
+/**
+ * \file gpr_session.c
+ * \brief
+ *  	This file contains GPR session implementation
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                    *
+ *****************************************************************************/
+#include "gpr_session.h"
+#include "gpr_session_table.h"
+#include "gpr_heap_i.h"
+
+/* Table size used for a list before it grows, max_cb_list_size is only a sizing hint here */
+static uint32_t gpr_session_table_initial_size(gpr_module_node_list_t *list_handle)
+{
+   uint32_t size = GPR_SESSION_TABLE_MIN_SIZE;
+
+   while (size < list_handle->max_cb_list_size)
+   {
+      size <<= 1;
+   }
+   return size;
+}
+
+/* Smallest table holding num_nodes at no more than half the maximum load, so a
+   rebuilt table takes many insertions or deletions before it is rebuilt again */
+static uint32_t gpr_session_table_size_for(gpr_module_node_list_t *list_handle, uint32_t num_nodes)
+{
+   uint32_t size = gpr_session_table_initial_size(list_handle);
+
+   while ((num_nodes * 200) > (size * GPR_SESSION_TABLE_MAX_LOAD_PCT))
+   {
+      size <<= 1;
+   }
+   return size;
+}
+
+static void gpr_session_table_free(gpr_module_node_list_t *list_handle, gpr_session_table_t *table)
+{
+   ar_heap_info heap_info;
+
+   gpr_populate_ar_heap_info(list_handle->heap_index, AR_HEAP_ALIGN_8_BYTES, &heap_info);
+   ar_heap_free(table, &heap_info);
+}
+
+/* Stores a node in the first empty slot of a table not yet visible to lookups */
+static void gpr_session_table_place(gpr_session_table_t *table, gpr_module_node_t *node)
+{
+   uint32_t idx = gpr_session_table_hash(table, node->my_module_port);
+
+   while (NULL != table->slots[idx])
+   {
+      idx = (idx + 1) & table->mask;
+   }
+   table->slots[idx] = node;
+   table->num_used++;
+}
+
+/**
+  @brief Replaces the slot table of a list
+
+  @param[in] extra_node   Node to add to the new table, NULL if none
+  @param[out] old_table   Table replaced, to be freed by the caller once
+                          gpr_session_synchronize returns
+
+  @detdesc
+  Builds a table sized for the live nodes of the current table plus
+  extra_node, dropping the deleted slots, and publishes it. When no node is
+  left the list goes back to having no table.
+
+  @return
+  #AR_EOK when successful.
+*/
+static uint32_t gpr_session_table_rebuild(gpr_module_node_list_t *list_handle,
+                                          gpr_module_node_t      *extra_node,
+                                          gpr_session_table_t   **old_table)
+{
+   gpr_session_table_t *cur_table = list_handle->table;
+   gpr_session_table_t *new_table = NULL;
+   uint32_t             num_nodes = ((NULL != cur_table) ? cur_table->num_used : 0) + ((NULL != extra_node) ? 1 : 0);
+
+   if (0 != num_nodes)
+   {
+      ar_heap_info heap_info;
+      uint32_t     size       = gpr_session_table_size_for(list_handle, num_nodes);
+      uint32_t     table_size = sizeof(gpr_session_table_t) + ((size - 1) * sizeof(gpr_module_node_t *));
+
+      gpr_populate_ar_heap_info(list_handle->heap_index, AR_HEAP_ALIGN_8_BYTES, &heap_info);
+      new_table = (gpr_session_table_t *)ar_heap_malloc(table_size, &heap_info);
+      if (NULL == new_table)
+      {
+         AR_MSG(DBG_ERROR_PRIO,
+                "Error: Failed to allocate gpr session table of %lu slots heap index %lu",
+                size,
+                list_handle->heap_index);
+         return AR_ENOMEMORY;
+      }
+      ar_mem_set(new_table, 0, table_size);
+      new_table->mask  = size - 1;
+      new_table->shift = 32;
+      for (uint32_t i = size; i > 1; i >>= 1)
+      {
+         new_table->shift--;
+      }
+
+      for (uint32_t i = 0; (NULL != cur_table) && (i <= cur_table->mask); i++)
+      {
+         if ((NULL != cur_table->slots[i]) && (GPR_SESSION_TOMBSTONE != cur_table->slots[i]))
+         {
+            gpr_session_table_place(new_table, cur_table->slots[i]);
+         }
+      }
+      if (NULL != extra_node)
+      {
+         gpr_session_table_place(new_table, extra_node);
+      }
+   }
+
+   ar_osal_atomic_store_ptr((void *volatile *)&list_handle->table, new_table);
+   *old_table = cur_table;
+   return AR_EOK;
+}
+
+/**
+  @brief Allocates memory and returns a pointer to a session
+  (contains callback function, callback argument) for a given
+  src_port
+
+  @param[in] src_port      Address/port of src module trying to register
+  @param[out] ret_entry   Double pointer to the session created
+
+  @detdesc
+  Allocates a new node for each src port and stores it in the slot table,
+  the table is rebuilt larger when the insertion would take it over
+  GPR_SESSION_TABLE_MAX_LOAD_PCT. Each node represents a session which
+  points to a callback function and corresponding callback argument which
+  will be populated by the caller of this function.
+  This is how a module registers to the GPR service.
+
+  @return
+  #AR_EOK when successful.
+*/
+GPR_INTERNAL uint32_t gpr_init_session(uint32_t                src_port,
+                                       gpr_callback_fn_t       callback_fn,
+                                       void                   *callback_data,
+                                       gpr_module_node_list_t *list_handle)
+{
+   if (NULL == list_handle)
+   {
+      return AR_EFAILED;
+   }
+
+   gpr_heap_index_t     heap_index = list_handle->heap_index;
+   gpr_session_table_t *table      = list_handle->table;
+   gpr_session_table_t *old_table  = NULL;
+   ar_heap_info         heap_info;
+   uint32_t             rc;
+   gpr_populate_ar_heap_info(heap_index, AR_HEAP_ALIGN_8_BYTES, &heap_info);
+
+   gpr_module_node_t *new_node = (gpr_module_node_t *)ar_heap_malloc(sizeof(gpr_module_node_t), &heap_info);
+   if (NULL == new_node)
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "Error: Failed to allocate gpr module node of size %d port 0x%lx heap index %lu",
+             sizeof(gpr_module_node_t),
+             src_port,
+             heap_index);
+      return AR_ENOMEMORY;
+   }
+
+   // Fill up the new node before it becomes visible to lookups
+   new_node->my_module_port        = src_port;
+   new_node->session.callback_fn   = callback_fn;
+   new_node->session.callback_data = callback_data;
+   new_node->next                  = NULL; // not chained, the table holds the node
+   new_node->ref_cnt               = 1;
+   new_node->heap_index            = heap_index;
+
+   if (NULL != table)
+   {
+      uint32_t idx      = gpr_session_table_hash(table, src_port);
+      uint32_t free_idx = table->mask + 1;
+
+      // Check for duplicate registration, remembering the first deleted slot for reuse
+      while (NULL != table->slots[idx])
+      {
+         if (GPR_SESSION_TOMBSTONE == table->slots[idx])
+         {
+            free_idx = (free_idx > table->mask) ? idx : free_idx;
+         }
+         else if (table->slots[idx]->my_module_port == src_port)
+         {
+            AR_MSG(DBG_ERROR_PRIO, "Error: Trying to register with source port %lu again, failing", src_port);
+            ar_heap_free(new_node, &heap_info);
+            return AR_EFAILED;
+         }
+         idx = (idx + 1) & table->mask;
+      }
+
+      if (free_idx <= table->mask)
+      {
+         table->num_tombstones--;
+      }
+      else if (((table->num_used + table->num_tombstones + 1) * 100) <= ((table->mask + 1) * GPR_SESSION_TABLE_MAX_LOAD_PCT))
+      {
+         free_idx = idx;
+      }
+
+      if (free_idx <= table->mask)
+      {
+         table->num_used++;
+         ar_osal_atomic_store_ptr((void *volatile *)&table->slots[free_idx], new_node);
+         return AR_EOK;
+      }
+   }
+
+   // No table yet or the table is too loaded, the new node goes into a rebuilt table
+   rc = gpr_session_table_rebuild(list_handle, new_node, &old_table);
+   if (AR_EOK != rc)
+   {
+      ar_heap_free(new_node, &heap_info);
+      return rc;
+   }
+
+   if (NULL != old_table)
+   {
+      gpr_session_synchronize(list_handle);
+      gpr_session_table_free(list_handle, old_table);
+   }
+   return AR_EOK;
+}
+
+/**
+  @brief De-allocates session memory for a given src_port
+
+  @param[in] src_port       Address/port of src module trying to de-register
+
+  @detdesc
+  Removes the node of a given src_port from the slot table and
+  de-allocates it. A table grown beyond its initial size is rebuilt
+  smaller once it drops under GPR_SESSION_TABLE_MIN_LOAD_PCT, and freed
+  with the last node.
+
+  @return
+  #AR_EOK when successful.
+*/
+GPR_INTERNAL uint32_t gpr_deinit_session(uint32_t src_port, gpr_module_node_list_t *list_handle)
+{
+   if (NULL == list_handle)
+   {
+      return AR_EFAILED;
+   }
+
+   gpr_session_table_t *table     = list_handle->table;
+   gpr_session_table_t *old_table = NULL;
+   gpr_module_node_t   *dealloc;
+   uint32_t             idx;
+
+   if (NULL == table)
+   {
+      AR_MSG(DBG_HIGH_PRIO, "No such module port (%lu) found to deinit", src_port);
+      return AR_ENOTEXIST;
+   }
+
+   for (idx = gpr_session_table_hash(table, src_port); NULL != table->slots[idx]; idx = (idx + 1) & table->mask)
+   {
+      dealloc = table->slots[idx];
+      if ((GPR_SESSION_TOMBSTONE == dealloc) || (dealloc->my_module_port != src_port))
+      {
+         continue;
+      }
+
+      /* A slot followed by an empty one ends every probe sequence through it, so it can be
+         emptied directly, otherwise it is marked deleted to keep later nodes reachable */
+      table->num_used--;
+      if (NULL == table->slots[(idx + 1) & table->mask])
+      {
+         ar_osal_atomic_store_ptr((void *volatile *)&table->slots[idx], NULL);
+      }
+      else
+      {
+         table->num_tombstones++;
+         ar_osal_atomic_store_ptr((void *volatile *)&table->slots[idx], GPR_SESSION_TOMBSTONE);
+      }
+
+      if ((0 == table->num_used) ||
+          (((table->mask + 1) > gpr_session_table_initial_size(list_handle)) &&
+           ((table->num_used * 100) < ((table->mask + 1) * GPR_SESSION_TABLE_MIN_LOAD_PCT))))
+      {
+         // keeps the current table if the smaller one cannot be allocated
+         (void)gpr_session_table_rebuild(list_handle, NULL, &old_table);
+      }
+
+      gpr_session_synchronize(list_handle);
+      gpr_session_node_put(dealloc);
+      if (NULL != old_table)
+      {
+         gpr_session_table_free(list_handle, old_table);
+      }
+      return AR_EOK;
+   }
+
+   AR_MSG(DBG_HIGH_PRIO, "No such module port (%lu) found to deinit", src_port);
+   return AR_ENOTEXIST; // NOT exists
+}
@@ -0,0 +1,75 @@
+/**
+ * \file gpr_session.c
+ * \brief
+ *  	This file contains GPR session implementation
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                    *
+ *****************************************************************************/
+#include "gpr_session.h"
+#include "gpr_session_table.h"
+
+/**
+  @brief Searches for callback function based on src port
+
+  @param[in] my_port      Address/port of module
+  @param[out] ret_entry   Double pointer to the session found
+
+  @detdesc
+  Probes the slot table from the hashed slot until the node matching
+  given src_port or an empty slot is found and returns pointer to the
+  corresponding session
+
+  @return
+  #AR_EOK when successful.
+*/
+GPR_INTERNAL uint32_t gpr_get_session(uint32_t                my_port,
+                                      gpr_module_entry_t    **ret_entry,
+                                      gpr_module_node_list_t *list_handle)
+{
+   if (NULL == list_handle)
+   {
+      return AR_EFAILED;
+   }
+   uint32_t             epoch = gpr_session_read_lock(list_handle);
+   gpr_session_table_t *table = (gpr_session_table_t *)ar_osal_atomic_load_ptr((void *volatile *)&list_handle->table);
+   gpr_module_node_t   *node;
+
+   if (NULL != table)
+   {
+      uint32_t idx = gpr_session_table_hash(table, my_port);
+
+      // the load factor guarantees an empty slot, the bound only guards a corrupt table
+      for (uint32_t probe = 0; probe <= table->mask; probe++, idx = (idx + 1) & table->mask)
+      {
+         node = (gpr_module_node_t *)ar_osal_atomic_load_ptr((void *volatile *)&table->slots[idx]);
+         if (NULL == node)
+         {
+            break;
+         }
+         if ((GPR_SESSION_TOMBSTONE != node) && (node->my_module_port == my_port))
+         {
+            // fails only if the node is being deregistered right now
+            if (gpr_session_try_get(node))
+            {
+               gpr_session_read_unlock(list_handle, epoch);
+               *ret_entry = &node->session;
+               return AR_EOK;
+            }
+            break;
+         }
+      }
+   }
+   gpr_session_read_unlock(list_handle, epoch);
+
+#ifdef GPR_DEBUG_MSG
+   AR_MSG(DBG_ERROR_PRIO, "No such module port (%lu) found in session table", my_port);
+#endif
+   return AR_ENOTEXIST;
+}
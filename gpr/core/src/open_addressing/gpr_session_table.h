@@ -0,0 +1,54 @@
+#ifndef _GPR_SESSION_TABLE_H_
+#define _GPR_SESSION_TABLE_H_
+
+/**
+ * \file gpr_session_table.h
+ * \brief
+ *  	This file contains the slot table of the open addressing GPR session lookup
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "gpr_session.h"
+
+/* Smallest table allocated, must be a power of 2 */
+#ifndef GPR_SESSION_TABLE_MIN_SIZE
+#define GPR_SESSION_TABLE_MIN_SIZE (8)
+#endif
+
+/* The table is rebuilt once live and deleted slots exceed this percentage of it */
+#ifndef GPR_SESSION_TABLE_MAX_LOAD_PCT
+#define GPR_SESSION_TABLE_MAX_LOAD_PCT (70)
+#endif
+
+/* A table grown beyond its initial size is shrunk once live slots drop below this percentage */
+#ifndef GPR_SESSION_TABLE_MIN_LOAD_PCT
+#define GPR_SESSION_TABLE_MIN_LOAD_PCT (15)
+#endif
+
+/* Marks a deleted slot, probing continues past it. Nodes are 8 byte aligned so it never matches one */
+#define GPR_SESSION_TOMBSTONE ((gpr_module_node_t *)(uintptr_t)1)
+
+/* Linear probing table of node pointers. Lookups read the table published in
+   gpr_module_node_list_t::table without a lock, a resize publishes a new table and the old
+   one is freed after gpr_session_synchronize. The counters are only used by the writer. */
+struct gpr_session_table_t
+{
+   uint32_t           mask;           // number of slots - 1
+   uint32_t           shift;          // 32 - log2(number of slots), used by the hash
+   uint32_t           num_used;       // slots holding a node
+   uint32_t           num_tombstones; // slots holding GPR_SESSION_TOMBSTONE
+   gpr_module_node_t *slots[1];       // mask + 1 slots
+};
+
+/* Fibonacci hashing, ports are often sequential within a range so the
+   top bits of the product spread them better than a modulo */
+static inline uint32_t gpr_session_table_hash(const gpr_session_table_t *table, uint32_t port)
+{
+   return (uint32_t)(port * 0x9E3779B1u) >> table->shift;
+}
+
+#endif /* _GPR_SESSION_TABLE_H_ */
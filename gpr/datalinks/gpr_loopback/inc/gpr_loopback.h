@@ -0,0 +1,53 @@
+/*
+ * gpr_loopback.h
+ *
+ * In-process loopback datalink. Packets sent to the remote domain are
+ * answered by a minimal SPF responder instead of a DSP, so the host side
+ * stack can be run without the GPR drivers.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __GPR_LOOPBACK_H__
+#define __GPR_LOOPBACK_H__
+
+#include "gpr_comdef.h"
+#include "gpr_packet.h"
+#include "ipc_dl_api.h"
+
+/******************************************************************************
+ * Defines                                                                    *
+ *****************************************************************************/
+/*Response latency of the SPF responder*/
+typedef struct gpr_loopback_config_t
+{
+   uint32_t cmd_latency_us;  /* delay before control commands are acknowledged */
+   uint32_t data_latency_us; /* delay before data buffers are returned */
+} gpr_loopback_config_t;
+
+/*Set the response latency, takes effect for packets sent afterwards*/
+GPR_INTERNAL uint32_t ipc_dl_loopback_set_config(const gpr_loopback_config_t *cfg);
+
+/*IPC datalink init function called from gpr layer for the loopback*/
+GPR_INTERNAL uint32_t ipc_dl_loopback_init(uint32_t                 src_domain_id,
+                                           uint32_t                 dest_domain_id,
+                                           const gpr_to_ipc_vtbl_t *p_gpr_to_ipc_vtbl,
+                                           ipc_to_gpr_vtbl_t **     pp_ipc_to_gpr_vtbl);
+
+/*IPC datalink de-init function called from gpr layer for the loopback*/
+GPR_INTERNAL uint32_t ipc_dl_loopback_deinit(uint32_t src_domain_id, uint32_t dest_domain_id);
+
+/*
+ * Builds the response the SPF would send for cmd into rsp, which must be
+ * at least as large as the command or GPR_SPF_STUB_MIN_RSP_SIZE. Returns
+ * AR_ENOTEXIST when the packet needs no response, is_data is set for data
+ * path responses.
+ */
+#define GPR_SPF_STUB_MIN_RSP_SIZE 128
+GPR_INTERNAL uint32_t gpr_spf_stub_respond(const gpr_packet_t *cmd,
+                                           uint32_t            cmd_size,
+                                           gpr_packet_t *      rsp,
+                                           uint32_t            rsp_buf_size,
+                                           bool_t *            is_data);
+
+#endif /* __GPR_LOOPBACK_H__ */
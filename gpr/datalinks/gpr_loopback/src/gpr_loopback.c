@@ -0,0 +1,273 @@
+/*
+ * gpr_loopback.c
+ *
+ * In-process loopback datalink. Every packet sent to the remote domain is
+ * consumed immediately and answered by the SPF stub after the configured
+ * latency, responses are delivered to GPR from a responder thread the same
+ * way the Linux datalink delivers packets read from the driver.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#define LOG_TAG "gpr_dl_loopback"
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "ar_osal_log.h"
+#include "ar_osal_error.h"
+#include "gpr_comdef.h"
+#include "ipc_dl_api.h"
+#include "gpr_ids_domains.h"
+#include "gpr_packet.h"
+#include "gpr_loopback.h"
+
+#ifndef GPR_LOOPBACK_CMD_LATENCY_US
+#define GPR_LOOPBACK_CMD_LATENCY_US 0
+#endif
+#ifndef GPR_LOOPBACK_DATA_LATENCY_US
+#define GPR_LOOPBACK_DATA_LATENCY_US 0
+#endif
+
+/* Response waiting to be delivered, the packet follows in the same allocation */
+typedef struct gpr_loopback_rsp{
+    struct gpr_loopback_rsp *next;
+    uint64_t due_us;
+    uint64_t packet[]; /* 8 byte aligned like the driver buffers */
+}gpr_loopback_rsp_t;
+
+typedef struct gpr_loopback_port{
+    uint32_t domain_id;
+    uint32_t (*rx_cb)(void *buf, uint32_t length);
+    uint32_t (*send_done)(void *buf, uint32_t length);
+    pthread_t responder_thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    /* responses ordered by due time, equal times keep the send order */
+    gpr_loopback_rsp_t *pending;
+    bool thread_exit;
+} gpr_loopback_port_t;
+
+static gpr_loopback_port_t *gpr_loopback_ports[GPR_PL_NUM_TOTAL_DOMAINS_V];
+
+static gpr_loopback_config_t gpr_loopback_cfg = {
+    GPR_LOOPBACK_CMD_LATENCY_US,
+    GPR_LOOPBACK_DATA_LATENCY_US,
+};
+
+static uint32_t gpr_loopback_send(uint32_t domain_id, void *buf, uint32_t size);
+
+static uint32_t gpr_loopback_receive_done(uint32_t domain_id, void *buf);
+
+/*ipc datalink function table*/
+static ipc_to_gpr_vtbl_t gpr_loopback_vtbl =
+{
+   gpr_loopback_send,
+   gpr_loopback_receive_done,
+};
+
+static uint64_t gpr_loopback_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void *responder_thread_loop(void *priv_data)
+{
+    gpr_loopback_port_t *port = (gpr_loopback_port_t *)priv_data;
+    gpr_loopback_rsp_t *rsp;
+    gpr_packet_t *packet;
+    struct timespec ts;
+    uint64_t now_us;
+
+    pthread_mutex_lock(&port->lock);
+    while (!port->thread_exit) {
+        if (port->pending == NULL) {
+            pthread_cond_wait(&port->cond, &port->lock);
+            continue;
+        }
+        now_us = gpr_loopback_now_us();
+        if (port->pending->due_us > now_us) {
+            ts.tv_sec = port->pending->due_us / 1000000;
+            ts.tv_nsec = (port->pending->due_us % 1000000) * 1000;
+            pthread_cond_timedwait(&port->cond, &port->lock, &ts);
+            continue;
+        }
+        rsp = port->pending;
+        port->pending = rsp->next;
+        pthread_mutex_unlock(&port->lock);
+
+        /* GPR returns the packet through receive_done once it is handled */
+        packet = (gpr_packet_t *)rsp->packet;
+        if (port->rx_cb(packet, GPR_PKT_GET_PACKET_BYTE_SIZE(packet->header)) != AR_EOK)
+            AR_LOG_ERR(LOG_TAG,"%s:%d receive callback failed", __func__, __LINE__);
+
+        pthread_mutex_lock(&port->lock);
+    }
+
+    /* responses not delivered yet are dropped */
+    while ((rsp = port->pending) != NULL) {
+        port->pending = rsp->next;
+        free(rsp);
+    }
+    pthread_mutex_unlock(&port->lock);
+    return NULL;
+}
+
+static uint32_t gpr_loopback_send(uint32_t domain_id, void *buf, uint32_t size)
+{
+    gpr_loopback_port_t *port;
+    gpr_loopback_rsp_t *rsp, **pos;
+    uint32_t rsp_buf_size;
+    uint32_t status;
+    bool_t is_data = FALSE;
+
+    if ((domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V) ||
+        ((port = gpr_loopback_ports[domain_id]) == NULL)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d port domain %d not initialized", __func__, __LINE__,
+              domain_id);
+        return AR_ENOTEXIST;
+    }
+
+    rsp_buf_size = (size > GPR_SPF_STUB_MIN_RSP_SIZE) ? size : GPR_SPF_STUB_MIN_RSP_SIZE;
+    rsp = (gpr_loopback_rsp_t *)malloc(sizeof(gpr_loopback_rsp_t) + rsp_buf_size);
+    if (rsp == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d malloc failed", __func__, __LINE__);
+        return AR_ENOMEMORY;
+    }
+
+    status = gpr_spf_stub_respond((gpr_packet_t *)buf, size,
+                                  (gpr_packet_t *)rsp->packet, rsp_buf_size, &is_data);
+    if (status == AR_EBADPARAM) {
+        free(rsp);
+        return status;
+    }
+
+    /* the command has been consumed by the remote side */
+    port->send_done(buf, size);
+
+    if (status != AR_EOK) {
+        free(rsp);
+        return AR_EOK;
+    }
+
+    rsp->due_us = gpr_loopback_now_us() +
+                  (is_data ? gpr_loopback_cfg.data_latency_us : gpr_loopback_cfg.cmd_latency_us);
+    rsp->next = NULL;
+
+    pthread_mutex_lock(&port->lock);
+    for (pos = &port->pending; *pos && (*pos)->due_us <= rsp->due_us; pos = &(*pos)->next)
+        ;
+    rsp->next = *pos;
+    *pos = rsp;
+    if (port->pending == rsp)
+        pthread_cond_signal(&port->cond);
+    pthread_mutex_unlock(&port->lock);
+    return AR_EOK;
+}
+
+static uint32_t gpr_loopback_receive_done(uint32_t domain_id, void *buf)
+{
+    if (buf == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d NULL buffer from domain %d", __func__, __LINE__, domain_id);
+        return AR_EBADPARAM;
+    }
+    free((char *)buf - offsetof(gpr_loopback_rsp_t, packet));
+    return AR_EOK;
+}
+
+uint32_t ipc_dl_loopback_set_config(const gpr_loopback_config_t *cfg)
+{
+    if (cfg == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d invalid config", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+    gpr_loopback_cfg = *cfg;
+    return AR_EOK;
+}
+
+uint32_t ipc_dl_loopback_init(uint32_t src_domain_id,
+                              uint32_t dest_domain_id,
+                              const gpr_to_ipc_vtbl_t *p_gpr_to_ipc_vtbl,
+                              ipc_to_gpr_vtbl_t ** pp_ipc_to_gpr_vtbl)
+{
+    gpr_loopback_port_t *port;
+    pthread_condattr_t cattr;
+    int status;
+
+    if ((dest_domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V) ||
+        (src_domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V) ||
+        (p_gpr_to_ipc_vtbl == NULL) || (pp_ipc_to_gpr_vtbl == NULL) ||
+        (p_gpr_to_ipc_vtbl->receive == NULL) || (p_gpr_to_ipc_vtbl->send_done == NULL)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d invalid param (src domain id %d, dst domain id %d)",
+                __func__, __LINE__, src_domain_id, dest_domain_id);
+        return AR_EBADPARAM;
+    }
+
+    if (gpr_loopback_ports[dest_domain_id] != NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d port already setup for domain id:%d", __func__, __LINE__,
+               dest_domain_id);
+        *pp_ipc_to_gpr_vtbl = &gpr_loopback_vtbl;
+        return AR_EOK;
+    }
+
+    port = (gpr_loopback_port_t *)calloc(1, sizeof(gpr_loopback_port_t));
+    if (port == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d malloc failed", __func__, __LINE__);
+        return AR_ENOMEMORY;
+    }
+    port->domain_id = dest_domain_id;
+    port->rx_cb = p_gpr_to_ipc_vtbl->receive;
+    port->send_done = p_gpr_to_ipc_vtbl->send_done;
+
+    /* due times come from the monotonic clock, wait on the same clock */
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&port->cond, &cattr);
+    pthread_condattr_destroy(&cattr);
+    pthread_mutex_init(&port->lock, (const pthread_mutexattr_t *) NULL);
+
+    status = pthread_create(&port->responder_thread, NULL, responder_thread_loop, port);
+    if (status) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d error:%d pthread_create fail", __func__, __LINE__, status);
+        pthread_cond_destroy(&port->cond);
+        pthread_mutex_destroy(&port->lock);
+        free(port);
+        return AR_EFAILED;
+    }
+    pthread_setname_np(port->responder_thread, "gpr_loopback");
+
+    gpr_loopback_ports[dest_domain_id] = port;
+    *pp_ipc_to_gpr_vtbl = &gpr_loopback_vtbl;
+    AR_LOG_INFO(LOG_TAG,"%s:%d loopback for src domain id %d and dst domain id %d",
+            __func__, __LINE__, src_domain_id, dest_domain_id);
+    return AR_EOK;
+}
+
+uint32_t ipc_dl_loopback_deinit(uint32_t src_domain_id, uint32_t dest_domain_id)
+{
+    gpr_loopback_port_t *port;
+
+    if ((dest_domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V) ||
+        ((port = gpr_loopback_ports[dest_domain_id]) == NULL)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d deinit already done", __func__, __LINE__);
+        return AR_EOK;
+    }
+    gpr_loopback_ports[dest_domain_id] = NULL;
+
+    pthread_mutex_lock(&port->lock);
+    port->thread_exit = true;
+    pthread_cond_signal(&port->cond);
+    pthread_mutex_unlock(&port->lock);
+
+    if (pthread_join(port->responder_thread, NULL))
+        AR_LOG_ERR(LOG_TAG,"%s:%d pthread_join failed", __func__, __LINE__);
+    pthread_cond_destroy(&port->cond);
+    pthread_mutex_destroy(&port->lock);
+    free(port);
+    return AR_EOK;
+}
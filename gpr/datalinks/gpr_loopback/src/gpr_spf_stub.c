@@ -0,0 +1,229 @@
+/*
+ * gpr_spf_stub.c
+ *
+ * Minimal SPF responder for the loopback datalink. Commands are acknowledged
+ * the way the APM and shared memory endpoints would, nothing is executed.
+ *
+ * Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#define LOG_TAG "gpr_spf_stub"
+
+#include <string.h>
+#include "ar_osal_log.h"
+#include "ar_osal_error.h"
+#include "ar_osal_atomic.h"
+#include "gpr_msg_if.h"
+#include "apm_api.h"
+#include "apm_memmap_api.h"
+#include "wr_sh_mem_ep_api.h"
+#include "rd_sh_mem_ep_api.h"
+#include "gpr_loopback.h"
+
+/* Upper byte of an opcode gives its type, only commands are answered */
+#define GPR_SPF_STUB_OPCODE_TYPE(opcode) ((opcode) >> 24)
+#define GPR_SPF_STUB_CMD_TYPE 0x01
+#define GPR_SPF_STUB_DATA_CMD_TYPE 0x04
+
+/* Handles returned for memory map commands, never 0 */
+static volatile uint32_t gpr_spf_stub_mem_map_handle;
+
+static void *gpr_spf_stub_init_rsp(const gpr_packet_t *cmd, gpr_packet_t *rsp,
+                                   uint32_t opcode, uint32_t payload_size)
+{
+    uint32_t size = GPR_PKT_HEADER_BYTE_SIZE_V + payload_size;
+
+    memset(rsp, 0, size);
+    rsp->header = GPR_SET_FIELD(GPR_PKT_VERSION, GPR_PKT_VERSION_V) |
+                  GPR_SET_FIELD(GPR_PKT_HEADER_SIZE, GPR_PKT_HEADER_WORD_SIZE_V) |
+                  GPR_SET_FIELD(GPR_PKT_PACKET_SIZE, size);
+    rsp->dst_domain_id = cmd->src_domain_id;
+    rsp->src_domain_id = cmd->dst_domain_id;
+    rsp->dst_port = cmd->src_port;
+    rsp->src_port = cmd->dst_port;
+    rsp->token = cmd->token;
+    rsp->opcode = opcode;
+    return GPR_PKT_GET_PAYLOAD(void, rsp);
+}
+
+static void gpr_spf_stub_basic_rsp(const gpr_packet_t *cmd, gpr_packet_t *rsp,
+                                   uint32_t status)
+{
+    gpr_ibasic_rsp_result_t *result;
+
+    result = (gpr_ibasic_rsp_result_t *)gpr_spf_stub_init_rsp(cmd, rsp,
+                GPR_IBASIC_RSP_RESULT, sizeof(gpr_ibasic_rsp_result_t));
+    result->opcode = cmd->opcode;
+    result->status = status;
+}
+
+/* Echoes in band parameters back, out of band data is left untouched */
+static void gpr_spf_stub_get_cfg_rsp(const gpr_packet_t *cmd, uint32_t payload_size,
+                                     gpr_packet_t *rsp)
+{
+    apm_cmd_header_t *cmd_hdr = GPR_PKT_GET_PAYLOAD(apm_cmd_header_t, cmd);
+    apm_cmd_rsp_get_cfg_t *cfg_rsp;
+    uint32_t param_size = 0;
+
+    if ((cmd_hdr->mem_map_handle == 0) &&
+        (cmd_hdr->payload_size <= payload_size - sizeof(apm_cmd_header_t)))
+        param_size = cmd_hdr->payload_size;
+
+    cfg_rsp = (apm_cmd_rsp_get_cfg_t *)gpr_spf_stub_init_rsp(cmd, rsp,
+                APM_CMD_RSP_GET_CFG, sizeof(apm_cmd_rsp_get_cfg_t) + param_size);
+    cfg_rsp->status = AR_EOK;
+    memcpy(cfg_rsp + 1, cmd_hdr + 1, param_size);
+}
+
+uint32_t gpr_spf_stub_respond(const gpr_packet_t *cmd, uint32_t cmd_size,
+                              gpr_packet_t *rsp, uint32_t rsp_buf_size,
+                              bool_t *is_data)
+{
+    uint32_t payload_size;
+    uint32_t type;
+
+    if ((cmd == NULL) || (rsp == NULL) || (is_data == NULL) ||
+        (cmd_size < GPR_PKT_HEADER_BYTE_SIZE_V) ||
+        (cmd_size != GPR_PKT_GET_PACKET_BYTE_SIZE(cmd->header)) ||
+        (rsp_buf_size < cmd_size) || (rsp_buf_size < GPR_SPF_STUB_MIN_RSP_SIZE)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d invalid param", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+
+    type = GPR_SPF_STUB_OPCODE_TYPE(cmd->opcode);
+    if ((type != GPR_SPF_STUB_CMD_TYPE) && (type != GPR_SPF_STUB_DATA_CMD_TYPE))
+        return AR_ENOTEXIST;
+
+    *is_data = (type == GPR_SPF_STUB_DATA_CMD_TYPE);
+    payload_size = GPR_PKT_GET_PAYLOAD_BYTE_SIZE(cmd->header);
+    AR_LOG_VERBOSE(LOG_TAG,"%s:%d opcode 0x%x port 0x%x token 0x%x", __func__, __LINE__,
+                   cmd->opcode, cmd->dst_port, cmd->token);
+
+    switch (cmd->opcode) {
+    case APM_CMD_GET_SPF_STATE:
+    {
+        apm_cmd_rsp_get_spf_status_t *state;
+
+        state = (apm_cmd_rsp_get_spf_status_t *)gpr_spf_stub_init_rsp(cmd, rsp,
+                    APM_CMD_RSP_GET_SPF_STATE, sizeof(apm_cmd_rsp_get_spf_status_t));
+        state->status = APM_SPF_STATE_READY;
+        break;
+    }
+    case APM_CMD_SHARED_MEM_MAP_REGIONS:
+    case APM_CMD_SHARED_SATELLITE_MEM_MAP_REGIONS:
+    {
+        apm_cmd_rsp_shared_mem_map_regions_t *map;
+
+        map = (apm_cmd_rsp_shared_mem_map_regions_t *)gpr_spf_stub_init_rsp(cmd, rsp,
+                  (cmd->opcode == APM_CMD_SHARED_MEM_MAP_REGIONS) ?
+                  APM_CMD_RSP_SHARED_MEM_MAP_REGIONS :
+                  APM_CMD_RSP_SHARED_SATELLITE_MEM_MAP_REGIONS,
+                  sizeof(apm_cmd_rsp_shared_mem_map_regions_t));
+        map->mem_map_handle = ar_osal_atomic_add_u32(&gpr_spf_stub_mem_map_handle, 1);
+        break;
+    }
+    case APM_CMD_GET_CFG:
+        if (payload_size < sizeof(apm_cmd_header_t))
+            goto bad_payload;
+        gpr_spf_stub_get_cfg_rsp(cmd, payload_size, rsp);
+        break;
+    case DATA_CMD_WR_SH_MEM_EP_DATA_BUFFER:
+    {
+        data_cmd_wr_sh_mem_ep_data_buffer_t *wr;
+        data_cmd_rsp_wr_sh_mem_ep_data_buffer_done_t *done;
+
+        if (payload_size < sizeof(*wr))
+            goto bad_payload;
+        wr = GPR_PKT_GET_PAYLOAD(data_cmd_wr_sh_mem_ep_data_buffer_t, cmd);
+        done = (data_cmd_rsp_wr_sh_mem_ep_data_buffer_done_t *)gpr_spf_stub_init_rsp(cmd,
+                   rsp, DATA_CMD_RSP_WR_SH_MEM_EP_DATA_BUFFER_DONE, sizeof(*done));
+        done->buf_addr_lsw = wr->buf_addr_lsw;
+        done->buf_addr_msw = wr->buf_addr_msw;
+        done->mem_map_handle = wr->mem_map_handle;
+        done->status = AR_EOK;
+        break;
+    }
+    case DATA_CMD_WR_SH_MEM_EP_DATA_BUFFER_V2:
+    {
+        data_cmd_wr_sh_mem_ep_data_buffer_v2_t *wr;
+        data_cmd_rsp_wr_sh_mem_ep_data_buffer_done_v2_t *done;
+
+        if (payload_size < sizeof(*wr))
+            goto bad_payload;
+        wr = GPR_PKT_GET_PAYLOAD(data_cmd_wr_sh_mem_ep_data_buffer_v2_t, cmd);
+        done = (data_cmd_rsp_wr_sh_mem_ep_data_buffer_done_v2_t *)gpr_spf_stub_init_rsp(cmd,
+                   rsp, DATA_CMD_RSP_WR_SH_MEM_EP_DATA_BUFFER_DONE_V2, sizeof(*done));
+        done->data_buf_addr_lsw = wr->data_buf_addr_lsw;
+        done->data_buf_addr_msw = wr->data_buf_addr_msw;
+        done->data_mem_map_handle = wr->data_mem_map_handle;
+        done->data_status = AR_EOK;
+        done->md_buf_addr_lsw = wr->md_buf_addr_lsw;
+        done->md_buf_addr_msw = wr->md_buf_addr_msw;
+        done->md_mem_map_handle = wr->md_mem_map_handle;
+        done->md_status = AR_EOK;
+        break;
+    }
+    case DATA_CMD_WR_SH_MEM_EP_EOS:
+    {
+        data_cmd_rsp_wr_sh_mem_ep_eos_rendered_t *eos;
+
+        eos = (data_cmd_rsp_wr_sh_mem_ep_eos_rendered_t *)gpr_spf_stub_init_rsp(cmd, rsp,
+                  DATA_CMD_RSP_WR_SH_MEM_EP_EOS_RENDERED, sizeof(*eos));
+        eos->module_instance_id = cmd->dst_port;
+        eos->render_status = WR_SH_MEM_EP_EOS_RENDER_STATUS_RENDERED;
+        break;
+    }
+    case DATA_CMD_RD_SH_MEM_EP_DATA_BUFFER:
+    {
+        data_cmd_rd_sh_mem_ep_data_buffer_t *rd;
+        data_cmd_rsp_rd_sh_mem_ep_data_buffer_done_t *done;
+
+        if (payload_size < sizeof(*rd))
+            goto bad_payload;
+        rd = GPR_PKT_GET_PAYLOAD(data_cmd_rd_sh_mem_ep_data_buffer_t, cmd);
+        done = (data_cmd_rsp_rd_sh_mem_ep_data_buffer_done_t *)gpr_spf_stub_init_rsp(cmd,
+                   rsp, DATA_CMD_RSP_RD_SH_MEM_EP_DATA_BUFFER_DONE, sizeof(*done));
+        done->status = AR_EOK;
+        done->buf_addr_lsw = rd->buf_addr_lsw;
+        done->buf_addr_msw = rd->buf_addr_msw;
+        done->mem_map_handle = rd->mem_map_handle;
+        /* report the buffer as filled, its content is whatever the client left */
+        done->data_size = rd->buf_size;
+        done->num_frames = 1;
+        break;
+    }
+    case DATA_CMD_RD_SH_MEM_EP_DATA_BUFFER_V2:
+    {
+        data_cmd_rd_sh_mem_ep_data_buffer_v2_t *rd;
+        data_cmd_rsp_rd_sh_mem_ep_data_buffer_done_v2_t *done;
+
+        if (payload_size < sizeof(*rd))
+            goto bad_payload;
+        rd = GPR_PKT_GET_PAYLOAD(data_cmd_rd_sh_mem_ep_data_buffer_v2_t, cmd);
+        done = (data_cmd_rsp_rd_sh_mem_ep_data_buffer_done_v2_t *)gpr_spf_stub_init_rsp(cmd,
+                   rsp, DATA_CMD_RSP_RD_SH_MEM_EP_DATA_BUFFER_DONE_V2, sizeof(*done));
+        done->data_status = AR_EOK;
+        done->data_buf_addr_lsw = rd->data_buf_addr_lsw;
+        done->data_buf_addr_msw = rd->data_buf_addr_msw;
+        done->data_mem_map_handle = rd->data_mem_map_handle;
+        done->data_size = rd->data_buf_size;
+        done->num_frames = 1;
+        done->md_status = AR_EOK;
+        done->md_buf_addr_lsw = rd->md_buf_addr_lsw;
+        done->md_buf_addr_msw = rd->md_buf_addr_msw;
+        done->md_mem_map_handle = rd->md_mem_map_handle;
+        break;
+    }
+    default:
+        /* graph management, set config, module loading and the rest just succeed */
+        gpr_spf_stub_basic_rsp(cmd, rsp, AR_EOK);
+        break;
+    }
+    return AR_EOK;
+
+bad_payload:
+    AR_LOG_ERR(LOG_TAG,"%s:%d opcode 0x%x payload too small %d", __func__, __LINE__,
+               cmd->opcode, payload_size);
+    gpr_spf_stub_basic_rsp(cmd, rsp, AR_EBADPARAM);
+    return AR_EOK;
+}
@@ -13,6 +13,39 @@
 /******************************************************************************
  * Defines                                                                    *
  *****************************************************************************/
+/*Receive side configuration of the Linux datalink*/
+typedef struct gpr_dl_lx_config_t
+{
+   uint32_t num_buffers; /* receive buffers per port, GPR_DL_LX_NO_OF_BUFFERS by default */
+   uint32_t buf_size;    /* size of each receive buffer in bytes, GPR_DL_LX_BUF_SIZE by default */
+   bool_t   batch_rx;    /* drain all queued packets per wakeup, enabled by default */
+   bool_t   spsc_rx;     /* receive buffers are returned from a single thread, the free
+                            ring is then used without a lock, disabled by default */
+   uint32_t tx_queue_depth; /* packets queued for the sender thread, 0 writes from the
+                               caller thread, GPR_DL_LX_TX_QUEUE_DEPTH by default */
+} gpr_dl_lx_config_t;
+
+/*Transmit queue statistics of one port*/
+typedef struct gpr_dl_lx_tx_stats_t
+{
+   uint32_t queue_depth;      /* packets currently queued */
+   uint32_t max_queue_depth;  /* highest number of packets queued at once */
+   uint32_t num_sent;         /* packets written to the driver */
+   uint32_t num_failed;       /* packets the driver failed to accept, dropped */
+   uint32_t num_rejected;     /* sends refused with AR_EBUSY as the queue was full */
+   uint64_t total_latency_us; /* time from queueing to send done, summed over sent and failed */
+   uint64_t max_latency_us;   /* longest time from queueing to send done */
+} gpr_dl_lx_tx_stats_t;
+
+/*Set the configuration used by ports initialized afterwards, call before gpr init*/
+GPR_INTERNAL uint32_t ipc_dl_lx_set_config(const gpr_dl_lx_config_t *cfg);
+
+/*Get the configuration used by ports initialized from now on*/
+GPR_INTERNAL uint32_t ipc_dl_lx_get_config(gpr_dl_lx_config_t *cfg);
+
+/*Get the transmit queue statistics of a port, AR_EUNSUPPORTED if it has no queue*/
+GPR_INTERNAL uint32_t ipc_dl_lx_get_tx_stats(uint32_t domain_id, gpr_dl_lx_tx_stats_t *stats);
+
 /*IPC datalink init function called from gpr layer for glink*/
 GPR_INTERNAL uint32_t ipc_dl_lx_init(uint32_t                 src_domain_id,
                                         uint32_t                 dest_domain_id,
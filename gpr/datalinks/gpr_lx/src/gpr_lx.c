@@ -17,10 +17,8 @@
 #include "ar_osal_log.h"
 
 #ifdef GPR_USE_CUTILS
-#include <cutils/list.h>
 #include <sys/poll.h>
 #else
-#include "list.h"
 #include "poll.h"
 #endif
 
@@ -28,14 +26,39 @@
 #include "gpr_comdef.h"
 #include "ipc_dl_api.h"
 #include "gpr_ids_domains.h"
+#include "gpr_packet.h"
 #include "ar_osal_error.h"
+#include "ar_osal_atomic.h"
+#include "ar_osal_timer.h"
+#include "gpr_lx.h"
 
 #define GPR_DL_LX_ADSP_DRV "/dev/aud_pasthru_adsp"
 #define GPR_DL_LX_CC_DSP_DRV "/dev/gpr_channel"
 #define GPR_DL_LX_MODEM_DRV "/dev/aud_pasthru_modem"
 #define GPR_DL_LX_APPS_SPF_DRV "/dev/aud_pasthru_apps"
+#ifndef GPR_DL_LX_BUF_SIZE
 #define GPR_DL_LX_BUF_SIZE 4096 /*bytes*/
+#endif
+#ifndef GPR_DL_LX_NO_OF_BUFFERS
 #define GPR_DL_LX_NO_OF_BUFFERS 8
+#endif
+/* 0 keeps sends synchronous on the caller thread */
+#ifndef GPR_DL_LX_TX_QUEUE_DEPTH
+#define GPR_DL_LX_TX_QUEUE_DEPTH 0
+#endif
+/*
+ * Each receive buffer is preceded by a header pointing back to its
+ * descriptor, sized to keep the buffer 8 byte aligned
+ */
+#define GPR_DL_LX_BUF_HDR_SIZE 8
+
+/*
+ * Buffers handed out twice are caught by tracking ownership per descriptor,
+ * only built in debug configurations as it adds a store to every get/put
+ */
+#if defined(GPR_DEBUG_MSG) && !defined(GPR_DL_LX_BUF_DEBUG)
+#define GPR_DL_LX_BUF_DEBUG
+#endif
 
 /** Data receive notification callback type*/
 typedef uint32_t (*gpr_dl_lx_receive_cb)(void *ptr, uint32_t length);
@@ -44,10 +67,19 @@ typedef uint32_t (*gpr_dl_lx_receive_cb)(void *ptr, uint32_t length);
 typedef uint32_t (*gpr_dl_lx_send_done_cb)(void *ptr, uint32_t length);
 
 typedef struct gpr_dl_lx_buf{
-    struct listnode node;
     void *buffer;
+    uint32_t index; /* position in the port descriptor array */
+#ifdef GPR_DL_LX_BUF_DEBUG
+    bool in_use; /* handed to GPR, not yet returned with receive_done */
+#endif
 }gpr_dl_lx_buf_t;
 
+typedef struct gpr_dl_lx_tx_entry{
+    void *buf;
+    uint32_t size;
+    uint64_t queued_us;
+}gpr_dl_lx_tx_entry_t;
+
 typedef struct gpr_dl_lx_port{
     uint32_t domain_id;
     pthread_t receiver_thread;
@@ -56,14 +88,56 @@ typedef struct gpr_dl_lx_port{
     gpr_dl_lx_send_done_cb send_done;
     int drv_fd;
     int intpipe[2];
-    struct listnode buff_list;
-    pthread_mutex_t buff_list_lock;
-    int buf_cnt;
+    gpr_dl_lx_buf_t *bufs; /* descriptors of all receive buffers */
+    uint32_t num_bufs;
+    uint32_t buf_size;
+    bool batch_rx;
+    /*
+     * Ring of free descriptor indices. Only the receiver thread takes
+     * buffers from the head, returned buffers are added at the tail.
+     * Both indices run freely and are masked on access.
+     */
+    uint32_t *free_ring;
+    uint32_t ring_mask;
+    volatile uint32_t ring_head;
+    volatile uint32_t ring_tail;
+    /* serializes put_buffer callers, not taken in single producer mode */
+    pthread_mutex_t ring_lock;
+    bool spsc_rx;
+    /*
+     * Transmit queue drained by the sender thread, only set up when
+     * tx_queue_depth is configured. tx_lock protects the queue indices
+     * and statistics, entries from tx_head up to the count snapshot taken
+     * by the sender thread are owned by it until tx_head is advanced.
+     */
+    gpr_dl_lx_tx_entry_t *tx_queue;
+    uint32_t tx_queue_size;
+    uint32_t tx_head;
+    uint32_t tx_count;
+    bool tx_exit;
+    /*
+     * set by the sender thread when the driver reports ENETRESET, sends then
+     * fail with AR_ESUBSYSRESET until a direct write succeeds again
+     */
+    bool tx_reset;
+    pthread_t sender_thread;
+    pthread_mutex_t tx_lock;
+    pthread_cond_t tx_cond;
+    gpr_dl_lx_tx_stats_t tx_stats;
 } gpr_dl_lx_port_t;
 
 /*Array of structure pointers each member pointer corresponds to one domain*/
 gpr_dl_lx_port_t *gpr_dl_lx_ports[GPR_PL_NUM_TOTAL_DOMAINS_V]={NULL};
 
+/*Configuration applied to ports initialized after ipc_dl_lx_set_config*/
+static gpr_dl_lx_config_t gpr_dl_lx_cfg = {
+    GPR_DL_LX_NO_OF_BUFFERS,
+    GPR_DL_LX_BUF_SIZE,
+    TRUE,
+    FALSE,
+    GPR_DL_LX_TX_QUEUE_DEPTH,
+};
+
 static uint32_t gpr_dl_lx_send(uint32_t domain_id, void *buf, uint32_t size);
 
 static uint32_t gpr_dl_lx_receive_done(uint32_t domain_id, void *buf);
@@ -77,126 +151,326 @@ static ipc_to_gpr_vtbl_t gpr_dl_lx_vtbl =
 
 void deallocate_buffers(gpr_dl_lx_port_t *dl_lx_port)
 {
-    gpr_dl_lx_buf_t *buffer_node = NULL;
-    struct listnode *item = NULL;
-
-    pthread_mutex_lock(&dl_lx_port->buff_list_lock);
-    while (!list_empty(&dl_lx_port->buff_list)) {
-        item = list_head(&dl_lx_port->buff_list);
-        list_remove(item);
-        buffer_node = node_to_item(item, gpr_dl_lx_buf_t, node);
-        if (buffer_node->buffer)
-            free(buffer_node->buffer);
-        free(buffer_node);
-        buffer_node = NULL;
-    }
-    pthread_mutex_unlock(&dl_lx_port->buff_list_lock);
+    uint32_t i;
+
+    if (dl_lx_port->bufs) {
+        for (i = 0; i < dl_lx_port->num_bufs; i++) {
+            if (dl_lx_port->bufs[i].buffer)
+                free((char *)dl_lx_port->bufs[i].buffer - GPR_DL_LX_BUF_HDR_SIZE);
+        }
+        free(dl_lx_port->bufs);
+        dl_lx_port->bufs = NULL;
+    }
+    free(dl_lx_port->free_ring);
+    dl_lx_port->free_ring = NULL;
+    dl_lx_port->num_bufs = 0;
+    dl_lx_port->ring_head = 0;
+    dl_lx_port->ring_tail = 0;
 }
 
 uint32_t allocate_buffers(gpr_dl_lx_port_t *dl_lx_port,
                           size_t buf_sz, size_t no_of_buffers)
 {
     uint32_t status;
+    uint32_t ring_size = 1;
     unsigned int i;
-
-    pthread_mutex_lock(&dl_lx_port->buff_list_lock);
-    list_init(&dl_lx_port->buff_list);
+    char *mem;
+
+    /* Descriptors and ring live for the lifetime of the port, get/put never allocate */
+    while (ring_size < no_of_buffers)
+        ring_size <<= 1;
+    dl_lx_port->bufs = (gpr_dl_lx_buf_t *)calloc(no_of_buffers, sizeof(gpr_dl_lx_buf_t));
+    dl_lx_port->free_ring = (uint32_t *)calloc(ring_size, sizeof(uint32_t));
+    if ((dl_lx_port->bufs == NULL) || (dl_lx_port->free_ring == NULL)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d malloc failed", __func__, __LINE__);
+        status = AR_ENOMEMORY;
+        goto error;
+    }
+    dl_lx_port->num_bufs = no_of_buffers;
+    dl_lx_port->buf_size = buf_sz;
+    dl_lx_port->ring_mask = ring_size - 1;
 
     for (i = 0; i < no_of_buffers; i++) {
-
-        gpr_dl_lx_buf_t *buffer_node =
-                          (gpr_dl_lx_buf_t *)malloc(sizeof(gpr_dl_lx_buf_t));
-        if (buffer_node == NULL) {
-            AR_LOG_ERR(LOG_TAG,"%s:%d malloc failed", __func__, __LINE__);
-            status = AR_ENOMEMORY;
-            goto error;
-        }
-
-        buffer_node->buffer = calloc(buf_sz, sizeof(int8_t));
-        if (buffer_node->buffer == NULL) {
+        mem = (char *)calloc(GPR_DL_LX_BUF_HDR_SIZE + buf_sz, sizeof(int8_t));
+        if (mem == NULL) {
             AR_LOG_ERR(LOG_TAG,"%s:%d malloc for buf failed", __func__, __LINE__);
-            free (buffer_node);
             status = AR_ENOMEMORY;
             goto error;
         }
-        list_add_tail(&dl_lx_port->buff_list, &buffer_node->node);
-        dl_lx_port->buf_cnt++;
+        *(gpr_dl_lx_buf_t **)mem = &dl_lx_port->bufs[i];
+        dl_lx_port->bufs[i].buffer = mem + GPR_DL_LX_BUF_HDR_SIZE;
+        dl_lx_port->bufs[i].index = i;
+        dl_lx_port->free_ring[i] = i;
     }
-    AR_LOG_VERBOSE(LOG_TAG,"%s:%d buf_cnt = %d", __func__, __LINE__, dl_lx_port->buf_cnt);
-    pthread_mutex_unlock(&dl_lx_port->buff_list_lock);
+    dl_lx_port->ring_head = 0;
+    ar_osal_atomic_store_u32(&dl_lx_port->ring_tail, no_of_buffers);
+    AR_LOG_VERBOSE(LOG_TAG,"%s:%d buf_cnt = %d", __func__, __LINE__, no_of_buffers);
     return AR_EOK;
 error:
-    pthread_mutex_unlock(&dl_lx_port->buff_list_lock);
     deallocate_buffers(dl_lx_port);
     return status;
 }
 
-uint32_t get_buffer(gpr_dl_lx_port_t *dl_lx_port, void **buf)
+/*
+ * Called from the receiver thread only, which is the single consumer of the
+ * ring. The buffer at the head is returned without taking it, take_buffer
+ * takes it once a packet has been read into it. A failed read leaves it at
+ * the head, so the receiver never puts buffers back and put_buffer only has
+ * the producers the client configured.
+ */
+uint32_t peek_buffer(gpr_dl_lx_port_t *dl_lx_port, void **buf)
 {
-    gpr_dl_lx_buf_t *buffer_node;
-    struct listnode *item;
-    pthread_mutex_lock(&dl_lx_port->buff_list_lock);
-    if (list_empty(&dl_lx_port->buff_list)) {
+    uint32_t head = dl_lx_port->ring_head;
+
+    if (head == ar_osal_atomic_load_u32(&dl_lx_port->ring_tail)) {
         AR_LOG_ERR(LOG_TAG,"%s:%d No free buffers available", __func__, __LINE__);
-        pthread_mutex_unlock(&dl_lx_port->buff_list_lock);
         return AR_ENORESOURCE;
     }
-    item = list_head(&dl_lx_port->buff_list);
-    if (item != NULL) {
-        list_remove(item);
-        buffer_node = node_to_item(item, gpr_dl_lx_buf_t, node);
-        if (buffer_node->buffer) {
-            *buf = buffer_node->buffer;
-            free(buffer_node);
-        } else {
-            AR_LOG_ERR(LOG_TAG,"%s:%d buffer node invalid", __func__, __LINE__);
-            pthread_mutex_unlock(&dl_lx_port->buff_list_lock);
-            return AR_ENOTEXIST;
-        }
-        AR_LOG_VERBOSE(LOG_TAG,"%s:%d buf_cnt = %d", __func__, __LINE__, --dl_lx_port->buf_cnt);
-    }
-    pthread_mutex_unlock(&dl_lx_port->buff_list_lock);
+    *buf = dl_lx_port->bufs[dl_lx_port->free_ring[head & dl_lx_port->ring_mask]].buffer;
     return AR_EOK;
 }
 
+/* Takes the buffer returned by peek_buffer, receiver thread only */
+void take_buffer(gpr_dl_lx_port_t *dl_lx_port)
+{
+#ifdef GPR_DL_LX_BUF_DEBUG
+    dl_lx_port->bufs[dl_lx_port->free_ring[dl_lx_port->ring_head & dl_lx_port->ring_mask]].in_use = true;
+#endif
+    /* publish the slot as consumed only after the packet has been read into it */
+    ar_osal_atomic_store_u32(&dl_lx_port->ring_head, dl_lx_port->ring_head + 1);
+}
+
 uint32_t put_buffer(gpr_dl_lx_port_t *dl_lx_port, void *buf)
 {
-    gpr_dl_lx_buf_t *buffer_node = NULL;
-    struct listnode *item = NULL;
-    struct listnode *temp_node = NULL;
-
-    pthread_mutex_lock(&dl_lx_port->buff_list_lock);
-    list_for_each_safe(item, temp_node, &dl_lx_port->buff_list) {
-        if (item != NULL) {
-            buffer_node = node_to_item(item, gpr_dl_lx_buf_t, node);
-            if (buffer_node && buffer_node->buffer == buf) {
-                AR_LOG_ERR(LOG_TAG,"%s:%d buffer already put error case", __func__, __LINE__);
-                pthread_mutex_unlock(&dl_lx_port->buff_list_lock);
-                return AR_EALREADY;
+    gpr_dl_lx_buf_t *buffer_node;
+    uint32_t status = AR_EOK;
+    uint32_t tail;
+
+    if (buf == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d NULL buffer", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+
+    /* The header in front of the buffer leads straight to its descriptor */
+    buffer_node = *(gpr_dl_lx_buf_t **)((char *)buf - GPR_DL_LX_BUF_HDR_SIZE);
+    if ((buffer_node < dl_lx_port->bufs) ||
+        (buffer_node >= dl_lx_port->bufs + dl_lx_port->num_bufs) ||
+        (buffer_node->buffer != buf)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d buffer does not belong to this port", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+
+    if (!dl_lx_port->spsc_rx)
+        pthread_mutex_lock(&dl_lx_port->ring_lock);
+
+    tail = dl_lx_port->ring_tail;
+#ifdef GPR_DL_LX_BUF_DEBUG
+    if (!buffer_node->in_use) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d buffer already put error case", __func__, __LINE__);
+        status = AR_EALREADY;
+        goto exit;
+    }
+    buffer_node->in_use = false;
+#endif
+    /* more returns than buffers handed out means a buffer was put twice */
+    if (tail - ar_osal_atomic_load_u32(&dl_lx_port->ring_head) >= dl_lx_port->num_bufs) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d free ring full, buffer already put", __func__, __LINE__);
+        status = AR_EALREADY;
+        goto exit;
+    }
+    dl_lx_port->free_ring[tail & dl_lx_port->ring_mask] = buffer_node->index;
+    ar_osal_atomic_store_u32(&dl_lx_port->ring_tail, tail + 1);
+
+exit:
+    if (!dl_lx_port->spsc_rx)
+        pthread_mutex_unlock(&dl_lx_port->ring_lock);
+    return status;
+}
+
+/*
+ * Writes one packet to the driver. The fd is non blocking for batch receive,
+ * so wait for the driver to accept more data instead of failing the send.
+ */
+static int32_t gpr_dl_lx_write(gpr_dl_lx_port_t *dl_lx_port, void *buf, uint32_t size)
+{
+    int32_t status;
+
+    status = write(dl_lx_port->drv_fd, buf, size);
+    while ((status < 0) && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        struct pollfd pfd = { .fd = dl_lx_port->drv_fd, .events = POLLOUT };
+
+        if ((poll(&pfd, 1, -1) < 0) && (errno != EINTR))
+            break;
+        status = write(dl_lx_port->drv_fd, buf, size);
+    }
+    return status;
+}
+
+/*
+ * Writes queued packets to the driver, all packets queued at wakeup are sent
+ * before the lock is taken again. The driver keeps one GPR packet per write so
+ * packets are not coalesced into a vectored write. On exit the queue is
+ * drained first so no packet is left without send done.
+ */
+void *sender_thread_loop(void *priv_data)
+{
+    gpr_dl_lx_port_t *dl_lx_port = (gpr_dl_lx_port_t *)priv_data;
+    gpr_dl_lx_tx_entry_t *entry;
+    uint32_t head, num, i;
+    uint32_t num_failed;
+    bool reset;
+    uint64_t latency_us, total_latency_us, max_latency_us;
+
+    pthread_mutex_lock(&dl_lx_port->tx_lock);
+    while (1) {
+        while ((dl_lx_port->tx_count == 0) && !dl_lx_port->tx_exit)
+            pthread_cond_wait(&dl_lx_port->tx_cond, &dl_lx_port->tx_lock);
+        if (dl_lx_port->tx_count == 0) {
+            AR_LOG_DEBUG(LOG_TAG,"%s:%d exiting sender thread", __func__, __LINE__);
+            break;
+        }
+        head = dl_lx_port->tx_head;
+        num = dl_lx_port->tx_count;
+        pthread_mutex_unlock(&dl_lx_port->tx_lock);
+
+        num_failed = 0;
+        reset = false;
+        total_latency_us = 0;
+        max_latency_us = 0;
+        for (i = 0; i < num; i++) {
+            entry = &dl_lx_port->tx_queue[(head + i) % dl_lx_port->tx_queue_size];
+            if (gpr_dl_lx_write(dl_lx_port, entry->buf, entry->size) < 0) {
+                /* the caller was already told the packet is queued, drop it */
+                if (errno == ENETRESET)
+                    reset = true;
+                AR_LOG_ERR(LOG_TAG,"%s:%d write to driver failed %d", __func__, __LINE__, errno);
+                num_failed++;
             }
+            dl_lx_port->send_done(entry->buf, entry->size);
+            latency_us = ar_timer_get_time_in_us() - entry->queued_us;
+            total_latency_us += latency_us;
+            if (latency_us > max_latency_us)
+                max_latency_us = latency_us;
         }
+
+        pthread_mutex_lock(&dl_lx_port->tx_lock);
+        dl_lx_port->tx_head = (head + num) % dl_lx_port->tx_queue_size;
+        dl_lx_port->tx_count -= num;
+        if (reset)
+            dl_lx_port->tx_reset = true;
+        dl_lx_port->tx_stats.num_sent += num - num_failed;
+        dl_lx_port->tx_stats.num_failed += num_failed;
+        dl_lx_port->tx_stats.total_latency_us += total_latency_us;
+        if (max_latency_us > dl_lx_port->tx_stats.max_latency_us)
+            dl_lx_port->tx_stats.max_latency_us = max_latency_us;
+        AR_LOG_VERBOSE(LOG_TAG,"%s:%d sent %d packets, max latency %llu us", __func__, __LINE__,
+                       num, (unsigned long long)max_latency_us);
     }
-    buffer_node = (gpr_dl_lx_buf_t *)malloc(sizeof(gpr_dl_lx_buf_t));
-    if (buffer_node == NULL) {
+    pthread_mutex_unlock(&dl_lx_port->tx_lock);
+    return NULL;
+}
+
+static void gpr_dl_lx_stop_sender(gpr_dl_lx_port_t *dl_lx_port)
+{
+    if (dl_lx_port->tx_queue == NULL)
+        return;
+
+    pthread_mutex_lock(&dl_lx_port->tx_lock);
+    dl_lx_port->tx_exit = true;
+    pthread_cond_signal(&dl_lx_port->tx_cond);
+    pthread_mutex_unlock(&dl_lx_port->tx_lock);
+
+    if (pthread_join(dl_lx_port->sender_thread, NULL))
+        AR_LOG_ERR(LOG_TAG,"%s:%d pthread_join failed", __func__, __LINE__);
+    pthread_cond_destroy(&dl_lx_port->tx_cond);
+    pthread_mutex_destroy(&dl_lx_port->tx_lock);
+    free(dl_lx_port->tx_queue);
+    dl_lx_port->tx_queue = NULL;
+}
+
+static uint32_t gpr_dl_lx_start_sender(gpr_dl_lx_port_t *dl_lx_port, uint32_t depth)
+{
+    uint32_t status;
+
+    dl_lx_port->tx_queue = (gpr_dl_lx_tx_entry_t *)calloc(depth, sizeof(gpr_dl_lx_tx_entry_t));
+    if (dl_lx_port->tx_queue == NULL) {
         AR_LOG_ERR(LOG_TAG,"%s:%d malloc failed", __func__, __LINE__);
-        pthread_mutex_unlock(&dl_lx_port->buff_list_lock);
         return AR_ENOMEMORY;
     }
-    buffer_node->buffer = buf;
-    list_add_tail(&dl_lx_port->buff_list, &buffer_node->node);
-    AR_LOG_VERBOSE(LOG_TAG,"%s:%d buf_cnt = %d", __func__, __LINE__, ++dl_lx_port->buf_cnt);
-    pthread_mutex_unlock(&dl_lx_port->buff_list_lock);
+    dl_lx_port->tx_queue_size = depth;
+    dl_lx_port->tx_head = 0;
+    dl_lx_port->tx_count = 0;
+    dl_lx_port->tx_exit = false;
+    dl_lx_port->tx_reset = false;
+    pthread_mutex_init(&dl_lx_port->tx_lock, (const pthread_mutexattr_t *) NULL);
+    pthread_cond_init(&dl_lx_port->tx_cond, (const pthread_condattr_t *) NULL);
+
+    status = pthread_create(&dl_lx_port->sender_thread, NULL,
+                            sender_thread_loop, dl_lx_port);
+    if (status) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d error:%d pthread_create fail", __func__, __LINE__, status);
+        pthread_cond_destroy(&dl_lx_port->tx_cond);
+        pthread_mutex_destroy(&dl_lx_port->tx_lock);
+        free(dl_lx_port->tx_queue);
+        dl_lx_port->tx_queue = NULL;
+        return AR_EFAILED;
+    }
+    pthread_setname_np(dl_lx_port->sender_thread, "gpr_sender_thread");
     return AR_EOK;
 }
 
 #define NUM_FDS 2
 
-void *receiver_thread_loop(void *priv_data)
+/*
+ * Reads packets from the driver and hands them to GPR. In batch mode the driver
+ * fd is non blocking and all packets already queued are drained in one wakeup,
+ * otherwise one packet is read per poll.
+ */
+static void gpr_dl_lx_receive_packets(gpr_dl_lx_port_t *dl_lx_port)
 {
     uint32_t status;
     int32_t receive_size;
     void *buf;
     uint32_t *temp;
+    uint32_t num_received = 0;
+
+    do {
+        /*
+         * Get a buffer from buffer queue, it is a finite queue
+         * So if the client holds the received buffers for long
+         * we would run out of buffers.
+         */
+        status = peek_buffer(dl_lx_port, &buf);
+        if (status != 0) {
+            AR_LOG_ERR(LOG_TAG,"%s:%d peek_buffer failed", __func__, __LINE__);
+            break;
+        }
+        /* only the received bytes are passed on, no need to clear the buffer */
+        receive_size = read(dl_lx_port->drv_fd, buf, dl_lx_port->buf_size);
+        if ((receive_size < 0) && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            /* drained everything the driver had queued, buffer stays free */
+            break;
+        }
+        if ((receive_size <= 0) || ((uint32_t)receive_size > dl_lx_port->buf_size)) {
+            AR_LOG_ERR(LOG_TAG,"%s:%d read failed %d", __func__, __LINE__, errno);
+            break;
+        }
+        take_buffer(dl_lx_port);
+        temp = (uint32_t *) buf;
+        AR_LOG_DEBUG(LOG_TAG,"recieved buffer %x %x %x %x size %d", temp[0], temp[1], temp[2], temp[3], receive_size);
+        num_received++;
+        if (dl_lx_port->rx_cb) {
+            status = dl_lx_port->rx_cb(buf, receive_size);
+            if (status != AR_EOK)
+                AR_LOG_ERR(LOG_TAG,"%s:%d receive callback failed", __func__, __LINE__);
+        }
+    } while (dl_lx_port->batch_rx && !dl_lx_port->thread_exit);
+
+    AR_LOG_VERBOSE(LOG_TAG,"%s:%d received %d packets", __func__, __LINE__, num_received);
+}
+
+void *receiver_thread_loop(void *priv_data)
+{
     gpr_dl_lx_port_t *dl_lx_port = (gpr_dl_lx_port_t *)priv_data;
     struct pollfd *pfd;
     if (dl_lx_port == NULL) {
@@ -242,33 +516,7 @@ void *receiver_thread_loop(void *priv_data)
 
         AR_LOG_DEBUG(LOG_TAG,"Out of poll");
         if (pfd[0].revents & (POLLIN|POLLPRI)) {
-            /*
-             * Get a buffer from buffer queue, it is a finite queue
-             * So if the client holds the received buffers for long
-             * we would run out of buffers.
-             */
-            status = get_buffer(dl_lx_port, &buf);
-            if (status != 0) {
-                AR_LOG_ERR(LOG_TAG,"%s:%d get_buffer failed", __func__, __LINE__);
-                /*Shall we break out or continue ?*/
-                continue;
-            }
-            memset(buf, 0 , GPR_DL_LX_BUF_SIZE);
-            receive_size = read(dl_lx_port->drv_fd, buf, GPR_DL_LX_BUF_SIZE);
-            temp = (uint32_t *) buf;
-            AR_LOG_DEBUG(LOG_TAG,"recieved buffer %x %x %x %x size %d", temp[0], temp[1], temp[2], temp[3], receive_size);
-            if ((receive_size <= 0) || (receive_size > GPR_DL_LX_BUF_SIZE)) {
-                AR_LOG_ERR(LOG_TAG,"%s:%d read failed %d", __func__, __LINE__, errno);
-                put_buffer(dl_lx_port, buf);
-            } else {
-                if (dl_lx_port->rx_cb) {
-                    status = dl_lx_port->rx_cb(buf, receive_size);
-                    if (status != AR_EOK) {
-                        AR_LOG_ERR(LOG_TAG,"%s:%d receive callback failed", __func__, __LINE__);
-                        continue;
-                    }
-                }
-             }
+            gpr_dl_lx_receive_packets(dl_lx_port);
         } else if (pfd[0].revents & (POLLERR|POLLHUP|POLLNVAL)) {
             /*
              *We should hit this case when we are trying to exit
@@ -345,11 +593,22 @@ static gpr_dl_lx_port_t * gpr_dl_lx_local_init(uint32_t src_domain_id, uint32_t
         return NULL;
     }
 
-    pthread_mutex_init(&dl_lx_port->buff_list_lock,
+    /* batch receive drains the driver with non blocking reads */
+    dl_lx_port->batch_rx = gpr_dl_lx_cfg.batch_rx;
+    if (dl_lx_port->batch_rx &&
+        (fcntl(dl_lx_port->drv_fd, F_SETFL,
+               fcntl(dl_lx_port->drv_fd, F_GETFL) | O_NONBLOCK) < 0)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d non blocking mode not supported %d, batch receive disabled",
+                   __func__, __LINE__, errno);
+        dl_lx_port->batch_rx = false;
+    }
+
+    dl_lx_port->spsc_rx = gpr_dl_lx_cfg.spsc_rx;
+    pthread_mutex_init(&dl_lx_port->ring_lock,
                           (const pthread_mutexattr_t *) NULL);
 
-    status = allocate_buffers(dl_lx_port, GPR_DL_LX_BUF_SIZE,
-                             GPR_DL_LX_NO_OF_BUFFERS);
+    status = allocate_buffers(dl_lx_port, gpr_dl_lx_cfg.buf_size,
+                             gpr_dl_lx_cfg.num_buffers);
     if (status) {
         AR_LOG_ERR(LOG_TAG,"%s:%d buffer allocation failed", __func__, __LINE__);
         free(dl_lx_port);
@@ -366,6 +625,12 @@ static gpr_dl_lx_port_t * gpr_dl_lx_local_init(uint32_t src_domain_id, uint32_t
         return NULL;
     }
     pthread_setname_np(dl_lx_port->receiver_thread, "gpr_receiver_thread");
+
+    if (gpr_dl_lx_cfg.tx_queue_depth &&
+        gpr_dl_lx_start_sender(dl_lx_port, gpr_dl_lx_cfg.tx_queue_depth)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d sender thread failed, sending from caller thread",
+                   __func__, __LINE__);
+    }
     return dl_lx_port;
 }
 
@@ -381,6 +646,8 @@ static uint32_t gpr_dl_lx_local_deinit(uint32_t src_domain_id, uint32_t dst_doma
     }
     dl_lx_port = gpr_dl_lx_ports[dst_domain_id];
     gpr_dl_lx_ports[dst_domain_id] = NULL;
+    /* packets already queued are written before the driver is closed */
+    gpr_dl_lx_stop_sender(dl_lx_port);
     /*
      * Set thread exit to true and then close the driver instance
      * this should unblock the poll and then we do a pthread_join
@@ -399,10 +666,60 @@ static uint32_t gpr_dl_lx_local_deinit(uint32_t src_domain_id, uint32_t dst_doma
     }
     close(dl_lx_port->drv_fd);
     dl_lx_port->drv_fd = 0;
+    deallocate_buffers(dl_lx_port);
+    pthread_mutex_destroy(&dl_lx_port->ring_lock);
     free(dl_lx_port);
     return status;
 }
 
+uint32_t ipc_dl_lx_set_config(const gpr_dl_lx_config_t *cfg)
+{
+    if ((cfg == NULL) || (cfg->num_buffers == 0) ||
+        (cfg->buf_size < GPR_PKT_HEADER_BYTE_SIZE_V)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d invalid config", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+
+    gpr_dl_lx_cfg = *cfg;
+    /* keep the buffers 8 byte aligned */
+    gpr_dl_lx_cfg.buf_size = (cfg->buf_size + 7) & ~7;
+    return AR_EOK;
+}
+
+uint32_t ipc_dl_lx_get_config(gpr_dl_lx_config_t *cfg)
+{
+    if (cfg == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d invalid param", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+
+    *cfg = gpr_dl_lx_cfg;
+    return AR_EOK;
+}
+
+uint32_t ipc_dl_lx_get_tx_stats(uint32_t domain_id, gpr_dl_lx_tx_stats_t *stats)
+{
+    gpr_dl_lx_port_t *dl_lx_port;
+
+    if ((domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V) || (stats == NULL)) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d invalid param", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+    if ((dl_lx_port = gpr_dl_lx_ports[domain_id]) == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d port domain %d not initialized", __func__, __LINE__,
+              domain_id);
+        return AR_ENOTEXIST;
+    }
+    if (dl_lx_port->tx_queue == NULL)
+        return AR_EUNSUPPORTED;
+
+    pthread_mutex_lock(&dl_lx_port->tx_lock);
+    *stats = dl_lx_port->tx_stats;
+    stats->queue_depth = dl_lx_port->tx_count;
+    pthread_mutex_unlock(&dl_lx_port->tx_lock);
+    return AR_EOK;
+}
+
 uint32_t ipc_dl_lx_init(uint32_t src_domain_id,
                         uint32_t dest_domain_id,
                         const gpr_to_ipc_vtbl_t *p_gpr_to_ipc_vtbl,
@@ -443,6 +760,60 @@ uint32_t ipc_dl_lx_deinit(uint32_t src_domain_id, uint32_t dest_domain_id)
    return status;
 }
 
+/*
+ * Hands the packet to the sender thread, send done is called from that
+ * thread. A full queue is reported with AR_EBUSY, the caller keeps the packet.
+ * After the sender thread saw a subsystem reset, packets are written from the
+ * caller thread once the queue is empty, so the caller gets AR_ESUBSYSRESET
+ * back until the remote side is up again.
+ */
+static uint32_t gpr_dl_lx_queue_send(gpr_dl_lx_port_t *dl_lx_port, void *buf, uint32_t size)
+{
+    gpr_dl_lx_tx_entry_t *entry;
+    uint64_t now_us = ar_timer_get_time_in_us();
+    int32_t status;
+
+    pthread_mutex_lock(&dl_lx_port->tx_lock);
+    if (dl_lx_port->tx_reset) {
+        if (dl_lx_port->tx_count != 0) {
+            pthread_mutex_unlock(&dl_lx_port->tx_lock);
+            return AR_ESUBSYSRESET;
+        }
+        pthread_mutex_unlock(&dl_lx_port->tx_lock);
+
+        status = gpr_dl_lx_write(dl_lx_port, buf, size);
+        if (status < 0) {
+            status = errno;
+            AR_LOG_ERR(LOG_TAG,"%s:%d write to driver failed %d", __func__, __LINE__, status);
+            return (status == ENETRESET) ? AR_ESUBSYSRESET : AR_EFAILED;
+        }
+        pthread_mutex_lock(&dl_lx_port->tx_lock);
+        dl_lx_port->tx_reset = false;
+        dl_lx_port->tx_stats.num_sent++;
+        pthread_mutex_unlock(&dl_lx_port->tx_lock);
+        dl_lx_port->send_done(buf, size);
+        return AR_EOK;
+    }
+    if (dl_lx_port->tx_count == dl_lx_port->tx_queue_size) {
+        dl_lx_port->tx_stats.num_rejected++;
+        pthread_mutex_unlock(&dl_lx_port->tx_lock);
+        AR_LOG_ERR(LOG_TAG,"%s:%d transmit queue full, depth %d", __func__, __LINE__,
+                   dl_lx_port->tx_queue_size);
+        return AR_EBUSY;
+    }
+    entry = &dl_lx_port->tx_queue[(dl_lx_port->tx_head + dl_lx_port->tx_count) %
+                                  dl_lx_port->tx_queue_size];
+    entry->buf = buf;
+    entry->size = size;
+    entry->queued_us = now_us;
+    dl_lx_port->tx_count++;
+    if (dl_lx_port->tx_count > dl_lx_port->tx_stats.max_queue_depth)
+        dl_lx_port->tx_stats.max_queue_depth = dl_lx_port->tx_count;
+    pthread_cond_signal(&dl_lx_port->tx_cond);
+    pthread_mutex_unlock(&dl_lx_port->tx_lock);
+    return AR_EOK;
+}
+
 static uint32_t gpr_dl_lx_send(uint32_t domain_id, void *buf, uint32_t size)
 {
     int32_t status;
@@ -453,8 +824,11 @@ static uint32_t gpr_dl_lx_send(uint32_t domain_id, void *buf, uint32_t size)
               domain_id);
         return AR_ENOTEXIST;
     }
+    if (dl_lx_port->tx_queue)
+        return gpr_dl_lx_queue_send(dl_lx_port, buf, size);
+
     AR_LOG_DEBUG(LOG_TAG,"%s:Sending buffer of size %d to driver",__func__, size);
-    status = write(dl_lx_port->drv_fd, buf, size);
+    status = gpr_dl_lx_write(dl_lx_port, buf, size);
     if (status < 0) {
         AR_LOG_ERR(LOG_TAG,"%s:%d write to driver failed %d", __func__, __LINE__, errno);
         if (errno == ENETRESET)
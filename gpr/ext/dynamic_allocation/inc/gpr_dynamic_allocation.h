@@ -19,9 +19,13 @@ extern "C" {
 #endif /*__cplusplus*/
 
 GPR_INTERNAL uint32_t gpr_allocate_dynamic_packet(gpr_packet_t **packet,
-                                                  uint32_t      size);
+                                                  uint32_t      size,
+                                                  uint32_t      pool_index);
 
-GPR_INTERNAL uint32_t gpr_check_and_free_dynamic_packet(gpr_packet_t *packet);
+/* Frees the packet if it was allocated by gpr_allocate_dynamic_packet and returns the pool index
+ * it was allocated with, returns AR_ENOTEXIST otherwise */
+GPR_INTERNAL uint32_t gpr_check_and_free_dynamic_packet(gpr_packet_t  *packet,
+                                                        uint32_t      *pool_index);
 
 GPR_INTERNAL uint32_t gpr_dynamic_packet_init(void);
 
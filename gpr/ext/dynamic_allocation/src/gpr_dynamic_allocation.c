@@ -19,30 +19,73 @@
 #include "ar_osal_heap.h"
 #include "ar_osal_mem_op.h"
 
+/*****************************************************************************
+ * Defines                                                                   *
+ ****************************************************************************/
+/* Number of hash buckets used to look up outstanding dynamic packets, must be a power of 2 */
+#define GPR_DYN_PACKET_NUM_BUCKETS (64)
+
+/* Freed packets are kept for reuse in power of 2 size classes, from 2^GPR_DYN_PACKET_MIN_CLASS_SHIFT
+ * up to 2^(GPR_DYN_PACKET_MIN_CLASS_SHIFT + GPR_DYN_PACKET_NUM_CLASSES - 1) bytes. Larger packets are
+ * allocated with their exact size and returned to the heap on free. */
+#define GPR_DYN_PACKET_MIN_CLASS_SHIFT (9)
+#define GPR_DYN_PACKET_NUM_CLASSES (8)
+#define GPR_DYN_PACKET_NO_CLASS (0xFFFFFFFF)
+
+/* Upper bound of packets kept per size class, beyond that freed packets go back to the heap */
+#ifndef GPR_DYN_PACKET_MAX_CACHED_PER_CLASS
+#define GPR_DYN_PACKET_MAX_CACHED_PER_CLASS (8)
+#endif
+
 /*****************************************************************************
  * Structure definitions                                                     *
  ****************************************************************************/
+/* Tracking header placed in front of every dynamic packet, the packet follows
+ * the header in the same allocation. */
 typedef struct gpr_dynamic_packet
 {
-   gpr_list_node_t node;
-   gpr_packet_t * packet;
+   struct gpr_dynamic_packet *next;       /* next packet in the same hash bucket or size class cache */
+   uint32_t                   pool_index; /* dynamic pool the packet was counted against */
+   uint32_t                   size_class; /* GPR_DYN_PACKET_NO_CLASS if the packet is not recycled */
 } gpr_dynamic_packet_t;
 
-gpr_list_t      dynamic_packet_list;
-ar_osal_mutex_t gpr_dyn_packet_list_lock;
-static bool_t   gpr_dynamic_packet_init_done = FALSE;
+/* Header size rounded up to keep the packet 8 byte aligned */
+#define GPR_DYN_PACKET_HDR_SIZE ((sizeof(gpr_dynamic_packet_t) + 7) & ~((size_t)7))
+
+static gpr_dynamic_packet_t *dynamic_packet_buckets[GPR_DYN_PACKET_NUM_BUCKETS];
+static gpr_dynamic_packet_t *dynamic_packet_cache[GPR_DYN_PACKET_NUM_CLASSES];
+static uint32_t              dynamic_packet_cache_cnt[GPR_DYN_PACKET_NUM_CLASSES];
+ar_osal_mutex_t              gpr_dyn_packet_list_lock;
+static bool_t                gpr_dynamic_packet_init_done = FALSE;
 
 /*****************************************************************************
  * Helper functions                                                          *
  ****************************************************************************/
-static void gpr_dyn_packet_lock_fn(void)
+static inline uint32_t gpr_dyn_packet_bucket(gpr_packet_t *packet)
 {
-   (void)ar_osal_mutex_lock(gpr_dyn_packet_list_lock);
+   /* Heap blocks are at least 8 byte aligned, drop the low bits before hashing */
+   uintptr_t addr = ((uintptr_t)packet) >> 3;
+
+   return (uint32_t)((addr ^ (addr >> 6) ^ (addr >> 12)) & (GPR_DYN_PACKET_NUM_BUCKETS - 1));
 }
 
-static void gpr_dyn_packet_unlock_fn(void)
+static inline gpr_packet_t *gpr_dyn_packet_from_hdr(gpr_dynamic_packet_t *dynamic_packet)
 {
-   (void)ar_osal_mutex_unlock(gpr_dyn_packet_list_lock);
+   return (gpr_packet_t *)(((char_t *)dynamic_packet) + GPR_DYN_PACKET_HDR_SIZE);
+}
+
+/* Returns the smallest size class holding size bytes, GPR_DYN_PACKET_NO_CLASS if none is large enough */
+static inline uint32_t gpr_dyn_packet_size_class(uint32_t size)
+{
+   for (uint32_t size_class = 0; size_class < GPR_DYN_PACKET_NUM_CLASSES; size_class++)
+   {
+      if (size <= (1UL << (GPR_DYN_PACKET_MIN_CLASS_SHIFT + size_class)))
+      {
+         return size_class;
+      }
+   }
+
+   return GPR_DYN_PACKET_NO_CLASS;
 }
 
 static void gpr_free_dynamic_packet_raw(gpr_dynamic_packet_t *dynamic_packet)
@@ -53,58 +96,41 @@ static void gpr_free_dynamic_packet_raw(gpr_dynamic_packet_t *dynamic_packet)
    heap_info.tag         = AR_HEAP_TAG_DEFAULT;
    heap_info.align_bytes = AR_HEAP_ALIGN_8_BYTES;
 
-   ar_heap_free((void *)(dynamic_packet->packet), &heap_info);
-   dynamic_packet->packet = NULL;
    ar_heap_free((void *)dynamic_packet, &heap_info);
-   dynamic_packet = NULL;
-   return;
 }
 
 static void gpr_free_dynamic_packet_list(void)
 {
-   gpr_list_node_t * node = NULL;
-
-   while (!gpr_list_raw_is_empty(&dynamic_packet_list))
-   {
-      gpr_list_remove_head(&dynamic_packet_list, &node);
-      gpr_free_dynamic_packet_raw((gpr_dynamic_packet_t *)((void *)node));
-   }
-}
-
-static gpr_dynamic_packet_t *gpr_get_dynamic_packet(gpr_packet_t *packet)
-{
-   gpr_list_node_t *     node = NULL;
-   gpr_list_node_t *     head = NULL;
    gpr_dynamic_packet_t *dynamic_packet = NULL;
 
-   if ((gpr_list_raw_is_empty(&dynamic_packet_list)))
+   for (uint32_t idx = 0; idx < GPR_DYN_PACKET_NUM_CLASSES; idx++)
    {
-      return dynamic_packet;
+      while (NULL != dynamic_packet_cache[idx])
+      {
+         dynamic_packet            = dynamic_packet_cache[idx];
+         dynamic_packet_cache[idx] = dynamic_packet->next;
+         gpr_free_dynamic_packet_raw(dynamic_packet);
+      }
+      dynamic_packet_cache_cnt[idx] = 0;
    }
-   else
+
+   for (uint32_t idx = 0; idx < GPR_DYN_PACKET_NUM_BUCKETS; idx++)
    {
-      gpr_list_get_head(&dynamic_packet_list, &head);
-      node = head;
-      do
+      while (NULL != dynamic_packet_buckets[idx])
       {
-         dynamic_packet = (gpr_dynamic_packet_t *)((void *)node);
-         if (dynamic_packet->packet == packet)
-         {
-            return dynamic_packet;
-         }
-
-         node = node->next;
-      } while (node != head);
+         dynamic_packet              = dynamic_packet_buckets[idx];
+         dynamic_packet_buckets[idx] = dynamic_packet->next;
+         gpr_free_dynamic_packet_raw(dynamic_packet);
+      }
    }
-
-   dynamic_packet = NULL;
-   return dynamic_packet;
 }
 
-GPR_INTERNAL uint32_t gpr_allocate_dynamic_packet(gpr_packet_t **packet, uint32_t size)
+GPR_INTERNAL uint32_t gpr_allocate_dynamic_packet(gpr_packet_t **packet, uint32_t size, uint32_t pool_index)
 {
    gpr_dynamic_packet_t *dynamic_packet = NULL;
    ar_heap_info          heap_info;
+   uint32_t              bucket;
+   uint32_t              size_class = gpr_dyn_packet_size_class(size);
 
    if (packet == NULL) {
       AR_MSG(DBG_ERROR_PRIO, "alloc error, NULL packet found");
@@ -115,40 +141,95 @@ GPR_INTERNAL uint32_t gpr_allocate_dynamic_packet(gpr_packet_t **packet, uint32_
    heap_info.tag         = AR_HEAP_TAG_DEFAULT;
    heap_info.align_bytes = AR_HEAP_ALIGN_8_BYTES;
 
-   dynamic_packet = (gpr_dynamic_packet_t *)ar_heap_malloc(sizeof(gpr_dynamic_packet_t), &heap_info);
-
-   if (!dynamic_packet)
+   /* Reuse a previously freed packet of the same size class when available */
+   if (GPR_DYN_PACKET_NO_CLASS != size_class)
    {
-      AR_MSG(DBG_ERROR_PRIO, "failed to alloc memory %lu", size);
-      return AR_ENOMEMORY;
+      (void)ar_osal_mutex_lock(gpr_dyn_packet_list_lock);
+      dynamic_packet = dynamic_packet_cache[size_class];
+      if (NULL != dynamic_packet)
+      {
+         dynamic_packet_cache[size_class] = dynamic_packet->next;
+         dynamic_packet_cache_cnt[size_class]--;
+      }
+      (void)ar_osal_mutex_unlock(gpr_dyn_packet_list_lock);
+
+      size = (1UL << (GPR_DYN_PACKET_MIN_CLASS_SHIFT + size_class));
    }
 
-   *packet = (gpr_packet_t *)ar_heap_malloc(size, &heap_info);
-   if (*packet == NULL)
+   if (NULL == dynamic_packet)
    {
-      ar_heap_free((void *)dynamic_packet, &heap_info);
-      AR_MSG(DBG_ERROR_PRIO, "failed to alloc memory %lu", size);
-      return AR_ENOMEMORY;
+      dynamic_packet = (gpr_dynamic_packet_t *)ar_heap_malloc(GPR_DYN_PACKET_HDR_SIZE + size, &heap_info);
+      if (!dynamic_packet)
+      {
+         AR_MSG(DBG_ERROR_PRIO, "failed to alloc memory %lu", size);
+         return AR_ENOMEMORY;
+      }
    }
 
-   dynamic_packet->packet = *packet;
-   gpr_list_init_node((gpr_list_node_t *)dynamic_packet);
-   gpr_list_add_tail(&dynamic_packet_list, (gpr_list_node_t *)dynamic_packet);
+   dynamic_packet->pool_index = pool_index;
+   dynamic_packet->size_class = size_class;
+   *packet                    = gpr_dyn_packet_from_hdr(dynamic_packet);
+   bucket                     = gpr_dyn_packet_bucket(*packet);
+
+   (void)ar_osal_mutex_lock(gpr_dyn_packet_list_lock);
+   dynamic_packet->next           = dynamic_packet_buckets[bucket];
+   dynamic_packet_buckets[bucket] = dynamic_packet;
+   (void)ar_osal_mutex_unlock(gpr_dyn_packet_list_lock);
+
    return AR_EOK;
 }
 
-GPR_INTERNAL uint32_t gpr_check_and_free_dynamic_packet(gpr_packet_t *packet)
+GPR_INTERNAL uint32_t gpr_check_and_free_dynamic_packet(gpr_packet_t *packet, uint32_t *pool_index)
 {
-   gpr_dynamic_packet_t *dynamic_packet = gpr_get_dynamic_packet(packet);
+   gpr_dynamic_packet_t **link           = NULL;
+   gpr_dynamic_packet_t  *dynamic_packet = NULL;
+   uint32_t               size_class;
 
-   if (dynamic_packet == NULL)
+   if (packet == NULL)
    {
-      AR_MSG(DBG_ERROR_PRIO, "failed to free memory");
       return AR_EBADPARAM;
    }
 
-   gpr_list_delete(&dynamic_packet_list, (gpr_list_node_t *)((void *)dynamic_packet));
-   gpr_free_dynamic_packet_raw(dynamic_packet);
+   /* Packets that were not allocated here, such as datalink buffers, are expected. Only the
+    * bucket the packet hashes to is searched, the packet memory itself is never touched. */
+   (void)ar_osal_mutex_lock(gpr_dyn_packet_list_lock);
+   for (link = &dynamic_packet_buckets[gpr_dyn_packet_bucket(packet)]; NULL != *link; link = &(*link)->next)
+   {
+      if (gpr_dyn_packet_from_hdr(*link) == packet)
+      {
+         dynamic_packet = *link;
+         *link          = dynamic_packet->next;
+         break;
+      }
+   }
+
+   if (dynamic_packet == NULL)
+   {
+      (void)ar_osal_mutex_unlock(gpr_dyn_packet_list_lock);
+      return AR_ENOTEXIST;
+   }
+
+   if (pool_index)
+   {
+      *pool_index = dynamic_packet->pool_index;
+   }
+
+   /* Keep the packet for reuse unless its size class cache is full */
+   size_class = dynamic_packet->size_class;
+   if ((GPR_DYN_PACKET_NO_CLASS != size_class) &&
+       (dynamic_packet_cache_cnt[size_class] < GPR_DYN_PACKET_MAX_CACHED_PER_CLASS))
+   {
+      dynamic_packet->next             = dynamic_packet_cache[size_class];
+      dynamic_packet_cache[size_class] = dynamic_packet;
+      dynamic_packet_cache_cnt[size_class]++;
+      dynamic_packet = NULL;
+   }
+   (void)ar_osal_mutex_unlock(gpr_dyn_packet_list_lock);
+
+   if (NULL != dynamic_packet)
+   {
+      gpr_free_dynamic_packet_raw(dynamic_packet);
+   }
    return AR_EOK;
 }
 
@@ -158,10 +239,12 @@ GPR_INTERNAL uint32_t gpr_dynamic_packet_init(void)
 
    if (!gpr_dynamic_packet_init_done)
    {
-      ar_osal_mutex_create(&gpr_dyn_packet_list_lock);
-      result = gpr_list_init(&dynamic_packet_list, gpr_dyn_packet_lock_fn, gpr_dyn_packet_unlock_fn);
+      result = ar_osal_mutex_create(&gpr_dyn_packet_list_lock);
       if (AR_EOK == result)
       {
+         ar_mem_set((void *)dynamic_packet_buckets, 0, sizeof(dynamic_packet_buckets));
+         ar_mem_set((void *)dynamic_packet_cache, 0, sizeof(dynamic_packet_cache));
+         ar_mem_set((void *)dynamic_packet_cache_cnt, 0, sizeof(dynamic_packet_cache_cnt));
          gpr_dynamic_packet_init_done = TRUE;
       }
    }
@@ -12,12 +12,12 @@
 #include "gpr_dynamic_allocation.h"
 #include "ar_osal_error.h"
 
-GPR_INTERNAL uint32_t gpr_allocate_dynamic_packet(gpr_packet_t **packet, uint32_t size)
+GPR_INTERNAL uint32_t gpr_allocate_dynamic_packet(gpr_packet_t **packet, uint32_t size, uint32_t pool_index)
 {
    return AR_EFAILED;
 }
 
-GPR_INTERNAL uint32_t gpr_check_and_free_dynamic_packet(gpr_packet_t *packet)
+GPR_INTERNAL uint32_t gpr_check_and_free_dynamic_packet(gpr_packet_t *packet, uint32_t *pool_index)
 {
    return AR_EFAILED;
 }
@@ -0,0 +1,130 @@
+#ifndef __GPR_TRACE_H__
+#define __GPR_TRACE_H__
+
+/**
+ * \file gpr_trace.h
+ * \brief
+ *  	This file contains the GPR packet trace. Each thread records the header
+ *  	fields of the packets it routes across domains into its own binary ring,
+ *  	the rings are dumped on demand and decoded offline with gpr_trace_decode.
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "gpr_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/*****************************************************************************
+ * Defines                                                                   *
+ ****************************************************************************/
+
+/** Number of per thread rings, threads beyond this share the last ring */
+#ifndef GPR_TRACE_MAX_RINGS
+#define GPR_TRACE_MAX_RINGS 16
+#endif
+
+/** Records kept per ring, must be a power of 2 */
+#ifndef GPR_TRACE_RING_RECORDS
+#define GPR_TRACE_RING_RECORDS 128
+#endif
+
+#define GPR_TRACE_DUMP_MAGIC "GPRTRACE"
+#define GPR_TRACE_DUMP_VERSION 1
+
+/*****************************************************************************
+ * Structure definitions                                                     *
+ ****************************************************************************/
+
+/** One traced packet, the layout is part of the dump format */
+typedef struct gpr_trace_record_t gpr_trace_record_t;
+struct gpr_trace_record_t
+{
+   uint32_t seq;           /**< Write count of the ring including this record, 0 if never written. */
+   uint32_t header;        /**< GPR packet header word, holds the packet size. */
+   uint64_t timestamp_us;  /**< Time the packet was routed. */
+   uint8_t  src_domain_id;
+   uint8_t  dst_domain_id;
+   uint8_t  client_data;
+   uint8_t  reserved;
+   uint32_t src_port;
+   uint32_t dst_port;
+   uint32_t token;
+   uint32_t opcode;
+   uint32_t reserved2;
+};
+
+/** Start of a dump, followed by num_rings rings */
+typedef struct gpr_trace_dump_header_t gpr_trace_dump_header_t;
+struct gpr_trace_dump_header_t
+{
+   char     magic[8];          /**< GPR_TRACE_DUMP_MAGIC, not NULL terminated. */
+   uint32_t version;           /**< GPR_TRACE_DUMP_VERSION. */
+   uint32_t record_size;       /**< sizeof(gpr_trace_record_t). */
+   uint32_t num_rings;
+   uint32_t records_per_ring;
+};
+
+/** Start of each ring in a dump, followed by records_per_ring records in slot order */
+typedef struct gpr_trace_dump_ring_t gpr_trace_dump_ring_t;
+struct gpr_trace_dump_ring_t
+{
+   uint32_t ring_index;
+   uint32_t write_count;       /**< Records written to the ring so far, older ones were overwritten. */
+};
+
+/*****************************************************************************
+ * Function Declarations                                                     *
+ ****************************************************************************/
+
+#ifndef GPR_TRACE_DISABLE
+/**
+ * Record the header of a packet in the ring of the calling thread. Takes a
+ * fixed number of stores, no lock and no allocation.
+ */
+GPR_INTERNAL void gpr_trace_packet(const gpr_packet_t *packet);
+#else
+#define gpr_trace_packet(packet) ((void)(packet))
+#endif
+
+/**
+ * Enable or disable recording, enabled by default. On Linux the
+ * vendor.audio.gpr.trace.enable property is applied at gpr init.
+ */
+GPR_EXTERNAL void gpr_trace_enable(bool_t enable);
+
+/**
+ * Forget all recorded packets, threads claim new rings on their next packet
+ */
+GPR_EXTERNAL void gpr_trace_reset(void);
+
+/**
+ * Size in bytes of a dump of the rings in use
+ */
+GPR_EXTERNAL uint32_t gpr_trace_dump_size(void);
+
+/**
+ * Copy the rings in use into buf in the dump format
+ * \param[in] buf: destination, at least gpr_trace_dump_size() bytes
+ * \param[in] buf_size: size of buf in bytes
+ * \param[out] bytes_written: size of the dump
+ * \return AR_EOK (0) when successful, AR_ENEEDMORE if buf is too small.
+ */
+GPR_EXTERNAL uint32_t gpr_trace_dump(void *buf, uint32_t buf_size, uint32_t *bytes_written);
+
+/**
+ * Write a dump of the rings in use to a file, see also gsl_dump_gpr_trace()
+ * \return AR_EOK (0) when successful.
+ */
+GPR_EXTERNAL uint32_t gpr_trace_dump_to_file(const char_t *path);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* __GPR_TRACE_H__ */
@@ -0,0 +1,239 @@
+/**
+ * \file gpr_trace.c
+ * \brief
+ *    This file contains the per thread binary packet trace
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                    *
+ *****************************************************************************/
+#include "ar_osal_atomic.h"
+#include "ar_osal_error.h"
+#include "ar_osal_file_io.h"
+#include "ar_osal_heap.h"
+#include "ar_osal_mem_op.h"
+#include "ar_osal_timer.h"
+#include "ar_msg.h"
+#include "gpr_api_i.h"
+#include "gpr_trace.h"
+
+/*****************************************************************************
+ * Defines                                                                   *
+ ****************************************************************************/
+
+#ifndef GPR_TRACE_THREAD_LOCAL
+#define GPR_TRACE_THREAD_LOCAL __thread
+#endif
+
+#define GPR_TRACE_RING_MASK (GPR_TRACE_RING_RECORDS - 1)
+
+/*****************************************************************************
+ * Structure definitions                                                     *
+ ****************************************************************************/
+
+typedef struct gpr_trace_ring_t gpr_trace_ring_t;
+struct gpr_trace_ring_t
+{
+   /* Normally only the owning thread writes, the count is still claimed
+    * atomically as threads beyond GPR_TRACE_MAX_RINGS share the last ring.
+    * Aligned so rings written by different threads do not share a line. */
+   volatile uint32_t  write_count __attribute__((aligned(64)));
+   gpr_trace_record_t records[GPR_TRACE_RING_RECORDS];
+};
+
+/*****************************************************************************
+ * Variables                                                                 *
+ ****************************************************************************/
+
+/* Static so a thread holding a ring pointer across a reset never sees freed memory */
+static gpr_trace_ring_t  gpr_trace_rings[GPR_TRACE_MAX_RINGS];
+static volatile uint32_t gpr_trace_num_rings;
+static volatile uint32_t gpr_trace_generation = 1;
+static volatile uint32_t gpr_trace_enabled    = TRUE;
+
+static GPR_TRACE_THREAD_LOCAL gpr_trace_ring_t *gpr_trace_thread_ring;
+static GPR_TRACE_THREAD_LOCAL uint32_t          gpr_trace_thread_generation;
+
+/*****************************************************************************
+ * Function Definitions                                                      *
+ ****************************************************************************/
+
+#ifndef GPR_TRACE_DISABLE
+static gpr_trace_ring_t *gpr_trace_get_ring(void)
+{
+   uint32_t generation = ar_osal_atomic_load_u32(&gpr_trace_generation);
+   uint32_t idx;
+
+   if ((NULL == gpr_trace_thread_ring) || (gpr_trace_thread_generation != generation))
+   {
+      idx = ar_osal_atomic_add_u32(&gpr_trace_num_rings, 1) - 1;
+      if (idx >= GPR_TRACE_MAX_RINGS)
+      {
+         idx = GPR_TRACE_MAX_RINGS - 1;
+      }
+      gpr_trace_thread_ring       = &gpr_trace_rings[idx];
+      gpr_trace_thread_generation = generation;
+   }
+   return gpr_trace_thread_ring;
+}
+
+GPR_INTERNAL void gpr_trace_packet(const gpr_packet_t *packet)
+{
+   gpr_trace_ring_t   *ring;
+   gpr_trace_record_t *rec;
+   uint32_t            seq;
+
+   if (!ar_osal_atomic_load_u32(&gpr_trace_enabled))
+   {
+      return;
+   }
+
+   ring = gpr_trace_get_ring();
+   seq  = ar_osal_atomic_add_u32(&ring->write_count, 1);
+   rec  = &ring->records[(seq - 1) & GPR_TRACE_RING_MASK];
+
+   /* seq is cleared while the fields are written so a dump can skip the record,
+    * the fence keeps the field stores from becoming visible before the clear */
+   ar_osal_atomic_store_u32(&rec->seq, 0);
+   ar_osal_atomic_fence();
+   rec->header        = packet->header;
+   rec->timestamp_us  = ar_timer_get_time_in_us();
+   rec->src_domain_id = packet->src_domain_id;
+   rec->dst_domain_id = packet->dst_domain_id;
+   rec->client_data   = packet->client_data;
+   rec->src_port      = packet->src_port;
+   rec->dst_port      = packet->dst_port;
+   rec->token         = packet->token;
+   rec->opcode        = packet->opcode;
+   ar_osal_atomic_store_u32(&rec->seq, seq);
+}
+#endif
+
+GPR_EXTERNAL void gpr_trace_enable(bool_t enable)
+{
+   ar_osal_atomic_store_u32(&gpr_trace_enabled, enable ? TRUE : FALSE);
+}
+
+GPR_EXTERNAL void gpr_trace_reset(void)
+{
+   uint32_t i, j;
+
+   ar_osal_atomic_add_u32(&gpr_trace_generation, 1);
+   ar_osal_atomic_store_u32(&gpr_trace_num_rings, 0);
+   for (i = 0; i < GPR_TRACE_MAX_RINGS; i++)
+   {
+      ar_osal_atomic_store_u32(&gpr_trace_rings[i].write_count, 0);
+      for (j = 0; j < GPR_TRACE_RING_RECORDS; j++)
+      {
+         ar_osal_atomic_store_u32(&gpr_trace_rings[i].records[j].seq, 0);
+      }
+   }
+}
+
+static uint32_t gpr_trace_rings_in_use(void)
+{
+   uint32_t num_rings = ar_osal_atomic_load_u32(&gpr_trace_num_rings);
+
+   return (num_rings > GPR_TRACE_MAX_RINGS) ? GPR_TRACE_MAX_RINGS : num_rings;
+}
+
+GPR_EXTERNAL uint32_t gpr_trace_dump_size(void)
+{
+   return sizeof(gpr_trace_dump_header_t) +
+          gpr_trace_rings_in_use() *
+             (sizeof(gpr_trace_dump_ring_t) + GPR_TRACE_RING_RECORDS * sizeof(gpr_trace_record_t));
+}
+
+GPR_EXTERNAL uint32_t gpr_trace_dump(void *buf, uint32_t buf_size, uint32_t *bytes_written)
+{
+   gpr_trace_dump_header_t *hdr = (gpr_trace_dump_header_t *)buf;
+   gpr_trace_dump_ring_t   *ring_hdr;
+   gpr_trace_record_t      *rec;
+   uint32_t                 num_rings = gpr_trace_rings_in_use();
+   uint32_t                 i, j, seq;
+
+   if ((NULL == buf) || (NULL == bytes_written))
+   {
+      return AR_EBADPARAM;
+   }
+   *bytes_written = sizeof(gpr_trace_dump_header_t) +
+                    num_rings * (sizeof(gpr_trace_dump_ring_t) + GPR_TRACE_RING_RECORDS * sizeof(gpr_trace_record_t));
+   if (buf_size < *bytes_written)
+   {
+      return AR_ENEEDMORE;
+   }
+
+   (void)ar_mem_cpy(hdr->magic, sizeof(hdr->magic), GPR_TRACE_DUMP_MAGIC, sizeof(hdr->magic));
+   hdr->version          = GPR_TRACE_DUMP_VERSION;
+   hdr->record_size      = sizeof(gpr_trace_record_t);
+   hdr->num_rings        = num_rings;
+   hdr->records_per_ring = GPR_TRACE_RING_RECORDS;
+
+   ring_hdr = (gpr_trace_dump_ring_t *)(hdr + 1);
+   for (i = 0; i < num_rings; i++)
+   {
+      ring_hdr->ring_index  = i;
+      ring_hdr->write_count = ar_osal_atomic_load_u32(&gpr_trace_rings[i].write_count);
+      rec                   = (gpr_trace_record_t *)(ring_hdr + 1);
+      for (j = 0; j < GPR_TRACE_RING_RECORDS; j++, rec++)
+      {
+         /* best effort, a record rewritten while it is copied is dropped */
+         seq = ar_osal_atomic_load_u32(&gpr_trace_rings[i].records[j].seq);
+         (void)ar_mem_cpy(rec, sizeof(*rec), &gpr_trace_rings[i].records[j], sizeof(*rec));
+         /* the copy must complete before seq is read again */
+         ar_osal_atomic_fence();
+         if (seq != ar_osal_atomic_load_u32(&gpr_trace_rings[i].records[j].seq))
+         {
+            seq = 0;
+         }
+         rec->seq = seq;
+      }
+      ring_hdr = (gpr_trace_dump_ring_t *)rec;
+   }
+   return AR_EOK;
+}
+
+GPR_EXTERNAL uint32_t gpr_trace_dump_to_file(const char_t *path)
+{
+   ar_heap_info heap_info = { AR_HEAP_ALIGN_8_BYTES, AR_HEAP_POOL_DEFAULT, AR_HEAP_ID_DEFAULT, AR_HEAP_TAG_DEFAULT };
+   ar_fhandle   file;
+   size_t       file_bytes = 0;
+   uint32_t     size       = gpr_trace_dump_size();
+   uint32_t     rc;
+   void        *buf;
+
+   buf = ar_heap_malloc(size, &heap_info);
+   if (NULL == buf)
+   {
+      return AR_ENOMEMORY;
+   }
+
+   /* rings claimed after the size was taken are left out of this dump */
+   rc = gpr_trace_dump(buf, size, &size);
+   if (AR_EOK != rc)
+   {
+      goto free_buf;
+   }
+
+   rc = ar_fopen(&file, path, AR_FOPEN_WRITE_ONLY);
+   if (AR_EOK != rc)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "GPR trace: failed to open dump file, rc %lu", rc);
+      goto free_buf;
+   }
+   rc = ar_fwrite(file, buf, size, &file_bytes);
+   if ((AR_EOK == rc) && (file_bytes != size))
+   {
+      rc = AR_EFAILED;
+   }
+   (void)ar_fclose(file);
+
+free_buf:
+   ar_heap_free(buf, &heap_info);
+   return rc;
+}
@@ -0,0 +1,149 @@
+/**
+ * \file gpr_trace_decode.c
+ * \brief
+ *  	Offline decoder for GPR packet trace dumps written by
+ *  	gpr_trace_dump_to_file(). Records from all rings are merged and printed
+ *  	in timestamp order.
+ *
+ *  	usage: gpr_trace_decode <dump file>
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                   *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpr_packet.h"
+#include "gpr_trace.h"
+
+/******************************************************************************
+ * Structure definitions                                                      *
+ *****************************************************************************/
+typedef struct trace_decode_entry_t
+{
+   gpr_trace_record_t rec;
+   uint32_t           ring_index;
+} trace_decode_entry_t;
+
+/******************************************************************************
+ * Functions                                                                  *
+ *****************************************************************************/
+static int trace_decode_compare(const void *a, const void *b)
+{
+   const trace_decode_entry_t *ea = (const trace_decode_entry_t *)a;
+   const trace_decode_entry_t *eb = (const trace_decode_entry_t *)b;
+
+   if (ea->rec.timestamp_us != eb->rec.timestamp_us)
+   {
+      return (ea->rec.timestamp_us < eb->rec.timestamp_us) ? -1 : 1;
+   }
+   if (ea->ring_index != eb->ring_index)
+   {
+      return (ea->ring_index < eb->ring_index) ? -1 : 1;
+   }
+   return (ea->rec.seq < eb->rec.seq) ? -1 : (ea->rec.seq > eb->rec.seq);
+}
+
+int main(int argc, char *argv[])
+{
+   gpr_trace_dump_header_t hdr;
+   gpr_trace_dump_ring_t   ring;
+   trace_decode_entry_t   *entries = NULL;
+   uint32_t                num_entries = 0;
+   uint32_t                i, j;
+   FILE                   *fp;
+   int                     rc = 1;
+
+   if (argc != 2)
+   {
+      fprintf(stderr, "usage: %s <dump file>\n", argv[0]);
+      return 1;
+   }
+   fp = fopen(argv[1], "rb");
+   if (NULL == fp)
+   {
+      perror(argv[1]);
+      return 1;
+   }
+
+   if ((1 != fread(&hdr, sizeof(hdr), 1, fp)) ||
+       (0 != memcmp(hdr.magic, GPR_TRACE_DUMP_MAGIC, sizeof(hdr.magic))))
+   {
+      fprintf(stderr, "%s: not a GPR trace dump\n", argv[1]);
+      goto done;
+   }
+   if ((GPR_TRACE_DUMP_VERSION != hdr.version) || (sizeof(gpr_trace_record_t) != hdr.record_size))
+   {
+      fprintf(stderr, "%s: unsupported dump version %u record size %u\n", argv[1], hdr.version, hdr.record_size);
+      goto done;
+   }
+
+   if (hdr.num_rings && hdr.records_per_ring)
+   {
+      entries = (trace_decode_entry_t *)calloc((size_t)hdr.num_rings * hdr.records_per_ring, sizeof(*entries));
+      if (NULL == entries)
+      {
+         fprintf(stderr, "out of memory\n");
+         goto done;
+      }
+   }
+
+   for (i = 0; i < hdr.num_rings; i++)
+   {
+      if (1 != fread(&ring, sizeof(ring), 1, fp))
+      {
+         fprintf(stderr, "%s: truncated at ring %u\n", argv[1], i);
+         goto done;
+      }
+      printf("ring %u: %u packets traced\n", ring.ring_index, ring.write_count);
+      for (j = 0; j < hdr.records_per_ring; j++)
+      {
+         if (1 != fread(&entries[num_entries].rec, sizeof(gpr_trace_record_t), 1, fp))
+         {
+            fprintf(stderr, "%s: truncated in ring %u\n", argv[1], i);
+            goto done;
+         }
+         /* slots never written or torn while the dump was taken */
+         if (0 == entries[num_entries].rec.seq)
+         {
+            continue;
+         }
+         entries[num_entries].ring_index = ring.ring_index;
+         num_entries++;
+      }
+   }
+
+   qsort(entries, num_entries, sizeof(*entries), trace_decode_compare);
+
+   printf("%16s %4s %8s  %-22s %-22s %10s %10s %6s\n",
+          "time_us", "ring", "seq", "src domain:port", "dst domain:port", "opcode", "token", "size");
+   for (i = 0; i < num_entries; i++)
+   {
+      const gpr_trace_record_t *rec = &entries[i].rec;
+      char                      src[24], dst[24];
+
+      snprintf(src, sizeof(src), "%u:0x%08x", rec->src_domain_id, rec->src_port);
+      snprintf(dst, sizeof(dst), "%u:0x%08x", rec->dst_domain_id, rec->dst_port);
+      printf("%16llu %4u %8u  %-22s %-22s 0x%08x 0x%08x %6u\n",
+             (unsigned long long)rec->timestamp_us,
+             entries[i].ring_index,
+             rec->seq,
+             src,
+             dst,
+             rec->opcode,
+             rec->token,
+             GPR_PKT_GET_PACKET_BYTE_SIZE(rec->header));
+   }
+   rc = 0;
+
+done:
+   free(entries);
+   fclose(fp);
+   return rc;
+}
@@ -10,10 +10,15 @@
 #include <errno.h>
 #include "gpr_api_i.h"
 #include "gpr_lx.h"
+#include "gpr_trace.h"
+#ifdef GPR_USE_LOOPBACK
+#include "gpr_loopback.h"
+#endif
 #include <unistd.h>
 
 #ifdef GPR_USE_CUTILS
 #include <log/log.h>
+#include <cutils/properties.h>
 #else
 #include <syslog.h>
 #ifndef ALOGD
@@ -87,6 +92,56 @@ GPR_INTERNAL void update_gpr_ipc_table(char *drv_path, uint16_t domain_id,
    num_domains++;
 }
 
+#ifdef GPR_USE_LOOPBACK
+/* Remote domain answered by the in-process SPF stub, no driver is needed */
+GPR_INTERNAL void update_gpr_loopback_ipc_table(uint16_t domain_id)
+{
+   ALOGD("%s:%d num_dom %d %d loopback\n", __func__, __LINE__, num_domains, domain_id);
+
+   gpr_lx_ipc_dl_table[num_domains].domain_id = domain_id;
+   gpr_lx_ipc_dl_table[num_domains].init_fn = ipc_dl_loopback_init;
+   gpr_lx_ipc_dl_table[num_domains].deinit_fn = ipc_dl_loopback_deinit;
+   gpr_lx_ipc_dl_table[num_domains].supports_shared_mem = TRUE;
+
+   num_domains++;
+}
+#endif
+
+/* Datalink settings that can be changed without a rebuild, kept at their defaults if not set */
+static void gpr_lx_update_dl_config(void)
+{
+#ifdef GPR_USE_CUTILS
+   gpr_dl_lx_config_t cfg;
+   int32_t val;
+
+   if (ipc_dl_lx_get_config(&cfg))
+      return;
+
+   /* negative values are ignored */
+   val = property_get_int32("vendor.audio.gpr.lx.num_buffers", cfg.num_buffers);
+   if (val > 0)
+      cfg.num_buffers = val;
+   val = property_get_int32("vendor.audio.gpr.lx.buf_size", cfg.buf_size);
+   if (val > 0)
+      cfg.buf_size = val;
+   val = property_get_int32("vendor.audio.gpr.lx.tx_queue_depth", cfg.tx_queue_depth);
+   if (val >= 0)
+      cfg.tx_queue_depth = val;
+   cfg.batch_rx = property_get_bool("vendor.audio.gpr.lx.batch_rx", cfg.batch_rx);
+
+   if (ipc_dl_lx_set_config(&cfg))
+      ALOGE("%s:%d invalid datalink config, using the previous one\n", __func__, __LINE__);
+#endif
+}
+
+/* Packet trace recording can be turned off in the field without a rebuild */
+static void gpr_lx_update_trace_config(void)
+{
+#ifdef GPR_USE_CUTILS
+   gpr_trace_enable(property_get_bool("vendor.audio.gpr.trace.enable", TRUE));
+#endif
+}
+
 GPR_INTERNAL uint32_t gpr_drv_init(void)
 {
    ALOGD("GPR INIT START");
@@ -127,6 +182,9 @@ GPR_INTERNAL uint32_t gpr_drv_init(void)
 
    num_domains++;
    domain_id = GPR_IDS_DOMAIN_ID_ADSP_V;
+#elif defined(GPR_USE_LOOPBACK)
+   update_gpr_loopback_ipc_table(GPR_IDS_DOMAIN_ID_ADSP_V);
+   domain_id = GPR_IDS_DOMAIN_ID_APPS_V;
 #else
    update_gpr_ipc_table("/dev/aud_pasthru_adsp",
                            GPR_IDS_DOMAIN_ID_ADSP_V,
@@ -139,6 +197,8 @@ GPR_INTERNAL uint32_t gpr_drv_init(void)
                            FALSE);
    domain_id = GPR_IDS_DOMAIN_ID_APPS_V;
 #endif
+   gpr_lx_update_dl_config();
+   gpr_lx_update_trace_config();
    rc = gpr_drv_internal_init_v2(domain_id,
                                  num_domains,
                                  gpr_lx_ipc_dl_table,
@@ -164,6 +224,12 @@ GPR_INTERNAL uint32_t gpr_drv_init_domain(uint32_t domain_id)
 
    num_domains++;
 
+#ifdef GPR_USE_LOOPBACK
+   if ((domain_id == GPR_IDS_DOMAIN_ID_APPS_V) || (domain_id == GPR_IDS_DOMAIN_ID_APPS2_V))
+   {
+      update_gpr_loopback_ipc_table(GPR_IDS_DOMAIN_ID_ADSP_V);
+   }
+#else
    if (domain_id == GPR_IDS_DOMAIN_ID_APPS_V)
    {
       update_gpr_ipc_table("/dev/aud_pasthru_adsp",
@@ -182,7 +248,10 @@ GPR_INTERNAL uint32_t gpr_drv_init_domain(uint32_t domain_id)
                            GPR_IDS_DOMAIN_ID_ADSP_V,
                            TRUE);
    }
+#endif
 
+   gpr_lx_update_dl_config();
+   gpr_lx_update_trace_config();
    rc = gpr_drv_internal_init_v2(domain_id,
                                  num_domains,
                                  gpr_lx_ipc_dl_table,
@@ -0,0 +1,209 @@
+/**
+ * \file gpr_loopback_bench.c
+ * \brief
+ *  	Host side GPR benchmark against the loopback datalink. GPR is brought
+ *  	up with the ADSP domain served by the in-process SPF stub, then command
+ *  	round trips and windowed data buffer throughput are measured with and
+ *  	without simulated DSP latency.
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                   *
+ *****************************************************************************/
+#include <stdio.h>
+#include "gpr_api_i.h"
+#include "gpr_api_inline.h"
+#include "gpr_loopback.h"
+#include "apm_api.h"
+#include "wr_sh_mem_ep_api.h"
+#include "ar_osal_atomic.h"
+#include "ar_osal_error.h"
+#include "ar_osal_signal.h"
+#include "ar_osal_timer.h"
+
+/******************************************************************************
+ * Defines                                                                    *
+ *****************************************************************************/
+#define LOOPBACK_BENCH_PORT (0x2001)
+#define LOOPBACK_BENCH_WR_EP_PORT (0x4001)
+#define LOOPBACK_BENCH_ITERATIONS (20000)
+/* data buffers kept in flight, like a client queueing several write buffers */
+#define LOOPBACK_BENCH_WINDOW (4)
+#define LOOPBACK_BENCH_TIMEOUT_NS (1000000000LL)
+
+/******************************************************************************
+ * Globals                                                                    *
+ *****************************************************************************/
+static ar_osal_signal_t  loopback_bench_sig;
+static volatile uint32_t loopback_bench_inflight;
+static volatile uint32_t loopback_bench_errors;
+
+static struct ipc_dl_v2_t loopback_bench_dl_table[] = {
+   { GPR_IDS_DOMAIN_ID_APPS_V, ipc_dl_local_init, ipc_dl_local_deinit, TRUE },
+   { GPR_IDS_DOMAIN_ID_ADSP_V, ipc_dl_loopback_init, ipc_dl_loopback_deinit, TRUE },
+};
+
+static gpr_packet_pool_info_v2_t loopback_bench_pools[] = {
+   { GPR_HEAP_INDEX_DEFAULT, 0, 0, 100, 512 },
+   { GPR_HEAP_INDEX_DEFAULT, 0, 0, 4, 4096 },
+};
+
+/******************************************************************************
+ * Functions                                                                  *
+ *****************************************************************************/
+static uint32_t loopback_bench_callback(gpr_packet_t *packet, void *callback_data)
+{
+   bool_t ok = FALSE;
+
+   (void)callback_data;
+   if (APM_CMD_RSP_GET_SPF_STATE == packet->opcode)
+   {
+      ok = (APM_SPF_STATE_READY == GPR_PKT_GET_PAYLOAD(apm_cmd_rsp_get_spf_status_t, packet)->status);
+   }
+   else if (DATA_CMD_RSP_WR_SH_MEM_EP_DATA_BUFFER_DONE_V2 == packet->opcode)
+   {
+      ok = (AR_EOK == GPR_PKT_GET_PAYLOAD(data_cmd_rsp_wr_sh_mem_ep_data_buffer_done_v2_t, packet)->data_status);
+   }
+   if (!ok)
+   {
+      (void)ar_osal_atomic_add_u32(&loopback_bench_errors, 1);
+   }
+
+   (void)__gpr_cmd_free(packet);
+   (void)ar_osal_atomic_sub_u32(&loopback_bench_inflight, 1);
+   (void)ar_osal_signal_set(loopback_bench_sig);
+   return AR_EOK;
+}
+
+static uint32_t loopback_bench_send(uint32_t opcode, uint32_t dst_port, uint32_t token, void *payload,
+                                    uint32_t payload_size)
+{
+   gpr_cmd_alloc_send_t args;
+   uint32_t             rc;
+
+   args.src_domain_id = GPR_IDS_DOMAIN_ID_APPS_V;
+   args.src_port      = LOOPBACK_BENCH_PORT;
+   args.dst_domain_id = GPR_IDS_DOMAIN_ID_ADSP_V;
+   args.dst_port      = dst_port;
+   args.client_data   = 0;
+   args.token         = token;
+   args.opcode        = opcode;
+   args.payload_size  = payload_size;
+   args.payload       = payload;
+
+   (void)ar_osal_atomic_add_u32(&loopback_bench_inflight, 1);
+   rc = __gpr_cmd_alloc_send(&args);
+   if (AR_EOK != rc)
+   {
+      (void)ar_osal_atomic_sub_u32(&loopback_bench_inflight, 1);
+   }
+   return rc;
+}
+
+/* waits until fewer than limit commands are in flight */
+static uint32_t loopback_bench_wait(uint32_t limit)
+{
+   while (ar_osal_atomic_load_u32(&loopback_bench_inflight) > limit)
+   {
+      if (AR_EOK != ar_osal_signal_timedwait(loopback_bench_sig, LOOPBACK_BENCH_TIMEOUT_NS))
+      {
+         return AR_ETIMEOUT;
+      }
+      (void)ar_osal_signal_clear(loopback_bench_sig);
+   }
+   return AR_EOK;
+}
+
+/* one command in flight at a time, returns ns per round trip */
+static uint64_t loopback_bench_round_trip(void)
+{
+   uint64_t start_us = ar_timer_get_time_in_us();
+
+   for (uint32_t i = 0; i < LOOPBACK_BENCH_ITERATIONS; i++)
+   {
+      if ((AR_EOK != loopback_bench_send(APM_CMD_GET_SPF_STATE, APM_MODULE_INSTANCE_ID, i, NULL, 0)) ||
+          (AR_EOK != loopback_bench_wait(0)))
+      {
+         (void)ar_osal_atomic_add_u32(&loopback_bench_errors, 1);
+         break;
+      }
+   }
+   return (ar_timer_get_time_in_us() - start_us) * 1000 / LOOPBACK_BENCH_ITERATIONS;
+}
+
+/* LOOPBACK_BENCH_WINDOW data buffers in flight, returns ns per buffer */
+static uint64_t loopback_bench_data(void)
+{
+   data_cmd_wr_sh_mem_ep_data_buffer_v2_t wr = { 0 };
+   uint64_t                               start_us = ar_timer_get_time_in_us();
+
+   wr.data_mem_map_handle = 1;
+   wr.data_buf_size       = 3840;
+   for (uint32_t i = 0; i < LOOPBACK_BENCH_ITERATIONS; i++)
+   {
+      wr.data_buf_addr_lsw = i;
+      if ((AR_EOK != loopback_bench_wait(LOOPBACK_BENCH_WINDOW - 1)) ||
+          (AR_EOK != loopback_bench_send(DATA_CMD_WR_SH_MEM_EP_DATA_BUFFER_V2,
+                                         LOOPBACK_BENCH_WR_EP_PORT,
+                                         i,
+                                         &wr,
+                                         sizeof(wr))))
+      {
+         (void)ar_osal_atomic_add_u32(&loopback_bench_errors, 1);
+         break;
+      }
+   }
+   if (AR_EOK != loopback_bench_wait(0))
+   {
+      (void)ar_osal_atomic_add_u32(&loopback_bench_errors, 1);
+   }
+   return (ar_timer_get_time_in_us() - start_us) * 1000 / LOOPBACK_BENCH_ITERATIONS;
+}
+
+int main(void)
+{
+   gpr_loopback_config_t cfgs[] = { { 0, 0 }, { 100, 100 } };
+   int                   rc     = 0;
+
+   if ((AR_EOK != ar_osal_signal_create(&loopback_bench_sig)) ||
+       (AR_EOK != gpr_drv_internal_init_v2(GPR_IDS_DOMAIN_ID_APPS_V,
+                                           sizeof(loopback_bench_dl_table) / sizeof(loopback_bench_dl_table[0]),
+                                           loopback_bench_dl_table,
+                                           sizeof(loopback_bench_pools) / sizeof(loopback_bench_pools[0]),
+                                           loopback_bench_pools)) ||
+       (AR_EOK != __gpr_cmd_register(LOOPBACK_BENCH_PORT, loopback_bench_callback, NULL)))
+   {
+      printf("setup failed\n");
+      return 1;
+   }
+
+   for (uint32_t i = 0; i < sizeof(cfgs) / sizeof(cfgs[0]); i++)
+   {
+      uint64_t rt_ns, data_ns;
+
+      (void)ipc_dl_loopback_set_config(&cfgs[i]);
+      rt_ns   = loopback_bench_round_trip();
+      data_ns = loopback_bench_data();
+      printf("latency %u us: command round trip %llu ns, data buffer %llu ns with %u in flight\n",
+             cfgs[i].cmd_latency_us,
+             (unsigned long long)rt_ns,
+             (unsigned long long)data_ns,
+             LOOPBACK_BENCH_WINDOW);
+   }
+
+   if (0 != ar_osal_atomic_load_u32(&loopback_bench_errors))
+   {
+      printf("FAILED: %u errors\n", ar_osal_atomic_load_u32(&loopback_bench_errors));
+      rc = 1;
+   }
+
+   (void)__gpr_cmd_deregister(LOOPBACK_BENCH_PORT);
+   (void)gpr_drv_deinit();
+   (void)ar_osal_signal_destroy(loopback_bench_sig);
+   return rc;
+}
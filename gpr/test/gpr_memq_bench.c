@@ -0,0 +1,215 @@
+/**
+ * \file gpr_memq_bench.c
+ * \brief
+ *  	Contention microbenchmark for the GPR packet free lists. Several
+ *  	threads allocate and free packets from one static pool queue, first
+ *  	through the lock free gpr_memq and then with every call serialized by a
+ *  	single mutex, which is how the queue was protected before.
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                   *
+ *****************************************************************************/
+#include <stdio.h>
+#include "gpr_memq.h"
+#include "ar_osal_atomic.h"
+#include "ar_osal_error.h"
+#include "ar_osal_heap.h"
+#include "ar_osal_mem_op.h"
+#include "ar_osal_mutex.h"
+#include "ar_osal_thread.h"
+#include "ar_osal_timer.h"
+
+/******************************************************************************
+ * Defines                                                                    *
+ *****************************************************************************/
+#define MEMQ_BENCH_MAX_THREADS (8)
+#define MEMQ_BENCH_ITERATIONS (200000)
+#define MEMQ_BENCH_NUM_UNITS (64)
+#define MEMQ_BENCH_BUF_SIZE (512)
+#define MEMQ_BENCH_METADATA_ITEMS (1)
+/* packets held at once by each thread, mimics a few commands in flight */
+#define MEMQ_BENCH_BATCH (4)
+
+/******************************************************************************
+ * Globals                                                                    *
+ *****************************************************************************/
+static gpr_memq_block_t  memq_bench_block;
+static ar_osal_mutex_t   memq_bench_lock;
+static bool_t            memq_bench_use_lock;
+static volatile uint32_t memq_bench_failures;
+
+/******************************************************************************
+ * Functions                                                                  *
+ *****************************************************************************/
+static void memq_bench_lock_fn(void)
+{
+   (void)ar_osal_mutex_lock(memq_bench_lock);
+}
+
+static void memq_bench_unlock_fn(void)
+{
+   (void)ar_osal_mutex_unlock(memq_bench_lock);
+}
+
+static void *memq_bench_alloc(void)
+{
+   void *ptr;
+
+   if (memq_bench_use_lock)
+   {
+      memq_bench_lock_fn();
+   }
+   ptr = gpr_memq_alloc(&memq_bench_block);
+   if (memq_bench_use_lock)
+   {
+      memq_bench_unlock_fn();
+   }
+   return ptr;
+}
+
+static void memq_bench_free(void *ptr)
+{
+   if (memq_bench_use_lock)
+   {
+      memq_bench_lock_fn();
+   }
+   gpr_memq_free(&memq_bench_block, ptr);
+   if (memq_bench_use_lock)
+   {
+      memq_bench_unlock_fn();
+   }
+}
+
+static void memq_bench_thread(void *param)
+{
+   void    *pkts[MEMQ_BENCH_BATCH];
+   uint32_t tag = (uint32_t)(uintptr_t)param;
+
+   for (uint32_t iter = 0; iter < MEMQ_BENCH_ITERATIONS / MEMQ_BENCH_BATCH; iter++)
+   {
+      for (uint32_t i = 0; i < MEMQ_BENCH_BATCH; i++)
+      {
+         pkts[i] = memq_bench_alloc();
+         if (NULL == pkts[i])
+         {
+            (void)ar_osal_atomic_add_u32(&memq_bench_failures, 1);
+            continue;
+         }
+         /* touch the packet so two owners of one unit would be noticed */
+         *(uint32_t *)pkts[i] = tag;
+      }
+
+      for (uint32_t i = 0; i < MEMQ_BENCH_BATCH; i++)
+      {
+         if (NULL == pkts[i])
+         {
+            continue;
+         }
+         if (*(uint32_t *)pkts[i] != tag)
+         {
+            (void)ar_osal_atomic_add_u32(&memq_bench_failures, 1);
+         }
+         memq_bench_free(pkts[i]);
+      }
+   }
+}
+
+static uint64_t memq_bench_run(uint32_t num_threads)
+{
+   ar_osal_thread_t      threads[MEMQ_BENCH_MAX_THREADS] = { NULL };
+   ar_osal_thread_attr_t attr;
+   uint64_t              start_us;
+
+   start_us = ar_timer_get_time_in_us();
+   for (uint32_t i = 0; i < num_threads; i++)
+   {
+      if ((AR_EOK != ar_osal_thread_attr_init(&attr)) ||
+          (AR_EOK != ar_osal_thread_create(&threads[i], &attr, memq_bench_thread, (void *)(uintptr_t)(i + 1))))
+      {
+         printf("thread create failed\n");
+         break;
+      }
+   }
+
+   for (uint32_t i = 0; i < num_threads; i++)
+   {
+      if (threads[i])
+      {
+         (void)ar_osal_thread_join_destroy(threads[i]);
+      }
+   }
+
+   return ar_timer_get_time_in_us() - start_us;
+}
+
+int main(void)
+{
+   uint32_t     unit_size = GPR_MEMQ_UNIT_OVERHEAD_V + MEMQ_BENCH_BUF_SIZE +
+                        (MEMQ_BENCH_METADATA_ITEMS * GPR_MEMQ_BYTES_PER_METADATA_ITEM_V);
+   uint32_t     heap_size = unit_size * MEMQ_BENCH_NUM_UNITS;
+   char_t      *heap;
+   ar_heap_info heap_info;
+   int          rc = 0;
+
+   ar_mem_set((void *)&heap_info, 0, sizeof(ar_heap_info));
+   heap_info.align_bytes = AR_HEAP_ALIGN_8_BYTES;
+   heap_info.tag         = AR_HEAP_TAG_DEFAULT;
+
+   heap = (char_t *)ar_heap_malloc(heap_size, &heap_info);
+   if ((NULL == heap) || (AR_EOK != ar_osal_mutex_create(&memq_bench_lock)))
+   {
+      printf("setup failed\n");
+      return 1;
+   }
+
+   if (AR_EOK != gpr_memq_init(&memq_bench_block,
+                               heap,
+                               heap_size,
+                               unit_size,
+                               MEMQ_BENCH_METADATA_ITEMS,
+                               memq_bench_lock_fn,
+                               memq_bench_unlock_fn,
+                               GPR_HEAP_INDEX_DEFAULT))
+   {
+      printf("gpr_memq_init failed\n");
+      return 1;
+   }
+
+   for (uint32_t num_threads = 1; num_threads <= MEMQ_BENCH_MAX_THREADS; num_threads *= 2)
+   {
+      uint64_t calls = (uint64_t)MEMQ_BENCH_ITERATIONS * num_threads;
+      uint64_t lock_free_us, locked_us;
+
+      memq_bench_use_lock = FALSE;
+      lock_free_us        = memq_bench_run(num_threads);
+      memq_bench_use_lock = TRUE;
+      locked_us           = memq_bench_run(num_threads);
+
+      printf("%u threads: lock free %llu ns/alloc+free, mutex %llu ns/alloc+free\n",
+             num_threads,
+             (unsigned long long)(lock_free_us * 1000 / calls),
+             (unsigned long long)(locked_us * 1000 / calls));
+   }
+
+   if ((0 != ar_osal_atomic_load_u32(&memq_bench_failures)) ||
+       (ar_osal_atomic_load_u32(&memq_bench_block.free_count) != MEMQ_BENCH_NUM_UNITS))
+   {
+      printf("FAILED: %u errors, %u of %u units free\n",
+             ar_osal_atomic_load_u32(&memq_bench_failures),
+             ar_osal_atomic_load_u32(&memq_bench_block.free_count),
+             MEMQ_BENCH_NUM_UNITS);
+      rc = 1;
+   }
+
+   gpr_memq_deinit(&memq_bench_block, GPR_HEAP_INDEX_DEFAULT);
+   ar_osal_mutex_destroy(memq_bench_lock);
+   ar_heap_free(heap, &heap_info);
+
+   return rc;
+}
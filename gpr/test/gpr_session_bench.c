@@ -0,0 +1,141 @@
+/**
+ * \file gpr_session_bench.c
+ * \brief
+ *  	Port to session lookup benchmark. The same source is built once per
+ *  	session variant (hash_based, array_based, open_addressing), each build
+ *  	registers growing numbers of ports and times gpr_get_session on them
+ *  	in random order, the way packets are delivered to registered ports.
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                   *
+ *****************************************************************************/
+#include <stdio.h>
+#include "gpr_session.h"
+#include "ar_osal_error.h"
+#include "ar_osal_heap.h"
+#include "ar_osal_mem_op.h"
+#include "ar_osal_timer.h"
+
+/******************************************************************************
+ * Defines                                                                    *
+ *****************************************************************************/
+#ifndef GPR_SESSION_BENCH_VARIANT
+#define GPR_SESSION_BENCH_VARIANT "hash_based"
+#endif
+#define SESSION_BENCH_LOOKUPS (2000000)
+#define SESSION_BENCH_MAX_PORTS (1024)
+/* module instance ids are handed out from this range, a few apart */
+#define SESSION_BENCH_PORT_BASE (0x4000)
+#define SESSION_BENCH_PORT_STRIDE (3)
+
+/******************************************************************************
+ * Globals                                                                    *
+ *****************************************************************************/
+static const uint32_t session_bench_num_ports[] = { 16, 64, 256, SESSION_BENCH_MAX_PORTS };
+
+/******************************************************************************
+ * Functions                                                                  *
+ *****************************************************************************/
+static uint32_t session_bench_callback(gpr_packet_t *packet, void *callback_data)
+{
+   (void)packet;
+   (void)callback_data;
+   return AR_EOK;
+}
+
+static uint32_t session_bench_port(uint32_t i)
+{
+   return SESSION_BENCH_PORT_BASE + (i * SESSION_BENCH_PORT_STRIDE);
+}
+
+/* Registers num_ports ports and returns ns per lookup, 0 on failure */
+static uint64_t session_bench_run(uint32_t num_ports)
+{
+   ar_heap_info            heap_info;
+   gpr_module_node_list_t *list;
+   gpr_module_entry_t     *entry;
+   uint32_t                list_slots = SESSION_ARRAY_SIZE;
+   uint32_t                list_size;
+   uint32_t                rnd    = 0x12345678;
+   uint32_t                failed = 0;
+   uint64_t                start_us, elapsed_us = 0;
+
+#ifdef GPR_SESSION_BENCH_ARRAY
+   /* the array variant holds at most max_cb_list_size ports */
+   list_slots = (num_ports > list_slots) ? num_ports : list_slots;
+#endif
+
+   /* list set up the way gpr_drv sets up the default list */
+   gpr_populate_ar_heap_info(GPR_HEAP_INDEX_DEFAULT, AR_HEAP_ALIGN_DEFAULT, &heap_info);
+   list_size = sizeof(gpr_module_node_list_t) + (list_slots * sizeof(gpr_module_node_t *));
+   list      = (gpr_module_node_list_t *)ar_heap_malloc(list_size, &heap_info);
+   if (NULL == list)
+   {
+      return 0;
+   }
+   ar_mem_set(list, 0, list_size);
+   list->max_cb_list_size = list_slots;
+   list->heap_index       = GPR_HEAP_INDEX_DEFAULT;
+
+   for (uint32_t i = 0; i < num_ports; i++)
+   {
+      if (AR_EOK != gpr_init_session(session_bench_port(i), session_bench_callback, NULL, list))
+      {
+         failed++;
+      }
+   }
+
+   if (0 == failed)
+   {
+      start_us = ar_timer_get_time_in_us();
+      for (uint32_t i = 0; i < SESSION_BENCH_LOOKUPS; i++)
+      {
+         rnd ^= rnd << 13;
+         rnd ^= rnd >> 17;
+         rnd ^= rnd << 5;
+         if (AR_EOK != gpr_get_session(session_bench_port(rnd % num_ports), &entry, list))
+         {
+            failed++;
+            break;
+         }
+         gpr_put_session(entry);
+      }
+      elapsed_us = ar_timer_get_time_in_us() - start_us;
+   }
+
+   for (uint32_t i = 0; i < num_ports; i++)
+   {
+      (void)gpr_deinit_session(session_bench_port(i), list);
+   }
+   ar_heap_free(list, &heap_info);
+
+   return (0 == failed) ? ((elapsed_us * 1000) / SESSION_BENCH_LOOKUPS) : 0;
+}
+
+int main(void)
+{
+   int rc = 0;
+
+   for (uint32_t i = 0; i < sizeof(session_bench_num_ports) / sizeof(session_bench_num_ports[0]); i++)
+   {
+      uint64_t ns = session_bench_run(session_bench_num_ports[i]);
+
+      if (0 == ns)
+      {
+         printf("%s: %u ports FAILED\n", GPR_SESSION_BENCH_VARIANT, session_bench_num_ports[i]);
+         rc = 1;
+         continue;
+      }
+      printf("%s: %u ports, %llu ns per lookup\n",
+             GPR_SESSION_BENCH_VARIANT,
+             session_bench_num_ports[i],
+             (unsigned long long)ns);
+   }
+   return rc;
+}
@@ -22,6 +22,7 @@ LOCAL_SRC_FILES := src/gsl_main.c \
     src/gsl_datapath.c\
     src/gsl_msg_builder.c\
     src/gsl_global_persist_cal.c\
+    src/gsl_async.c\
     src/gsl_dls_client.c
 
 LOCAL_HEADER_LIBRARIES := libspf-headers
@@ -217,9 +217,22 @@ enum gsl_event_id {
 	 * available for client to write to
 	 */
 	GSL_EVENT_ID_BUFFER_AVAIL = 0x3,
+	/**
+	 * Indicates that an operation issued through gsl_open_async,
+	 * gsl_ioctl_async or gsl_close_async has completed
+	 * Payload: struct gsl_event_async_done_payload
+	 */
+	GSL_EVENT_ID_ASYNC_DONE = 0x4,
 	GSL_EVENT_ID_MAX
 };
 
+/** Operations that can be issued through the asynchronous GSL APIs */
+enum gsl_async_op {
+	GSL_ASYNC_OP_OPEN = 0x0,
+	GSL_ASYNC_OP_IOCTL = 0x1,
+	GSL_ASYNC_OP_CLOSE = 0x2,
+};
+
 /**
  * Global events that can be raised through the global callback
  */
@@ -639,6 +652,17 @@ struct gsl_event_eos_payload {
 	enum gsl_eos_render_status_t render_status;
 };
 
+/**
+ * Event payload passed to client with GSL_EVENT_ID_ASYNC_DONE
+ */
+struct gsl_event_async_done_payload {
+	uint32_t op; /**< operation that completed, enum gsl_async_op */
+	uint32_t cmd_id; /**< ioctl command id, valid for GSL_ASYNC_OP_IOCTL */
+	int32_t status; /**< result of the operation as defined in ar_osal_error.h */
+	uint64_t queue_time_us; /**< time spent queued behind other operations */
+	uint64_t exec_time_us; /**< time spent executing the operation */
+};
+
 /**
  * Event payload passed to client with GSL_GLOBAL_EVENT_AUDIO_SVC_DN
  */
@@ -689,6 +713,77 @@ void gsl_deinit(void);
 int32_t gsl_register_global_event_cb(gsl_global_cb_func_ptr global_cb,
 	void *client_data);
 
+/**
+ * Timings recorded for the most recent restart of a master proc, intended
+ * for post-mortem analysis of audio loss around SSR. Durations are in
+ * microseconds.
+ */
+struct gsl_ssr_recovery_stats {
+	uint64_t svc_dn_ts_us; /**< monotonic time service down was received */
+	uint64_t svc_up_ts_us; /**< monotonic time service up was received */
+	/** moving impacted graphs to error state and notifying the client */
+	uint32_t dn_handling_us;
+	uint32_t shmem_remap_us; /**< re-mapping pre-allocated shared memory */
+	uint32_t satellite_info_us; /**< sending satellite info to the master */
+	uint32_t loaned_shmem_us; /**< re-allocating loaned shared memory */
+	uint32_t dyn_module_us; /**< re-loading bootup dynamic modules */
+	uint32_t recovery_us; /**< from service up until recovery completed */
+	int32_t status; /**< result of the recovery, AR_EOK on success */
+};
+
+/**
+ * \brief Query the timings of the most recent SSR recovery of a master proc.
+ * Recovery starts as soon as GSL_GLOBAL_EVENT_AUDIO_SVC_UP is raised, in the
+ * background, rather than in the first gsl_open after the restart.
+ *
+ * \param[in] master_proc: master proc id as defined in ar_osal_sys_id.h
+ * \param[out] stats: timings of the last recovery, zeroed if none happened
+ *
+ * \return EOK on success, error code otherwise
+ */
+int32_t gsl_get_ssr_recovery_stats(uint32_t master_proc,
+	struct gsl_ssr_recovery_stats *stats);
+
+/**
+ * Statistics of the global persistent calibration pool. Calibrations with
+ * different cal_ids but identical payloads share one shared memory buffer.
+ */
+struct gsl_global_persist_cal_stats {
+	uint32_t num_requests; /**< get and add requests made to the pool */
+	/** requests served from an existing entry with the same cal_id */
+	uint32_t num_cal_id_hits;
+	/** requests for a new cal_id served from an identical payload */
+	uint32_t num_content_hits;
+	uint32_t num_cals; /**< cal_id entries currently in the pool */
+	uint32_t num_blobs; /**< unique payloads currently in the pool */
+	/** shared memory bytes currently saved by content sharing */
+	uint32_t curr_bytes_saved;
+	/** peak shared memory bytes saved by content sharing */
+	uint32_t max_bytes_saved;
+};
+
+/**
+ * \brief Query the statistics of the global persistent calibration pool.
+ *
+ * \param[out] stats: current pool statistics
+ *
+ * \return EOK on success, error code otherwise
+ */
+int32_t gsl_get_global_persist_cal_stats(
+	struct gsl_global_persist_cal_stats *stats);
+
+/**
+ * \brief Write the GPR packet trace to a file, for post-mortem analysis of
+ * command and event timing. Each thread that exchanged packets with SPF
+ * recorded the headers of its most recent ones. Decode the file offline
+ * with gpr_trace_decode.
+ *
+ * \param[in] path: file to write, replaced if it exists
+ *
+ * \return EOK on success, error code otherwise
+ */
+int32_t gsl_dump_gpr_trace(const char *path);
+
 /**
  * \brief Load a graph that is specified using graph_key_vector to the DSP.
  * Does not reload graphs which are already loaded.
@@ -932,6 +1027,55 @@ typedef void (*gsl_cb_func_ptr)(struct gsl_event_cb_params *event_params,
 int32_t gsl_register_event_cb(gsl_handle_t graph_handle,
 	gsl_cb_func_ptr cb, void *client_data);
 
+/**
+ * \brief Non-blocking variant of gsl_open. The handle is returned right away
+ * and cb is registered on it, completion is reported through cb with
+ * GSL_EVENT_ID_ASYNC_DONE. Operations issued on the handle with
+ * gsl_ioctl_async and gsl_close_async are queued behind the open and executed
+ * in the order they were issued. Operations on different handles run
+ * independently. gsl_close and gsl_ioctl on the handle block until the open
+ * completes, and fail with AR_EBADPARAM if it failed.
+ *
+ * \param[in] graph_key_vect: used to identify the graph, copied by GSL
+ * \param[in] cal_key_vect: OPTIONAL used to identify calibration data, copied
+ * by GSL
+ * \param[in] cb: event callback for the handle, see gsl_register_event_cb
+ * \param[in] client_data: opaque data passed to client in the callback
+ * \param[out] graph_handle: graph handle on success
+ *
+ * \return EOK if the open was queued, error code otherwise in which case no
+ * completion event is raised
+ */
+int32_t gsl_open_async(const struct gsl_key_vector *graph_key_vect,
+	const struct gsl_key_vector *cal_key_vect, gsl_cb_func_ptr cb,
+	void *client_data, gsl_handle_t *graph_handle);
+
+/**
+ * \brief Non-blocking variant of gsl_ioctl, supported for GSL_CMD_PREPARE,
+ * GSL_CMD_START, GSL_CMD_STOP and GSL_CMD_SUSPEND. Completion is reported
+ * through the handle's event callback with GSL_EVENT_ID_ASYNC_DONE.
+ *
+ * \param[in] graph_handle: handle returned from gsl_open or gsl_open_async
+ * \param[in] cmd_id: command to issue
+ * \param[in] cmd_payload: command specific parameters, copied by GSL
+ * \param[in] cmd_payload_sz: size of cmd_payload
+ *
+ * \return EOK if the command was queued, error code otherwise
+ */
+int32_t gsl_ioctl_async(gsl_handle_t graph_handle,
+	enum gsl_cmd_id cmd_id, void *cmd_payload, size_t cmd_payload_sz);
+
+/**
+ * \brief Non-blocking variant of gsl_close. Completion is reported through
+ * the handle's event callback with GSL_EVENT_ID_ASYNC_DONE, after which the
+ * callback is not invoked again for this handle.
+ *
+ * \param[in] graph_handle: handle returned from gsl_open or gsl_open_async
+ *
+ * \return EOK if the close was queued, error code otherwise
+ */
+int32_t gsl_close_async(gsl_handle_t graph_handle);
+
 /**
  * \brief Query database for data associated with a given tag and tkv.
  * This API is used to get spf module data in the form {IID, PID, Size,
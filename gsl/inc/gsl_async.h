@@ -0,0 +1,63 @@
+#ifndef GSL_ASYNC_H
+#define GSL_ASYNC_H
+/**
+ * \file gsl_async.h
+ *
+ * \brief
+ *      Worker pool used to run GSL control operations asynchronously
+ *
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ar_osal_types.h"
+#include "ar_util_list.h"
+
+/* Number of worker threads, jobs on different keys run in parallel */
+#ifndef GSL_ASYNC_NUM_WORKERS
+#define GSL_ASYNC_NUM_WORKERS 2
+#endif
+
+struct gsl_async_job;
+
+/**
+ * Executes a job, called on a worker thread. The function owns the job and
+ * is responsible for freeing it.
+ */
+typedef void (*gsl_async_job_fn)(struct gsl_async_job *job);
+
+/*
+ * Base of every asynchronous job, embedded as the first member of the
+ * caller's job structure
+ */
+struct gsl_async_job {
+	ar_list_node_t node;
+	/** jobs with the same key are executed one at a time, in queued order */
+	uint32_t key;
+	/** time the job was queued in microseconds */
+	uint64_t queued_us;
+	gsl_async_job_fn exec;
+};
+
+/**
+ * \brief Create the worker threads
+ *
+ * \return AR_EOK on success, error code otherwise
+ */
+int32_t gsl_async_init(void);
+
+/**
+ * \brief Run all queued jobs to completion then stop the worker threads
+ */
+void gsl_async_deinit(void);
+
+/**
+ * \brief Queue a job for execution on a worker thread
+ *
+ * \param[in] job: job to queue, key and exec must be set
+ *
+ * \return AR_EOK on success, AR_ENOTREADY if the pool is not running
+ */
+int32_t gsl_async_queue(struct gsl_async_job *job);
+
+#endif /* GSL_ASYNC_H */
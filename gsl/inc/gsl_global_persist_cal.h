@@ -10,20 +10,46 @@
  *  SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include "gsl_intf.h"
 #include "gsl_shmem_mgr.h"
 #include "acdb.h"
-#include "ar_util_list.h"
 
 #define GSL_MAX_IIDS_PER_GP_CAL 10
 
-struct gsl_glbl_persist_cal {
-	struct ar_list_node_t node;
-	uint32_t cal_id;
+/*
+ * Number of hash buckets used by the pool for both the cal_id and the
+ * content lookup, must be a power of 2
+ */
+#define GSL_GP_CAL_HASH_BUCKETS 64
+
+/*
+ * Holds one unique global persist cal payload per master proc. Payloads
+ * which are byte-for-byte identical are stored and mapped only once, and
+ * shared by every cal_id that resolves to them.
+ */
+struct gsl_glbl_persist_cal_blob {
+	/** next blob in the same content hash bucket */
+	struct gsl_glbl_persist_cal_blob *next;
+	/** hash of the payload contents */
+	uint32_t content_hash;
+	uint32_t master_proc;
+	/** number of cal_id entries referencing this blob */
 	uint32_t ref_cnt;
 	struct gsl_shmem_alloc_data cal_data;
 	uint32_t cal_data_size;
 };
 
+struct gsl_glbl_persist_cal {
+	/** next cal in the same cal_id hash bucket */
+	struct gsl_glbl_persist_cal *next;
+	uint32_t cal_id;
+	uint32_t master_proc;
+	/** number of graphs referencing this cal */
+	uint32_t ref_cnt;
+	/** payload for this cal, possibly shared with other cal_ids */
+	struct gsl_glbl_persist_cal_blob *blob;
+};
+
 struct gsl_glbl_persist_cal_iid_list {
 	/* assumed that there is a maximum number of IIDs per cal for ease of
 	 * allocating space
@@ -52,20 +78,32 @@ int32_t gsl_global_persist_cal_pool_init(void);
 int32_t gsl_global_persist_cal_pool_deinit(void);
 
 /**
- * \brief Add a cal to the pool
+ * \brief Find a cal already present in the pool and take a reference on it.
+ * Used to skip retrieving the cal data from ACDB when another graph has
+ * already registered the same cal_id on the same proc.
+ *
+ * \param[in] cal_id: identifier of global persist cal to find in pool
+ * \param[in] master_proc: SPF master proc id
+ *
+ * \return pointer to global persist cal object, NULL if not in the pool
+ */
+struct gsl_glbl_persist_cal *gsl_global_persist_cal_pool_get(uint32_t cal_id,
+	uint32_t master_proc);
+
+/**
+ * \brief Add a cal to the pool. If a payload with identical contents is
+ * already present for master_proc it is shared instead of allocating and
+ * mapping a new shared memory buffer.
  *
- * \param[in] cal_id: identifier of global persist cal to add to/find in pool
+ * \param[in] cal_id: identifier of global persist cal to add to the pool
+ * \param[in] cal_data: ACDB data associated with this cal_id
  * \param[in] cal_data_size: size of ACDB data associated with this cal_id
  * \param[in] master_proc: SPF master proc id
- * \param[out] cal_data: Set to NULL when we already have ACDB data for this
- *						 cal_id in the pool. Otherwise holds pointer to shmem
- *						 object into which to fill the data for this cal_id
  *
  * \return pointer to global persist cal object which was added to pool
  */
 struct gsl_glbl_persist_cal *gsl_global_persist_cal_pool_add(uint32_t cal_id,
-	uint32_t cal_data_size, struct gsl_shmem_alloc_data **cal_data,
-	uint32_t master_proc);
+	const void *cal_data, uint32_t cal_data_size, uint32_t master_proc);
 
 /**
  * \brief Remove a cal from pool
@@ -74,4 +112,12 @@ struct gsl_glbl_persist_cal *gsl_global_persist_cal_pool_add(uint32_t cal_id,
  */
 int32_t gsl_global_persist_cal_pool_remove(struct gsl_glbl_persist_cal *gpc);
 
+/**
+ * \brief Get a snapshot of the pool statistics
+ *
+ * \param[out] stats: filled with the current pool statistics
+ */
+void gsl_global_persist_cal_pool_get_stats(
+	struct gsl_global_persist_cal_stats *stats);
+
 #endif /* GSL_GLOBAL_PERSIST_CAL */
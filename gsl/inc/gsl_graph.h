@@ -200,6 +200,11 @@ struct gsl_graph {
 	 * values for this bitmask are provided in gsl_spf_ss_state.h
 	 */
 	uint32_t ss_mask;
+	/**
+	 * size of the last non-persistent calibration sent, used as the buffer
+	 * size for the next one so ACDB can fill it in a single pass
+	 */
+	uint32_t nonpersist_cal_size;
 };
 
 struct gsl_prepare_change_graph_single_gkv_params {
@@ -10,4 +10,53 @@
  *  SPDX-License-Identifier: BSD-3-Clause
  */
 
- #endif //GSL_MAIN_H
+#include "ar_osal_types.h"
+#include "gsl_intf.h"
+
+#ifdef GSL_TEST_HOOKS
+/*
+ * Entry points into the static state of gsl_main.c for the programs under
+ * gsl/test, only built into the libar-gsl-test library used by "make check"
+ */
+
+/**
+ * \brief Set up the locks and signals used by the datapath and RTGM
+ * synchronization without initializing SPF, GPR or ACDB
+ */
+int32_t gsl_test_init(void);
+
+void gsl_test_deinit(void);
+
+/**
+ * \brief Allocate a handle for a graph in GRAPH_ERROR state. Datapath calls
+ * on it go through all synchronization and return AR_ESUBSYSRESET
+ */
+gsl_handle_t gsl_test_open_error_graph(void);
+
+void gsl_test_close_graph(gsl_handle_t graph_handle);
+
+/**
+ * \brief Start and end an RTGM operation the way gsl_rtc_callback does
+ */
+int32_t gsl_test_start_rtgm(void);
+
+void gsl_test_end_rtgm(void);
+
+/**
+ * \brief Number of datapath calls holding a pin on the graph
+ */
+uint32_t gsl_test_get_pin_cnt(gsl_handle_t graph_handle);
+
+/**
+ * \brief Whether no datapath call, client op or RTGM operation is in progress
+ */
+bool_t gsl_test_is_idle(void);
+
+/**
+ * \brief Run the synchronization of the former gsl_read/gsl_write, a
+ * blocking client op around a locked handle lookup, as a baseline
+ */
+int32_t gsl_test_locked_dp_op(gsl_handle_t graph_handle);
+#endif /* GSL_TEST_HOOKS */
+
+#endif /* GSL_MAIN_H */
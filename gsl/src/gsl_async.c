@@ -0,0 +1,184 @@
+/**
+ * \file gsl_async.c
+ *
+ * \brief
+ *      Worker pool used to run GSL control operations asynchronously
+ *
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "gsl_async.h"
+#include "gsl_common.h"
+#include "ar_osal_thread.h"
+#include "ar_osal_timer.h"
+#include "ar_osal_error.h"
+
+static struct gsl_async_pool {
+	ar_list_t job_list; /**< jobs not yet picked up by a worker */
+	ar_osal_mutex_t lock; /**< protects everything in this struct */
+	ar_osal_signal_t sig; /**< set when a job may have become runnable */
+	ar_osal_thread_t workers[GSL_ASYNC_NUM_WORKERS];
+	bool_t busy[GSL_ASYNC_NUM_WORKERS]; /**< worker is executing a job */
+	uint32_t busy_key[GSL_ASYNC_NUM_WORKERS]; /**< key of that job */
+	bool_t running; /**< pool accepts new jobs */
+	bool_t exiting; /**< workers exit once the queue is empty */
+} gsl_async_pool;
+
+/*
+ * returns the oldest job whose key is neither being executed nor used by an
+ * older queued job, must be called with lock held
+ */
+static struct gsl_async_job *gsl_async_next_job(void)
+{
+	ar_list_node_t *curr, *prev;
+	struct gsl_async_job *job;
+	bool_t blocked;
+	uint32_t i;
+
+	ar_list_for_each_entry(curr, &gsl_async_pool.job_list) {
+		job = (struct gsl_async_job *)curr;
+		blocked = FALSE;
+		for (i = 0; i < GSL_ASYNC_NUM_WORKERS; ++i) {
+			if (gsl_async_pool.busy[i] &&
+				gsl_async_pool.busy_key[i] == job->key)
+				blocked = TRUE;
+		}
+		for (prev = gsl_async_pool.job_list.dummy.next;
+			!blocked && prev != curr; prev = prev->next) {
+			if (((struct gsl_async_job *)prev)->key == job->key)
+				blocked = TRUE;
+		}
+		if (!blocked)
+			return job;
+	}
+
+	return NULL;
+}
+
+static void gsl_async_worker(void *param)
+{
+	uint32_t idx = (uint32_t)(uintptr_t)param;
+	struct gsl_async_job *job;
+
+	GSL_MUTEX_LOCK(gsl_async_pool.lock);
+	for (;;) {
+		job = gsl_async_next_job();
+		if (!job) {
+			if (gsl_async_pool.exiting &&
+				gsl_async_pool.job_list.size == 0)
+				break;
+			/* set and clear are done under lock so no wakeup is lost */
+			ar_osal_signal_clear(gsl_async_pool.sig);
+			GSL_MUTEX_UNLOCK(gsl_async_pool.lock);
+			ar_osal_signal_wait(gsl_async_pool.sig);
+			GSL_MUTEX_LOCK(gsl_async_pool.lock);
+			continue;
+		}
+
+		ar_list_delete(&gsl_async_pool.job_list, &job->node);
+		gsl_async_pool.busy[idx] = TRUE;
+		gsl_async_pool.busy_key[idx] = job->key;
+		GSL_MUTEX_UNLOCK(gsl_async_pool.lock);
+
+		job->exec(job);
+
+		GSL_MUTEX_LOCK(gsl_async_pool.lock);
+		gsl_async_pool.busy[idx] = FALSE;
+		/* next job on the same key can now run on any worker */
+		ar_osal_signal_set(gsl_async_pool.sig);
+	}
+	GSL_MUTEX_UNLOCK(gsl_async_pool.lock);
+}
+
+int32_t gsl_async_init(void)
+{
+	ar_osal_thread_attr_t attr;
+	int32_t rc = AR_EOK;
+	uint32_t i;
+
+	gsl_memset(&gsl_async_pool, 0, sizeof(gsl_async_pool));
+
+	rc = ar_list_init(&gsl_async_pool.job_list, NULL, NULL);
+	if (rc)
+		return rc;
+
+	rc = ar_osal_mutex_create(&gsl_async_pool.lock);
+	if (rc)
+		return rc;
+
+	rc = ar_osal_signal_create(&gsl_async_pool.sig);
+	if (rc)
+		goto destroy_lock;
+
+	for (i = 0; i < GSL_ASYNC_NUM_WORKERS; ++i) {
+		rc = ar_osal_thread_attr_init(&attr);
+		if (rc)
+			goto stop_workers;
+		attr.thread_name = "gsl_async";
+		rc = ar_osal_thread_create(&gsl_async_pool.workers[i], &attr,
+			gsl_async_worker, (void *)(uintptr_t)i);
+		if (rc) {
+			GSL_ERR("failed to create async worker %d, rc %d", i, rc);
+			goto stop_workers;
+		}
+	}
+
+	gsl_async_pool.running = TRUE;
+	return rc;
+
+stop_workers:
+	GSL_MUTEX_LOCK(gsl_async_pool.lock);
+	gsl_async_pool.exiting = TRUE;
+	ar_osal_signal_set(gsl_async_pool.sig);
+	GSL_MUTEX_UNLOCK(gsl_async_pool.lock);
+	while (i--)
+		ar_osal_thread_join_destroy(gsl_async_pool.workers[i]);
+	ar_osal_signal_destroy(gsl_async_pool.sig);
+destroy_lock:
+	ar_osal_mutex_destroy(gsl_async_pool.lock);
+	return rc;
+}
+
+void gsl_async_deinit(void)
+{
+	uint32_t i;
+
+	if (!gsl_async_pool.running)
+		return;
+
+	GSL_MUTEX_LOCK(gsl_async_pool.lock);
+	gsl_async_pool.running = FALSE;
+	gsl_async_pool.exiting = TRUE;
+	ar_osal_signal_set(gsl_async_pool.sig);
+	GSL_MUTEX_UNLOCK(gsl_async_pool.lock);
+
+	for (i = 0; i < GSL_ASYNC_NUM_WORKERS; ++i)
+		ar_osal_thread_join_destroy(gsl_async_pool.workers[i]);
+
+	ar_osal_signal_destroy(gsl_async_pool.sig);
+	ar_osal_mutex_destroy(gsl_async_pool.lock);
+}
+
+int32_t gsl_async_queue(struct gsl_async_job *job)
+{
+	int32_t rc = AR_EOK;
+
+	if (!job || !job->exec)
+		return AR_EBADPARAM;
+
+	job->queued_us = ar_timer_get_time_in_us();
+
+	GSL_MUTEX_LOCK(gsl_async_pool.lock);
+	if (!gsl_async_pool.running) {
+		rc = AR_ENOTREADY;
+		goto exit;
+	}
+	ar_list_init_node(&job->node);
+	ar_list_add_tail(&gsl_async_pool.job_list, &job->node);
+	ar_osal_signal_set(gsl_async_pool.sig);
+
+exit:
+	GSL_MUTEX_UNLOCK(gsl_async_pool.lock);
+	return rc;
+}
@@ -12,57 +12,132 @@
 #include "gsl_common.h"
 #include "ar_osal_mutex.h"
 #include "ar_osal_error.h"
-#include "ar_util_list.h"
+#include "ar_osal_mem_op.h"
+
+#define GSL_GP_CAL_FNV_OFFSET_BASIS 0x811C9DC5
+#define GSL_GP_CAL_FNV_PRIME 0x01000193
+
+#define GSL_GP_CAL_BUCKET(x) ((x) & (GSL_GP_CAL_HASH_BUCKETS - 1))
 
 struct gsl_global_persist_cal_pool {
-	ar_list_t cal_list; /**< list of all GP cals in the system */
-	uint32_t num_cals; /**< number of entries in GP cal pool */
+	/** cal_id to cal lookup, keyed on cal_id and master proc */
+	struct gsl_glbl_persist_cal *cal_tbl[GSL_GP_CAL_HASH_BUCKETS];
+	/** payload contents to blob lookup, keyed on content hash */
+	struct gsl_glbl_persist_cal_blob *blob_tbl[GSL_GP_CAL_HASH_BUCKETS];
+	struct gsl_global_persist_cal_stats stats;
 	ar_osal_mutex_t lock; /**< used to serialize operations on pool */
 } gpc_pool;
 
-static int32_t gsl_gp_cal_init(struct gsl_glbl_persist_cal *gpc,
-	uint32_t cal_id, uint32_t cal_data_size, uint32_t master_proc)
+static uint32_t gsl_gp_cal_id_hash(uint32_t cal_id, uint32_t master_proc)
 {
-	uint32_t rc = AR_EOK;
+	/* fold proc into the top bits as proc ids are small */
+	return GSL_GP_CAL_BUCKET((cal_id * GSL_GP_CAL_FNV_PRIME)
+		^ (master_proc << 24));
+}
 
-	if (gpc == NULL)
-		return AR_EBADPARAM;
+/* FNV-1a over the payload, seeded with the size and master proc */
+static uint32_t gsl_gp_cal_content_hash(const uint8_t *data, uint32_t size,
+	uint32_t master_proc)
+{
+	uint32_t hash = GSL_GP_CAL_FNV_OFFSET_BASIS;
+	uint32_t i;
 
-	gpc->ref_cnt = 0;
-	gpc->cal_id = cal_id;
-	gpc->cal_data_size = cal_data_size;
+	hash = (hash ^ size) * GSL_GP_CAL_FNV_PRIME;
+	hash = (hash ^ master_proc) * GSL_GP_CAL_FNV_PRIME;
+	for (i = 0; i < size; ++i)
+		hash = (hash ^ data[i]) * GSL_GP_CAL_FNV_PRIME;
 
-	rc = ar_list_init_node(&gpc->node);
-	if (rc) {
-		GSL_ERR("ar_list_init_node failed %d", rc);
-		goto exit;
+	return hash;
+}
+
+static struct gsl_glbl_persist_cal *gsl_gp_cal_find(uint32_t cal_id,
+	uint32_t master_proc)
+{
+	struct gsl_glbl_persist_cal *gpc;
+
+	gpc = gpc_pool.cal_tbl[gsl_gp_cal_id_hash(cal_id, master_proc)];
+	while (gpc) {
+		if (gpc->cal_id == cal_id && gpc->master_proc == master_proc)
+			break;
+		gpc = gpc->next;
+	}
+
+	return gpc;
+}
+
+static struct gsl_glbl_persist_cal_blob *gsl_gp_cal_blob_find(
+	uint32_t content_hash, const void *cal_data, uint32_t cal_data_size,
+	uint32_t master_proc)
+{
+	struct gsl_glbl_persist_cal_blob *blob;
+
+	blob = gpc_pool.blob_tbl[GSL_GP_CAL_BUCKET(content_hash)];
+	while (blob) {
+		/* hash collisions are resolved with a full compare */
+		if (blob->content_hash == content_hash &&
+			blob->master_proc == master_proc &&
+			blob->cal_data_size == cal_data_size &&
+			ar_mem_cmp(blob->cal_data.v_addr, cal_data, cal_data_size) == 0)
+			break;
+		blob = blob->next;
 	}
 
-	rc = gsl_shmem_alloc(cal_data_size, master_proc, &gpc->cal_data);
+	return blob;
+}
+
+static struct gsl_glbl_persist_cal_blob *gsl_gp_cal_blob_create(
+	uint32_t content_hash, const void *cal_data, uint32_t cal_data_size,
+	uint32_t master_proc)
+{
+	struct gsl_glbl_persist_cal_blob *blob;
+	uint32_t bucket = GSL_GP_CAL_BUCKET(content_hash);
+	int32_t rc;
+
+	blob = gsl_mem_zalloc(sizeof(struct gsl_glbl_persist_cal_blob));
+	if (!blob)
+		return NULL;
+
+	rc = gsl_shmem_alloc(cal_data_size, master_proc, &blob->cal_data);
 	if (rc) {
-		GSL_ERR("shmem alloc for glbl persistent cal id %d failed %d", cal_id,
-			rc);
-		goto delete_list_node;
+		GSL_ERR("shmem alloc for glbl persistent cal failed %d", rc);
+		gsl_mem_free(blob);
+		return NULL;
 	}
+	gsl_memcpy(blob->cal_data.v_addr, cal_data_size, cal_data,
+		cal_data_size);
 
-	/* skip in success case */
-	goto exit;
-delete_list_node:
-	ar_list_delete(&gpc_pool.cal_list, &gpc->node);
-exit:
-	return rc;
+	blob->content_hash = content_hash;
+	blob->master_proc = master_proc;
+	blob->cal_data_size = cal_data_size;
+	blob->next = gpc_pool.blob_tbl[bucket];
+	gpc_pool.blob_tbl[bucket] = blob;
+	++gpc_pool.stats.num_blobs;
+
+	return blob;
 }
 
-static int32_t gsl_gp_cal_deinit(struct gsl_glbl_persist_cal *gpc)
+static void gsl_gp_cal_blob_release(struct gsl_glbl_persist_cal_blob *blob)
 {
-	uint32_t rc = AR_EOK;
+	struct gsl_glbl_persist_cal_blob **pp;
+	int32_t rc;
+
+	if (--blob->ref_cnt > 0) {
+		gpc_pool.stats.curr_bytes_saved -= blob->cal_data_size;
+		return;
+	}
 
-	rc = gsl_shmem_free(&gpc->cal_data);
+	pp = &gpc_pool.blob_tbl[GSL_GP_CAL_BUCKET(blob->content_hash)];
+	while (*pp && *pp != blob)
+		pp = &(*pp)->next;
+	if (*pp)
+		*pp = blob->next;
+
+	rc = gsl_shmem_free(&blob->cal_data);
 	if (rc)
-		GSL_ERR("shmem free for glbl persistent cal id %d failed %d",
-			gpc->cal_id, rc);
+		GSL_ERR("shmem free for glbl persistent cal failed %d", rc);
 
-	return rc;
+	--gpc_pool.stats.num_blobs;
+	gsl_mem_free(blob);
 }
 
 /*
@@ -75,90 +150,123 @@ int32_t gsl_global_persist_cal_pool_init(void)
 
 	gsl_memset(&gpc_pool, 0, sizeof(gpc_pool));
 	rc = ar_osal_mutex_create(&gpc_pool.lock);
-	if (rc) {
+	if (rc)
 		GSL_ERR("ar_osal_mutex_create failed %d", rc);
-		goto exit;
-	}
 
-	rc = ar_list_init(&gpc_pool.cal_list, NULL, NULL);
-	if (rc)
-		GSL_ERR("ar_list_init failed %d", rc);
-exit:
 	return rc;
 }
 
 int32_t gsl_global_persist_cal_pool_deinit(void)
 {
+	struct gsl_glbl_persist_cal *gpc, *next_gpc;
+	struct gsl_glbl_persist_cal_blob *blob, *next_blob;
+	uint32_t i;
+
+	GSL_DBG("gp cal pool: requests %d, cal_id hits %d, content hits %d, peak bytes saved %d",
+		gpc_pool.stats.num_requests, gpc_pool.stats.num_cal_id_hits,
+		gpc_pool.stats.num_content_hits, gpc_pool.stats.max_bytes_saved);
+
+	/* free any entries leaked by clients, shmem is torn down separately */
+	for (i = 0; i < GSL_GP_CAL_HASH_BUCKETS; ++i) {
+		for (gpc = gpc_pool.cal_tbl[i]; gpc; gpc = next_gpc) {
+			next_gpc = gpc->next;
+			gsl_mem_free(gpc);
+		}
+		for (blob = gpc_pool.blob_tbl[i]; blob; blob = next_blob) {
+			next_blob = blob->next;
+			gsl_mem_free(blob);
+		}
+	}
+
 	ar_osal_mutex_destroy(gpc_pool.lock);
-	ar_list_clear(&gpc_pool.cal_list);
+	gsl_memset(&gpc_pool, 0, sizeof(gpc_pool));
 	return AR_EOK;
 }
 
-struct gsl_glbl_persist_cal *gsl_global_persist_cal_pool_add(uint32_t cal_id,
-	uint32_t cal_data_size, struct gsl_shmem_alloc_data **cal_data,
+struct gsl_glbl_persist_cal *gsl_global_persist_cal_pool_get(uint32_t cal_id,
 	uint32_t master_proc)
 {
-	ar_list_node_t *curr = NULL;
-	struct gsl_glbl_persist_cal *curr_gpc = NULL;
-	uint8_t cal_found = 0;
-	int32_t rc;
+	struct gsl_glbl_persist_cal *gpc;
 
 	GSL_MUTEX_LOCK(gpc_pool.lock);
+	++gpc_pool.stats.num_requests;
+	gpc = gsl_gp_cal_find(cal_id, master_proc);
+	if (gpc) {
+		++gpc->ref_cnt;
+		++gpc_pool.stats.num_cal_id_hits;
+	}
+	GSL_MUTEX_UNLOCK(gpc_pool.lock);
 
-	/* check if cal_id already exists in the pool */
-	ar_list_for_each_entry(curr, &gpc_pool.cal_list) {
-		curr_gpc = get_container_base(curr, struct gsl_glbl_persist_cal, node);
-		if (!curr_gpc) {
-			GSL_ERR("null returned for curr_gpc\n");
-			goto exit;
-		}
+	return gpc;
+}
 
-		if (curr_gpc->cal_id == cal_id) {
-			cal_found = 1;
-			break;
-		}
-	}
-	if (!cal_found) {
-		/* cal does not exist, so add it to pool */
-		curr_gpc = gsl_mem_zalloc(sizeof(struct gsl_glbl_persist_cal));
-		if (curr_gpc == NULL)
-			goto exit;
+struct gsl_glbl_persist_cal *gsl_global_persist_cal_pool_add(uint32_t cal_id,
+	const void *cal_data, uint32_t cal_data_size, uint32_t master_proc)
+{
+	struct gsl_glbl_persist_cal *gpc = NULL;
+	struct gsl_glbl_persist_cal_blob *blob = NULL;
+	uint32_t content_hash, bucket;
 
-		rc = gsl_gp_cal_init(curr_gpc, cal_id, cal_data_size, master_proc);
-		if (rc) {
-			GSL_ERR("gsl_gp_cal_init failed %d", rc);
-			goto cleanup;
-		}
+	if (!cal_data || cal_data_size == 0)
+		return NULL;
 
-		rc = ar_list_add_tail(&gpc_pool.cal_list, &curr_gpc->node);
-		if (rc) {
-			GSL_ERR("ar_list_add_tail failed, %d", rc);
-			goto deinit;
-		}
+	content_hash = gsl_gp_cal_content_hash(cal_data, cal_data_size,
+		master_proc);
+
+	GSL_MUTEX_LOCK(gpc_pool.lock);
+	++gpc_pool.stats.num_requests;
+
+	/* another graph may have added the same cal_id since it was checked */
+	gpc = gsl_gp_cal_find(cal_id, master_proc);
+	if (gpc) {
+		++gpc->ref_cnt;
+		++gpc_pool.stats.num_cal_id_hits;
+		goto exit;
+	}
 
-		*cal_data = &curr_gpc->cal_data;
-		/* we only set cal_data if we need to fetch the data from ACDB */
+	gpc = gsl_mem_zalloc(sizeof(struct gsl_glbl_persist_cal));
+	if (!gpc)
+		goto exit;
 
-		++(curr_gpc->ref_cnt);
-		++gpc_pool.num_cals;
+	blob = gsl_gp_cal_blob_find(content_hash, cal_data, cal_data_size,
+		master_proc);
+	if (blob) {
+		++gpc_pool.stats.num_content_hits;
+		gpc_pool.stats.curr_bytes_saved += cal_data_size;
+		if (gpc_pool.stats.curr_bytes_saved > gpc_pool.stats.max_bytes_saved)
+			gpc_pool.stats.max_bytes_saved =
+				gpc_pool.stats.curr_bytes_saved;
 	} else {
-		*cal_data = NULL;
+		blob = gsl_gp_cal_blob_create(content_hash, cal_data, cal_data_size,
+			master_proc);
+		if (!blob) {
+			GSL_ERR("failed to create blob for glbl persistent cal id %d",
+				cal_id);
+			gsl_mem_free(gpc);
+			gpc = NULL;
+			goto exit;
+		}
 	}
-	goto exit;
+	++blob->ref_cnt;
+
+	gpc->cal_id = cal_id;
+	gpc->master_proc = master_proc;
+	gpc->ref_cnt = 1;
+	gpc->blob = blob;
+
+	bucket = gsl_gp_cal_id_hash(cal_id, master_proc);
+	gpc->next = gpc_pool.cal_tbl[bucket];
+	gpc_pool.cal_tbl[bucket] = gpc;
+	++gpc_pool.stats.num_cals;
 
-deinit:
-	gsl_gp_cal_deinit(curr_gpc);
-cleanup:
-	gsl_mem_free(curr_gpc);
-	curr_gpc = NULL;
 exit:
 	GSL_MUTEX_UNLOCK(gpc_pool.lock);
-	return curr_gpc;
+	return gpc;
 }
 
 int32_t gsl_global_persist_cal_pool_remove(struct gsl_glbl_persist_cal *gpc)
 {
-	int32_t rc = AR_EOK;
+	struct gsl_glbl_persist_cal **pp;
 
 	if (!gpc)
 		return AR_EBADPARAM;
@@ -168,26 +276,29 @@ int32_t gsl_global_persist_cal_pool_remove(struct gsl_glbl_persist_cal *gpc)
 		--gpc->ref_cnt;
 
 	if (gpc->ref_cnt == 0) {
-		rc = gsl_shmem_free(&gpc->cal_data);
-		if (rc) {
-			GSL_ERR("gsl_shmem_free failed %d", rc);
-			goto exit;
-		}
+		pp = &gpc_pool.cal_tbl[gsl_gp_cal_id_hash(gpc->cal_id,
+			gpc->master_proc)];
+		while (*pp && *pp != gpc)
+			pp = &(*pp)->next;
+		if (*pp)
+			*pp = gpc->next;
 
-		rc = ar_list_delete(&gpc_pool.cal_list, &gpc->node);
-		if (rc) {
-			GSL_ERR("ar_list_delete failed %d", rc);
-			goto exit;
-		}
-		--gpc_pool.num_cals;
-		/*
-		 * Do not free if we fail to remove from list, to preserve the
-		 * integrity of the linked list
-		 */
-		gsl_gp_cal_deinit(gpc);
+		gsl_gp_cal_blob_release(gpc->blob);
+		--gpc_pool.stats.num_cals;
 		gsl_mem_free(gpc);
 	}
-exit:
 	GSL_MUTEX_UNLOCK(gpc_pool.lock);
-	return rc;
+
+	return AR_EOK;
+}
+
+void gsl_global_persist_cal_pool_get_stats(
+	struct gsl_global_persist_cal_stats *stats)
+{
+	if (!stats)
+		return;
+
+	GSL_MUTEX_LOCK(gpc_pool.lock);
+	*stats = gpc_pool.stats;
+	GSL_MUTEX_UNLOCK(gpc_pool.lock);
 }
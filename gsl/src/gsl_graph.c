@@ -12,6 +12,7 @@
 #include "acdb.h"
 #include "ar_osal_error.h"
 #include "ar_osal_shmem.h"
+#include "ar_osal_atomic.h"
 #include "ar_osal_log.h"
 #include "ar_util_data_log.h"
 #include "ar_util_data_log_codes.h"
@@ -818,6 +819,32 @@ static void gsl_graph_check_ckvs(struct gsl_key_vector *gkv, struct gsl_key_vect
 	}
 }
 
+struct gsl_graph_cal_msg_alloc {
+	struct gsl_graph *graph;
+	gsl_msg_t gsl_msg;
+};
+
+/* allocates the SET_CFG message ACDB fills the calibration into */
+static void *gsl_graph_alloc_cal_msg(void *ctx, uint32_t buf_index,
+	uint32_t size)
+{
+	struct gsl_graph_cal_msg_alloc *alloc = ctx;
+	struct apm_cmd_header_t *cmd_header;
+	int32_t rc;
+
+	/* the calibration did not fit, the earlier message is not used */
+	gsl_msg_free(&alloc->gsl_msg);
+
+	rc = gsl_msg_alloc(APM_CMD_SET_CFG, alloc->graph->src_port,
+		GSL_GPR_DST_PORT_APM, sizeof(*cmd_header), 0, alloc->graph->proc_id,
+		size, false, &alloc->gsl_msg);
+	if (rc) {
+		GSL_ERR("gsl msg alloc failed %d", rc);
+		return NULL;
+	}
+	return alloc->gsl_msg.payload;
+}
+
 static int32_t gsl_graph_send_nonpersist_cal(struct gsl_graph *graph,
 	struct gsl_sgid_list *sgid_list,
 	struct gsl_key_vector *prior_ckv, const struct gsl_key_vector *new_ckv,
@@ -828,7 +855,10 @@ static int32_t gsl_graph_send_nonpersist_cal(struct gsl_graph *graph,
 	AcdbBlob rsp_struct;
 	int32_t rc;
 	struct apm_cmd_header_t *cmd_header;
+	struct gsl_graph_cal_msg_alloc alloc;
+	AcdbAllocator allocator = { gsl_graph_alloc_cal_msg, &alloc };
 	gsl_msg_t gsl_msg;
+	bool_t is_shmem_supported = FALSE;
 
 	cmd_struct.num_sg_ids = sgid_list->len;
 	cmd_struct.sg_ids = sgid_list->sg_ids;
@@ -839,36 +869,36 @@ static int32_t gsl_graph_send_nonpersist_cal(struct gsl_graph *graph,
 	cmd_struct.cal_key_vector_new.graph_key_vector =
 		(AcdbKeyValuePair *)new_ckv->kvp;
 
+	/*
+	 * the size of the last cal is only a hint for shared memory. An in-band
+	 * message is sent whole, so it is sized to the cal
+	 */
 	rsp_struct.buf = NULL;
 	rsp_struct.buf_size = 0;
+	if (!__gpr_cmd_is_shared_mem_supported(graph->proc_id,
+		&is_shmem_supported) && is_shmem_supported)
+		rsp_struct.buf_size = graph->nonpersist_cal_size;
+
+	gsl_memset(&alloc, 0, sizeof(alloc));
+	alloc.graph = graph;
 
 	if (!isCKVValidated)
 		gsl_graph_check_ckvs(gkv, new_ckv);
 
-	rc = acdb_ioctl(ACDB_CMD_GET_SUBGRAPH_CALIBRATION_DATA_NONPERSIST,
-		&cmd_struct, sizeof(cmd_struct), &rsp_struct, sizeof(rsp_struct));
+	/* size and data are retrieved in one call, in a single pass if the cal
+	 * fits in the size of the last one sent */
+	rc = acdb_ioctl_alloc(ACDB_CMD_GET_SUBGRAPH_CALIBRATION_DATA_NONPERSIST,
+		&cmd_struct, sizeof(cmd_struct), &rsp_struct, sizeof(rsp_struct),
+		&allocator);
+	gsl_msg = alloc.gsl_msg;
 	if (rc == AR_ENOTEXIST) {
 		/* avoid logging error if not exist */
-		return rc;
+		goto exit;
 	} else if (rc) {
-		GSL_ERR("get non-persist data (size) failed %d", rc);
-		return rc;
-	}
-
-	rc = gsl_msg_alloc(APM_CMD_SET_CFG, graph->src_port, GSL_GPR_DST_PORT_APM,
-		sizeof(*cmd_header), 0, graph->proc_id, rsp_struct.buf_size, false,
-		&gsl_msg);
-	if (rc) {
-		GSL_ERR("gsl msg alloc failed %d", rc);
-		return rc;
-	}
-	rsp_struct.buf = gsl_msg.payload;
-	rc = acdb_ioctl(ACDB_CMD_GET_SUBGRAPH_CALIBRATION_DATA_NONPERSIST,
-		&cmd_struct, sizeof(cmd_struct), &rsp_struct, sizeof(rsp_struct));
-	if (rc) {
-		GSL_ERR("get non-persist data (cal) failed %d", rc);
+		GSL_ERR("get non-persist data failed %d", rc);
 		goto exit;
 	}
+	graph->nonpersist_cal_size = rsp_struct.buf_size;
 
 	cmd_header = GPR_PKT_GET_PAYLOAD(struct apm_cmd_header_t,
 		gsl_msg.gpr_packet);
@@ -1304,42 +1334,52 @@ static int32_t gsl_graph_send_global_persist_cal(struct gsl_graph *graph,
 
 	for (i = 0; i < rsp_id_list.num_glb_persist_identifiers; ++i) {
 
-		cal_data = NULL;
-		rsp_blob.buf = NULL;
-		rsp_blob.buf_size = 0;
 		cal_info = (AcdbGlbPsistCalInfo *)cal_info_ptr;
-
 		gpc_id = cal_info->cal_identifier;
 
-		rc = acdb_ioctl(ACDB_CMD_GET_SUBGRAPH_GLB_PSIST_CALDATA, &gpc_id,
-			sizeof(gpc_id), &rsp_blob, sizeof(rsp_blob));
-		if (rc) {
-			GSL_ERR("get global persist identifiers size failed %d", rc);
-			goto cleanup;
-		}
-
-		cal_iid_lists[i].gpcal = gsl_global_persist_cal_pool_add(gpc_id,
-			rsp_blob.buf_size, &cal_data, graph->proc_id);
+		/*
+		 * cal already in the pool for this proc, no need to fetch it from
+		 * ACDB again
+		 */
+		cal_iid_lists[i].gpcal = gsl_global_persist_cal_pool_get(gpc_id,
+			graph->proc_id);
 
 		if (!cal_iid_lists[i].gpcal) {
-			GSL_ERR("Add to global cal pool failed for cal ID %d", gpc_id);
-			rc = AR_EFAILED;
-			goto cleanup;
-		}
+			rsp_blob.buf = NULL;
+			rsp_blob.buf_size = 0;
+			rc = acdb_ioctl(ACDB_CMD_GET_SUBGRAPH_GLB_PSIST_CALDATA, &gpc_id,
+				sizeof(gpc_id), &rsp_blob, sizeof(rsp_blob));
+			if (rc) {
+				GSL_ERR("get global persist identifiers size failed %d", rc);
+				goto cleanup;
+			}
+
+			rsp_blob.buf = gsl_mem_zalloc(rsp_blob.buf_size);
+			if (!rsp_blob.buf) {
+				rc = AR_ENOMEMORY;
+				goto cleanup;
+			}
 
-		/* cal_data will be non-null if we need to fetch data */
-		if (cal_data) {
-			rsp_blob.buf = cal_data->v_addr;
 			rc = acdb_ioctl(ACDB_CMD_GET_SUBGRAPH_GLB_PSIST_CALDATA, &gpc_id,
 				sizeof(gpc_id), &rsp_blob, sizeof(rsp_blob));
 			if (rc) {
 				GSL_ERR("get global persist calibration data failed %d", rc);
+				gsl_mem_free(rsp_blob.buf);
+				goto cleanup;
+			}
+
+			/* pool shares the payload if another cal_id has identical data */
+			cal_iid_lists[i].gpcal = gsl_global_persist_cal_pool_add(gpc_id,
+				rsp_blob.buf, rsp_blob.buf_size, graph->proc_id);
+			gsl_mem_free(rsp_blob.buf);
+			if (!cal_iid_lists[i].gpcal) {
+				GSL_ERR("Add to global cal pool failed for cal ID %d", gpc_id);
+				rc = AR_EFAILED;
 				goto cleanup;
 			}
-		} else {
-			/* got null so entry already exists. Just point to it */
-			cal_data = &(cal_iid_lists[i].gpcal->cal_data);
 		}
+		gkv_node->num_of_gp_cals = i + 1;
+		cal_data = &(cal_iid_lists[i].gpcal->blob->cal_data);
 
 		/* register cal on each iid */
 		for (j = 0; j < cal_info->num_iids; ++j) {
@@ -1378,7 +1418,14 @@ static int32_t gsl_graph_send_global_persist_cal(struct gsl_graph *graph,
 	goto free_cal_info;
 
 cleanup:
-	gsl_mem_free(cal_iid_lists);
+	/*
+	 * cals added so far stay in glbl_persist_cal_list so that they are
+	 * deregistered and released from the pool when the graph is closed
+	 */
+	if (gkv_node->num_of_gp_cals == 0) {
+		gsl_mem_free(cal_iid_lists);
+		gkv_node->glbl_persist_cal_list = NULL;
+	}
 free_cal_info:
 	gsl_mem_free(rsp_id_list.global_persistent_cal_info);
 exit:
@@ -1562,12 +1609,30 @@ int32_t gsl_graph_deinit(struct gsl_graph *graph)
 	return AR_EOK;
 }
 
+/*
+ * largest get_graph response seen so far, used as the size of the subgraph
+ * buffer so ACDB can fill it in a single pass
+ */
+static uint32_t gsl_acdb_get_graph_size_hint;
+
+/* allocates a zeroed response buffer, freeing any earlier one for the index */
+static void *gsl_acdb_alloc_rsp_buf(void *ctx, uint32_t buf_index,
+	uint32_t size)
+{
+	void **bufs = ctx;
+
+	gsl_mem_free(bufs[buf_index]);
+	bufs[buf_index] = gsl_mem_zalloc(size);
+	return bufs[buf_index];
+}
+
 int32_t gsl_acdb_get_graph(const struct gsl_key_vector *gkv,
 	uint32_t **sg_id_list, AcdbGetGraphRsp *sg_conn_info)
 {
 	AcdbGetGraphRsp rsp_struct;
 	AcdbGraphKeyVector cmd_struct;
-	AcdbSubgraph *sgs;
+	AcdbSubgraph *sgs = NULL;
+	AcdbAllocator allocator = { gsl_acdb_alloc_rsp_buf, &sgs };
 	uint32_t cmd_struct_size, rsp_struct_size, num_dst_sgs;
 	int32_t rc, i, payload_size;
 	uint32_t num_of_subgraphs, *rsp_p, *sg_ids;
@@ -1579,27 +1644,35 @@ int32_t gsl_acdb_get_graph(const struct gsl_key_vector *gkv,
 
 	/**
 	 * Populate response structure
-	 * Response size is unknown here, so allocate minimum of 8 bytes,
-	 * so ACDB SW can return the size to be allocated
+	 * Response size is unknown here, start from the largest one seen so
+	 * far. ACDB SW gets the size and reallocates the subgraphs through the
+	 * allocator if they do not fit
 	 */
 	rsp_struct.subgraphs = NULL;
-	rsp_struct.size = 0;
+	rsp_struct.size = ar_osal_atomic_load_u32(&gsl_acdb_get_graph_size_hint);
 	rsp_struct.num_subgraphs = 0;
 	rsp_struct_size = sizeof(AcdbGetGraphRsp);
 
-	rc = acdb_ioctl(ACDB_CMD_GET_GRAPH, &cmd_struct, cmd_struct_size,
-		&rsp_struct, rsp_struct_size);
+	rc = acdb_ioctl_alloc(ACDB_CMD_GET_GRAPH, &cmd_struct, cmd_struct_size,
+		&rsp_struct, rsp_struct_size, &allocator);
 	if (rc) {
-		GSL_ERR("get_graph acdb ioctl for size failed: %d", rc);
-		goto exit;
+		GSL_ERR("get_graph acdb ioctl failed: %d", rc);
+		goto free_sgs;
 	}
+	/* a lost update from a racing open only costs that caller a retry */
+	if (rsp_struct.size >
+		ar_osal_atomic_load_u32(&gsl_acdb_get_graph_size_hint))
+		ar_osal_atomic_store_u32(&gsl_acdb_get_graph_size_hint,
+			rsp_struct.size);
 	/*
 	 * Getting 0 subgraphs is a valid scenario, GSL should handle it by not
-	 * opening any subgraphs on Spf
+	 * opening any subgraphs on Spf. The size is not used to detect it as
+	 * it may still hold the hinted buffer size
 	 */
-	if (rsp_struct.size == 0) {
+	if (rsp_struct.num_subgraphs == 0) {
 		GSL_DBG("zero size returned for get_graph: %d, size: %d", rc,
 			rsp_struct.size);
+		gsl_mem_free(sgs);
 		if (sg_conn_info) {
 			sg_conn_info->num_subgraphs = 0;
 			sg_conn_info->size = 0;
@@ -1610,20 +1683,6 @@ int32_t gsl_acdb_get_graph(const struct gsl_key_vector *gkv,
 		goto exit;
 	}
 
-	sgs = gsl_mem_zalloc(rsp_struct.size);
-	if (!sgs) {
-		rc = AR_ENOMEMORY;
-		goto exit;
-	}
-	rsp_struct.subgraphs = sgs;
-
-	rc = acdb_ioctl(ACDB_CMD_GET_GRAPH, &cmd_struct, cmd_struct_size,
-		&rsp_struct, rsp_struct_size);
-	if (rc) {
-		GSL_ERR("get_graph acdb ioctl for data failed: %d", rc);
-		goto free_sgs;
-	}
-
 	/* rsp_struct: {num_of_subgraphs, size, <AcdbSubgraph structure> */
 	rsp_p = (uint32_t *)&rsp_struct;
 	payload_size = rsp_struct.size;
@@ -1642,18 +1701,23 @@ int32_t gsl_acdb_get_graph(const struct gsl_key_vector *gkv,
 
 	rsp_p = (uint32_t *)rsp_struct.subgraphs;
 	i = 0;
-	while (payload_size > 0) {
+	while (payload_size >= 8 && i < (int32_t)num_of_subgraphs) {
 		sg_ids[i++] = *rsp_p++;
 		num_dst_sgs = *rsp_p++;
+		payload_size -= 8;
+		if (num_dst_sgs > (uint32_t)payload_size / 4) {
+			payload_size = -1;
+			break;
+		}
 		rsp_p += num_dst_sgs;
-		payload_size -= 4 * (2 + num_dst_sgs);
+		payload_size -= 4 * num_dst_sgs;
 	}
 	/**
-	 * After successful parsing payload_size should become 0
-	 * Check if it becomes negative and return error to avoid
-	 * illegal memory accesses
+	 * After successful parsing all subgraphs are read and payload_size
+	 * should become 0. Return an error otherwise to avoid illegal memory
+	 * accesses
 	 */
-	if (payload_size < 0) {
+	if (payload_size != 0 || i != (int32_t)num_of_subgraphs) {
 		rc = AR_EFAILED;
 		GSL_ERR("get_graph response parsing failed: %d", rc);
 		goto free_sg_ids;
@@ -2800,11 +2864,12 @@ static int32_t gsl_graph_close_single_gkv(struct gsl_graph *graph,
 			}
 
 			cmd_header = GPR_PKT_GET_PAYLOAD(apm_cmd_header_t, send_pkt);
-			cmd_header->mem_map_handle = tmp_gpcal->cal_data.spf_mmap_handle;
+			cmd_header->mem_map_handle =
+				tmp_gpcal->blob->cal_data.spf_mmap_handle;
 			cmd_header->payload_address_lsw =
-				(uint32_t)tmp_gpcal->cal_data.spf_addr;
+				(uint32_t)tmp_gpcal->blob->cal_data.spf_addr;
 			cmd_header->payload_address_msw =
-				(uint32_t)(tmp_gpcal->cal_data.spf_addr >> 32);
+				(uint32_t)(tmp_gpcal->blob->cal_data.spf_addr >> 32);
 
 			GSL_LOG_PKT("send_pkt", graph->src_port, send_pkt,
 				sizeof(*send_pkt) + sizeof(*cmd_header), NULL, 0);
@@ -8,6 +8,7 @@
  *  SPDX-License-Identifier: BSD-3-Clause
  */
 #include "gsl_intf.h"
+#include "gsl_main.h"
 #include "acdb.h"
 #include "ar_osal_error.h"
 #include "ar_osal_log.h"
@@ -16,9 +17,11 @@
 #include "ar_util_data_log.h"
 #include "ar_util_err_detection.h"
 #include "ar_osal_mutex.h"
+#include "ar_osal_atomic.h"
 #include "ar_osal_sleep.h"
 #include "ar_osal_string.h"
 #include "ar_osal_sys_id.h"
+#include "ar_osal_timer.h"
 #include "gsl_graph.h"
 #include "gsl_subgraph_pool.h"
 #include "gsl_global_persist_cal.h"
@@ -30,9 +33,11 @@
 #include "gsl_rtc.h"
 #include "gsl_rtc_intf.h"
 #include "gsl_dynamic_module_mgr.h"
+#include "gsl_async.h"
 #include "gpr_api.h"
 #include "gpr_api_inline.h"
 #include "gpr_ids_domains.h"
+#include "gpr_trace.h"
 #include "apm_api.h"
 #include "apm_memmap_api.h"
 #include "apm_graph_properties.h"
@@ -55,13 +60,37 @@ ar_osal_mutex_t log_mutex;
  */
 #define GSL_MINOR_VERSION 0
 
-/** max. number of use-case graphs, initialize to 16 */
+/**
+ * initial number of use-case graphs, the graph table grows in chunks of
+ * this many entries up to GSL_MAX_GRAPHS
+ */
 #define MAX_UC_GRAPHS 16
-#define GSL_MAGIC_WORD  0x47534C  /* 'GSL' */
-#define GSL_MAGIC_WORD_MASK  0xFFFFFF
-#define GSL_GRAPH_IDX_SHIFT 24
+#define GSL_GRAPH_TBL_CHUNK_SHIFT 4
+#define GSL_GRAPH_TBL_CHUNK_MASK (MAX_UC_GRAPHS - 1)
+
+/** max. number of concurrent use-case graphs */
+#ifndef GSL_MAX_GRAPHS
+#define GSL_MAX_GRAPHS 1024
+#endif
+#define GSL_GRAPH_TBL_NUM_CHUNKS (GSL_MAX_GRAPHS >> GSL_GRAPH_TBL_CHUNK_SHIFT)
+
+/*
+ * graph handle layout, handles are passed around as 32 bit values
+ *   [31:24] magic word
+ *   [23:12] generation of the graph table entry, bumped on every release
+ *   [11:0]  index into the graph table
+ */
+#define GSL_MAGIC_WORD  0x47  /* 'G' */
+#define GSL_MAGIC_WORD_SHIFT 24
+#define GSL_GRAPH_GEN_SHIFT 12
+#define GSL_GRAPH_GEN_MASK 0xFFF
+#define GSL_GRAPH_IDX_MASK 0xFFF
 #define GSL_GRAPH_SRC_PORT_MIN  0x2010
-#define GSL_GRAPH_SRC_PORT_MAX  0x2100
+#define GSL_GRAPH_SRC_PORT_MAX  (GSL_GRAPH_SRC_PORT_MIN + GSL_MAX_GRAPHS - 1)
+
+#if (GSL_MAX_GRAPHS > 2048) || (GSL_MAX_GRAPHS & GSL_GRAPH_TBL_CHUNK_MASK)
+#error "GSL_MAX_GRAPHS must be a multiple of MAX_UC_GRAPHS and at most 2048"
+#endif
 
 #define get_src_port(i)  ((((i) + GSL_GRAPH_SRC_PORT_MIN) > \
 				GSL_GRAPH_SRC_PORT_MAX) ? \
@@ -79,20 +108,34 @@ struct gsl_rtgm_state_info {
 
 	/*
 	 * when non-zero it means rtgm operation is in progress
-	 * QACT sends all prepares then all change
+	 * QACT sends all prepares then all change. Updated under graph_hdl_lock
+	 * but read without it on the datapath
 	 */
 	uint32_t num_rtgm_in_prog;
 
 	/*
 	 * when true it means non-rtgm client operation is in progress such as
-	 * read/write or set_cfg
+	 * set_cfg
 	 */
 	bool_t client_op_in_prog;
 
+	/*
+	 * number of gsl_read/gsl_write calls in progress, updated atomically
+	 * without graph_hdl_lock
+	 */
+	uint32_t num_dp_op_in_prog;
+
 	/*
 	 * signal to tell waiting rtgm operation when it is safe to proceed
 	 */
 	struct gsl_signal sig;
+
+	/*
+	 * set while no rtgm operation is in progress. Datapath calls that back
+	 * off wait on it without clearing it, so it wakes all of them and is
+	 * never consumed by one of them in place of the rtgm waiter on sig
+	 */
+	ar_osal_signal_t rtgm_done_sig;
 };
 
 struct gsl_acdb_client_info {
@@ -103,9 +146,32 @@ struct gsl_acdb_client_info {
 	gsl_acdb_handle_t acdb_handle; /**< acdb handle returned from AML */
 };
 
+/** entry in the graph table, one per GSL handle */
+struct gsl_graph_slot {
+	struct gsl_graph *graph;
+	/**< graph using this entry, NULL if free. Read without lock */
+	uint32_t gen;
+	/**< generation of this entry, part of the handle. Read without lock */
+	uint32_t pin_cnt;
+	/**< number of datapath calls currently using graph, see pin_gsl_graph */
+	ar_osal_signal_t unpin_sig;
+	/**< set by the last unpin of a released graph, see release_graph_handle */
+	bool_t in_use;
+	/**< entry is allocated to a handle, cleared once all pins are dropped */
+	uint32_t open_pending;
+	/**< graph is being opened by gsl_open_async, see gsl_main_wait_open */
+	ar_osal_signal_t open_sig;
+	/**< set when open_pending is cleared, see gsl_main_end_open_pending */
+};
+
 static struct gsl_ctxt_ {
-	void **graph_list; /**< list of all graphs, one per GSL handle */
-	uint8_t graph_list_size; /**< size of graph list */
+	struct gsl_graph_slot *graph_tbl[GSL_GRAPH_TBL_NUM_CHUNKS];
+	/**<
+	 * table of all graphs, allocated in chunks of MAX_UC_GRAPHS entries.
+	 * Chunks are only freed at deinit so the table can be read without
+	 * holding graph_hdl_lock
+	 */
+	uint32_t graph_list_size; /**< number of entries in graph table */
 	uint32_t num_graphs; /**< number of active graphs */
 	ar_osal_mutex_t open_close_lock;
 	    /**< used to serialize open and close operations */
@@ -121,28 +187,70 @@ static struct gsl_ctxt_ {
 	/**< client data that is passed back to client in the callback */
 	struct gsl_rtgm_state_info rtgm_state_info;
 	/**< info used to sychronize rtgm and non-rtgm operations */
-	bool_t spf_restart[AR_SUB_SYS_ID_LAST + 1];
-	/**< on SPF SSR/PDR, we need to reconfigure shmem and dyn modules */
+	uint32_t spf_restart[AR_SUB_SYS_ID_LAST + 1];
+	/**<
+	 * on SPF SSR/PDR, we need to reconfigure shmem and dyn modules. Counts
+	 * the service ups not recovered yet, guarded by ssr_lock
+	 */
+	struct gsl_ssr_recovery_stats ssr_stats[AR_SUB_SYS_ID_LAST + 1];
+	/**< timings of the last SSR of each master proc, see gsl_main_ssr_recover */
+	ar_osal_mutex_t ssr_lock;
+	/**<
+	 * guards spf_restart and ssr_stats, only held briefly as they are
+	 * updated from the SSR callback
+	 */
 	bool_t rtc_conn_active;
 	/**< whether there is an active RTC session or not */
 	ar_list_t acdb_client_list; /**< list of acdb clients from PVM and GVM */
 	ar_osal_mutex_t acdb_client_lock;
 } gsl_ctxt;
 
-static inline gsl_handle_t to_gsl_handle(uint8_t index)
+/* returns the table entry for index, NULL if its chunk is not allocated */
+static inline struct gsl_graph_slot *gsl_graph_slot_get(uint32_t index)
+{
+	struct gsl_graph_slot *chunk;
+
+	if (index >= GSL_MAX_GRAPHS)
+		return NULL;
+
+	chunk = ar_osal_atomic_load_ptr(
+		(void **)&gsl_ctxt.graph_tbl[index >> GSL_GRAPH_TBL_CHUNK_SHIFT]);
+	if (!chunk)
+		return NULL;
+
+	return &chunk[index & GSL_GRAPH_TBL_CHUNK_MASK];
+}
+
+/* must be called with graph_hdl_lock held, index must be allocated */
+static inline struct gsl_graph *gsl_graph_at(uint32_t index)
+{
+	return gsl_graph_slot_get(index)->graph;
+}
+
+/* must be called with graph_hdl_lock held, index must be allocated */
+static inline gsl_handle_t to_gsl_handle(uint32_t index)
+{
+	uint32_t gen = gsl_graph_slot_get(index)->gen & GSL_GRAPH_GEN_MASK;
+
+	return (gsl_handle_t)((uintptr_t)(
+		(GSL_MAGIC_WORD << GSL_MAGIC_WORD_SHIFT) |
+		(gen << GSL_GRAPH_GEN_SHIFT) | index));
+}
+
+static inline uint32_t to_gsl_graph_index(gsl_handle_t hdl)
 {
-	return (gsl_handle_t)((uintptr_t)(GSL_MAGIC_WORD |
-		(index << GSL_GRAPH_IDX_SHIFT)));
+	return (uint32_t)(uintptr_t)hdl & GSL_GRAPH_IDX_MASK;
 }
 
-static inline uint8_t to_gsl_graph_index(gsl_handle_t hdl)
+static inline uint32_t to_gsl_graph_gen(gsl_handle_t hdl)
 {
-	return ((uintptr_t)hdl >> GSL_GRAPH_IDX_SHIFT) & 0xff;
+	return ((uint32_t)(uintptr_t)hdl >> GSL_GRAPH_GEN_SHIFT) &
+		GSL_GRAPH_GEN_MASK;
 }
 
 static bool_t is_valid_gsl_hdl(gsl_handle_t hdl)
 {
-	if (((uintptr_t)hdl & GSL_MAGIC_WORD_MASK) != GSL_MAGIC_WORD)
+	if (((uint32_t)(uintptr_t)hdl >> GSL_MAGIC_WORD_SHIFT) != GSL_MAGIC_WORD)
 		return 0;
 
 	return 1;
@@ -155,7 +263,8 @@ static bool_t is_valid_gsl_hdl(gsl_handle_t hdl)
 static bool_t gsl_main_start_client_op(struct gsl_ctxt_ *ctxt)
 {
 	GSL_MUTEX_LOCK(ctxt->graph_hdl_lock);
-	if (ctxt->rtgm_state_info.num_rtgm_in_prog > 0) {
+	if (ar_osal_atomic_load_u32(&ctxt->rtgm_state_info.num_rtgm_in_prog)
+		> 0) {
 		GSL_MUTEX_UNLOCK(ctxt->graph_hdl_lock);
 		return false;
 	}
@@ -171,7 +280,8 @@ static int32_t gsl_main_start_client_op_blocking(struct gsl_ctxt_ *ctxt)
 
 	GSL_MUTEX_LOCK(ctxt->graph_hdl_lock);
 	/* if RTGM is in-progress block */
-	while (ctxt->rtgm_state_info.num_rtgm_in_prog > 0) {
+	while (ar_osal_atomic_load_u32(
+		&ctxt->rtgm_state_info.num_rtgm_in_prog) > 0) {
 		GSL_MUTEX_UNLOCK(ctxt->graph_hdl_lock);
 		GSL_DBG("blocked due to RTGM");
 		rc = gsl_signal_timedwait(
@@ -201,29 +311,191 @@ static void gsl_main_end_client_op(struct gsl_ctxt_ *ctxt)
 	GSL_MUTEX_UNLOCK(ctxt->graph_hdl_lock);
 }
 
+/*
+ * Lock free equivalent of gsl_main_end_client_op for datapath calls. Only
+ * signals when an RTGM operation is waiting for datapath calls to drain
+ */
+static void gsl_main_end_dp_op(struct gsl_ctxt_ *ctxt)
+{
+	if (ar_osal_atomic_sub_u32(&ctxt->rtgm_state_info.num_dp_op_in_prog, 1)
+		== 0 && ar_osal_atomic_load_u32(
+		&ctxt->rtgm_state_info.num_rtgm_in_prog) > 0)
+		gsl_signal_set(&ctxt->rtgm_state_info.sig,
+			GSL_SIG_EVENT_CLIENT_OP_DONE, 0, NULL);
+}
+
+/*
+ * Lock free equivalent of gsl_main_start_client_op_blocking for datapath
+ * calls. The datapath count is raised before checking for RTGM while RTGM
+ * raises its count before checking for datapath calls, so at least one side
+ * always observes the other. Only backs off to waiting if RTGM is pending
+ */
+static int32_t gsl_main_start_dp_op(struct gsl_ctxt_ *ctxt)
+{
+	int32_t rc = AR_EOK;
+
+	for (;;) {
+		ar_osal_atomic_add_u32(&ctxt->rtgm_state_info.num_dp_op_in_prog, 1);
+		if (ar_osal_atomic_load_u32(
+			&ctxt->rtgm_state_info.num_rtgm_in_prog) == 0)
+			break;
+
+		/*
+		 * sig only wakes RTGM if it is already draining datapath calls,
+		 * this thread waits on rtgm_done_sig
+		 */
+		gsl_main_end_dp_op(ctxt);
+		GSL_DBG("blocked due to RTGM");
+		rc = ar_osal_signal_timedwait(ctxt->rtgm_state_info.rtgm_done_sig,
+			GSL_TIMEOUT_NS(GSL_SPF_READ_WRITE_TIMEOUT_MS));
+		if (rc != AR_EOK) {
+			GSL_ERR("signal timed wait returned err %d", rc);
+			return rc;
+		}
+	}
+
+	return rc;
+}
+
+/*
+ * Finishes an RTGM operation, the last one to finish releases datapath calls
+ * waiting on rtgm_done_sig and client ops waiting on sig
+ */
+static void gsl_main_end_rtgm(struct gsl_ctxt_ *ctxt)
+{
+	GSL_MUTEX_LOCK(ctxt->graph_hdl_lock);
+	if (ar_osal_atomic_sub_u32(
+		&ctxt->rtgm_state_info.num_rtgm_in_prog, 1) == 0) {
+		ar_osal_signal_set(ctxt->rtgm_state_info.rtgm_done_sig);
+		gsl_signal_set(&ctxt->rtgm_state_info.sig,
+			GSL_SIG_EVENT_MASK_RTGM_DONE, 0, NULL);
+	}
+	GSL_ERR("tvl end of RTGM, num in prog: %d",
+		ctxt->rtgm_state_info.num_rtgm_in_prog);
+	GSL_MUTEX_UNLOCK(ctxt->graph_hdl_lock);
+}
+
+/*
+ * Starts an RTGM operation. Waits for any client operation such as set_cfg
+ * to complete, then for datapath calls already started to drain
+ */
+static int32_t gsl_main_start_rtgm(struct gsl_ctxt_ *ctxt)
+{
+	uint32_t ev_flags = 0;
+	int32_t rc = AR_EOK;
+
+	GSL_MUTEX_LOCK(ctxt->graph_hdl_lock);
+	while (ctxt->rtgm_state_info.client_op_in_prog) {
+		GSL_MUTEX_UNLOCK(ctxt->graph_hdl_lock);
+		rc = gsl_signal_timedwait(&ctxt->rtgm_state_info.sig,
+			GSL_SPF_TIMEOUT_MS, &ev_flags, NULL, NULL);
+		if (rc) {
+			GSL_ERR("signal timedwait failed %d", rc);
+			return rc;
+		}
+		GSL_MUTEX_LOCK(ctxt->graph_hdl_lock);
+	}
+	/* cleared before datapath calls can see RTGM in progress */
+	if (ctxt->rtgm_state_info.num_rtgm_in_prog == 0)
+		ar_osal_signal_clear(ctxt->rtgm_state_info.rtgm_done_sig);
+	ar_osal_atomic_add_u32(&ctxt->rtgm_state_info.num_rtgm_in_prog, 1);
+	GSL_MUTEX_UNLOCK(ctxt->graph_hdl_lock);
+
+	/*
+	 * datapath calls back off once they see RTGM in progress, wait for
+	 * the ones already started to complete
+	 */
+	while (ar_osal_atomic_load_u32(
+		&ctxt->rtgm_state_info.num_dp_op_in_prog) > 0) {
+		rc = gsl_signal_timedwait(&ctxt->rtgm_state_info.sig,
+			GSL_SPF_READ_WRITE_TIMEOUT_MS, &ev_flags, NULL, NULL);
+		if (rc) {
+			GSL_ERR("signal timedwait for datapath failed %d", rc);
+			gsl_main_end_rtgm(ctxt);
+			return rc;
+		}
+	}
+
+	return rc;
+}
+
+/*
+ * Resolves a handle to its graph without taking graph_hdl_lock. The graph
+ * pointer is read before the generation, and a release clears the pointer
+ * before bumping the generation, so a stale or recycled handle never
+ * resolves to the graph now occupying its entry.
+ */
 static struct gsl_graph *to_gsl_graph(gsl_handle_t graph_handle)
 {
-	struct gsl_graph *graph = NULL;
+	struct gsl_graph_slot *slot;
+	struct gsl_graph *graph;
 
-	GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
+	if (!is_valid_gsl_hdl(graph_handle))
+		return NULL;
+
+	slot = gsl_graph_slot_get(to_gsl_graph_index(graph_handle));
+	if (!slot)
+		return NULL;
+
+	graph = ar_osal_atomic_load_ptr((void **)&slot->graph);
+	if ((ar_osal_atomic_load_u32(&slot->gen) & GSL_GRAPH_GEN_MASK) !=
+		to_gsl_graph_gen(graph_handle))
+		return NULL;
+
+	return graph;
+}
+
+static inline void unpin_gsl_graph(struct gsl_graph_slot *slot);
+
+/*
+ * Resolves a handle and pins its graph so that it cannot be freed by a
+ * concurrent close until unpin_gsl_graph is called. The pin count lives in
+ * the table entry, which is never freed, and is raised before the graph is
+ * looked up. Close clears the graph before waiting for the pin count to
+ * drop, so either close waits for this pin or this lookup fails.
+ */
+static struct gsl_graph *pin_gsl_graph(gsl_handle_t graph_handle,
+	struct gsl_graph_slot **pinned_slot)
+{
+	struct gsl_graph_slot *slot;
+	struct gsl_graph *graph;
 
 	if (!is_valid_gsl_hdl(graph_handle))
-		goto cleanup;
+		return NULL;
 
-	graph = (struct gsl_graph *)
-		gsl_ctxt.graph_list[to_gsl_graph_index(graph_handle)];
+	slot = gsl_graph_slot_get(to_gsl_graph_index(graph_handle));
+	if (!slot)
+		return NULL;
 
-cleanup:
-	GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
+	ar_osal_atomic_add_u32(&slot->pin_cnt, 1);
+	graph = ar_osal_atomic_load_ptr((void **)&slot->graph);
+	if (!graph || (ar_osal_atomic_load_u32(&slot->gen) & GSL_GRAPH_GEN_MASK)
+		!= to_gsl_graph_gen(graph_handle)) {
+		unpin_gsl_graph(slot);
+		return NULL;
+	}
 
+	*pinned_slot = slot;
 	return graph;
 }
 
+/*
+ * Drops a pin. Release clears the graph before it checks the pin count, so
+ * either release sees the count at zero or the last unpin sees the graph
+ * cleared and wakes release
+ */
+static inline void unpin_gsl_graph(struct gsl_graph_slot *slot)
+{
+	if (ar_osal_atomic_sub_u32(&slot->pin_cnt, 1) == 0 &&
+		!ar_osal_atomic_load_ptr((void **)&slot->graph))
+		ar_osal_signal_set(slot->unpin_sig);
+}
+
 /** callback handles RTC callbacks */
 static int32_t gsl_rtc_callback(enum gsl_rtc_request_type req, void *cb_data)
 {
 	struct gsl_rtc_active_uc_info *info;
-	uint32_t size_remaining = 0, ev_flags = 0;
+	uint32_t size_remaining = 0;
 	uint32_t size_to_copy = 0, gkv_node_size;
 	uint32_t gkv_bytes = 0, ckv_bytes = 0;
 	static uint32_t restart_list_position, restart_list_size;
@@ -231,7 +503,7 @@ static int32_t gsl_rtc_callback(enum gsl_rtc_request_type req, void *cb_data)
 	struct gsl_graph *graph = NULL;
 	struct gsl_rtc_uc_data *uc_data = NULL;
 	uint8_t *payload;
-	uint8_t i;
+	uint32_t i;
 	struct gsl_rtc_param *rtc_cal_data;
 	struct gsl_rtc_persist_param *rtc_persist_cal_data;
 	struct gsl_rtc_prepare_change_graph_info *prep_change_graph_params;
@@ -256,7 +528,7 @@ static int32_t gsl_rtc_callback(enum gsl_rtc_request_type req, void *cb_data)
 			gsl_memset(uc_data, 0, size_remaining);
 		GSL_MUTEX_LOCK(gsl_ctxt.open_close_lock);
 		for (i = 0; i < gsl_ctxt.graph_list_size; ++i) {
-			graph = (struct gsl_graph *)(gsl_ctxt.graph_list[i]);
+			graph = gsl_graph_at(i);
 			if (graph &&
 				(gsl_graph_get_state(graph) >= GRAPH_OPENED) &&
 				(gsl_graph_get_state(graph) != GRAPH_ERROR) &&
@@ -284,23 +556,9 @@ static int32_t gsl_rtc_callback(enum gsl_rtc_request_type req, void *cb_data)
 		break;
 
 	case GSL_RTC_PREPARE_CHANGE_GRAPH:
-		/*
-		 * check that no other client operation is in progress before starting
-		 * RTGM, if it is then wait for it to complete
-		 */
-		GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
-		while (gsl_ctxt.rtgm_state_info.client_op_in_prog) {
-			GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
-			rc = gsl_signal_timedwait(&gsl_ctxt.rtgm_state_info.sig,
-				GSL_SPF_TIMEOUT_MS, &ev_flags, NULL, NULL);
-			if (rc) {
-				GSL_ERR("signal timedwait failed %d", rc);
-				goto exit;
-			}
-			GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
-		}
-		++gsl_ctxt.rtgm_state_info.num_rtgm_in_prog;
-		GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
+		rc = gsl_main_start_rtgm(&gsl_ctxt);
+		if (rc)
+			goto exit;
 
 		GSL_MUTEX_LOCK(gsl_ctxt.open_close_lock);
 		prep_change_graph_params = (struct gsl_rtc_prepare_change_graph_info *)
@@ -404,14 +662,7 @@ static int32_t gsl_rtc_callback(enum gsl_rtc_request_type req, void *cb_data)
 		}
 		GSL_MUTEX_UNLOCK(gsl_ctxt.open_close_lock);
 
-		/* Decrement counter to finish this rtgm operation. Signal if no more */
-		GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
-		if (--gsl_ctxt.rtgm_state_info.num_rtgm_in_prog == 0)
-			gsl_signal_set(&gsl_ctxt.rtgm_state_info.sig,
-				GSL_SIG_EVENT_MASK_RTGM_DONE, 0, NULL);
-		GSL_ERR("tvl end of RTGM, num in prog: %d",
-			gsl_ctxt.rtgm_state_info.num_rtgm_in_prog);
-		GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
+		gsl_main_end_rtgm(&gsl_ctxt);
 		break;
 
 	case GSL_RTC_CONN_INFO_CHANGE:
@@ -424,14 +675,16 @@ static int32_t gsl_rtc_callback(enum gsl_rtc_request_type req, void *cb_data)
 		case GSL_RTC_CONNECTION_STATE_STOP:
 			gsl_ctxt.rtc_conn_active = false;
 			/* stop graphs from logging cfg info to diag */
+			GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
 			for (i = 0; i < gsl_ctxt.graph_list_size; ++i) {
 				/* list not necessarily contiguous, check for null */
-				if (!gsl_ctxt.graph_list[i])
+				graph = gsl_graph_at(i);
+				if (!graph)
 					continue;
 
-				((struct gsl_graph *)gsl_ctxt.graph_list[i])
-					->rtc_conn_active = false;
+				graph->rtc_conn_active = false;
 			}
+			GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
 			break;
 		default:
 			rc = AR_EUNSUPPORTED;
@@ -487,6 +740,158 @@ exit:
 	return rc;
 }
 
+/* returns whether master_proc restarted and was not recovered yet */
+static bool_t gsl_main_ssr_pending(uint32_t master_proc)
+{
+	bool_t pending;
+
+	GSL_MUTEX_LOCK(gsl_ctxt.ssr_lock);
+	pending = gsl_ctxt.spf_restart[master_proc] != 0;
+	GSL_MUTEX_UNLOCK(gsl_ctxt.ssr_lock);
+
+	return pending;
+}
+
+/*
+ * Re-establishes state on a master proc after it restarted, must be called
+ * with open_close_lock held. spf_restart is left set on failure so that the
+ * next open retries.
+ */
+static int32_t gsl_main_ssr_recover(uint32_t master_proc)
+{
+	struct gsl_ssr_recovery_stats local_stats;
+	struct gsl_ssr_recovery_stats *stats = &local_stats;
+	uint32_t num_restarts;
+	uint32_t supported_ss_mask = 0;
+	uint32_t num_procs = 0;
+	struct proc_domain_type *proc_domains = NULL;
+	bool_t is_shmem_supported = TRUE;
+	uint64_t ts;
+	int32_t rc = AR_EOK;
+	uint32_t j = 0;
+
+	/*
+	 * timings are collected locally and published at the end, the SSR
+	 * callback may reset the shared copy if the proc goes down again
+	 */
+	GSL_MUTEX_LOCK(gsl_ctxt.ssr_lock);
+	num_restarts = gsl_ctxt.spf_restart[master_proc];
+	local_stats = gsl_ctxt.ssr_stats[master_proc];
+	GSL_MUTEX_UNLOCK(gsl_ctxt.ssr_lock);
+	if (num_restarts == 0)
+		return AR_EOK;
+
+	ts = ar_timer_get_time_in_us();
+	gsl_shmem_remap_pre_alloc(master_proc);
+	stats->shmem_remap_us = (uint32_t)(ar_timer_get_time_in_us() - ts);
+
+	ts = ar_timer_get_time_in_us();
+	gsl_mdf_utils_get_supported_ss_info_from_master_proc(master_proc,
+		&supported_ss_mask);
+	gsl_mdf_utils_get_proc_domain_info(&proc_domains, &num_procs);
+	if (!proc_domains)
+		num_procs = 0;
+	/* Reset dynamic PD mask. It will be handled after dynamic PD is initialized. */
+	for (j = 0; j < num_procs; ++j) {
+		if (proc_domains[j].proc_type == DYNAMIC_PD)
+			supported_ss_mask &= ~(GSL_GET_SPF_SS_MASK(proc_domains[j].proc_id));
+	}
+	rc = gsl_send_spf_satellite_info(master_proc, supported_ss_mask,
+		GSL_MAIN_SRC_PORT, &gsl_ctxt.rsp_signal);
+	stats->satellite_info_us = (uint32_t)(ar_timer_get_time_in_us() - ts);
+	if (rc) {
+		GSL_ERR("gsl_send_spf_satellite_info failed for master_proc %d rc %d",
+			master_proc, rc);
+		goto exit;
+	}
+
+	ts = ar_timer_get_time_in_us();
+	__gpr_cmd_is_shared_mem_supported(master_proc, &is_shmem_supported);
+	if (is_shmem_supported) {
+		rc = gsl_mdf_utils_shmem_alloc(supported_ss_mask, master_proc);
+		stats->loaned_shmem_us = (uint32_t)(ar_timer_get_time_in_us() - ts);
+		if (rc != AR_EOK && rc != AR_EUNSUPPORTED) {
+			GSL_ERR("failed to alloc loaned shmem for master_proc %d rc %d",
+				master_proc, rc);
+			goto exit;
+		}
+	}
+
+	/*
+	 * retry for up to 3 seconds to help in cases
+	 * where ADSP RPC thread not ready
+	 */
+	ts = ar_timer_get_time_in_us();
+	for (j = 0; j < GSL_DYN_DL_NUM_RETRIES_SSR; ++j) {
+		rc = gsl_do_load_bootup_dyn_modules(master_proc, NULL);
+		if (!rc)
+			break;
+		ar_osal_micro_sleep(GSL_TIMEOUT_US(GSL_DYN_DL_RETRY_MS));
+	}
+	stats->dyn_module_us = (uint32_t)(ar_timer_get_time_in_us() - ts);
+
+exit:
+	stats->status = rc;
+	stats->recovery_us = (uint32_t)(ar_timer_get_time_in_us() -
+		stats->svc_up_ts_us);
+
+	GSL_MUTEX_LOCK(gsl_ctxt.ssr_lock);
+	/* a restart reported meanwhile stays pending and is recovered again */
+	if (!rc)
+		gsl_ctxt.spf_restart[master_proc] -= num_restarts;
+	if (gsl_ctxt.ssr_stats[master_proc].svc_up_ts_us == stats->svc_up_ts_us)
+		gsl_ctxt.ssr_stats[master_proc] = local_stats;
+	GSL_MUTEX_UNLOCK(gsl_ctxt.ssr_lock);
+	GSL_INFO("ssr recovery proc %d rc %d: dn handling %u us, remap %u us, "
+		"satellite info %u us, loaned shmem %u us, dyn modules %u us, "
+		"total since up %u us", master_proc, rc, stats->dn_handling_us,
+		stats->shmem_remap_us, stats->satellite_info_us,
+		stats->loaned_shmem_us, stats->dyn_module_us, stats->recovery_us);
+
+	return rc;
+}
+
+/* recovery queued from the service up notification */
+struct gsl_main_ssr_job {
+	struct gsl_async_job base; /**< must be first */
+	uint32_t master_proc;
+};
+
+static void gsl_main_ssr_recover_exec(struct gsl_async_job *base)
+{
+	struct gsl_main_ssr_job *job = (struct gsl_main_ssr_job *)base;
+
+	GSL_MUTEX_LOCK(gsl_ctxt.open_close_lock);
+	/* does nothing if an open already did it */
+	gsl_main_ssr_recover(job->master_proc);
+	GSL_MUTEX_UNLOCK(gsl_ctxt.open_close_lock);
+
+	gsl_mem_free(job);
+}
+
+/*
+ * Starts recovery of the master proc right away rather than in the next
+ * gsl_open, so that shmem and dynamic modules are ready by the time the
+ * client re-opens its graphs
+ */
+static void gsl_main_queue_ssr_recovery(uint32_t master_proc)
+{
+	struct gsl_main_ssr_job *job;
+
+	job = gsl_mem_zalloc(sizeof(*job));
+	if (!job)
+		return;
+
+	job->master_proc = master_proc;
+	job->base.exec = gsl_main_ssr_recover_exec;
+	/* graph handles always have a non zero magic so this never collides */
+	job->base.key = master_proc;
+	if (gsl_async_queue(&job->base)) {
+		/* fall back to recovering in the next gsl_open */
+		gsl_mem_free(job);
+	}
+}
+
 /**
  * callback handles ssr events and returns the list of impacted
  * graph handles
@@ -499,7 +904,7 @@ static void gsl_main_ssr_callback(enum spf_ss_state_t state,
 	struct gsl_global_event_svc_dn_payload client_pld = {.num_handles = 0,
 		.handle_list = NULL};
 	uint32_t num_graph_handles = 0;
-	uint8_t i = 0;
+	uint32_t i = 0;
 	struct gsl_graph *graph;
 	bool_t master_proc_ssr = gsl_mdf_utils_is_master_proc(spf_ss_mask);
 	uint32_t master_proc = gsl_mdf_utils_get_master_proc_id(spf_ss_mask);
@@ -513,6 +918,15 @@ static void gsl_main_ssr_callback(enum spf_ss_state_t state,
 		return;
 
 	if (state == GSL_SPF_SS_STATE_DN) {
+		if (master_proc_ssr) {
+			GSL_MUTEX_LOCK(gsl_ctxt.ssr_lock);
+			gsl_memset(&gsl_ctxt.ssr_stats[master_proc], 0,
+				sizeof(gsl_ctxt.ssr_stats[master_proc]));
+			gsl_ctxt.ssr_stats[master_proc].svc_dn_ts_us =
+				ar_timer_get_time_in_us();
+			GSL_MUTEX_UNLOCK(gsl_ctxt.ssr_lock);
+		}
+
 		/*
 		 * unblock any memory map operations in progress, for now assume master
 		 * is ADSP this assumption may need to be revisited in the future
@@ -534,11 +948,10 @@ static void gsl_main_ssr_callback(enum spf_ss_state_t state,
 
 			/* build the list of impacted handles */
 			for (i = 0; i < gsl_ctxt.graph_list_size; ++i) {
-				if (!gsl_ctxt.graph_list[i])
+				graph = gsl_graph_at(i);
+				if (!graph)
 					continue;
 
-				graph = (struct gsl_graph *)(gsl_ctxt.graph_list[i]);
-
 				/* check if a ss this graph depends is down */
 				if ((spf_ss_mask & graph->ss_mask) == 0)
 					continue;
@@ -592,11 +1005,24 @@ static void gsl_main_ssr_callback(enum spf_ss_state_t state,
 		/* free the handle_list memory  */
 		if (client_pld.handle_list)
 			gsl_mem_free(client_pld.handle_list);
+
+		if (master_proc_ssr) {
+			GSL_MUTEX_LOCK(gsl_ctxt.ssr_lock);
+			gsl_ctxt.ssr_stats[master_proc].dn_handling_us = (uint32_t)
+				(ar_timer_get_time_in_us() -
+				gsl_ctxt.ssr_stats[master_proc].svc_dn_ts_us);
+			GSL_MUTEX_UNLOCK(gsl_ctxt.ssr_lock);
+		}
 	} else { /* GSL_SPF_SS_STATE_UP */
 		if (master_proc_ssr) {
-			gsl_ctxt.spf_restart[master_proc] = TRUE;
+			GSL_MUTEX_LOCK(gsl_ctxt.ssr_lock);
+			gsl_ctxt.ssr_stats[master_proc].svc_up_ts_us =
+				ar_timer_get_time_in_us();
+			++gsl_ctxt.spf_restart[master_proc];
+			GSL_MUTEX_UNLOCK(gsl_ctxt.ssr_lock);
 			/* clear ssr state from shmem mgr */
 			gsl_shmem_clear_ssr(master_proc);
+			gsl_main_queue_ssr_recovery(master_proc);
 		}
 
 		/* issue callback to client */
@@ -647,50 +1073,176 @@ static uint32_t gsl_main_gpr_callback(gpr_packet_t *packet, void *cb_data)
 	return status;
 }
 
+static void gsl_graph_tbl_free_chunk(struct gsl_graph_slot *chunk)
+{
+	uint32_t i;
+
+	for (i = 0; i < MAX_UC_GRAPHS; ++i) {
+		if (chunk[i].unpin_sig)
+			ar_osal_signal_destroy(chunk[i].unpin_sig);
+		if (chunk[i].open_sig)
+			ar_osal_signal_destroy(chunk[i].open_sig);
+	}
+	gsl_mem_free(chunk);
+}
+
+/* must be called with graph_hdl_lock held */
+static int32_t gsl_graph_tbl_grow(void)
+{
+	struct gsl_graph_slot *chunk;
+	uint32_t chunk_idx = gsl_ctxt.graph_list_size >> GSL_GRAPH_TBL_CHUNK_SHIFT;
+	uint32_t i;
+	int32_t rc;
+
+	if (chunk_idx >= GSL_GRAPH_TBL_NUM_CHUNKS) {
+		GSL_ERR("max number of graphs %d reached", GSL_MAX_GRAPHS);
+		return AR_ENORESOURCE;
+	}
+
+	chunk = gsl_mem_zalloc(sizeof(struct gsl_graph_slot) * MAX_UC_GRAPHS);
+	if (!chunk)
+		return AR_ENOMEMORY;
+
+	for (i = 0; i < MAX_UC_GRAPHS; ++i) {
+		rc = ar_osal_signal_create(&chunk[i].unpin_sig);
+		if (!rc)
+			rc = ar_osal_signal_create(&chunk[i].open_sig);
+		if (rc) {
+			GSL_ERR("failed to create graph table signals %d", rc);
+			gsl_graph_tbl_free_chunk(chunk);
+			return rc;
+		}
+	}
+
+	/* publish the chunk before making its entries visible to open */
+	ar_osal_atomic_store_ptr((void **)&gsl_ctxt.graph_tbl[chunk_idx], chunk);
+	gsl_ctxt.graph_list_size += MAX_UC_GRAPHS;
+
+	return AR_EOK;
+}
+
+static void gsl_graph_tbl_free(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < GSL_GRAPH_TBL_NUM_CHUNKS; ++i) {
+		if (gsl_ctxt.graph_tbl[i])
+			gsl_graph_tbl_free_chunk(gsl_ctxt.graph_tbl[i]);
+		gsl_ctxt.graph_tbl[i] = NULL;
+	}
+	gsl_ctxt.graph_list_size = 0;
+}
+
 static gsl_handle_t get_graph_handle(struct gsl_graph *graph)
 {
-	void **tmp;
+	struct gsl_graph_slot *slot;
 	gsl_handle_t hdl = 0;
-	uint8_t i;
+	uint32_t i;
 
 	GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
 
 	for (i = 0; i < gsl_ctxt.graph_list_size; i++) {
-		if (!gsl_ctxt.graph_list[i])
+		if (!gsl_graph_slot_get(i)->in_use)
 			break;
 	}
 	if (i == gsl_ctxt.graph_list_size) {
-		tmp = gsl_mem_realloc(gsl_ctxt.graph_list,
-			sizeof(void *) * ((size_t)gsl_ctxt.graph_list_size),
-			sizeof(void *) * ((size_t)gsl_ctxt.graph_list_size +
-			(MAX_UC_GRAPHS >> 1)));
-		if (!tmp)
+		if (gsl_graph_tbl_grow())
 			goto exit;
-
-		gsl_ctxt.graph_list_size +=  (MAX_UC_GRAPHS >> 1);
-		gsl_ctxt.graph_list = tmp;
 	}
 
+	slot = gsl_graph_slot_get(i);
 	hdl = to_gsl_handle(i);
 	graph->src_port = get_src_port(i);
-	gsl_ctxt.graph_list[i] = (void *)graph;
+	slot->in_use = TRUE;
+	ar_osal_atomic_store_ptr((void **)&slot->graph, graph);
 	++gsl_ctxt.num_graphs;
 exit:
 	GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
 	return hdl;
 }
 
+/*
+ * Ends the wait of close and ioctl for an open queued by gsl_open_async.
+ * The signal is set after the flag is cleared, so a waiter which saw the flag
+ * still set is woken
+ */
+static void gsl_main_end_open_pending(struct gsl_graph_slot *slot)
+{
+	ar_osal_atomic_store_u32(&slot->open_pending, 0);
+	ar_osal_signal_set(slot->open_sig);
+}
+
+/*
+ * Invalidates the handle and waits for datapath calls which pinned the graph
+ * to return, after which the graph can safely be freed
+ */
 static void release_graph_handle(gsl_handle_t hdl)
 {
-	int32_t i;
+	struct gsl_graph_slot *slot;
+	int32_t rc;
 
 	GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
 
-	i = to_gsl_graph_index(hdl);
-	gsl_ctxt.graph_list[i] = NULL;
-	--gsl_ctxt.num_graphs;
+	slot = gsl_graph_slot_get(to_gsl_graph_index(hdl));
+	if (!slot || !slot->graph) {
+		GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
+		return;
+	}
+	/* clear graph before bumping gen, see to_gsl_graph */
+	ar_osal_atomic_store_ptr((void **)&slot->graph, NULL);
+	ar_osal_atomic_add_u32(&slot->gen, 1);
+	gsl_main_end_open_pending(slot);
 
 	GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
+
+	/*
+	 * slot stays in_use so a new open cannot reuse it while draining. The
+	 * signal is cleared before each check of the count so a wake up left
+	 * by an earlier unpin does not turn this into a busy loop. The graph
+	 * is freed by the caller, so keep waiting past the timeout
+	 */
+	for (;;) {
+		ar_osal_signal_clear(slot->unpin_sig);
+		if (ar_osal_atomic_load_u32(&slot->pin_cnt) == 0)
+			break;
+		rc = ar_osal_signal_timedwait(slot->unpin_sig,
+			GSL_TIMEOUT_NS(GSL_SPF_READ_WRITE_TIMEOUT_MS));
+		if (rc)
+			GSL_ERR("still waiting for %d datapath calls on handle 0x%x",
+				ar_osal_atomic_load_u32(&slot->pin_cnt), hdl);
+	}
+
+	GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
+	slot->in_use = FALSE;
+	--gsl_ctxt.num_graphs;
+	GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
+}
+
+/*
+ * Waits for an open queued by gsl_open_async on this handle to complete. The
+ * open frees the graph if it fails, so close and ioctl must not use the graph
+ * until then. Stops waiting once the handle is released
+ */
+static void gsl_main_wait_open(gsl_handle_t hdl)
+{
+	struct gsl_graph_slot *slot;
+	int32_t rc;
+
+	if (!is_valid_gsl_hdl(hdl))
+		return;
+
+	slot = gsl_graph_slot_get(to_gsl_graph_index(hdl));
+	if (!slot)
+		return;
+
+	while (ar_osal_atomic_load_u32(&slot->open_pending) &&
+		(ar_osal_atomic_load_u32(&slot->gen) & GSL_GRAPH_GEN_MASK) ==
+		to_gsl_graph_gen(hdl)) {
+		rc = ar_osal_signal_timedwait(slot->open_sig,
+			GSL_TIMEOUT_NS(GSL_SPF_TIMEOUT_MS));
+		if (rc)
+			GSL_ERR("still waiting for open of handle 0x%x", hdl);
+	}
 }
 
 void gsl_get_version(uint32_t *major, uint32_t *minor)
@@ -919,13 +1471,10 @@ int32_t gsl_init(struct gsl_init_data *init_data)
 
 	ar_list_init(&gsl_ctxt.acdb_client_list, NULL, NULL);
 	ar_osal_mutex_create(&gsl_ctxt.acdb_client_lock);
-	gsl_ctxt.graph_list_size = MAX_UC_GRAPHS;
-	gsl_ctxt.graph_list = gsl_mem_zalloc(gsl_ctxt.graph_list_size *
-				sizeof(void *));
-	if (!gsl_ctxt.graph_list) {
-		rc = AR_ENOMEMORY;
+	gsl_ctxt.graph_list_size = 0;
+	rc = gsl_graph_tbl_grow();
+	if (rc)
 		goto deinit_gpcpool;
-	}
 
 	gsl_ctxt.num_graphs = 0;
 
@@ -947,10 +1496,16 @@ int32_t gsl_init(struct gsl_init_data *init_data)
 		goto destroy_graph_hdl_lock;
 	}
 
+	rc = ar_osal_mutex_create(&gsl_ctxt.ssr_lock);
+	if (rc) {
+		GSL_ERR("ssr mutex create failed %d", rc);
+		goto destroy_start_stop_lock;
+	}
+
 	rc = gsl_dp_create_cache_refcount_lock();
 	if (rc) {
 		GSL_ERR("external mem cache refcount mutex create failed %d", rc);
-		goto destroy_start_stop_lock;
+		goto destroy_ssr_lock;
 	}
 
 	GSL_PKT_LOG_INIT();
@@ -973,12 +1528,21 @@ int32_t gsl_init(struct gsl_init_data *init_data)
 	}
 	gsl_ctxt.rtgm_state_info.client_op_in_prog = false;
 	gsl_ctxt.rtgm_state_info.num_rtgm_in_prog = 0;
+	gsl_ctxt.rtgm_state_info.num_dp_op_in_prog = 0;
+
+	rc = ar_osal_signal_create(&gsl_ctxt.rtgm_state_info.rtgm_done_sig);
+	if (rc) {
+		GSL_ERR("signal create failed %d", rc);
+		goto destroy_rtgm_state_signal;
+	}
+	/* no RTGM in progress */
+	ar_osal_signal_set(gsl_ctxt.rtgm_state_info.rtgm_done_sig);
 
 	rc = __gpr_cmd_register(GSL_MAIN_SRC_PORT, gsl_main_gpr_callback,
 		&gsl_ctxt);
 	if (rc) {
 		GSL_ERR("gpr register failed");
-		goto destroy_rtgm_state_signal;
+		goto destroy_rtgm_done_signal;
 	}
 
 	rc = gsl_mdf_utils_init();
@@ -1112,8 +1676,15 @@ int32_t gsl_init(struct gsl_init_data *init_data)
 		goto dyn_module_mgr_deinit;
 	}
 
+	rc = gsl_async_init();
+	if (rc) {
+		GSL_ERR("gsl async init failed %d", rc);
+		gsl_rtc_deinit();
+		goto dyn_module_mgr_deinit;
+	}
+
 	for (i = AR_SUB_SYS_ID_FIRST; i <= AR_SUB_SYS_ID_LAST; i++)
-		gsl_ctxt.spf_restart[i] = FALSE;
+		gsl_ctxt.spf_restart[i] = 0;
 
 	GSL_PKT_LOG_CLOSE();
 	gsl_mem_free(master_procs);
@@ -1132,12 +1703,16 @@ mdf_utils_deinit:
 	gsl_mdf_utils_deinit();
 gpr_deregister:
 	__gpr_cmd_deregister(GSL_MAIN_SRC_PORT);
+destroy_rtgm_done_signal:
+	ar_osal_signal_destroy(gsl_ctxt.rtgm_state_info.rtgm_done_sig);
 destroy_rtgm_state_signal:
 	gsl_signal_destroy(&gsl_ctxt.rtgm_state_info.sig);
 destroy_rsp_signal:
 	gsl_signal_destroy(&gsl_ctxt.rsp_signal);
 destroy_ext_mem_cache_lock:
 	gsl_dp_destroy_cache_refcount_lock();
+destroy_ssr_lock:
+	ar_osal_mutex_destroy(gsl_ctxt.ssr_lock);
 destroy_start_stop_lock:
 	GSL_PKT_LOG_CLOSE();
 	ar_osal_mutex_destroy(gsl_ctxt.start_stop_lock);
@@ -1146,7 +1721,7 @@ destroy_graph_hdl_lock:
 destroy_open_close_lock:
 	ar_osal_mutex_destroy(gsl_ctxt.open_close_lock);
 free_graph_list:
-	gsl_mem_free(gsl_ctxt.graph_list);
+	gsl_graph_tbl_free();
 deinit_gpcpool:
 	gsl_global_persist_cal_pool_deinit();
 deinit_sgpool:
@@ -1164,13 +1739,20 @@ deinit_gpr:
 
 void gsl_deinit(void)
 {
+	gsl_handle_t hdl;
 	uint32_t i;
 	uint32_t num_master_procs = 0;
 	uint32_t *master_procs = NULL;
 
-	for (uint8_t j = 0; j < gsl_ctxt.graph_list_size; ++j) {
-		if (gsl_ctxt.graph_list[j])
-			gsl_close(to_gsl_handle(j));
+	/* let queued asynchronous operations complete first */
+	gsl_async_deinit();
+
+	for (uint32_t j = 0; j < gsl_ctxt.graph_list_size; ++j) {
+		GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
+		hdl = gsl_graph_at(j) ? to_gsl_handle(j) : NULL;
+		GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
+		if (hdl)
+			gsl_close(hdl);
 	}
 
 	GSL_PKT_LOG_OPEN(AR_FOPEN_WRITE_ONLY_APPEND);
@@ -1205,11 +1787,13 @@ void gsl_deinit(void)
 	__gpr_cmd_deregister(GSL_MAIN_SRC_PORT);
 	gsl_signal_destroy(&gsl_ctxt.rsp_signal);
 	gsl_signal_destroy(&gsl_ctxt.rtgm_state_info.sig);
+	ar_osal_signal_destroy(gsl_ctxt.rtgm_state_info.rtgm_done_sig);
 	gsl_dp_destroy_cache_refcount_lock();
 	ar_osal_mutex_destroy(gsl_ctxt.open_close_lock);
 	ar_osal_mutex_destroy(gsl_ctxt.start_stop_lock);
+	ar_osal_mutex_destroy(gsl_ctxt.ssr_lock);
 	ar_osal_mutex_destroy(gsl_ctxt.graph_hdl_lock);
-	gsl_mem_free(gsl_ctxt.graph_list);
+	gsl_graph_tbl_free();
 	ar_data_log_deinit();
 	gpr_deinit();
 	GSL_PKT_LOG_CLOSE();
@@ -1226,24 +1810,55 @@ int32_t gsl_register_global_event_cb(gsl_global_cb_func_ptr global_cb,
 	return AR_EOK;
 }
 
-int32_t gsl_open(const struct gsl_key_vector *graph_key_vect,
-	const struct gsl_key_vector *cal_key_vect, gsl_handle_t *graph_handle)
+int32_t gsl_get_ssr_recovery_stats(uint32_t master_proc,
+	struct gsl_ssr_recovery_stats *stats)
 {
-	int32_t rc = AR_EOK;
-	struct gsl_graph *graph = NULL;
-	gsl_handle_t hdl = 0;
-	uint32_t supported_ss_mask = 0;
-	uint32_t num_procs = 0;
-	struct proc_domain_type *proc_domains = NULL;
-	bool_t is_shmem_supported = TRUE;
-	uint8_t i = 0;
-	uint8_t j = 0;
-	int32_t ss_retry_count = 10;
+	if (!stats || master_proc < AR_SUB_SYS_ID_FIRST ||
+		master_proc > AR_SUB_SYS_ID_LAST)
+		return AR_EBADPARAM;
 
-	if (graph_handle == NULL)
+	GSL_MUTEX_LOCK(gsl_ctxt.ssr_lock);
+	*stats = gsl_ctxt.ssr_stats[master_proc];
+	GSL_MUTEX_UNLOCK(gsl_ctxt.ssr_lock);
+
+	return AR_EOK;
+}
+
+int32_t gsl_get_global_persist_cal_stats(
+	struct gsl_global_persist_cal_stats *stats)
+{
+	if (!stats)
 		return AR_EBADPARAM;
 
-	GSL_PKT_LOG_OPEN(AR_FOPEN_WRITE_ONLY_APPEND);
+	gsl_global_persist_cal_pool_get_stats(stats);
+
+	return AR_EOK;
+}
+
+int32_t gsl_dump_gpr_trace(const char *path)
+{
+	int32_t rc;
+
+	if (!path)
+		return AR_EBADPARAM;
+
+	rc = gpr_trace_dump_to_file(path);
+	if (rc)
+		GSL_ERR("gpr trace dump to %s failed %d", path, rc);
+
+	return rc;
+}
+
+/*
+ * Allocates a graph and a handle for it and initializes it locally, nothing is
+ * sent to spf
+ */
+static int32_t gsl_main_graph_create(struct gsl_graph **graph_p,
+	gsl_handle_t *hdl_p)
+{
+	int32_t rc = AR_EOK;
+	struct gsl_graph *graph = NULL;
+	gsl_handle_t hdl = 0;
 
 	graph = gsl_mem_zalloc(sizeof(struct gsl_graph));
 	if (graph == NULL)
@@ -1256,56 +1871,11 @@ int32_t gsl_open(const struct gsl_key_vector *graph_key_vect,
 		goto cleanup;
 	}
 
-	GSL_MUTEX_LOCK(gsl_ctxt.open_close_lock);
-	for (i = AR_SUB_SYS_ID_FIRST; i <= AR_SUB_SYS_ID_LAST; i++) {
-		if (gsl_ctxt.spf_restart[i]) {
-
-			// handle master proc restarting
-			gsl_shmem_remap_pre_alloc(i);
-			gsl_mdf_utils_get_supported_ss_info_from_master_proc(i, &supported_ss_mask);
-			gsl_mdf_utils_get_proc_domain_info(&proc_domains, &num_procs);
-			if (!proc_domains)
-				num_procs = 0;
-			/* Reset dynamic PD mask. It will be handled after dynamic PD is initialized. */
-			for (j = 0; j < num_procs; ++j) {
-				if (proc_domains[j].proc_type == DYNAMIC_PD)
-					supported_ss_mask &= ~(GSL_GET_SPF_SS_MASK(proc_domains[j].proc_id));
-			}
-			rc = gsl_send_spf_satellite_info(i, supported_ss_mask,
-				GSL_MAIN_SRC_PORT, &gsl_ctxt.rsp_signal);
-			if (rc) {
-				GSL_ERR("gsl_send_spf_satellite_info failed for master_proc %d rc %d", i, rc);
-				continue;
-			}
-
-			__gpr_cmd_is_shared_mem_supported(i, &is_shmem_supported);
-			if (is_shmem_supported) {
-				rc = gsl_mdf_utils_shmem_alloc(supported_ss_mask, i);
-				if (rc != AR_EOK && rc != AR_EUNSUPPORTED) {
-					GSL_ERR("failed to alloc loaned shmem for master_proc %d rc %d", i, rc);
-					continue;
-				}
-			}
-            /* retry for up to 3 seconds to help in cases
-			    where ADSP RPC thread not ready */
-			for (j = 0; j < GSL_DYN_DL_NUM_RETRIES_SSR; ++j) {
-				rc = gsl_do_load_bootup_dyn_modules(i, NULL);
-				if (rc) {
-					ar_osal_micro_sleep(GSL_TIMEOUT_US(GSL_DYN_DL_RETRY_MS));
-				} else {
-					gsl_ctxt.spf_restart[i] = FALSE;
-					break;
-				}
-			}
-		}
-	}
-	GSL_MUTEX_UNLOCK(gsl_ctxt.open_close_lock);
-
-    /*
-     * Initialize graph instance and register to GPR to
-     * receive/send commands/events/data from spf
-     * State is updated under lock to sync with SSR
-     */
+	/*
+	 * Initialize graph instance and register to GPR to
+	 * receive/send commands/events/data from spf
+	 * State is updated under lock to sync with SSR
+	 */
 	GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
 	rc = gsl_graph_init(graph);
 	GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
@@ -1314,6 +1884,48 @@ int32_t gsl_open(const struct gsl_key_vector *graph_key_vect,
 		goto release_handle;
 	}
 
+	*graph_p = graph;
+	*hdl_p = hdl;
+	return rc;
+
+release_handle:
+	release_graph_handle(hdl);
+cleanup:
+	gsl_mem_free(graph);
+	return rc;
+}
+
+/* Frees a graph created with gsl_main_graph_create which failed to open */
+static void gsl_main_graph_destroy(struct gsl_graph *graph, gsl_handle_t hdl)
+{
+	release_graph_handle(hdl);
+	GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
+	gsl_graph_deinit(graph);
+	GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
+	gsl_mem_free(graph);
+}
+
+/* Opens a graph created with gsl_main_graph_create on spf */
+static int32_t gsl_main_graph_open(struct gsl_graph *graph,
+	const struct gsl_key_vector *graph_key_vect,
+	const struct gsl_key_vector *cal_key_vect)
+{
+	int32_t rc = AR_EOK;
+	uint32_t i = 0;
+	int32_t ss_retry_count = 10;
+
+	for (i = AR_SUB_SYS_ID_FIRST; i <= AR_SUB_SYS_ID_LAST; i++) {
+		/*
+		 * normally already done by the recovery queued on service up, then
+		 * opens do not serialize here
+		 */
+		if (!gsl_main_ssr_pending(i))
+			continue;
+		GSL_MUTEX_LOCK(gsl_ctxt.open_close_lock);
+		gsl_main_ssr_recover(i);
+		GSL_MUTEX_UNLOCK(gsl_ctxt.open_close_lock);
+	}
+
 	while (ss_retry_count--) {
 		rc = gsl_graph_open(graph, graph_key_vect, cal_key_vect, gsl_ctxt.open_close_lock);
 		if (AR_ESUBSYSRESET == rc) {
@@ -1322,30 +1934,50 @@ int32_t gsl_open(const struct gsl_key_vector *graph_key_vect,
 			continue;
 		} else if (rc) {
 			GSL_ERR("graph_open failed %d", rc);
-			goto deinit;
+			return rc;
 		}
 		break;
 	}
-    // If it comes out from while() with a AR_ESUBSYSRESET even after ss_retry_count's retry,
-    // we should goto deinit.
+	/*
+	 * If it comes out from while() with a AR_ESUBSYSRESET even after
+	 * ss_retry_count's retry, the caller cleans up the graph
+	 */
 	if (AR_ESUBSYSRESET == rc)
-		goto deinit;
-
-	*graph_handle = hdl;
+		return rc;
 
 	if (gsl_ctxt.rtc_conn_active)
 		graph->rtc_conn_active = true;
 
 	return rc;
+}
 
-deinit:
-	GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
-	gsl_graph_deinit(graph);
-	GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
-release_handle:
-	release_graph_handle(hdl);
-cleanup:
-	gsl_mem_free(graph);
+int32_t gsl_open(const struct gsl_key_vector *graph_key_vect,
+	const struct gsl_key_vector *cal_key_vect, gsl_handle_t *graph_handle)
+{
+	int32_t rc = AR_EOK;
+	struct gsl_graph *graph = NULL;
+	gsl_handle_t hdl = 0;
+
+	if (graph_handle == NULL)
+		return AR_EBADPARAM;
+
+	GSL_PKT_LOG_OPEN(AR_FOPEN_WRITE_ONLY_APPEND);
+
+	rc = gsl_main_graph_create(&graph, &hdl);
+	if (rc)
+		goto close_log;
+
+	rc = gsl_main_graph_open(graph, graph_key_vect, cal_key_vect);
+	if (rc) {
+		gsl_main_graph_destroy(graph, hdl);
+		goto close_log;
+	}
+
+	*graph_handle = hdl;
+
+	return rc;
+
+close_log:
 	GSL_PKT_LOG_CLOSE();
 	return rc;
 }
@@ -1355,14 +1987,18 @@ int32_t gsl_close(gsl_handle_t graph_handle)
 	int32_t rc = AR_EOK;
 	struct gsl_graph *graph = NULL;
 
+	gsl_main_wait_open(graph_handle);
+
 	/* if RTGM is in-progress block close */
 	rc = gsl_main_start_client_op_blocking(&gsl_ctxt);
 	if (rc)
 		return rc;
 
 	graph = to_gsl_graph(graph_handle);
-	if (!graph)
+	if (!graph) {
+		gsl_main_end_client_op(&gsl_ctxt);
 		return AR_EBADPARAM;
+	}
 
 	/** Stop graph if not already done */
 	rc = gsl_graph_stop(graph, gsl_ctxt.start_stop_lock);
@@ -1666,6 +2302,8 @@ int32_t gsl_ioctl(gsl_handle_t graph_handle,
 	struct gsl_cmd_graph_select *ag = NULL, *cg = NULL;
 	struct gsl_cmd_remove_graph *rg = NULL;
 
+	gsl_main_wait_open(graph_handle);
+
 	if (!gsl_main_start_client_op(&gsl_ctxt)) {
 		rc = AR_ENOTREADY;
 		goto exit;
@@ -1916,16 +2554,17 @@ int32_t gsl_read(gsl_handle_t graph_handle, uint32_t tag,
 	struct gsl_buff *buff, uint32_t *filled_size)
 {
 	struct gsl_graph *graph;
+	struct gsl_graph_slot *slot = NULL;
 	int32_t rc = AR_EOK;
 
 	GSL_VERBOSE("ENTER handle=%d, buff size=%d", graph_handle, buff->size);
 
 	/* if RTGM is in-progress block read */
-	rc = gsl_main_start_client_op_blocking(&gsl_ctxt);
+	rc = gsl_main_start_dp_op(&gsl_ctxt);
 	if (rc)
 		return rc;
 
-	graph = to_gsl_graph(graph_handle);
+	graph = pin_gsl_graph(graph_handle, &slot);
 	if (!graph) {
 		rc = AR_EBADPARAM;
 		goto exit;
@@ -1947,7 +2586,9 @@ int32_t gsl_read(gsl_handle_t graph_handle, uint32_t tag,
 		GSL_ERR("gsl_graph_read failed err %d", rc);
 
 exit:
-	gsl_main_end_client_op(&gsl_ctxt);
+	if (slot)
+		unpin_gsl_graph(slot);
+	gsl_main_end_dp_op(&gsl_ctxt);
 
 	return rc;
 }
@@ -1956,16 +2597,17 @@ int32_t gsl_write(gsl_handle_t graph_handle, uint32_t tag,
 	struct gsl_buff *buff, uint32_t *consumed_size)
 {
 	struct gsl_graph *graph;
+	struct gsl_graph_slot *slot = NULL;
 	int32_t rc = AR_EOK;
 
 	GSL_VERBOSE("ENTER handle=%d, buff size=%d", graph_handle, buff->size);
 
 	/* if RTGM is in-progress block write */
-	rc = gsl_main_start_client_op_blocking(&gsl_ctxt);
+	rc = gsl_main_start_dp_op(&gsl_ctxt);
 	if (rc)
 		return rc;
 
-	graph = to_gsl_graph(graph_handle);
+	graph = pin_gsl_graph(graph_handle, &slot);
 	if (!graph) {
 		rc = AR_EBADPARAM;
 		goto exit;
@@ -1988,7 +2630,9 @@ int32_t gsl_write(gsl_handle_t graph_handle, uint32_t tag,
 			*consumed_size, rc);
 
 exit:
-	gsl_main_end_client_op(&gsl_ctxt);
+	if (slot)
+		unpin_gsl_graph(slot);
+	gsl_main_end_dp_op(&gsl_ctxt);
 
 	return rc;
 }
@@ -2010,6 +2654,294 @@ int32_t gsl_register_event_cb(gsl_handle_t graph_handle,
 	return AR_EOK;
 }
 
+/** an operation queued through one of the gsl_*_async APIs */
+struct gsl_main_async_job {
+	struct gsl_async_job base; /**< must be first */
+	enum gsl_async_op op;
+	gsl_handle_t hdl;
+	/** callback captured when the operation was queued */
+	gsl_cb_func_ptr cb;
+	void *client_data;
+	/** graph being opened, GSL_ASYNC_OP_OPEN only */
+	struct gsl_graph *graph;
+	struct gsl_key_vector gkv;
+	struct gsl_key_vector ckv;
+	bool_t has_ckv;
+	/** ioctl command and payload, GSL_ASYNC_OP_IOCTL only */
+	enum gsl_cmd_id cmd_id;
+	struct gsl_cmd_properties props;
+	bool_t has_props;
+	/** key vectors and property values referenced above are copied here */
+	uint8_t data[];
+};
+
+static void gsl_main_async_notify(struct gsl_main_async_job *job,
+	int32_t status, uint64_t start_us)
+{
+	struct gsl_event_async_done_payload pld;
+	struct gsl_event_cb_params ev;
+
+	if (!job->cb)
+		return;
+
+	pld.op = job->op;
+	pld.cmd_id = job->cmd_id;
+	pld.status = status;
+	pld.queue_time_us = start_us - job->base.queued_us;
+	pld.exec_time_us = ar_timer_get_time_in_us() - start_us;
+
+	ev.source_module_id = GSL_EVENT_SRC_MODULE_ID_GSL;
+	ev.event_id = GSL_EVENT_ID_ASYNC_DONE;
+	ev.event_payload = &pld;
+	ev.event_payload_size = sizeof(pld);
+	job->cb(&ev, job->client_data);
+}
+
+static void gsl_main_async_exec(struct gsl_async_job *base)
+{
+	struct gsl_main_async_job *job = (struct gsl_main_async_job *)base;
+	struct gsl_graph_slot *slot = NULL;
+	uint64_t start_us = ar_timer_get_time_in_us();
+	int32_t rc = AR_EOK;
+
+	switch (job->op) {
+	case GSL_ASYNC_OP_OPEN:
+		rc = gsl_main_graph_open(job->graph, &job->gkv,
+			job->has_ckv ? &job->ckv : NULL);
+		if (rc) {
+			/*
+			 * handle becomes invalid, queued operations on it will fail.
+			 * Releasing it also clears open_pending
+			 */
+			gsl_main_graph_destroy(job->graph, job->hdl);
+			GSL_PKT_LOG_CLOSE();
+		} else {
+			/* close and ioctl may use the graph from here on */
+			gsl_main_end_open_pending(gsl_graph_slot_get(
+				to_gsl_graph_index(job->hdl)));
+		}
+		break;
+
+	case GSL_ASYNC_OP_IOCTL:
+		/* keep graph alive should the client close it synchronously */
+		if (!pin_gsl_graph(job->hdl, &slot)) {
+			rc = AR_EBADPARAM;
+			break;
+		}
+		rc = gsl_ioctl(job->hdl, job->cmd_id,
+			job->has_props ? &job->props : NULL,
+			job->has_props ? sizeof(job->props) : 0);
+		unpin_gsl_graph(slot);
+		break;
+
+	case GSL_ASYNC_OP_CLOSE:
+		rc = gsl_close(job->hdl);
+		break;
+	}
+
+	if (rc)
+		GSL_ERR("async op %d cmd %d on handle 0x%x failed %d", job->op,
+			job->cmd_id, (uint32_t)(uintptr_t)job->hdl, rc);
+
+	gsl_main_async_notify(job, rc, start_us);
+	gsl_mem_free(job);
+}
+
+static struct gsl_main_async_job *gsl_main_async_job_alloc(
+	enum gsl_async_op op, size_t data_size)
+{
+	struct gsl_main_async_job *job;
+
+	job = gsl_mem_zalloc(sizeof(*job) + data_size);
+	if (!job)
+		return NULL;
+
+	job->op = op;
+	job->base.exec = gsl_main_async_exec;
+	return job;
+}
+
+static int32_t gsl_main_async_queue(struct gsl_main_async_job *job,
+	gsl_handle_t hdl)
+{
+	job->hdl = hdl;
+	/* handles are 32 bits wide, see to_gsl_handle */
+	job->base.key = (uint32_t)(uintptr_t)hdl;
+	return gsl_async_queue(&job->base);
+}
+
+/*
+ * captures the callback of an existing graph for an ioctl or close, pinned so
+ * a concurrent close cannot free the graph while it is read
+ */
+static int32_t gsl_main_async_get_cb(gsl_handle_t hdl,
+	struct gsl_main_async_job *job)
+{
+	struct gsl_graph_slot *slot = NULL;
+	struct gsl_graph *graph;
+
+	graph = pin_gsl_graph(hdl, &slot);
+	if (!graph)
+		return AR_EBADPARAM;
+
+	job->cb = graph->cb;
+	job->client_data = graph->client_data;
+	unpin_gsl_graph(slot);
+
+	return AR_EOK;
+}
+
+int32_t gsl_open_async(const struct gsl_key_vector *graph_key_vect,
+	const struct gsl_key_vector *cal_key_vect, gsl_cb_func_ptr cb,
+	void *client_data, gsl_handle_t *graph_handle)
+{
+	int32_t rc = AR_EOK;
+	struct gsl_main_async_job *job;
+	struct gsl_graph *graph = NULL;
+	struct gsl_graph_slot *slot;
+	gsl_handle_t hdl = 0;
+	size_t gkv_size, ckv_size = 0;
+
+	if (!graph_handle || !graph_key_vect)
+		return AR_EBADPARAM;
+
+	gkv_size = graph_key_vect->num_kvps * sizeof(struct gsl_key_value_pair);
+	if (cal_key_vect)
+		ckv_size = cal_key_vect->num_kvps * sizeof(struct gsl_key_value_pair);
+
+	job = gsl_main_async_job_alloc(GSL_ASYNC_OP_OPEN, gkv_size + ckv_size);
+	if (!job)
+		return AR_ENOMEMORY;
+
+	/* client may free the key vectors once we return */
+	job->gkv.num_kvps = graph_key_vect->num_kvps;
+	job->gkv.kvp = (struct gsl_key_value_pair *)job->data;
+	gsl_memcpy(job->gkv.kvp, gkv_size, graph_key_vect->kvp, gkv_size);
+	if (cal_key_vect) {
+		job->has_ckv = TRUE;
+		job->ckv.num_kvps = cal_key_vect->num_kvps;
+		job->ckv.kvp = (struct gsl_key_value_pair *)(job->data + gkv_size);
+		gsl_memcpy(job->ckv.kvp, ckv_size, cal_key_vect->kvp, ckv_size);
+	}
+
+	GSL_PKT_LOG_OPEN(AR_FOPEN_WRITE_ONLY_APPEND);
+
+	rc = gsl_main_graph_create(&graph, &hdl);
+	if (rc)
+		goto close_log;
+
+	graph->cb = cb;
+	graph->client_data = client_data;
+	job->cb = cb;
+	job->client_data = client_data;
+	job->graph = graph;
+	/*
+	 * close and ioctl on the handle wait for the job, see
+	 * gsl_main_wait_open. The signal is cleared first, it may still be set
+	 * from an earlier graph in the same entry
+	 */
+	slot = gsl_graph_slot_get(to_gsl_graph_index(hdl));
+	ar_osal_signal_clear(slot->open_sig);
+	ar_osal_atomic_store_u32(&slot->open_pending, 1);
+
+	/* job may complete and be freed before this returns */
+	rc = gsl_main_async_queue(job, hdl);
+	if (rc) {
+		gsl_main_graph_destroy(graph, hdl);
+		goto close_log;
+	}
+
+	*graph_handle = hdl;
+	return rc;
+
+close_log:
+	GSL_PKT_LOG_CLOSE();
+	gsl_mem_free(job);
+	return rc;
+}
+
+int32_t gsl_ioctl_async(gsl_handle_t graph_handle,
+	enum gsl_cmd_id cmd_id, void *cmd_payload, size_t cmd_payload_sz)
+{
+	int32_t rc = AR_EOK;
+	struct gsl_main_async_job *job;
+	struct gsl_cmd_properties *props = NULL;
+	size_t kvp_size = 0, values_size = 0;
+
+	switch (cmd_id) {
+	case GSL_CMD_PREPARE:
+	case GSL_CMD_START:
+	case GSL_CMD_SUSPEND:
+		break;
+	case GSL_CMD_STOP:
+		if (!cmd_payload)
+			break;
+		if (cmd_payload_sz != sizeof(struct gsl_cmd_properties))
+			return AR_EBADPARAM;
+		props = (struct gsl_cmd_properties *)cmd_payload;
+		kvp_size = props->gkv.num_kvps * sizeof(struct gsl_key_value_pair);
+		values_size = props->num_property_values * sizeof(uint32_t);
+		break;
+	default:
+		GSL_ERR("cmd %d not supported asynchronously", cmd_id);
+		return AR_EUNSUPPORTED;
+	}
+
+	job = gsl_main_async_job_alloc(GSL_ASYNC_OP_IOCTL,
+		kvp_size + values_size);
+	if (!job)
+		return AR_ENOMEMORY;
+
+	job->cmd_id = cmd_id;
+	if (props) {
+		job->has_props = TRUE;
+		job->props = *props;
+		job->props.gkv.kvp = (struct gsl_key_value_pair *)job->data;
+		gsl_memcpy(job->props.gkv.kvp, kvp_size, props->gkv.kvp, kvp_size);
+		job->props.property_values = (uint32_t *)(job->data + kvp_size);
+		gsl_memcpy(job->props.property_values, values_size,
+			props->property_values, values_size);
+	}
+
+	rc = gsl_main_async_get_cb(graph_handle, job);
+	if (rc)
+		goto free_job;
+
+	rc = gsl_main_async_queue(job, graph_handle);
+	if (rc)
+		goto free_job;
+
+	return rc;
+
+free_job:
+	gsl_mem_free(job);
+	return rc;
+}
+
+int32_t gsl_close_async(gsl_handle_t graph_handle)
+{
+	int32_t rc = AR_EOK;
+	struct gsl_main_async_job *job;
+
+	job = gsl_main_async_job_alloc(GSL_ASYNC_OP_CLOSE, 0);
+	if (!job)
+		return AR_ENOMEMORY;
+
+	rc = gsl_main_async_get_cb(graph_handle, job);
+	if (rc)
+		goto free_job;
+
+	rc = gsl_main_async_queue(job, graph_handle);
+	if (rc)
+		goto free_job;
+
+	return rc;
+
+free_job:
+	gsl_mem_free(job);
+	return rc;
+}
+
 int32_t gsl_get_tagged_data(
 	const struct gsl_key_vector *graph_key_vect, uint32_t tag,
 	struct gsl_key_vector *tag_key_vect, uint8_t *payload,
@@ -2250,44 +3182,56 @@ int32_t gsl_get_processed_buff_cnt(gsl_handle_t graph_handle,
 	enum gsl_data_dir dir, uint32_t *cnt)
 {
 	struct gsl_graph *graph;
+	struct gsl_graph_slot *slot = NULL;
+	int32_t rc = AR_EOK;
 
 	/* no need to synchronize with rtgm as it doesnt do anything with spf */
 
-	graph = to_gsl_graph(graph_handle);
+	graph = pin_gsl_graph(graph_handle, &slot);
 	if (!graph)
 		return AR_EBADPARAM;
 
-	if (gsl_graph_get_state(graph) == GRAPH_ERROR)
-		return AR_ESUBSYSRESET;
+	if (gsl_graph_get_state(graph) == GRAPH_ERROR) {
+		rc = AR_ESUBSYSRESET;
+		goto exit;
+	}
 
 	if (dir == GSL_DATA_DIR_READ)
 		*cnt = gsl_dp_get_processed_buff_cnt(&graph->read_info);
 	else
 		*cnt = gsl_dp_get_processed_buff_cnt(&graph->write_info);
 
-	return AR_EOK;
+exit:
+	unpin_gsl_graph(slot);
+	return rc;
 }
 
 int32_t gsl_get_avail_buffer_size(gsl_handle_t graph_handle, enum gsl_data_dir dir,
 	uint32_t *bytes)
 {
 	struct gsl_graph *graph;
+	struct gsl_graph_slot *slot = NULL;
+	int32_t rc = AR_EOK;
 
 	/* no need to synchronize with rtgm as it doesnt do anything with spf */
 
-	graph = to_gsl_graph(graph_handle);
+	graph = pin_gsl_graph(graph_handle, &slot);
 	if (!graph)
 		return AR_EBADPARAM;
 
-	if (gsl_graph_get_state(graph) == GRAPH_ERROR)
-		return AR_ESUBSYSRESET;
+	if (gsl_graph_get_state(graph) == GRAPH_ERROR) {
+		rc = AR_ESUBSYSRESET;
+		goto exit;
+	}
 
 	if (dir == GSL_DATA_DIR_READ)
 		*bytes = gsl_dp_get_avail_buffer_size(&graph->read_info);
 	else
 		*bytes = gsl_dp_get_avail_buffer_size(&graph->write_info);
 
-	return AR_EOK;
+exit:
+	unpin_gsl_graph(slot);
+	return rc;
 }
 
 int32_t gsl_add_database(struct gsl_acdb_data_files *acdb_data_files,
@@ -2379,3 +3323,119 @@ exit:
 	GSL_MUTEX_UNLOCK(gsl_ctxt.acdb_client_lock);
 	return rc;
 }
+
+#ifdef GSL_TEST_HOOKS
+int32_t gsl_test_init(void)
+{
+	int32_t rc;
+
+	rc = ar_osal_mutex_create(&gsl_ctxt.graph_hdl_lock);
+	if (rc)
+		return rc;
+	rc = gsl_signal_create(&gsl_ctxt.rtgm_state_info.sig, NULL);
+	if (rc)
+		goto destroy_hdl_lock;
+	rc = ar_osal_signal_create(&gsl_ctxt.rtgm_state_info.rtgm_done_sig);
+	if (rc)
+		goto destroy_sig;
+	ar_osal_signal_set(gsl_ctxt.rtgm_state_info.rtgm_done_sig);
+
+	return AR_EOK;
+
+destroy_sig:
+	gsl_signal_destroy(&gsl_ctxt.rtgm_state_info.sig);
+destroy_hdl_lock:
+	ar_osal_mutex_destroy(gsl_ctxt.graph_hdl_lock);
+	return rc;
+}
+
+void gsl_test_deinit(void)
+{
+	gsl_graph_tbl_free();
+	ar_osal_signal_destroy(gsl_ctxt.rtgm_state_info.rtgm_done_sig);
+	gsl_signal_destroy(&gsl_ctxt.rtgm_state_info.sig);
+	ar_osal_mutex_destroy(gsl_ctxt.graph_hdl_lock);
+}
+
+gsl_handle_t gsl_test_open_error_graph(void)
+{
+	struct gsl_graph *graph;
+	gsl_handle_t hdl;
+
+	graph = gsl_mem_zalloc(sizeof(*graph));
+	if (!graph)
+		return NULL;
+
+	graph->graph_state = GRAPH_ERROR;
+	hdl = get_graph_handle(graph);
+	if (!hdl)
+		gsl_mem_free(graph);
+
+	return hdl;
+}
+
+void gsl_test_close_graph(gsl_handle_t graph_handle)
+{
+	struct gsl_graph *graph = to_gsl_graph(graph_handle);
+
+	release_graph_handle(graph_handle);
+	gsl_mem_free(graph);
+}
+
+int32_t gsl_test_start_rtgm(void)
+{
+	return gsl_main_start_rtgm(&gsl_ctxt);
+}
+
+void gsl_test_end_rtgm(void)
+{
+	gsl_main_end_rtgm(&gsl_ctxt);
+}
+
+uint32_t gsl_test_get_pin_cnt(gsl_handle_t graph_handle)
+{
+	struct gsl_graph_slot *slot;
+
+	slot = gsl_graph_slot_get(to_gsl_graph_index(graph_handle));
+	return slot ? ar_osal_atomic_load_u32(&slot->pin_cnt) : 0;
+}
+
+bool_t gsl_test_is_idle(void)
+{
+	return ar_osal_atomic_load_u32(
+		&gsl_ctxt.rtgm_state_info.num_dp_op_in_prog) == 0 &&
+		ar_osal_atomic_load_u32(
+		&gsl_ctxt.rtgm_state_info.num_rtgm_in_prog) == 0 &&
+		!gsl_ctxt.rtgm_state_info.client_op_in_prog;
+}
+
+/*
+ * The synchronization gsl_read and gsl_write used before the datapath op
+ * count and graph pin: a blocking client op around a handle lookup under
+ * graph_hdl_lock
+ */
+int32_t gsl_test_locked_dp_op(gsl_handle_t graph_handle)
+{
+	struct gsl_graph *graph = NULL;
+	int32_t rc;
+
+	rc = gsl_main_start_client_op_blocking(&gsl_ctxt);
+	if (rc)
+		return rc;
+
+	GSL_MUTEX_LOCK(gsl_ctxt.graph_hdl_lock);
+	if (is_valid_gsl_hdl(graph_handle))
+		graph = gsl_graph_at(to_gsl_graph_index(graph_handle));
+	GSL_MUTEX_UNLOCK(gsl_ctxt.graph_hdl_lock);
+
+	if (!graph)
+		rc = AR_EBADPARAM;
+	else if (gsl_graph_get_state(graph) == GRAPH_ERROR ||
+		gsl_graph_get_state(graph) == GRAPH_ERROR_ALLOW_CLEANUP)
+		rc = AR_ESUBSYSRESET;
+
+	gsl_main_end_client_op(&gsl_ctxt);
+
+	return rc;
+}
+#endif /* GSL_TEST_HOOKS */
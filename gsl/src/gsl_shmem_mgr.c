@@ -1326,6 +1326,7 @@ void gsl_shmem_remap_pre_alloc(uint32_t master_proc_id)
 {
 	ar_list_node_t *iter = NULL;
 	struct gsl_shmem_page *page = NULL;
+	int32_t rc = AR_EOK;
 
 	if (!ctxt[master_proc_id])
 		return;
@@ -1336,7 +1337,15 @@ void gsl_shmem_remap_pre_alloc(uint32_t master_proc_id)
 		&ctxt[master_proc_id]->bins[GSL_SHMEM_MGR_BIN_IDX_PRE_ALLOC_SCRATCH]
 			.page_list.dummy) {
 		page = (struct gsl_shmem_page *) iter;
-		gsl_shmem_map_page_to_spf(page, 0, page->spf_ss_mask);
+		rc = gsl_shmem_map_page_to_spf(page, 0, page->spf_ss_mask);
+		if (rc == AR_ENOTREADY || rc == AR_ESUBSYSRESET) {
+			/* remaining pages would fail the same way */
+			GSL_ERR("remap stopped, proc %d went down again rc %d",
+				master_proc_id, rc);
+			break;
+		} else if (rc) {
+			GSL_ERR("remap of pre-alloc page failed %d", rc);
+		}
 		iter = iter->next;
 	}
 }
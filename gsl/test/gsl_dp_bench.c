@@ -0,0 +1,186 @@
+/**
+ * \file gsl_dp_bench.c
+ *
+ * \brief
+ *      Benchmark of the per-call synchronization overhead of gsl_read and
+ *      gsl_write against the blocking client op and locked handle lookup
+ *      they used before. Several threads call both on one graph while, in
+ *      the second pass, another thread keeps starting and finishing RTGM
+ *      operations the way gsl_rtc_callback does. The graph is left in
+ *      GRAPH_ERROR so each call goes through the synchronization and then
+ *      returns AR_ESUBSYSRESET without talking to SPF.
+ *
+ *  Copyright (c) Qualcomm Innovation Center, Inc. All rights reserved.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include "gsl_main.h"
+#include "gsl_spf_timeout.h"
+#include "ar_osal_atomic.h"
+#include "ar_osal_error.h"
+#include "ar_osal_sleep.h"
+#include "ar_osal_thread.h"
+#include "ar_osal_timer.h"
+
+#define DP_BENCH_MAX_THREADS (4)
+#define DP_BENCH_ITERATIONS (1000000)
+/* time RTGM holds off datapath calls, mimics a short graph change */
+#define DP_BENCH_RTGM_HOLD_US (50)
+#define DP_BENCH_TIMEOUT_MS (1000)
+
+enum dp_bench_mode {
+	DP_BENCH_LOCKED, /**< former client op and locked handle lookup */
+	DP_BENCH_PINNED, /**< gsl_read and gsl_write */
+	DP_BENCH_NUM_MODES
+};
+
+static gsl_handle_t dp_bench_hdl;
+static enum dp_bench_mode dp_bench_mode;
+static uint32_t dp_bench_num_running;
+static uint32_t dp_bench_failures[DP_BENCH_NUM_MODES];
+static uint32_t dp_bench_rtgm_failures;
+static uint32_t dp_bench_num_rtgm;
+
+static void dp_bench_thread(void *param)
+{
+	uint8_t data[64];
+	struct gsl_buff buff = { 0 };
+	uint32_t size = 0;
+	uint32_t i;
+	int32_t rc;
+
+	__UNREFERENCED_PARAM(param);
+
+	buff.addr = data;
+	buff.size = sizeof(data);
+
+	for (i = 0; i < DP_BENCH_ITERATIONS; i++) {
+		if (dp_bench_mode == DP_BENCH_LOCKED)
+			rc = gsl_test_locked_dp_op(dp_bench_hdl);
+		else
+			rc = gsl_read(dp_bench_hdl, 0, &buff, &size);
+		if (rc != AR_ESUBSYSRESET)
+			ar_osal_atomic_add_u32(&dp_bench_failures[dp_bench_mode], 1);
+
+		if (dp_bench_mode == DP_BENCH_LOCKED)
+			rc = gsl_test_locked_dp_op(dp_bench_hdl);
+		else
+			rc = gsl_write(dp_bench_hdl, 0, &buff, &size);
+		if (rc != AR_ESUBSYSRESET)
+			ar_osal_atomic_add_u32(&dp_bench_failures[dp_bench_mode], 1);
+	}
+	ar_osal_atomic_sub_u32(&dp_bench_num_running, 1);
+}
+
+static void dp_bench_rtgm_thread(void *param)
+{
+	__UNREFERENCED_PARAM(param);
+
+	while (ar_osal_atomic_load_u32(&dp_bench_num_running) > 0) {
+		if (gsl_test_start_rtgm()) {
+			ar_osal_atomic_add_u32(&dp_bench_rtgm_failures, 1);
+			continue;
+		}
+		/* nothing may still be inside the datapath once RTGM has drained */
+		if (gsl_test_get_pin_cnt(dp_bench_hdl) != 0)
+			ar_osal_atomic_add_u32(&dp_bench_rtgm_failures, 1);
+		ar_osal_micro_sleep(DP_BENCH_RTGM_HOLD_US);
+		gsl_test_end_rtgm();
+		++dp_bench_num_rtgm;
+	}
+}
+
+static uint64_t dp_bench_run(uint32_t num_threads, bool_t with_rtgm)
+{
+	ar_osal_thread_t threads[DP_BENCH_MAX_THREADS + 1] = { NULL };
+	ar_osal_thread_attr_t attr;
+	uint64_t start_us;
+	uint32_t i;
+
+	ar_osal_atomic_store_u32(&dp_bench_num_running, num_threads);
+	start_us = ar_timer_get_time_in_us();
+	for (i = 0; i < num_threads + (with_rtgm ? 1 : 0); i++) {
+		if (ar_osal_thread_attr_init(&attr) ||
+			ar_osal_thread_create(&threads[i], &attr,
+			i < num_threads ? dp_bench_thread : dp_bench_rtgm_thread,
+			NULL)) {
+			printf("thread create failed\n");
+			ar_osal_atomic_add_u32(&dp_bench_failures[dp_bench_mode], 1);
+			if (i < num_threads)
+				ar_osal_atomic_sub_u32(&dp_bench_num_running, 1);
+		}
+	}
+
+	for (i = 0; i < num_threads + 1; i++) {
+		if (threads[i])
+			ar_osal_thread_join_destroy(threads[i]);
+	}
+
+	return ar_timer_get_time_in_us() - start_us;
+}
+
+/* runs one mode without and with RTGM and prints the ns per call */
+static void dp_bench_run_mode(enum dp_bench_mode mode, uint32_t num_threads)
+{
+	uint64_t calls = (uint64_t)DP_BENCH_ITERATIONS * 2 * num_threads;
+	uint64_t us, rtgm_us;
+
+	dp_bench_mode = mode;
+	us = dp_bench_run(num_threads, FALSE);
+	dp_bench_num_rtgm = 0;
+	rtgm_us = dp_bench_run(num_threads, TRUE);
+
+	printf("%u threads, %s: %llu ns/call, with RTGM %llu ns/call (%u RTGM ops)\n",
+		num_threads, mode == DP_BENCH_LOCKED ? "locked" : "pinned",
+		(unsigned long long)(us * 1000 / calls),
+		(unsigned long long)(rtgm_us * 1000 / calls),
+		dp_bench_num_rtgm);
+}
+
+int main(void)
+{
+	uint32_t num_threads, locked_failures;
+	int rc = 0;
+
+	GSL_SPF_TIMEOUT_MS = DP_BENCH_TIMEOUT_MS;
+	GSL_SPF_READ_WRITE_TIMEOUT_MS = DP_BENCH_TIMEOUT_MS;
+
+	if (gsl_test_init()) {
+		printf("setup failed\n");
+		return 1;
+	}
+	dp_bench_hdl = gsl_test_open_error_graph();
+	if (!dp_bench_hdl) {
+		printf("setup failed\n");
+		gsl_test_deinit();
+		return 1;
+	}
+
+	for (num_threads = 1; num_threads <= DP_BENCH_MAX_THREADS;
+		num_threads *= 2) {
+		dp_bench_run_mode(DP_BENCH_LOCKED, num_threads);
+		dp_bench_run_mode(DP_BENCH_PINNED, num_threads);
+	}
+
+	/*
+	 * the baseline is only measured. Its calls can time out when another
+	 * thread consumed the RTGM done event, which is not an error of
+	 * gsl_read and gsl_write
+	 */
+	locked_failures = dp_bench_failures[DP_BENCH_LOCKED];
+	if (locked_failures)
+		printf("baseline: %u calls failed waiting for RTGM\n",
+			locked_failures);
+
+	if (dp_bench_failures[DP_BENCH_PINNED] || dp_bench_rtgm_failures ||
+		!gsl_test_is_idle() || gsl_test_get_pin_cnt(dp_bench_hdl)) {
+		printf("FAILED: %u datapath errors, %u RTGM errors\n",
+			dp_bench_failures[DP_BENCH_PINNED], dp_bench_rtgm_failures);
+		rc = 1;
+	}
+
+	gsl_test_close_graph(dp_bench_hdl);
+	gsl_test_deinit();
+
+	return rc;
+}